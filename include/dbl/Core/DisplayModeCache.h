@@ -0,0 +1,96 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file DisplayModeCache.h
+ * @brief Display mode cache.
+ */
+
+#ifndef __DBL_DISPLAYMODECACHE_H_
+#define __DBL_DISPLAYMODECACHE_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Core/GameWindowSettings.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+
+// External Libraries //
+#include <map>
+#include <vector>
+
+namespace dbl
+{
+	//! @brief Display modes cached per monitor.
+	//! Enumerating display modes goes through the graphics driver and is slow, so modes are
+	//! enumerated once per monitor and kept in memory and in sCacheFile between runs. The
+	//! cache is keyed by monitor identity and is only refreshed when the display configuration
+	//! changes. The cache isn't thread safe: windows enumerate on background threads, so GameWindow
+	//! only finds, stores and invalidates modes while holding its resolution lock.
+	class DBL_API DisplayModeCache
+	{
+	/***** Types *****/
+	public:
+		//! Display mode list.
+		typedef std::vector< GameWindowSize >		DisplayModeList;
+
+	/***** Static Members *****/
+	public:
+		static cbl::FileInfo	sCacheFile;		//!< File modes are cached in between runs (empty to only cache in memory). Defaults to "displaymodes.bin".
+
+	/***** Public Static Methods *****/
+	public:
+		//! Find the cached modes for a monitor.
+		//! @param	monitor		Monitor identity.
+		//! @param	modes		Cached modes.
+		//! @return		False if the monitor's modes haven't been cached.
+		static bool Find( const cbl::String & monitor, DisplayModeList & modes );
+		//! Cache the modes for a monitor and update the cache file.
+		//! @param	monitor		Monitor identity.
+		//! @param	modes		Enumerated modes.
+		static void Store( const cbl::String & monitor, const DisplayModeList & modes );
+		//! Discard every cached mode, including the cache file's.
+		//! Call when the display configuration changes.
+		static void Invalidate( void );
+		//! Get a counter that's incremented every time the cache is invalidated.
+		//! Use this to refresh other values that depend on the display configuration.
+		static cbl::Uint32 GetGeneration( void );
+		//! Sort modes by size and colour depth and remove duplicates.
+		static void Sort( DisplayModeList & modes );
+
+	/***** Private Types *****/
+	private:
+		typedef std::map< cbl::String, DisplayModeList >	MonitorMap;
+
+	/***** Private Static Methods *****/
+	private:
+		//! Load the cache file on first use.
+		static void Load( void );
+		//! Write every cached monitor to the cache file.
+		static void Save( void );
+
+	/***** Private Static Members *****/
+	private:
+		static MonitorMap		sMonitors;		//!< Cached modes per monitor.
+		static bool				sLoaded;		//!< The cache file has been read.
+		static cbl::Uint32		sGeneration;	//!< Invalidation counter.
+	};
+}
+
+#endif // __DBL_DISPLAYMODECACHE_H_
@@ -0,0 +1,107 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file FramePacer.h
+ * @brief Frame rate limiting component.
+ */
+
+#ifndef __DBL_FRAMEPACER_H_
+#define __DBL_FRAMEPACER_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Threading/WaitableTimer.h"
+
+// Chewable Headers //
+#include <cbl/Core/GameComponent.h>
+
+namespace dbl
+{
+	//! @brief Frame rate limiting component.
+	//! Sleeps at the end of each update until the next frame is due instead of letting the
+	//! game loop spin. While the window is focused, frames are paced with a high resolution
+	//! timer at the target frame rate (unlimited by default). While the window is unfocused or
+	//! minimised, the game can be throttled to the idle frame rate (off by default), blocking
+	//! on window events and waking early when input arrives. The update and wait phases are
+	//! lapped on the window's frame timer.
+	class DBL_API FramePacer :
+		public cbl::GameComponent
+	{
+	/***** Static Members *****/
+	public:
+		static cbl::Float64			sDefaultFrameRate;		//!< Focused frame rate (0 for unlimited). Defaults to 0.
+		static cbl::Float64			sDefaultIdleFrameRate;	//!< Unfocused and minimised frame rate (0 for unlimited). Defaults to 0.
+		static cbl::Float64			sSpinTime;				//!< Time before a deadline spent yielding instead of sleeping when the timer isn't high resolution. Defaults to 2ms.
+
+	/***** Properties *****/
+	public:
+		//! Get the focused frame rate (0 for unlimited).
+		inline cbl::Float64 GetFrameRate( void ) const { return mFrameRate; }
+		//! Set the focused frame rate (0 for unlimited).
+		inline void SetFrameRate( cbl::Float64 rate ) { mFrameRate = rate; }
+		//! Get the unfocused and minimised frame rate (0 for unlimited).
+		inline cbl::Float64 GetIdleFrameRate( void ) const { return mIdleFrameRate; }
+		//! Set the unfocused and minimised frame rate (0 for unlimited).
+		inline void SetIdleFrameRate( cbl::Float64 rate ) { mIdleFrameRate = rate; }
+		//! Check if the last frame was throttled to the idle frame rate.
+		inline bool IsIdle( void ) const { return mIdle; }
+		//! Get the time spent waiting at the end of the last frame (in seconds).
+		inline cbl::Float64 GetWaitTime( void ) const { return mWaitTime; }
+		//! Get the time the next frame is due on the window's input clock.
+		inline cbl::Float64 GetNextFrame( void ) const { return mNextFrame; }
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	game		Pointer to game.
+		explicit FramePacer( cbl::Game & game );
+		//! Destructor.
+		virtual ~FramePacer();
+		//! Pure virtual function to initialise component.
+		virtual void Initialise( void );
+		//! Pure virtual function to shut down component.
+		virtual void Shutdown( void );
+		//! Pure virtual update function (from IUpdatable).
+		virtual void Update( const cbl::GameTime & time );
+
+	/***** Private Methods *****/
+	private:
+		//! Sleep until the deadline on the frame timer.
+		void WaitUntil( cbl::Float64 deadline );
+		//! Block on window events until the deadline.
+		void WaitForEventsUntil( cbl::Float64 deadline );
+		void OnWindowLostFocus( void );
+		void OnWindowGainedFocus( void );
+
+	/***** Private Members *****/
+	private:
+		GameWindow			* mWindow;			//!< Window providing the clock, focus and events.
+		WaitableTimer		mTimer;				//!< Frame timer.
+		cbl::Float64		mFrameRate;			//!< Focused frame rate.
+		cbl::Float64		mIdleFrameRate;		//!< Unfocused frame rate.
+		cbl::Float64		mNextFrame;			//!< Time the next frame is due.
+		cbl::Float64		mWaitTime;			//!< Time waited at the end of the last frame.
+		bool				mFocused;			//!< The window has focus.
+		bool				mIdle;				//!< The last frame was throttled.
+	};
+}
+
+CBL_TYPE( dbl::FramePacer, FramePacer );
+
+#endif // __DBL_FRAMEPACER_H_
@@ -0,0 +1,165 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file FrameTimer.h
+ * @brief Per-frame timing capture.
+ */
+
+#ifndef __DBL_FRAMETIMER_H_
+#define __DBL_FRAMETIMER_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Util/Noncopyable.h>
+
+// External Libraries //
+#include <vector>
+
+namespace dbl
+{
+	// Forward Declarations //
+	class JSONWriter;
+
+	//! Frame phases, in the order they run.
+	namespace FramePhase
+	{
+		enum Type
+		{
+			Pump,		//!< Pumping and dispatching window and input events.
+			Update,		//!< Updating the other components.
+			Wait,		//!< Waiting for the next frame (see FramePacer).
+			Draw,		//!< Drawing and presenting; everything after the last lap.
+
+			Count,
+		};
+
+		//! Get the name of a phase.
+		DBL_API const cbl::Char * GetName( Type phase );
+	}
+
+	//! Timing of a single frame.
+	struct FrameTiming
+	{
+		static const cbl::Uint32	sMaxLaps = 8;	//!< Laps kept per frame for the trace.
+
+		//! Phase timing, summed over every lap of the phase.
+		struct Phase
+		{
+			cbl::Float64	Start;		//!< Time the phase's first lap started (in seconds).
+			cbl::Float64	Duration;	//!< Total phase duration (in seconds).
+		};
+
+		//! A single lap.
+		struct Lap
+		{
+			FramePhase::Type	Phase;		//!< Phase the lap ended.
+			cbl::Float64		Start;		//!< Time the lap started (in seconds).
+			cbl::Float64		Duration;	//!< Lap duration (in seconds).
+		};
+
+		cbl::Uint32		Frame;						//!< Frame index.
+		cbl::Float64	Start;						//!< Time the frame started (in seconds).
+		cbl::Float64	Duration;					//!< Time until the next frame started (in seconds).
+		Phase			Phases[FramePhase::Count];	//!< Phase timing.
+		cbl::Uint32		LapCount;					//!< Number of laps kept.
+		Lap				Laps[sMaxLaps];				//!< Laps in order, each a separate trace span.
+	};
+
+	//! Frame time statistics.
+	struct FrameStats
+	{
+		cbl::Uint32		Frames;		//!< Number of frames measured.
+		cbl::Float64	P50;		//!< Median frame time (in seconds).
+		cbl::Float64	P99;		//!< 99th percentile frame time (in seconds).
+		cbl::Float64	Max;		//!< Longest frame time (in seconds).
+		cbl::Uint32		Hitches;	//!< Frames longer than FrameTimer::sHitchThreshold times the median.
+	};
+
+	//! @brief Records the timing of the most recent frames.
+	//! Frames are kept in a fixed-size ring buffer, so recording never allocates. Each frame is
+	//! split into phases with Lap(): a lap ends the given phase at the given time, starting where
+	//! the previous lap (or the frame) ended. Time left over when the next frame begins is
+	//! counted as Draw, which runs after every component has updated.
+	class DBL_API FrameTimer :
+		cbl::Noncopyable
+	{
+	/***** Static Members *****/
+	public:
+		static cbl::Float64		sHitchThreshold;	//!< Frames this many times longer than the median are hitches. Defaults to 2.
+
+	/***** Properties *****/
+	public:
+		//! Get the number of frames kept.
+		inline cbl::Uint32 GetCapacity( void ) const { return cbl::Uint32( mFrames.size() ); }
+		//! Get the number of completed frames recorded.
+		inline cbl::Uint32 GetCount( void ) const { return mCount; }
+		//! Get a completed frame, oldest first.
+		const FrameTiming & GetFrame( cbl::Uint32 index ) const;
+		//! Get the most recently completed frame.
+		inline const FrameTiming & GetLastFrame( void ) const { return GetFrame( mCount - 1 ); }
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	capacity	Number of frames to keep.
+		explicit FrameTimer( cbl::Uint32 capacity );
+		//! Finish the current frame and start a new one.
+		//! @param	frame		Frame index.
+		//! @param	time		Time the frame started (in seconds).
+		void BeginFrame( cbl::Uint32 frame, cbl::Float64 time );
+		//! End a phase of the current frame.
+		//! Laps of the same phase in one frame are added together in FrameTiming::Phases, but
+		//! each is kept as its own span in FrameTiming::Laps (back to back laps are merged).
+		//! Past FrameTiming::sMaxLaps, laps only count towards the phase totals.
+		//! @param	phase		Phase that just ended.
+		//! @param	time		Time it ended (in seconds).
+		void Lap( FramePhase::Type phase, cbl::Float64 time );
+		//! Discard every recorded frame.
+		void Clear( void );
+		//! Compute frame time statistics over the recorded frames.
+		void GetStats( FrameStats & stats ) const;
+		//! Write the recorded frames as a Chrome trace (chrome://tracing, Perfetto).
+		void WriteTrace( JSONWriter & writer ) const;
+		//! Save the recorded frames as a Chrome trace.
+		//! @return		False if the file could not be written.
+		bool SaveTrace( const cbl::Char * fileName ) const;
+
+	/***** Private Types *****/
+	private:
+		typedef std::vector< FrameTiming >		FrameList;
+		typedef std::vector< cbl::Float64 >		DurationList;
+
+	/***** Private Members *****/
+	private:
+		FrameList				mFrames;		//!< Ring buffer of completed frames.
+		cbl::Uint32				mHead;			//!< Slot the next completed frame is written to.
+		cbl::Uint32				mCount;			//!< Number of completed frames.
+		FrameTiming				mCurrent;		//!< Frame being timed.
+		cbl::Float64			mLapTime;		//!< Time the last lap ended.
+		bool					mTiming;		//!< A frame has begun.
+		mutable DurationList	mDurations;		//!< Scratch space for percentiles.
+	};
+}
+
+CBL_TYPE( dbl::FrameTimer, FrameTimer );
+
+#endif // __DBL_FRAMETIMER_H_
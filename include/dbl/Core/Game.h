@@ -31,23 +31,38 @@
 // Delectable Headers //
 #include "dbl/Delectable.h"
 #include "dbl/Core/GameWindow.h"
+#include "dbl/Core/FramePacer.h"
 #include "dbl/Core/LevelManager.h"
+#include "dbl/Core/StartupReport.h"
 #include "dbl/Input/KeyboardManager.h"
 #include "dbl/Input/MouseManager.h"
+#include "dbl/Input/GamepadManager.h"
+#include "dbl/Input/ActionMap.h"
 
 namespace dbl
 {
 	//! @brief Basic windowed game class.
 	//! Derive from this class to obtain a windowed game.
+	//! Startup is timed from Initialise() to the end of the first update, when the window is
+	//! on screen; see Startup. Set GameWindow::sDeferCreation and prefetch levels with
+	//! LevelManager::Prefetch() before Run() to overlap the slow parts of startup.
 	class DBL_API Game :
 		public cbl::Game
 	{
+	/***** Static Members *****/
+	public:
+		static bool			sLogStartupReport;	//!< Log the startup report after the first update. Defaults to false.
+
 	/***** Public Members *****/
 	public:
 		GameWindow			Window;		//!< The game window.
+		FramePacer			Pacer;		//!< Frame rate limiter.
 		KeyboardManager		Keyboard;	//!< Keyboard manager.
 		MouseManager		Mouse;		//!< Mouse manager.
+		GamepadManager		Gamepads;	//!< Gamepad manager.
+		ActionMap			Actions;	//!< Action and axis mapping.
 		LevelManager		Levels;		//!< Level manager.
+		StartupReport		Startup;	//!< Startup time breakdown.
 
 	/***** Public Methods *****/
 	public:
@@ -56,6 +71,13 @@ namespace dbl
 		explicit Game( const cbl::Char * name );
 		//! Destructor.
 		virtual ~Game();
+		//! Initialise the game's components.
+		virtual void Initialise( void );
+		//! Update the game's components.
+		virtual void Update( const cbl::GameTime & time );
+		//! Fill a snapshot of the keyboard and mouse state latched this frame.
+		//! The snapshot can be copied to other threads; it doesn't reference the managers.
+		void GetInputSnapshot( InputSnapshot & snapshot ) const;
 	};
 }
 
@@ -31,20 +31,36 @@
 #include <cbl/Core/Services.h>
 #include <cbl/Core/GameTime.h>
 #include <cbl/Util/Property.h>
+#include <cbl/Util/Stopwatch.h>
 #include <cbl/Math/Vector2.h>
 
 // Delectable Headers //
 #include "dbl/Delectable.h"
 #include "dbl/Core/GameWindowSettings.h"
+#include "dbl/Core/FrameTimer.h"
 #include "dbl/Input/KeyCodes.h"
 #include "dbl/Input/MouseButtons.h"
+#include "dbl/Input/InputEvent.h"
+#include "dbl/Input/InputState.h"
+#include "dbl/Core/WindowEvent.h"
+#include "dbl/Threading/EventBus.h"
+#include "dbl/Threading/RingBuffer.h"
+#include "dbl/Threading/Thread.h"
 #include "dbl/Serialisation/YAMLSerialiser.h"
 #include "dbl/Serialisation/YAMLDeserialiser.h"
 
+// External Libraries //
+#include <list>
+#include <unordered_set>
+#include <vector>
+
 namespace dbl
 {
 	// Forward Declarations //
 	class IPlatformWindow;
+	class IInputSource;
+	class DragDropEnumerator;
+	class SettingsWriter;
 
 	namespace E
 	{
@@ -59,6 +75,8 @@ namespace dbl
 		typedef cbl::Event<void(cbl::Int32,cbl::Int32,::dbl::Mouse::Button)>							WindowMouseButton;	//!< params: X, Y, Button
 		typedef cbl::Event<void(cbl::Int32)>															WindowMouseWheel;	//!< params: Delta
 		typedef cbl::Event<void(cbl::Int32,cbl::Int32,const cbl::FileInfo::List&)>						WindowDragDrop;		//!< params: X, Y, File names, File count.
+		typedef cbl::Event<void(cbl::Int32,cbl::Int32,const cbl::FileInfo::List&,bool)>					WindowDragDropBatch;//!< params: X, Y, File names in this batch, Last batch.
+		typedef cbl::Event<void(const ::dbl::InputEventList&)>											WindowInputBatch;	//!< params: Input events in arrival order.
 #else
 		typedef cbl::Event0<void>																		Window;				//!< Parameterless window event.
 		typedef cbl::Event2<void,cbl::Uint32,cbl::Uint32,cbl::Uint32,cbl::Uint32,cbl::Uint16,cbl::Real>	WindowSize;			//!< params: Resolution X, Resolution Y, Window X, Window Y, BPP, Window aspect ratio
@@ -69,6 +87,8 @@ namespace dbl
 		typedef cbl::Event3<void,cbl::Int32,cbl::Int32,::dbl::Mouse::Button>							WindowMouseButton;	//!< params: X, Y, Button
 		typedef cbl::Event1<void,cbl::Int32>															WindowMouseWheel;	//!< params: Delta
 		typedef cbl::Event3<void,cbl::Int32,cbl::Int32,const cbl::FileInfo::List&>						WindowDragDrop;		//!< params: X, Y, File names, File count.
+		typedef cbl::Event4<void,cbl::Int32,cbl::Int32,const cbl::FileInfo::List&,bool>					WindowDragDropBatch;//!< params: X, Y, File names in this batch, Last batch.
+		typedef cbl::Event1<void,const ::dbl::InputEventList&>											WindowInputBatch;	//!< params: Input events in arrival order.
 #endif
 		// Better naming
 		typedef Window				WindowCreated;
@@ -78,16 +98,20 @@ namespace dbl
 		typedef Window				WindowGainedFocus;
 		typedef Window				WindowMouseEnter;
 		typedef Window				WindowMouseLeave;
+		typedef Window				WindowDisplayChanged;
 		typedef WindowMouseButton	WindowMouseUp;
 		typedef WindowMouseButton	WindowMouseDown;
 		typedef WindowMouseButton	WindowMouseDblClick;
 		typedef WindowKey			WindowKeyUp;
 		typedef WindowKey			WindowKeyDown;
+		typedef WindowMouseMove		WindowMouseRawMotion;	//!< params: DiffX, DiffY
 	}
 
 	//! @brief Main application window object which wraps the OS-dependent implementation.
 	//! The game window's update order is set to always be the first to
 	//! be updated in a game application.
+	//! A game can own several windows (e.g. tool views): add each one as a component and
+	//! bind input managers to it with BindWindow(). dbl::Game::Window remains the GameWindow service.
 	class DBL_API GameWindow :
 		public cbl::GameComponent
 	{
@@ -97,6 +121,12 @@ namespace dbl
 		static void GetWorkableAreaCenter( cbl::Uint32& x, cbl::Uint32& y, GameWindowStyle& style );
 		static void GetBestClientWindowDimensions( cbl::Uint32 targetw, cbl::Uint32 targeth, GameWindowStyle& style, cbl::Uint32& bestw, cbl::Uint32& besth );
 		static cbl::Uint32 GetSystemWindowStyle( GameWindowStyle& style );
+		//! Process platform events for every window in a single pass.
+		//! The first window updated each frame pumps for all of them; only call this
+		//! directly when windows aren't updated as game components.
+		static void PumpEvents( void );
+		//! Get the number of times platform events have been pumped.
+		inline static cbl::Uint32 GetPumpCount( void ) { return sPumpCount; }
 
 	/***** Types *****/
 	public:
@@ -110,13 +140,41 @@ namespace dbl
 		//! Current cursor resource.
 		GETTER_AUTO_CREF( cbl::String, CursorResource );
 		//! Get the list of available window sizes.
-		GETTER_AUTO_CREF( GameWindowSizeList, AvailableResolutions );
+		const GameWindowSizeList & GetAvailableResolutions( void ) const;
 		//! Get the current desktop resolution
-		GETTER_AUTO_CREF( GameWindowSize, DesktopResolution );
+		const GameWindowSize & GetDesktopResolution( void ) const;
 		//! Get game window handle.
+		//! Creates the window if its creation was deferred.
 		GameWindowHandle GetGameWindowHandle();
+		//! Check if the platform window has been created.
+		inline bool IsCreated( void ) const { return mPlatformWindow != NULL; }
 		//! Check if supplied resolution is valid.
 		bool IsValidResolution( cbl::Uint32 width, cbl::Uint32 height ) const;
+		//! Get the current time on the input clock, in seconds.
+		cbl::Float64 GetInputTime( void );
+		//! Get the time of the input event currently being dispatched.
+		//! Use this from input handlers for sub-frame timing.
+		inline cbl::Float64 GetInputEventTime( void ) const { return mInputEventTime; }
+		//! Get the number of window events dropped because a producer's queue was full.
+		inline cbl::Uint32 GetDroppedWindowEvents( void ) const { return mWindowEvents.GetDroppedEvents(); }
+		//! Get the number of input events dropped because the input queue was full.
+		inline cbl::Uint32 GetDroppedInputEvents( void ) const { return mDroppedInputEvents; }
+		//! Get the latest input state sampled by the input thread, read at the start of the frame.
+		GETTER_AUTO_CREF( InputState, InputState );
+		//! Check if input is being sampled on a dedicated thread.
+		bool IsInputThreadEnabled( void ) const;
+		//! Get the number of times the window has been updated.
+		inline cbl::Uint32 GetFrameIndex( void ) const { return mFrameIndex; }
+		//! Get the timing of recent frames.
+		//! Each update begins a frame and laps the event pump; see FramePacer for the rest.
+		inline FrameTimer & GetFrameTimer( void ) { return mFrameTimer; }
+		inline const FrameTimer & GetFrameTimer( void ) const { return mFrameTimer; }
+		//! Get the attached input source.
+		inline IInputSource * GetInputSource( void ) const { return mInputSource; }
+		//! Check if the window is minimised or hidden.
+		bool IsMinimised( void ) const;
+		//! Check if the window was created without a display.
+		inline bool IsHeadless( void ) const { return mHeadless; }
 
 		inline const GameWindowSize& GetWindowDimensions( void ) const { return mSettings.Dimensions; }
 		inline const GameWindowSize& GetResolution( void ) const { return mSettings.Resolution; }
@@ -125,10 +183,20 @@ namespace dbl
 
 	/***** Constants *****/
 	public:
-		static cbl::FileInfo	sSettingsFile;		//!< Default xml file to save/load settings.
+		static cbl::FileInfo	sSettingsFile;		//!< File settings are persisted to. A binary cache is kept alongside it with a ".bin" extension.
+		static bool				sPersistSettings;	//!< Load sSettingsFile on initialisation and save settings changes to it in the background. Defaults to false.
+		static cbl::Float64		sSettingsSaveDelay;	//!< Seconds the settings must stay unchanged before they're saved, so bursts of changes are written once. Defaults to 1.
 		static cbl::Uint32		sMinimumResolutionX;//!< Default resolution width is 640
 		static cbl::Uint32		sMinimumResolutionY;//!< Default resolution width is 480.
 		static bool				sDefaultFullscreen;	//!< Defaults resolution to fullscreen if no window settings applied.
+		static cbl::Uint32		sInputQueueSize;	//!< Input events that can be queued between frames. Defaults to 1024.
+		static cbl::Uint32		sEventQueueSize;	//!< Window events each thread can queue between frames. Defaults to 256.
+		static cbl::Uint32		sDragDropBatchSize;	//!< Maximum files per OnWindowDragDropBatch. Defaults to 256.
+		static cbl::Uint32		sFrameHistory;		//!< Frames of timing kept by the frame timer. Defaults to 1024.
+		static bool				sInputThread;		//!< Sample input on a dedicated thread when the window is created. Defaults to false.
+		static bool				sHeadless;			//!< Create the window without a display. Defaults to false. Windows are always headless when there's no display.
+		static bool				sDeferCreation;		//!< Enumerate resolutions in the background during initialisation and create the window on first use (or the first update). Defaults to false.
+		static GameWindowSize	sVirtualResolution;	//!< Resolution reported by headless windows. Defaults to 1024x768x32.
 
 	/***** Events *****/
 	public:
@@ -139,6 +207,7 @@ namespace dbl
 		E::WindowLostFocus		OnWindowLostFocus;	//!< Triggered when window is loses focus.
 		E::WindowGainedFocus	OnWindowGainedFocus;//!< Triggered when window is gains focus.
 		E::WindowFullScreen		OnWindowFullscreen;	//!< Triggered when window toggles fullscreen mode.
+		E::WindowDisplayChanged	OnWindowDisplayChanged;	//!< Triggered after the display configuration changes and the available resolutions are refreshed.
 		
 		E::WindowKeyDown		OnWindowKeyDown;	//!< Triggered when a key is pressed down.
 		E::WindowKeyUp			OnWindowKeyUp;		//!< Triggered when a key is released.
@@ -149,11 +218,15 @@ namespace dbl
 		E::WindowMouseDown		OnWindowMouseDown;	//!< Triggered when mouse button is pressed down.
 		E::WindowMouseUp		OnWindowMouseUp;	//!< Triggered when mouse button is released.
 		E::WindowMouseWheel		OnWindowMouseWheel;	//!< Triggered when mouse wheel is moved.
+		E::WindowMouseRawMotion	OnWindowMouseRawMotion;	//!< Triggered with relative device motion while in relative mouse mode.
 		
 		E::WindowMouseEnter		OnWindowMouseEnter;	//!< Triggered when mouse enters the window.
 		E::WindowMouseLeave		OnWindowMouseLeave;	//!< Triggered when mouse leaves the window.
 
-		E::WindowDragDrop		OnWindowDragDrop;	//!< Triggered when a file is dragged into the window.
+		E::WindowDragDrop		OnWindowDragDrop;	//!< Triggered when a file is dragged into the window, once every dropped folder has been expanded.
+		E::WindowDragDropBatch	OnWindowDragDropBatch;	//!< Triggered with each batch of files found while dropped folders are expanded.
+
+		E::WindowInputBatch		OnWindowInputBatch;	//!< Triggered once per frame with all input events received since the last frame.
 
 	/***** Public Methods *****/
 	public:
@@ -168,6 +241,7 @@ namespace dbl
 		//! Automatically destroys any existing window.
 		~GameWindow();
 		//! Initialise and create the game window.
+		//! With sDeferCreation set, this only starts enumerating resolutions.
 		virtual void Initialise( void );
 		//! Shutdown and destroy the game window.
 		virtual void Shutdown( void );
@@ -192,6 +266,7 @@ namespace dbl
 		//! @param	state		Fullscreen state.
 		void SetFullscreen( bool state );
 		//! Show game window.
+		//! Creates the window if its creation was deferred.
 		//! @param	state		Visibility state.
 		void Show( bool state );
 		//! Show window cursor.
@@ -210,12 +285,59 @@ namespace dbl
 		void ClipCursor( bool state );
 		//! Set whether the drag and drop works.
 		void SetAcceptDragDrop( bool state );
+		//! Queue a platform input event for delivery on the next update.
+		//! Only the platform layer should call this.
+		//! @return		False if the input queue is full and the event was dropped.
+		bool PushInputEvent( const InputEvent & ev );
+		//! Queue a window event from any thread.
+		//! Window events (resize, fullscreen, close and drag and drop) are raised on the main
+		//! thread during the next update, before input events.
+		//! @return		False if the calling thread's queue is full and the event was dropped.
+		bool PostWindowEvent( const WindowEvent & ev );
+		//! Drop files and folders on the window.
+		//! Folders are expanded on a background thread and the files found are delivered through
+		//! OnWindowDragDropBatch as they are discovered, then OnWindowDragDrop once complete.
+		//! Drops are delivered one at a time in the order they were made.
+		//! @param	x, y		Drop position.
+		//! @param	paths		Dropped files and folders.
+		void DropFiles( cbl::Int32 x, cbl::Int32 y, const std::vector< cbl::String > & paths );
+		//! Queue an input event as if it came from the platform, e.g. to drive a headless window.
+		//! Events with no time are stamped with the current input time.
+		//! @return		False if the input queue is full and the event was dropped.
+		bool InjectInputEvent( const InputEvent & ev );
+		//! Get a file descriptor that becomes readable when window events arrive.
+		//! Use this to wait on window input alongside other descriptors.
+		//! @return		-1 if the platform has no such descriptor.
+		int GetEventFd( void ) const;
+		//! Block until window events arrive or the timeout expires, instead of spinning.
+		//! @param	timeout		Maximum wait in seconds (negative waits indefinitely).
+		//! @return		False if the timeout expired without any events.
+		bool WaitForEvents( cbl::Float64 timeout );
+		//! Report relative mouse motion straight from the device instead of cursor positions.
+		//! @return		False if the platform does not support relative motion.
+		bool SetRelativeMouseMode( bool state );
+		//! Check if relative mouse motion is being reported.
+		bool IsRelativeMouseMode( void ) const;
+		//! Attach an input source that replaces live platform input (NULL to detach).
+		//! The window does not need to be initialised to dispatch input from a source.
+		void SetInputSource( IInputSource * source );
+		//! Start or stop sampling input on a dedicated thread.
+		//! Input is sampled and timestamped as it arrives instead of once per frame.
+		//! @return		False if the platform does not support an input thread.
+		bool SetInputThreadEnabled( bool state );
 		//! Save window settings.
+		//! The file is replaced atomically, along with its binary cache, after any background save finishes.
 		template< typename SERIALISER_TYPE >
 		void SaveSettings( const cbl::Char* fileName ) const;
 		//! Load window settings.
+		//! The binary cache is used instead of parsing the file as long as it's up to date.
 		template< typename DESERIALISER_TYPE >
 		void LoadSettings( const cbl::Char* fileName );
+		//! Save the settings to sSettingsFile on a worker thread once they've been unchanged for sSettingsSaveDelay.
+		//! Called automatically when the settings change if sPersistSettings is set.
+		void QueueSaveSettings( void );
+		//! Write any queued settings save now and wait for it to finish.
+		void FlushSettings( void );
 		
 	/***** Private Methods *****/
 	private:
@@ -223,8 +345,49 @@ namespace dbl
 		void PopulateResolutions( void );
 		//! Set resolution to the current desktop resolution.
 		void SetCurrentDesktopResolution( void );
+		//! Refresh the available resolutions and desktop resolution.
+		//! @param	displayChanged	Discard the display mode cache first, unless another window already has for this change.
+		void RefreshResolutions( bool displayChanged );
+		//! Resolution thread entry point.
+		static void RefreshResolutionsThread( void * self );
+		//! Wait for resolutions being enumerated in the background.
+		void WaitForResolutions( void ) const;
+		//! Create the platform window if its creation was deferred.
+		inline void EnsureCreated( void ) { if( mCreatePending ) CreatePlatformWindow(); }
+		//! Create the platform window.
+		void CreatePlatformWindow( void );
 		//! Default to desktop resolution and fullscreen if flag is set.
 		void DefaultToFullscreen( void );
+		//! Queue a settings save if settings are persisted.
+		inline void OnSettingsChanged( void ) { if( sPersistSettings ) QueueSaveSettings(); }
+		//! Start writing the settings on the worker thread.
+		//! @return		False if the previous write is still in progress.
+		bool StartSettingsWrite( void );
+		//! Raise all queued window events.
+		void DispatchWindowEvents( void );
+		//! Fire the window event for a single posted event.
+		void DispatchWindowEvent( const WindowEvent & ev );
+		//! Start expanding the drop at the front of the queue, discarding any that can't be.
+		void StartDragDrop( void );
+		//! Deliver the files found by the current drop.
+		void DispatchDragDrops( void );
+		//! Cancel and discard every drop.
+		void ClearDragDrops( void );
+		//! Deliver all queued input events.
+		void DispatchInputEvents( void );
+		//! Fire the window event for a single input event.
+		void DispatchInputEvent( const InputEvent & ev );
+
+	/***** Private Types *****/
+	private:
+		//! Input event queue.
+		typedef RingBuffer< InputEvent >	InputEventQueue;
+		//! Drops being expanded (the first is running, the rest are waiting).
+		typedef std::list< DragDropEnumerator * >	DragDropList;
+		//! Resolution index, keyed by width and height.
+		typedef std::unordered_set< cbl::Uint64 >	ResolutionIndex;
+		//! Window event bus.
+		typedef EventBus< WindowEvent >		WindowEventBus;
 
 	/***** Private Members *****/
 	private:
@@ -232,7 +395,36 @@ namespace dbl
 		GameWindowSettings		mSettings;				//!< Game window settings.
 		cbl::String				mCursorResource;		//!< Current cursor resource.
 		GameWindowSizeList		mAvailableResolutions;	//!< Available screen resolutions.
+		ResolutionIndex			mResolutionIndex;		//!< Available screen resolutions by size.
 		GameWindowSize			mDesktopResolution;		//!< The desktop resolution.
+		WindowEventBus			mWindowEvents;			//!< Window events posted from any thread.
+		WindowEventList			mWindowEventBatch;		//!< Window events being raised this frame.
+		DragDropList			mDragDrops;				//!< Drops being expanded.
+		cbl::FileInfo::List		mDragDropFiles;			//!< Files delivered so far for the current drop.
+		InputEventQueue			mInputQueue;			//!< Timestamped input events waiting for the next update.
+		InputEventList			mInputBatch;			//!< Input events being dispatched this frame.
+		cbl::Stopwatch			mInputClock;			//!< Input event clock.
+		cbl::Float64			mInputEventTime;		//!< Time of the input event being dispatched.
+		cbl::Uint32				mDroppedInputEvents;	//!< Input events dropped due to a full queue.
+		InputState				mInputState;			//!< Latest sampled input state.
+		IInputSource			* mInputSource;			//!< Input source replacing live input.
+		cbl::Uint32				mFrameIndex;			//!< Number of updates.
+		FrameTimer				mFrameTimer;			//!< Recent frame timing.
+		bool					mHeadless;				//!< Window was created without a display.
+		bool					mCreatePending;			//!< Window creation has been deferred.
+		mutable Thread			mResolutionThread;		//!< Background resolution enumeration.
+		cbl::Float64			mResolutionStart;		//!< Startup time the resolution thread was started.
+		cbl::Float64			mResolutionTime;		//!< Time the resolution thread took (written by the thread).
+		cbl::Uint32				mDisplayGeneration;		//!< Display mode cache generation the resolutions were enumerated from.
+		cbl::Uint32				mLastPump;				//!< Pump count at this window's last update.
+		SettingsWriter			* mSettingsWriter;		//!< Background settings writer.
+		mutable bool			mSettingsPending;		//!< Settings have changed since they were last written.
+		cbl::Float64			mSettingsChangeTime;	//!< Input time the settings last changed.
+
+	/***** Private Static Members *****/
+	private:
+		static cbl::Uint32		sPumpCount;				//!< Number of event pumps.
+		static volatile cbl::Uint32	sResolutionLock;	//!< Serialises resolution enumeration and display mode cache access between windows.
 	};
 
 	template<>
@@ -26,13 +26,12 @@
 
 // Delectable Headers //
 #include "dbl/Delectable.h"
+#include "dbl/Serialisation/StaticFields.h"
 
 namespace dbl
 {
-#if CBL_PLATFORM == CBL_PLATFORM_WIN32
-	// Windows defines a void* handle (HWND)
+	// Windows defines a void* handle (HWND); headless windows have a NULL handle.
 	typedef void *		GameWindowHandle;
-#endif
 
 	//! Game window styles.
 	//! Use bitwise OR to combine options.
@@ -95,4 +94,23 @@ CBL_TYPE( dbl::GameWindowStyle, GameWindowStyle );
 CBL_TYPE( dbl::GameWindowSize, GameWindowSize );
 CBL_TYPE( dbl::GameWindowSettings, GameWindowSettings );
 
+// Compile-time field lists (mirror the CBL_FIELD registration in DblRegistrar.cpp).
+DBL_STATIC_FIELDS_BEGIN( dbl::GameWindowStyle )
+	DBL_STATIC_FIELD( Close )
+	DBL_STATIC_FIELD( Minimize )
+	DBL_STATIC_FIELD( Fullscreen )
+DBL_STATIC_FIELDS_END()
+
+DBL_STATIC_FIELDS_BEGIN( dbl::GameWindowSize )
+	DBL_STATIC_FIELD( Width )
+	DBL_STATIC_FIELD( Height )
+	DBL_STATIC_FIELD( BitsPerPixel )
+DBL_STATIC_FIELDS_END()
+
+DBL_STATIC_FIELDS_BEGIN( dbl::GameWindowSettings )
+	DBL_STATIC_FIELD( Title )
+	DBL_STATIC_FIELD( Style )
+	DBL_STATIC_FIELD( Resolution )
+DBL_STATIC_FIELDS_END()
+
 #endif // __DBL_GAMEWINDOWSETTINGS_H_
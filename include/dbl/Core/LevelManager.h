@@ -26,8 +26,11 @@
 
 // Delectable Headers //
 #include "dbl/Delectable.h"
+#include "dbl/Serialisation/JSONDeserialiser.h"
+#include "dbl/Serialisation/JSONSerialiser.h"
 #include "dbl/Serialisation/YAMLDeserialiser.h"
 #include "dbl/Serialisation/YAMLSerialiser.h"
+#include "dbl/Threading/Thread.h"
 
 // Chewable Headers //
 #include "cbl/Serialisation/BinaryDeserialiser.h"
@@ -58,6 +61,18 @@ namespace dbl
 	private:
 		typedef std::vector<cbl::ObjectID>	LevelObjectList;
 
+		//! Level file being read ahead of time.
+		struct LevelPrefetch
+		{
+			cbl::String		File;		//!< Level file.
+			Thread			Worker;		//!< Reading thread.
+			cbl::Float64	Start;		//!< Startup time the read started.
+			cbl::Float64	Duration;	//!< Read time (written by the worker).
+			volatile cbl::Uint32	Finished;	//!< The read has finished.
+		};
+
+		typedef std::vector<LevelPrefetch*>	PrefetchList;
+
 	public:
 		bool IsLoading( void ) const { return Enabled || Visible; }
 
@@ -91,15 +106,19 @@ namespace dbl
 		//! Pure virtual draw function (from IDrawable).
 		virtual void Draw( const cbl::GameTime & time );
 		//! Load new level.
-		//! @tparam	DESERIALISER_TYPE	Deserialiser type. e.g. YAMLDeserialiser, BinaryDeserialiser.
+		//! @tparam	DESERIALISER_TYPE	Deserialiser type. e.g. YAMLDeserialiser, JSONDeserialiser, BinaryDeserialiser.
 		template< typename DESERIALISER_TYPE >
 		void Load( const cbl::Char* file, bool unload = true );
 		//! Save current level.
-		//! @tparam	SERIALISER_TYPE		Serialiser type. e.g. YAMLSerialiser, BinarySerialiser.
+		//! @tparam	SERIALISER_TYPE		Serialiser type. e.g. YAMLSerialiser, JSONSerialiser, BinarySerialiser.
 		template< typename SERIALISER_TYPE >
 		void Save( const cbl::Char* file ) const;
 		//! Unload current level.
 		void Unload( void );
+		//! Start reading a level file on a background thread, e.g. while the game starts up.
+		//! A later Load() of the file finds it in the file system cache instead of waiting on the disk.
+		//! Load() doesn't wait for the prefetch; if it's still running, both read at once.
+		void Prefetch( const cbl::Char* file );
 		//! Begin iterator for level object IDs.
 		iterator begin( void ) { return mLevelObjects.begin(); }
 		//! Begin iterator for level object IDs.
@@ -120,6 +139,11 @@ namespace dbl
 	private:
 		//! Setup the necessary variables for loading a file.
 		void SetupLoad( const cbl::Char* file, bool unload );
+		//! Prefetch thread entry point.
+		static void PrefetchThread( void* prefetch );
+		//! Clean up prefetches that have finished.
+		//! @param	wait	Wait for every prefetch to finish first.
+		void CollectPrefetches( bool wait );
 		//! Used by LevelObject to add itself to the manager.
 		void Add( LevelObject* obj );
 		//! Used by LevelObject to remove itself from the manager.
@@ -134,6 +158,7 @@ namespace dbl
 		cbl::Uint32					mUnloadWait;
 		mutable cbl::FileInfo		mLoadedLevel;
 		LevelObjectList				mLevelObjects;
+		PrefetchList				mPrefetches;
 		friend class				LevelObject;
 	};
 
@@ -155,6 +180,12 @@ namespace dbl
 	//! YAML level serialiser.
 	template<> 
 	DBL_API void LevelManager::Save<YAMLSerialiser>( const cbl::Char* file ) const;
+	//! JSON level deserialiser.
+	template<> 
+	DBL_API void LevelManager::Load<JSONDeserialiser>( const cbl::Char* file, bool unload );
+	//! JSON level serialiser.
+	template<> 
+	DBL_API void LevelManager::Save<JSONSerialiser>( const cbl::Char* file ) const;
 	//! Binary level deserialiser.
 	template<> 
 	DBL_API void LevelManager::Load<cbl::BinaryDeserialiser>( const cbl::Char* file, bool unload );
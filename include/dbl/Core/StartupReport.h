@@ -0,0 +1,100 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file StartupReport.h
+ * @brief Startup time breakdown.
+ */
+
+#ifndef __DBL_STARTUPREPORT_H_
+#define __DBL_STARTUPREPORT_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Util/Property.h>
+#include <cbl/Util/Stopwatch.h>
+
+// External Libraries //
+#include <vector>
+
+namespace dbl
+{
+	//! @brief Breakdown of where startup time went.
+	//! dbl::Game registers its report as a service; components add the phases they time.
+	//! Phases run on other threads are added by the main thread once they've been joined.
+	class DBL_API StartupReport
+	{
+	/***** Types *****/
+	public:
+		//! Timed startup phase.
+		struct Phase
+		{
+			cbl::String		Name;		//!< Phase name.
+			cbl::Float64	Start;		//!< Time the phase started, relative to Begin() (in seconds).
+			cbl::Float64	Duration;	//!< Phase duration (in seconds).
+			bool			Background;	//!< The phase ran on another thread.
+		};
+
+		//! Phase list.
+		typedef std::vector< Phase >	PhaseList;
+
+	/***** Properties *****/
+	public:
+		//! Get the recorded phases, in the order they were added.
+		GETTER_AUTO_CREF( PhaseList, Phases );
+		//! Get the time from Begin() to End() (in seconds).
+		inline cbl::Float64 GetTotalTime( void ) const { return mTotalTime; }
+		//! Check if startup has finished.
+		inline bool IsFinished( void ) const { return mFinished; }
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		StartupReport();
+		//! Start timing startup, discarding any recorded phases.
+		void Begin( void );
+		//! Finish timing startup.
+		void End( void );
+		//! Get the time since Begin() (in seconds).
+		cbl::Float64 GetTime( void ) const;
+		//! Add a timed phase.
+		//! @param	name		Phase name.
+		//! @param	start		Time the phase started, from GetTime().
+		//! @param	duration	Phase duration (in seconds).
+		//! @param	background	The phase ran on another thread.
+		void Add( const cbl::Char * name, cbl::Float64 start, cbl::Float64 duration, bool background = false );
+		//! Add a phase that started at the given time and finished now.
+		void AddSince( const cbl::Char * name, cbl::Float64 start );
+		//! Log the breakdown.
+		void Log( void ) const;
+
+	/***** Private Members *****/
+	private:
+		cbl::Stopwatch			mClock;			//!< Startup clock.
+		PhaseList				mPhases;		//!< Recorded phases.
+		cbl::Float64			mTotalTime;		//!< Total startup time.
+		bool					mFinished;		//!< End() has been called.
+	};
+}
+
+CBL_TYPE( dbl::StartupReport, StartupReport );
+
+#endif // __DBL_STARTUPREPORT_H_
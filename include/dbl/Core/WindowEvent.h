@@ -0,0 +1,94 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file WindowEvent.h
+ * @brief Deferred window event.
+ */
+
+#ifndef __DBL_WINDOWEVENT_H_
+#define __DBL_WINDOWEVENT_H_
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+// External Libraries //
+#include <vector>
+
+namespace dbl
+{
+	//! Window event types.
+	namespace WindowEventType
+	{
+		enum Type
+		{
+			Resized,		//!< Width, Height: Resolution. X, Y: Window dimensions. Code: Bits per pixel. AspectRatio.
+			Fullscreen,		//!< Code: Fullscreen state. X: Non-zero if the mode change failed.
+			Closed,
+			DisplayChanged,	//!< The display configuration or work area changed.
+
+			Count,
+		};
+	}
+
+	//! @brief Window event posted to the GameWindow's event bus.
+	//! Window events can be posted from any thread and are raised on the main thread during
+	//! the window's update, before input events.
+	struct WindowEvent
+	{
+		cbl::Uint32				Type;			//!< WindowEventType::Type.
+		cbl::Uint32				Code;			//!< Bits per pixel or fullscreen state.
+		cbl::Int32				X;				//!< Window width or error flag.
+		cbl::Int32				Y;				//!< Window height.
+		cbl::Uint32				Width;			//!< Resolution width.
+		cbl::Uint32				Height;			//!< Resolution height.
+		cbl::Real				AspectRatio;	//!< Window aspect ratio.
+
+		//! Build a window event.
+		static inline WindowEvent Make( WindowEventType::Type type, cbl::Uint32 code = 0, cbl::Int32 x = 0, cbl::Int32 y = 0 )
+		{
+			WindowEvent ev;
+			ev.Type			= type;
+			ev.Code			= code;
+			ev.X			= x;
+			ev.Y			= y;
+			ev.Width		= 0;
+			ev.Height		= 0;
+			ev.AspectRatio	= 0;
+			return ev;
+		}
+
+		//! Build a resize event.
+		static inline WindowEvent MakeResized( cbl::Uint32 resx, cbl::Uint32 resy, cbl::Uint32 width, cbl::Uint32 height, cbl::Uint16 bpp, cbl::Real aspectRatio )
+		{
+			WindowEvent ev = Make( WindowEventType::Resized, bpp, cbl::Int32( width ), cbl::Int32( height ) );
+			ev.Width		= resx;
+			ev.Height		= resy;
+			ev.AspectRatio	= aspectRatio;
+			return ev;
+		}
+	};
+
+	//! Window event list.
+	typedef std::vector< WindowEvent >	WindowEventList;
+}
+
+#endif // __DBL_WINDOWEVENT_H_
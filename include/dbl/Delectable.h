@@ -37,6 +37,9 @@
 namespace dbl
 {
 	// Core //
+	class DisplayModeCache;
+	class FramePacer;
+	class FrameTimer;
 	class Game;
 	class GameWindow;
 	struct GameWindowSize;
@@ -44,8 +47,23 @@ namespace dbl
 	class IPlatformWindow;
 	class LevelManager;
 	class LevelObject;
+	class StartupReport;
+	struct WindowEvent;
 
 	// Input //
+	class ActionMap;
+	struct ActionBindings;
+	class ComboDetector;
+	struct GamepadEvent;
+	class GamepadManager;
+	struct GamepadState;
+	class IGamepadBackend;
+	class IInputSource;
+	class InputRecorder;
+	class InputReplay;
+	struct InputEvent;
+	struct InputSnapshot;
+	struct InputState;
 	class KeyboardManager;
 	class MouseManager;
 
@@ -0,0 +1,65 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file ActionBindings.h
+ * @brief Action and axis input bindings.
+ */
+
+#ifndef __DBL_ACTIONBINDINGS_H_
+#define __DBL_ACTIONBINDINGS_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/KeyCodes.h"
+#include "dbl/Input/MouseButtons.h"
+
+// External Dependencies //
+#include <vector>
+
+namespace dbl
+{
+	//! Inputs bound to a named action.
+	struct DBL_API ActionBinding
+	{
+		cbl::String					Name;		//!< Action name.
+		std::vector<Key::Code>		Keys;		//!< Keys that trigger the action.
+		std::vector<Mouse::Button>	Buttons;	//!< Mouse buttons that trigger the action.
+	};
+
+	//! Inputs bound to a named axis.
+	struct DBL_API AxisBinding
+	{
+		cbl::String					Name;		//!< Axis name.
+		std::vector<Key::Code>		Positive;	//!< Keys that push the axis towards 1.
+		std::vector<Key::Code>		Negative;	//!< Keys that push the axis towards -1.
+	};
+
+	//! Action map bindings.
+	struct DBL_API ActionBindings
+	{
+		std::vector<ActionBinding>	Actions;	//!< Action bindings. Action IDs follow this order.
+		std::vector<AxisBinding>	Axes;		//!< Axis bindings. Axis IDs follow this order.
+	};
+}
+
+CBL_TYPE( dbl::ActionBinding, ActionBinding );
+CBL_TYPE( dbl::AxisBinding, AxisBinding );
+CBL_TYPE( dbl::ActionBindings, ActionBindings );
+
+#endif // __DBL_ACTIONBINDINGS_H_
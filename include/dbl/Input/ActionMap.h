@@ -0,0 +1,199 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file ActionMap.h
+ * @brief Action and axis mapping component.
+ */
+
+#ifndef __DBL_ACTIONMAP_H_
+#define __DBL_ACTIONMAP_H_
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Core/GameComponent.h>
+#include <cbl/Core/Event.h>
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/ActionBindings.h"
+
+// External Dependencies //
+#include <bitset>
+#include <map>
+#include <vector>
+
+namespace dbl
+{
+	namespace E
+	{
+		/***** Action events *****/
+#ifdef CBL_TPLFUNCTION_PREFERRED_SYNTAX
+		typedef cbl::Event<void(cbl::Uint32)>	Action;		//!< params: Action ID
+#else
+		typedef cbl::Event1<void,cbl::Uint32>	Action;		//!< params: Action ID
+#endif
+		typedef Action	ActionPressed;
+		typedef Action	ActionReleased;
+	}
+
+	//! @brief Action and axis mapping component.
+	//! Maps keys and mouse buttons to named actions and axes. Bindings are compiled into flat
+	//! tables indexed by input, so each key or button event only touches the actions bound to it.
+	//! This class depends on the KeyboardManager and MouseManager services.
+	class DBL_API ActionMap :
+		public cbl::GameComponent
+	{
+	/***** Types *****/
+	public:
+		//! Action state bit set (indexed by action ID).
+		typedef std::vector< bool >		ActionSet;
+
+	/***** Static Members *****/
+	public:
+		static const cbl::Uint32	sInvalidId;		//!< Returned for unknown action and axis names.
+
+	/***** Properties *****/
+	public:
+		//! Get the current bindings.
+		inline const ActionBindings & GetBindings( void ) const { return mBindings; }
+		//! Get the number of bound actions.
+		inline cbl::Uint32 GetActionCount( void ) const { return cbl::Uint32( mBindings.Actions.size() ); }
+		//! Get the number of bound axes.
+		inline cbl::Uint32 GetAxisCount( void ) const { return cbl::Uint32( mBindings.Axes.size() ); }
+		//! Get an action ID from its name.
+		//! @return		sInvalidId if the action doesn't exist.
+		cbl::Uint32 GetActionId( const cbl::String & name ) const;
+		//! Get an axis ID from its name.
+		//! @return		sInvalidId if the axis doesn't exist.
+		cbl::Uint32 GetAxisId( const cbl::String & name ) const;
+		//! Check if an action was pressed during the last frame.
+		inline bool IsPressed( cbl::Uint32 id ) const { return id < mPressed.size() && mPressed[id]; }
+		//! Check if an action is currently held.
+		inline bool IsHeld( cbl::Uint32 id ) const { return id < mHeld.size() && mHeld[id]; }
+		//! Check if an action was released during the last frame.
+		inline bool IsReleased( cbl::Uint32 id ) const { return id < mReleased.size() && mReleased[id]; }
+		//! Get the actions pressed during the last frame.
+		inline const ActionSet & GetPressed( void ) const { return mPressed; }
+		//! Get the actions currently held.
+		inline const ActionSet & GetHeld( void ) const { return mHeld; }
+		//! Get the actions released during the last frame.
+		inline const ActionSet & GetReleased( void ) const { return mReleased; }
+		//! Get an axis value (-1, 0 or 1).
+		cbl::Float32 GetAxis( cbl::Uint32 id ) const;
+
+	/***** Events *****/
+	public:
+		E::ActionPressed	OnActionPressed;	//!< Action pressed event (triggers once when the first bound input goes down).
+		E::ActionReleased	OnActionReleased;	//!< Action released event (triggers once when the last bound input goes up).
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	game		Pointer to game.
+		explicit ActionMap( cbl::Game & game );
+		//! Destructor.
+		virtual ~ActionMap();
+		//! Pure virtual function to initialise component.
+		virtual void Initialise( void );
+		//! Pure virtual function to shut down component.
+		virtual void Shutdown( void );
+		//! Pure virtual update function (from IUpdatable).
+		//! Latches the pressed and released sets for this frame.
+		virtual void Update( const cbl::GameTime & time );
+		//! Set and compile bindings.
+		//! Inputs that are already held are applied to the new actions.
+		void SetBindings( const ActionBindings & bindings );
+		//! Load and compile bindings.
+		template< typename DESERIALISER_TYPE >
+		bool LoadBindings( const cbl::Char* fileName );
+
+	/***** Event Handlers *****/
+	public:
+		void OnKeyClick( Key::Code keyCode, cbl::Uint16 modifiers );
+		void OnKeyUp( Key::Code keyCode, cbl::Uint16 modifiers );
+		void OnMouseClick( cbl::Int32 x, cbl::Int32 y, Mouse::Button button );
+		void OnMouseUp( cbl::Int32 x, cbl::Int32 y, Mouse::Button button );
+
+	/***** Private Types *****/
+	private:
+		//! Number of bindable inputs (keys followed by mouse buttons).
+		static const cbl::Uint32 sInputCount = Key::Count + Mouse::Count;
+		//! Bound input state list.
+		typedef std::bitset< sInputCount >					InputList;
+		//! Offsets into a compiled binding list, indexed by input.
+		typedef std::vector< cbl::Uint32 >					OffsetList;
+		//! Compiled action ID list.
+		typedef std::vector< cbl::Uint32 >					ActionIdList;
+		//! Compiled axis contribution.
+		struct AxisEntry
+		{
+			cbl::Uint32		Axis;		//!< Axis ID.
+			bool			Positive;	//!< Input pushes the axis positive.
+		};
+		typedef std::vector< AxisEntry >					AxisEntryList;
+		//! Number of bound inputs held per action.
+		typedef std::vector< cbl::Uint16 >					HeldCountList;
+		//! Number of bound inputs held per axis direction.
+		struct AxisState
+		{
+			cbl::Uint16		Positive;
+			cbl::Uint16		Negative;
+		};
+		typedef std::vector< AxisState >					AxisStateList;
+		//! Name lookup.
+		typedef std::map< cbl::String, cbl::Uint32 >		NameMap;
+
+	/***** Private Methods *****/
+	private:
+		//! Compile the bindings into lookup tables.
+		void Compile( void );
+		//! Handle a bound input going down.
+		void InputDown( cbl::Uint32 input );
+		//! Handle a bound input going up.
+		void InputUp( cbl::Uint32 input );
+
+	/***** Private Members *****/
+	private:
+		ActionBindings		mBindings;			//!< Source bindings.
+		NameMap				mActionNames;		//!< Action name lookup.
+		NameMap				mAxisNames;			//!< Axis name lookup.
+		OffsetList			mActionOffsets;		//!< Per-input ranges into mActionIds (sInputCount + 1 entries).
+		ActionIdList		mActionIds;			//!< Actions bound to each input.
+		OffsetList			mAxisOffsets;		//!< Per-input ranges into mAxisEntries (sInputCount + 1 entries).
+		AxisEntryList		mAxisEntries;		//!< Axes bound to each input.
+		InputList			mInputs;			//!< Bindable inputs currently held.
+		HeldCountList		mHeldCounts;		//!< Bound inputs held per action.
+		AxisStateList		mAxisStates;		//!< Bound inputs held per axis.
+		ActionSet			mHeld;				//!< Actions currently held.
+		ActionSet			mPressed;			//!< Actions pressed last frame.
+		ActionSet			mReleased;			//!< Actions released last frame.
+		ActionSet			mNextPressed;		//!< Actions pressed since the last update.
+		ActionSet			mNextReleased;		//!< Actions released since the last update.
+		KeyboardManager		* mKeyboard;		//!< Keyboard to listen to.
+		MouseManager		* mMouse;			//!< Mouse to listen to.
+	};
+
+	template<>
+	DBL_API bool ActionMap::LoadBindings<YAMLDeserialiser>( const cbl::Char* fileName );
+}
+
+//! Declare action map type.
+CBL_TYPE( dbl::ActionMap, ActionMap );
+
+#endif // __DBL_ACTIONMAP_H_
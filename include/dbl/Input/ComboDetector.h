@@ -0,0 +1,172 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file ComboDetector.h
+ * @brief Key chord and sequence detection.
+ */
+
+#ifndef __DBL_COMBODETECTOR_H_
+#define __DBL_COMBODETECTOR_H_
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Core/GameComponent.h>
+#include <cbl/Core/Event.h>
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/KeyCodes.h"
+
+// External Dependencies //
+#include <vector>
+
+namespace dbl
+{
+	namespace E
+	{
+		/***** Combo events *****/
+#ifdef CBL_TPLFUNCTION_PREFERRED_SYNTAX
+		typedef cbl::Event<void(cbl::Uint32)>	Combo;		//!< params: Combo ID
+#else
+		typedef cbl::Event1<void,cbl::Uint32>	Combo;		//!< params: Combo ID
+#endif
+	}
+
+	//! Single key press in a combo.
+	struct ComboStep
+	{
+		Key::Code		Code;		//!< Key to press.
+		cbl::Uint16		Modifiers;	//!< Modifiers that must be held (Key::Modifier::Code flags).
+
+		//! Constructor.
+		ComboStep( Key::Code key = Key::Count, cbl::Uint16 modifiers = 0 )
+		: Code( key ), Modifiers( modifiers )
+		{
+		}
+	};
+
+	//! @brief Key chord and sequence detection component.
+	//! Registered combos are compiled into a single automaton (an Aho-Corasick trie with every
+	//! transition resolved up front), so each key press costs one table lookup no matter how
+	//! many combos are registered. Timing windows are checked only when a combo completes.
+	//! Modifier keys that aren't part of a combo are ignored; any other unregistered key breaks
+	//! the sequence in progress.
+	//! This class depends on the KeyboardManager service. Key presses are timed with the
+	//! GameWindow input clock when available, otherwise with the game time of the last update.
+	class DBL_API ComboDetector :
+		public cbl::GameComponent
+	{
+	/***** Static Members *****/
+	public:
+		static cbl::Float64				sDefaultWindow;	//!< Default time allowed between sequence steps (in seconds).
+		static const cbl::Uint32		sInvalidId;		//!< Returned when a combo can't be added.
+
+	/***** Properties *****/
+	public:
+		//! Get the number of registered combos.
+		inline cbl::Uint32 GetComboCount( void ) const { return cbl::Uint32( mCombos.size() ); }
+		//! Get the number of automaton states (compiles pending combos).
+		cbl::Uint32 GetStateCount( void );
+
+	/***** Events *****/
+	public:
+		E::Combo			OnCombo;		//!< Combo completed event.
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	game		Pointer to game.
+		explicit ComboDetector( cbl::Game & game );
+		//! Destructor.
+		virtual ~ComboDetector();
+		//! Pure virtual function to initialise component.
+		virtual void Initialise( void );
+		//! Pure virtual function to shut down component.
+		virtual void Shutdown( void );
+		//! Pure virtual update function (from IUpdatable).
+		virtual void Update( const cbl::GameTime & time );
+		//! Add a chord (a key pressed while modifiers are held, e.g. Ctrl+Shift+X).
+		//! @return		Combo ID.
+		cbl::Uint32 AddChord( Key::Code key, cbl::Uint16 modifiers );
+		//! Add a double tap.
+		//! @param	window		Maximum time between the taps.
+		//! @return		Combo ID.
+		cbl::Uint32 AddDoubleTap( Key::Code key, cbl::Float64 window = sDefaultWindow );
+		//! Add a key sequence.
+		//! @param	steps		Key presses in order.
+		//! @param	count		Number of steps.
+		//! @param	window		Maximum time between consecutive steps.
+		//! @return		Combo ID, or sInvalidId if the sequence is empty or invalid.
+		cbl::Uint32 AddSequence( const ComboStep * steps, cbl::Uint32 count, cbl::Float64 window = sDefaultWindow );
+		//! Remove all combos.
+		void Clear( void );
+		//! Forget the sequence in progress.
+		void Reset( void );
+		//! Advance the automaton with a key press.
+		//! @param	key			Key pressed.
+		//! @param	modifiers	Held modifiers.
+		//! @param	time		Time of the key press (in seconds).
+		void ProcessKey( Key::Code key, cbl::Uint16 modifiers, cbl::Float64 time );
+
+	/***** Event Handlers *****/
+	public:
+		void OnKeyClick( Key::Code keyCode, cbl::Uint16 modifiers );
+
+	/***** Private Types *****/
+	private:
+		//! Registered combo.
+		struct Combo
+		{
+			std::vector< ComboStep >	Steps;		//!< Key presses.
+			cbl::Float64				Window;		//!< Maximum time between steps.
+		};
+		typedef std::vector< Combo >		ComboList;
+		typedef std::vector< cbl::Uint16 >	SymbolTable;
+		typedef std::vector< cbl::Uint32 >	StateTable;
+		typedef std::vector< cbl::Float64 >	TimeList;
+
+	/***** Private Methods *****/
+	private:
+		//! Build the automaton from the registered combos.
+		void Compile( void );
+		//! Check that a completed combo was pressed within its timing window.
+		bool CheckTiming( const Combo & combo ) const;
+
+	/***** Private Members *****/
+	private:
+		ComboList			mCombos;			//!< Registered combos.
+		SymbolTable			mSymbols;			//!< Symbol for each key and modifier combination.
+		cbl::Uint32			mSymbolCount;		//!< Number of symbols used by combos.
+		StateTable			mTransitions;		//!< Next state for each state and symbol.
+		StateTable			mOutputOffsets;		//!< Per-state ranges into mOutputs.
+		StateTable			mOutputs;			//!< Combos completed in each state.
+		TimeList			mHistory;			//!< Times of the most recent key presses (ring buffer).
+		cbl::Uint32			mHistoryHead;		//!< Next history slot.
+		cbl::Uint32			mState;				//!< Current automaton state.
+		bool				mDirty;				//!< Combos have changed since the last compile.
+		cbl::Float64		mTime;				//!< Game time of the last update.
+		KeyboardManager		* mKeyboard;		//!< Keyboard to listen to.
+		GameWindow			* mWindow;			//!< Window providing input timestamps.
+	};
+}
+
+//! Declare combo detector type.
+CBL_TYPE( dbl::ComboDetector, ComboDetector );
+
+#endif // __DBL_COMBODETECTOR_H_
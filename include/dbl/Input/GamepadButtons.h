@@ -0,0 +1,73 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file GamepadButtons.h
+ * @brief Gamepad button and axis list.
+ */
+
+#ifndef __DBL_GAMEPADBUTTONS_H_
+#define __DBL_GAMEPADBUTTONS_H_
+
+namespace dbl
+{
+	//! Gamepad button and axis list (Xbox controller layout).
+	namespace Gamepad
+	{
+		enum Button
+		{
+			A,
+			B,
+			X,
+			Y,
+			LeftShoulder,
+			RightShoulder,
+			Back,
+			Start,
+			Guide,
+			LeftStick,
+			RightStick,
+			DPadUp,
+			DPadDown,
+			DPadLeft,
+			DPadRight,
+
+			ButtonCount,
+		};
+
+		enum Axis
+		{
+			LeftX,
+			LeftY,
+			RightX,
+			RightY,
+			LeftTrigger,
+			RightTrigger,
+
+			AxisCount,
+		};
+
+		//! Maximum number of connected gamepads.
+		static const cbl::Uint32 MaxPads = 4;
+	}
+}
+
+CBL_TYPE( dbl::Gamepad::Button, GamepadButton );
+CBL_TYPE( dbl::Gamepad::Axis, GamepadAxis );
+
+#endif // __DBL_GAMEPADBUTTONS_H_
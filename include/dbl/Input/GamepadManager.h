@@ -0,0 +1,232 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file GamepadManager.h
+ * @brief Gamepad manager component.
+ */
+
+#ifndef __DBL_GAMEPADMANAGER_H_
+#define __DBL_GAMEPADMANAGER_H_
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Core/GameComponent.h>
+#include <cbl/Core/Event.h>
+#include <cbl/Core/Services.h>
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/GamepadButtons.h"
+#include "dbl/Input/InputFilter.h"
+
+// External Dependencies //
+#include <bitset>
+#include <vector>
+
+namespace dbl
+{
+	namespace E
+	{
+		/***** Gamepad events *****/
+#ifdef CBL_TPLFUNCTION_PREFERRED_SYNTAX
+		typedef cbl::Event<void(cbl::Uint32,::dbl::Gamepad::Button)>				GamepadButton;		//!< params: Pad, Button
+		typedef cbl::Event<void(cbl::Uint32,::dbl::Gamepad::Axis,cbl::Float32)>	GamepadAxis;		//!< params: Pad, Axis, Value
+		typedef cbl::Event<void(cbl::Uint32)>										GamepadConnection;	//!< params: Pad
+#else
+		typedef cbl::Event2<void,cbl::Uint32,::dbl::Gamepad::Button>				GamepadButton;		//!< params: Pad, Button
+		typedef cbl::Event3<void,cbl::Uint32,::dbl::Gamepad::Axis,cbl::Float32>	GamepadAxis;		//!< params: Pad, Axis, Value
+		typedef cbl::Event1<void,cbl::Uint32>										GamepadConnection;	//!< params: Pad
+#endif
+		typedef GamepadButton		GamepadButtonDown;
+		typedef GamepadButton		GamepadButtonUp;
+		typedef GamepadButton		GamepadButtonClick;
+		typedef GamepadConnection	GamepadConnected;
+		typedef GamepadConnection	GamepadDisconnected;
+	}
+
+	//! Gamepad event types.
+	namespace GamepadEventType
+	{
+		enum Type
+		{
+			Connected,		//!< A gamepad was assigned to the pad.
+			Disconnected,	//!< The pad's gamepad was removed.
+			Button,			//!< Code: Gamepad::Button, Value: 1 when pressed, 0 when released.
+			Axis,			//!< Code: Gamepad::Axis, Value: -1 to 1 for sticks, 0 to 1 for triggers.
+		};
+	}
+
+	//! @brief Raw gamepad event.
+	//! Produced by the platform backend (or injected for testing) before deadzone filtering.
+	struct GamepadEvent
+	{
+		cbl::Float64	Time;		//!< Device timestamp (in seconds).
+		cbl::Uint32		Pad;		//!< Pad index.
+		cbl::Uint32		Type;		//!< GamepadEventType::Type.
+		cbl::Uint32		Code;		//!< Button or axis.
+		cbl::Float32	Value;		//!< Button or axis value.
+
+		//! Build an event.
+		static inline GamepadEvent Make( cbl::Uint32 type, cbl::Uint32 pad, cbl::Uint32 code = 0, cbl::Float32 value = 0.0f, cbl::Float64 time = 0.0 ) {
+			GamepadEvent ev = { time, pad, type, code, value };
+			return ev;
+		}
+	};
+
+	//! @brief Gamepad state latched once per frame.
+	//! A plain value type that can be copied and handed to other threads.
+	struct GamepadState
+	{
+		typedef std::bitset< Gamepad::ButtonCount >	ButtonList;
+
+		ButtonList		Buttons;						//!< Buttons held this frame.
+		ButtonList		PreviousButtons;				//!< Buttons held last frame.
+		cbl::Float32	Axes[ Gamepad::AxisCount ];		//!< Axis values after deadzone filtering.
+		bool			Connected;						//!< Pad has a gamepad attached.
+
+		//! Constructor.
+		GamepadState()
+		: Connected( false )
+		{
+			for( cbl::Uint32 i = 0; i < Gamepad::AxisCount; ++i )
+				Axes[i] = 0.0f;
+		}
+
+		//! Is button held this frame?
+		inline bool IsButtonDown( Gamepad::Button button ) const { return Buttons[button]; }
+		//! Did the button go down this frame?
+		inline bool IsButtonPressed( Gamepad::Button button ) const { return Buttons[button] && !PreviousButtons[button]; }
+		//! Did the button go up this frame?
+		inline bool IsButtonReleased( Gamepad::Button button ) const { return !Buttons[button] && PreviousButtons[button]; }
+	};
+
+	//! @brief Gamepad management component.
+	//! Register listeners with the gamepad manager events to respond to gamepad input.
+	//! Devices are read by a platform backend on its own thread (evdev on Linux) and the
+	//! queued events are applied at the start of each update. The backend is opt-in: it
+	//! starts on initialise if sBackendEnabled is set, or on the first OpenDevice(). Stick axes use a radial
+	//! deadzone and triggers a linear one; values are rescaled to start from zero at the edge
+	//! of the deadzone.
+	class DBL_API GamepadManager :
+		public cbl::GameComponent
+	{
+	/***** Private Types *****/
+	private:
+		//! Button list for every pad (indexed by pad * Gamepad::ButtonCount + button).
+		typedef std::bitset< Gamepad::MaxPads * Gamepad::ButtonCount >	PadButtonList;
+
+	/***** Types *****/
+	public:
+		//! Filtered gamepad event.
+		struct FilterEvent
+		{
+			PadButtonList			Buttons;		//!< Filter button states.
+			E::GamepadButtonDown	OnButtonDown;	//!< Button down event (triggers as long as the button is down).
+			E::GamepadButtonUp		OnButtonUp;		//!< Button up event.
+			E::GamepadButtonClick	OnButtonClick;	//!< Button clicked event (triggers once when the button is pressed).
+			E::GamepadAxis			OnAxisMove;		//!< Axis moved event.
+			inline bool IsButtonDown( cbl::Uint32 pad, Gamepad::Button button ) const { return Buttons[ pad * Gamepad::ButtonCount + button ]; }
+		};
+		//! Filtered gamepad event map.
+		typedef InputFilter<FilterEvent>	FilterEvents;
+
+	/***** Static Members *****/
+	public:
+		static bool					sBackendEnabled;	//!< Start the platform backend on initialise. Defaults to false.
+		static cbl::Float32			sStickDeadzone;		//!< Radial stick deadzone (0 to 1).
+		static cbl::Float32			sTriggerDeadzone;	//!< Trigger deadzone (0 to 1).
+		static cbl::Uint32			sQueueSize;			//!< Backend event queue size.
+
+	/***** Properties *****/
+	public:
+		//! Check if a pad has a gamepad attached.
+		bool IsConnected( cbl::Uint32 pad ) const;
+		//! Is button down?
+		bool IsButtonDown( cbl::Uint32 pad, Gamepad::Button button ) const;
+		//! Get an axis value after deadzone filtering.
+		cbl::Float32 GetAxis( cbl::Uint32 pad, Gamepad::Axis axis ) const;
+		//! Get the state of a pad latched in the last Update().
+		const GamepadState & GetState( cbl::Uint32 pad ) const;
+		//! Get the number of backend events dropped because the queue was full.
+		cbl::Uint32 GetDroppedEvents( void ) const;
+
+	/***** Events *****/
+	public:
+		FilterEvents			Filter;			//!< Filtered gamepad event map.
+		E::GamepadButtonDown	OnButtonDown;	//!< Button down event (triggers as long as the button is down).
+		E::GamepadButtonUp		OnButtonUp;		//!< Button up event.
+		E::GamepadButtonClick	OnButtonClick;	//!< Button clicked event (triggers once when the button is pressed).
+		E::GamepadAxis			OnAxisMove;		//!< Axis moved event.
+		E::GamepadConnected		OnConnected;	//!< Gamepad connected event.
+		E::GamepadDisconnected	OnDisconnected;	//!< Gamepad disconnected event.
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	game		Pointer to game.
+		explicit GamepadManager( cbl::Game & game );
+		//! Destructor.
+		virtual ~GamepadManager();
+		//! Pure virtual function to initialise component.
+		virtual void Initialise( void );
+		//! Pure virtual function to shut down component.
+		virtual void Shutdown( void );
+		//! Pure virtual update function (from IUpdatable).
+		virtual void Update( const cbl::GameTime & time );
+		//! Queue a raw event as if it came from a device. It is applied in the next Update().
+		void InjectEvent( const GamepadEvent & ev );
+		//! Open a device explicitly (starting the backend if needed).
+		//! On Linux this accepts an evdev node (including uinput virtual devices) or a file
+		//! or pipe of recorded input_event records.
+		//! @return		False if the backend isn't available or the device can't be opened.
+		bool OpenDevice( const cbl::Char * path );
+
+	/***** Private Types *****/
+	private:
+		//! Gamepad state and raw axis values.
+		struct Pad
+		{
+			GamepadState	State;							//!< Current state.
+			cbl::Float32	Raw[ Gamepad::AxisCount ];		//!< Axis values before filtering.
+		};
+
+	/***** Private Methods *****/
+	private:
+		//! Create and start the platform backend.
+		bool StartBackend( void );
+		//! Apply a raw event.
+		void ApplyEvent( const GamepadEvent & ev );
+		//! Press or release a button.
+		void SetButton( cbl::Uint32 pad, Gamepad::Button button, bool down );
+		//! Filter an axis and fire move events if it changed.
+		void SetAxis( cbl::Uint32 pad, Gamepad::Axis axis, cbl::Float32 value );
+
+	/***** Private Members *****/
+	private:
+		Pad							mPads[ Gamepad::MaxPads ];		//!< Current pad states.
+		GamepadState				mStates[ Gamepad::MaxPads ];	//!< Pad states latched at the last update.
+		std::vector< GamepadEvent >	mInjected;						//!< Events injected since the last update.
+		IGamepadBackend				* mBackend;						//!< Platform backend (NULL if unavailable).
+	};
+}
+
+//! Declare gamepad manager type.
+CBL_TYPE( dbl::GamepadManager, GamepadManager );
+
+#endif // __DBL_GAMEPADMANAGER_H_
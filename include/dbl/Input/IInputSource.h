@@ -0,0 +1,46 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file IInputSource.h
+ * @brief Abstract input event source.
+ */
+
+#ifndef __DBL_IINPUTSOURCE_H_
+#define __DBL_IINPUTSOURCE_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+namespace dbl
+{
+	//! @brief Abstract source of input events for a GameWindow.
+	//! An attached source replaces live platform input. It is polled once per frame
+	//! and pushes its events with GameWindow::PushInputEvent.
+	class IInputSource
+	{
+	/***** Public Methods *****/
+	public:
+		//! Destructor.
+		virtual ~IInputSource() {}
+		//! Push the input events for the window's current frame.
+		virtual void PollInput( GameWindow & window ) = 0;
+	};
+}
+
+#endif // __DBL_IINPUTSOURCE_H_
@@ -0,0 +1,88 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file InputEvent.h
+ * @brief Timestamped platform input event.
+ */
+
+#ifndef __DBL_INPUTEVENT_H_
+#define __DBL_INPUTEVENT_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/KeyCodes.h"
+#include "dbl/Input/MouseButtons.h"
+
+// External Libraries //
+#include <vector>
+
+namespace dbl
+{
+	//! Input event types.
+	namespace InputEventType
+	{
+		enum Type
+		{
+			KeyDown,		//!< Code: Key::Code.
+			KeyUp,			//!< Code: Key::Code.
+			KeyChar,		//!< Code: Unicode character.
+			MouseMove,		//!< X, Y: Cursor position.
+			MouseDown,		//!< X, Y: Cursor position. Code: Mouse::Button.
+			MouseUp,		//!< X, Y: Cursor position. Code: Mouse::Button.
+			MouseDblClick,	//!< X, Y: Cursor position. Code: Mouse::Button.
+			MouseWheel,		//!< X: Wheel delta.
+			MouseEnter,
+			MouseLeave,
+			GainedFocus,
+			LostFocus,
+			MouseRawMotion,	//!< X, Y: Relative device motion.
+
+			Count,
+		};
+	}
+
+	//! @brief Platform input event.
+	//! Filled in by the platform layer and delivered by the GameWindow in a single
+	//! batch at the start of each frame.
+	struct InputEvent
+	{
+		cbl::Float64		Time;	//!< Time the event occurred, in seconds on the window's input clock.
+		cbl::Uint32			Type;	//!< InputEventType::Type.
+		cbl::Uint32			Code;	//!< Key code, unicode character or mouse button.
+		cbl::Int32			X;		//!< Cursor x position or wheel delta.
+		cbl::Int32			Y;		//!< Cursor y position.
+
+		//! Build an input event.
+		static inline InputEvent Make( InputEventType::Type type, cbl::Float64 time, cbl::Uint32 code = 0, cbl::Int32 x = 0, cbl::Int32 y = 0 )
+		{
+			InputEvent ev;
+			ev.Time	= time;
+			ev.Type	= type;
+			ev.Code	= code;
+			ev.X	= x;
+			ev.Y	= y;
+			return ev;
+		}
+	};
+
+	//! Input event list.
+	typedef std::vector< InputEvent >	InputEventList;
+}
+
+#endif // __DBL_INPUTEVENT_H_
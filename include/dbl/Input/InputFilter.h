@@ -31,11 +31,14 @@
 #include "cbl/Util/Property.h"
 
 // External Libraries //
-#include <vector>
+#include <deque>
 
 namespace dbl
 {
-	//! Input filter system.
+	//! @brief Input filter system.
+	//! The highest active level is tracked as levels are set, so Top() is constant time.
+	//! Levels and their filter events are stored contiguously in blocks that never move, so
+	//! references to them stay valid until the level is removed by SetStackSize().
 	template< typename TYPE >
 	class InputFilter
 	{
@@ -44,6 +47,8 @@ namespace dbl
 
 	/***** Public Methods *****/
 	public:
+		//! Constructor.
+		InputFilter();
 		//! Set the input stack size.
 		void SetStackSize( cbl::Uint32 size );
 		//! Set an input stack id's active level.
@@ -53,6 +58,9 @@ namespace dbl
 		//! Get the highest level on the input stack that is active.
 		//! @return		NULL if none are active.
 		Type* Top( void );
+		//! Get the index of the highest level on the input stack that is active.
+		//! @return		size() if none are active.
+		size_t TopIndex( void ) const;
 		//! Get input stack element.
 		Type& operator[] ( size_t index );
 		//! Get input stack element.
@@ -66,10 +74,10 @@ namespace dbl
 		struct StackElement {
 			StackElement();
 			~StackElement();
-			cbl::SharedPtr<Type> Filter;
+			Type Filter;
 			bool Active;
 		};
-		typedef std::vector<StackElement>	FilterStack;
+		typedef std::deque<StackElement>	FilterStack;
 
 	/***** Public Types *****/
 	public:
@@ -89,9 +97,15 @@ namespace dbl
 		typename reverse_iterator rend( void );
 		typename const_reverse_iterator rend( void ) const;
 
+	/***** Private Methods *****/
+	private:
+		//! Find the highest active level at or below an index.
+		void FindTop( size_t from );
+
 	/***** Private Members *****/
 	private:
-		FilterStack		mFilterStack;
+		FilterStack		mFilterStack;	//!< Filter levels.
+		size_t			mTop;			//!< Highest active level (size() if none).
 	};
 }
 
@@ -23,48 +23,78 @@
 
 namespace dbl
 {
+	template< typename TYPE >
+	inline InputFilter<TYPE>::InputFilter()
+	: mTop( 0 )
+	{
+	}
+
 	template< typename TYPE >
 	inline void InputFilter<TYPE>::SetStackSize( cbl::Uint32 size )
 	{
-		mFilterStack.resize( size );
+		// Only add or remove at the back; a deque never moves the remaining levels.
+		while( mFilterStack.size() > size )
+			mFilterStack.pop_back();
+		while( mFilterStack.size() < size )
+			mFilterStack.push_back( StackElement() );
+		FindTop( size );
 	}
 
 	template< typename TYPE >
 	inline void InputFilter<TYPE>::Set( cbl::Uint32 id, bool active )
 	{
-		if( id < mFilterStack.size() )
-			mFilterStack[id].Active = active;
+		if( id >= mFilterStack.size() )
+			return;
+
+		mFilterStack[id].Active = active;
+		if( active ) {
+			if( mTop == mFilterStack.size() || id > mTop )
+				mTop = id;
+		}
+		else if( id == mTop ) {
+			FindTop( id );
+		}
 	}
 
 	template< typename TYPE >
 	inline bool InputFilter<TYPE>::GetActive( cbl::Uint32 id ) const
 	{
-		for( size_t i = mFilterStack.size(); i > 0; --i )
-			if( mFilterStack[i-1].Active )
-				return id == i-1;
-		return false;
+		return id == mTop && mTop < mFilterStack.size();
 	}
 
 	template< typename TYPE >
 	inline typename InputFilter<TYPE>::Type* InputFilter<TYPE>::Top( void )
 	{
-		if( mFilterStack.size() == 0 ) return NULL;
+		return mTop < mFilterStack.size() ? &mFilterStack[mTop].Filter : NULL;
+	}
+
+	template< typename TYPE >
+	inline size_t InputFilter<TYPE>::TopIndex( void ) const
+	{
+		return mTop;
+	}
 
-		for( size_t i = mFilterStack.size(); i > 0; --i )
-			if( mFilterStack[i-1].Active )
-				return mFilterStack[i-1].Filter.Get();
+	template< typename TYPE >
+	inline void InputFilter<TYPE>::FindTop( size_t from )
+	{
+		for( size_t i = from; i > 0; --i ) {
+			if( mFilterStack[i-1].Active ) {
+				mTop = i-1;
+				return;
+			}
+		}
 
-		return NULL;
+		mTop = mFilterStack.size();
 	}
 
 	template< typename TYPE >
 	inline typename InputFilter<TYPE>::Type& InputFilter<TYPE>::operator[] ( size_t index ) {
-		return *(mFilterStack[index].Filter);
+		return mFilterStack[index].Filter;
 	}
 
 	template< typename TYPE >
 	inline const typename InputFilter<TYPE>::Type& InputFilter<TYPE>::operator[] ( size_t index ) const {
-		return *(mFilterStack[index].Filter);
+		return mFilterStack[index].Filter;
 	}
 
 	template< typename TYPE >
@@ -109,7 +139,7 @@ namespace dbl
 
 	template< typename TYPE >
 	InputFilter<TYPE>::StackElement::StackElement()
-	: Filter( new TYPE () )
+	: Filter()
 	, Active( false )
 	{
 	}
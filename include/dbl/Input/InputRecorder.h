@@ -0,0 +1,141 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file InputRecorder.h
+ * @brief Input event recording and replay.
+ */
+
+#ifndef __DBL_INPUTRECORDER_H_
+#define __DBL_INPUTRECORDER_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/IInputSource.h"
+#include "dbl/Input/InputEvent.h"
+
+// Chewable Headers //
+#include <cbl/Util/Noncopyable.h>
+
+// External Libraries //
+#include <fstream>
+
+namespace dbl
+{
+	//! @brief Records the input event stream of a GameWindow.
+	//! Every input batch delivered by the window is written with its frame index, so a
+	//! session can be played back frame for frame with an InputReplay.
+	//!
+	//! File layout (little-endian):
+	//! @code
+	//! "DBLI" Uint32:version
+	//! { Uint32:frame Uint32:count { Float64:time Uint8:type Uint32:code Int32:x Int32:y } * count } *
+	//! @endcode
+	//! Frames and times are relative to the start of the recording.
+	class DBL_API InputRecorder :
+		cbl::Noncopyable
+	{
+	/***** Public Static Members *****/
+	public:
+		static const cbl::Uint32	sVersion;		//!< Current file format version.
+
+	/***** Properties *****/
+	public:
+		//! Check if recording.
+		inline bool IsRecording( void ) const { return mWindow != NULL; }
+		//! Get the number of events recorded.
+		inline cbl::Uint32 GetEventCount( void ) const { return mEventCount; }
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		InputRecorder();
+		//! Destructor.
+		~InputRecorder();
+		//! Start recording a window's input to a file.
+		bool Start( GameWindow & window, const cbl::Char * file );
+		//! Start recording a window's input to a stream.
+		//! The stream must stay alive until recording stops.
+		bool Start( GameWindow & window, std::ostream & stream );
+		//! Stop recording and flush the output.
+		void Stop( void );
+
+	/***** Event Handlers *****/
+	public:
+		void OnWindowInputBatch( const InputEventList & events );
+
+	/***** Private Members *****/
+	private:
+		GameWindow			* mWindow;		//!< Window being recorded.
+		std::ofstream		mFile;			//!< Output file (when recording to a file).
+		std::ostream		* mStream;		//!< Output stream.
+		cbl::Uint32			mStartFrame;	//!< Window frame index of the first recorded update.
+		cbl::Float64		mStartTime;		//!< Window input time when recording started.
+		cbl::Uint32			mEventCount;	//!< Events recorded.
+	};
+
+	//! @brief Plays back input recorded by an InputRecorder.
+	//! Attach it to a window with GameWindow::SetInputSource. Each window update then
+	//! delivers the events recorded for the matching frame through the usual
+	//! OnWindowKey* and OnWindowMouse* events. No platform window is needed.
+	class DBL_API InputReplay :
+		public IInputSource,
+		cbl::Noncopyable
+	{
+	/***** Properties *****/
+	public:
+		//! Check if every recorded frame has been played.
+		inline bool IsFinished( void ) const { return mFinished; }
+		//! Get the number of frames played.
+		inline cbl::Uint32 GetFrame( void ) const { return mFrame; }
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		InputReplay();
+		//! Destructor.
+		virtual ~InputReplay();
+		//! Open a recording file.
+		bool Open( const cbl::Char * file );
+		//! Open a recording stream.
+		//! The stream must stay alive until the replay is closed.
+		bool Open( std::istream & stream );
+		//! Close the recording.
+		void Close( void );
+		//! Push the events recorded for the next frame.
+		virtual void PollInput( GameWindow & window );
+
+	/***** Private Methods *****/
+	private:
+		//! Read the header of the next recorded frame.
+		void ReadFrameHeader( void );
+
+	/***** Private Members *****/
+	private:
+		std::ifstream		mFile;			//!< Input file (when replaying a file).
+		std::istream		* mStream;		//!< Input stream.
+		cbl::Uint32			mFrame;			//!< Frames played.
+		cbl::Uint32			mNextFrame;		//!< Frame of the next recorded batch.
+		cbl::Uint32			mNextCount;		//!< Event count of the next recorded batch.
+		cbl::Float64		mStartTime;		//!< Window input time when playback started.
+		bool				mStarted;		//!< Playback has started.
+		bool				mFinished;		//!< All recorded frames have been played.
+	};
+}
+
+#endif // __DBL_INPUTRECORDER_H_
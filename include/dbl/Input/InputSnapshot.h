@@ -0,0 +1,79 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file InputSnapshot.h
+ * @brief Per-frame keyboard and mouse snapshot.
+ */
+
+#ifndef __DBL_INPUTSNAPSHOT_H_
+#define __DBL_INPUTSNAPSHOT_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/KeyCodes.h"
+#include "dbl/Input/MouseButtons.h"
+
+// External Libraries //
+#include <bitset>
+
+namespace dbl
+{
+	//! @brief Keyboard and mouse state latched once per frame.
+	//! A plain value type with no references back into the input managers, so it can be
+	//! copied and handed to jobs on other threads. Fill one with Game::GetInputSnapshot(),
+	//! or with KeyboardManager::GetSnapshot() and MouseManager::GetSnapshot().
+	struct InputSnapshot
+	{
+		typedef std::bitset< Key::Count >	KeyList;
+		typedef std::bitset< Mouse::Count >	ButtonList;
+
+		KeyList			Keys;				//!< Keys held this frame.
+		KeyList			PreviousKeys;		//!< Keys held last frame.
+		ButtonList		Buttons;			//!< Mouse buttons held this frame.
+		ButtonList		PreviousButtons;	//!< Mouse buttons held last frame.
+		cbl::Uint16		Modifiers;			//!< Held modifiers (Key::Modifier::Code flags).
+		cbl::Int32		X;					//!< Cursor x position relative to the window.
+		cbl::Int32		Y;					//!< Cursor y position relative to the window.
+		cbl::Int32		DiffX;				//!< Horizontal mouse motion this frame.
+		cbl::Int32		DiffY;				//!< Vertical mouse motion this frame.
+		cbl::Int32		Wheel;				//!< Mouse wheel delta this frame.
+		cbl::Uint32		Frame;				//!< Frame the snapshot was latched on.
+
+		//! Constructor.
+		InputSnapshot()
+		: Modifiers( 0 ), X( 0 ), Y( 0 ), DiffX( 0 ), DiffY( 0 ), Wheel( 0 ), Frame( 0 )
+		{
+		}
+
+		//! Is key held this frame?
+		inline bool IsKeyDown( Key::Code code ) const { return Keys[code]; }
+		//! Did the key go down this frame?
+		inline bool IsKeyPressed( Key::Code code ) const { return Keys[code] && !PreviousKeys[code]; }
+		//! Did the key go up this frame?
+		inline bool IsKeyReleased( Key::Code code ) const { return !Keys[code] && PreviousKeys[code]; }
+		//! Is button held this frame?
+		inline bool IsButtonDown( Mouse::Button button ) const { return Buttons[button]; }
+		//! Did the button go down this frame?
+		inline bool IsButtonPressed( Mouse::Button button ) const { return Buttons[button] && !PreviousButtons[button]; }
+		//! Did the button go up this frame?
+		inline bool IsButtonReleased( Mouse::Button button ) const { return !Buttons[button] && PreviousButtons[button]; }
+	};
+}
+
+#endif // __DBL_INPUTSNAPSHOT_H_
@@ -0,0 +1,57 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file InputState.h
+ * @brief Sampled input device state.
+ */
+
+#ifndef __DBL_INPUTSTATE_H_
+#define __DBL_INPUTSTATE_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/KeyCodes.h"
+#include "dbl/Input/MouseButtons.h"
+
+// External Libraries //
+#include <bitset>
+
+namespace dbl
+{
+	//! @brief Snapshot of the keyboard and mouse state.
+	//! Published by the platform input thread and read by the input managers at the
+	//! start of each frame.
+	struct InputState
+	{
+		std::bitset< Key::Count >	Keys;		//!< Held keys.
+		std::bitset< Mouse::Count >	Buttons;	//!< Held mouse buttons.
+		cbl::Int32					X;			//!< Cursor x position relative to the window.
+		cbl::Int32					Y;			//!< Cursor y position relative to the window.
+		cbl::Float64				Time;		//!< Time the state was sampled, on the window's input clock.
+		cbl::Uint32					Sequence;	//!< Incremented every time the state is published.
+
+		//! Constructor.
+		InputState()
+		: X( 0 ), Y( 0 ), Time( 0.0 ), Sequence( 0 )
+		{
+		}
+	};
+}
+
+#endif // __DBL_INPUTSTATE_H_
@@ -0,0 +1,85 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file KeySet.h
+ * @brief Compact held key set.
+ */
+
+#ifndef __DBL_KEYSET_H_
+#define __DBL_KEYSET_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/KeyCodes.h"
+
+// External Libraries //
+#include <bitset>
+#include <vector>
+
+namespace dbl
+{
+	//! @brief Set of keys currently held down.
+	//! Keeps a bitset for O(1) lookups alongside a dense list of the held keys so
+	//! iteration only costs as much as the number of keys actually down.
+	//! The modifier mask is cached and only recomputed when a modifier key changes.
+	class KeySet
+	{
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		KeySet();
+		//! Check if a key is held.
+		bool Test( Key::Code code ) const;
+		//! Check if a key is held.
+		bool operator[] ( Key::Code code ) const;
+		//! Add a held key.
+		//! @return		False if the key was already held.
+		bool Insert( Key::Code code );
+		//! Remove a held key.
+		//! @return		False if the key was not held.
+		bool Remove( Key::Code code );
+		//! Remove all held keys.
+		void Clear( void );
+		//! Get a held key by its position in the dense list.
+		Key::Code Get( cbl::Uint32 index ) const;
+		//! Get the number of held keys.
+		cbl::Uint32 Size( void ) const;
+		//! Check if no keys are held.
+		bool Empty( void ) const;
+		//! Get the cached modifier mask (Key::Modifier::Code flags).
+		cbl::Uint16 GetModifiers( void ) const;
+		//! Get the held keys as a bitset.
+		const std::bitset< Key::Count > & GetBits( void ) const;
+
+	/***** Private Methods *****/
+	private:
+		//! Refresh the modifier mask after a modifier key has changed.
+		void UpdateModifiers( Key::Code code );
+
+	/***** Private Members *****/
+	private:
+		std::bitset< Key::Count >	mBits;		//!< Key lookup.
+		std::vector< cbl::Uint16 >	mHeld;		//!< Dense held key list.
+		cbl::Uint16					mModifiers;	//!< Cached modifier mask.
+	};
+}
+
+#include "KeySet.inl"
+
+#endif // __DBL_KEYSET_H_
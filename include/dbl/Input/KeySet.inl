@@ -0,0 +1,130 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file KeySet.inl
+ * @brief Compact held key set.
+ */
+
+namespace dbl
+{
+	inline KeySet::KeySet()
+	: mModifiers( 0 )
+	{
+	}
+
+	inline bool KeySet::Test( Key::Code code ) const
+	{
+		return mBits[code];
+	}
+
+	inline bool KeySet::operator[] ( Key::Code code ) const
+	{
+		return mBits[code];
+	}
+
+	inline bool KeySet::Insert( Key::Code code )
+	{
+		if( mBits[code] )
+			return false;
+
+		mBits[code] = true;
+		mHeld.push_back( cbl::Uint16( code ) );
+		UpdateModifiers( code );
+		return true;
+	}
+
+	inline bool KeySet::Remove( Key::Code code )
+	{
+		if( !mBits[code] )
+			return false;
+
+		mBits[code] = false;
+		// Only a handful of keys are ever held at once, so a swap-remove is cheap.
+		for( size_t i = 0; i < mHeld.size(); ++i ) {
+			if( mHeld[i] == code ) {
+				mHeld[i] = mHeld.back();
+				mHeld.pop_back();
+				break;
+			}
+		}
+		UpdateModifiers( code );
+		return true;
+	}
+
+	inline void KeySet::Clear( void )
+	{
+		mBits.reset();
+		mHeld.clear();
+		mModifiers = 0;
+	}
+
+	inline Key::Code KeySet::Get( cbl::Uint32 index ) const
+	{
+		return Key::Code( mHeld[index] );
+	}
+
+	inline cbl::Uint32 KeySet::Size( void ) const
+	{
+		return cbl::Uint32( mHeld.size() );
+	}
+
+	inline bool KeySet::Empty( void ) const
+	{
+		return mHeld.empty();
+	}
+
+	inline cbl::Uint16 KeySet::GetModifiers( void ) const
+	{
+		return mModifiers;
+	}
+
+	inline const std::bitset< Key::Count > & KeySet::GetBits( void ) const
+	{
+		return mBits;
+	}
+
+	inline void KeySet::UpdateModifiers( Key::Code code )
+	{
+		cbl::Uint16 mask = 0;
+		bool held = false;
+
+		switch( code )
+		{
+		case Key::LShift:
+		case Key::RShift:
+			mask = Key::Modifier::Shift;
+			held = mBits[ Key::LShift ] || mBits[ Key::RShift ];
+			break;
+		case Key::LAlt:
+		case Key::RAlt:
+			mask = Key::Modifier::Alt;
+			held = mBits[ Key::LAlt ] || mBits[ Key::RAlt ];
+			break;
+		case Key::LCtrl:
+		case Key::RCtrl:
+			mask = Key::Modifier::Ctrl;
+			held = mBits[ Key::LCtrl ] || mBits[ Key::RCtrl ];
+			break;
+		default:
+			return;
+		}
+
+		mModifiers = cbl::Uint16( held ? ( mModifiers | mask ) : ( mModifiers & ~mask ) );
+	}
+}
@@ -36,9 +36,12 @@
 #include "dbl/Delectable.h"
 #include "dbl/Input/KeyCodes.h"
 #include "dbl/Input/InputFilter.h"
+#include "dbl/Input/InputSnapshot.h"
+#include "dbl/Input/KeySet.h"
 
 // External Dependencies //
 #include <bitset>
+#include <vector>
 
 namespace dbl
 {
@@ -59,21 +62,17 @@ namespace dbl
 
 	//! @brief Keyboard management component.
 	//! Register listeners with the keyboard manager events to respond to keyboard input.
-	//! This class depends on a GameWindow service existing in the game application.
+	//! This class depends on a GameWindow service existing in the game application, unless
+	//! it's bound to another window with BindWindow().
 	class DBL_API KeyboardManager :
 		public cbl::GameComponent
 	{
-	/***** Private Types *****/
-	private:
-		//! Key list type.
-		typedef std::bitset< Key::Count >	KeyList;
-
 	/***** Types *****/
 	public:
 		//! Filtered keyboard event.
 		struct FilterEvent
 		{
-			KeyList		Keys;		//!< Filter key states.
+			KeySet		Keys;		//!< Filter key states.
 			E::KeyDown	OnKeyDown;	//!< Key down event (triggers as long as key is down).
 			E::KeyUp	OnKeyUp;	//!< Key up event.
 			E::KeyClick	OnKeyClick;	//!< Key clicked event (triggers once when key is pressed).
@@ -88,6 +87,16 @@ namespace dbl
 		//! Is key down?
 		//! @param	code	Key code to check.
 		bool IsKeyDown( Key::Code code ) const;
+		//! Get the currently held modifiers (Key::Modifier::Code flags).
+		cbl::Uint16 GetModifiers( void ) const;
+		//! Is key down in the state sampled at the start of this frame?
+		//! Uses the input thread's snapshot when it is running, otherwise the same as IsKeyDown().
+		//! @param	code	Key code to check.
+		bool IsKeySampledDown( Key::Code code ) const;
+		//! Fill the keyboard part of an input snapshot with the state latched in the last Update().
+		void GetSnapshot( InputSnapshot & snapshot ) const;
+		//! Get the window input is being read from (NULL until initialised).
+		inline GameWindow * GetWindow( void ) const { return mWindow; }
 
 	/***** Events *****/
 	public:
@@ -110,6 +119,10 @@ namespace dbl
 		virtual void Shutdown( void );
 		//! Pure virtual update function (from IUpdatable).
 		virtual void Update( const cbl::GameTime & time );
+		//! Read input from a window other than the GameWindow service.
+		//! Keys held in the previous window are released.
+		//! @param	window		Window to read input from (NULL for the GameWindow service).
+		void BindWindow( GameWindow * window );
 
 	/***** Event Handlers *****/
 	public:
@@ -118,12 +131,38 @@ namespace dbl
 		void OnWindowKeyChar( cbl::Uint32 unicode );
 		void OnWindowLostFocus( void );
 
+	/***** Private Types *****/
+	private:
+		//! Sampled key state list.
+		typedef std::bitset< Key::Count >	InputKeyList;
+		//! Filter layer index list.
+		typedef std::vector< size_t >	LayerList;
+
+	/***** Private Methods *****/
+	private:
+		//! Start listening to the bound window.
+		void AttachWindow( void );
+		//! Stop listening to the current window.
+		void DetachWindow( void );
+		//! Track a filter layer that has keys held.
+		void HoldLayer( size_t index );
+		//! Stop tracking a filter layer that has no keys held.
+		void DropLayer( size_t index );
+		//! Release all held keys on a filter layer.
+		void ReleaseLayer( size_t index );
+
 	/***** Private Members *****/
 	private:
 		cbl::HashValue		mCurrentState;	//!< Current keyboard state.
 		//StateMap			mStates;		//!< Keyboard state filtering.
-		KeyList				mKeys;			//!< Key state list.
+		KeySet				mKeys;			//!< Key state list.
+		InputKeyList		mSampledKeys;	//!< Key states sampled by the input thread at frame start.
+		InputKeyList		mFrameKeys;		//!< Key states latched at the last update.
+		InputKeyList		mPreviousKeys;	//!< Key states latched at the update before that.
+		cbl::Uint16			mFrameModifiers;//!< Modifiers latched at the last update.
+		LayerList			mHeldLayers;	//!< Filter layers with keys held.
 		GameWindow			* mWindow;		//!< Game window to listen to input from.
+		GameWindow			* mBoundWindow;	//!< Window set with BindWindow() (NULL for the GameWindow service).
 	};
 }
 
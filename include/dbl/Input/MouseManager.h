@@ -36,9 +36,11 @@
 #include "dbl/Delectable.h"
 #include "dbl/Input/MouseButtons.h"
 #include "dbl/Input/InputFilter.h"
+#include "dbl/Input/InputSnapshot.h"
 
 // External Dependencies //
 #include <bitset>
+#include <vector>
 
 namespace dbl
 {
@@ -73,7 +75,8 @@ namespace dbl
 	}
 	//! @brief Mouse management component.
 	//! Register listeners with the mouse manager events to respond to mouse input.
-	//! This class depends on a GameWindow service existing in the game application.
+	//! This class depends on a GameWindow service existing in the game application, unless
+	//! it's bound to another window with BindWindow().
 	class DBL_API MouseManager :
 		public cbl::GameComponent
 	{
@@ -99,6 +102,17 @@ namespace dbl
 		};
 		//! Filtered mouse event map.
 		typedef InputFilter<FilterEvent>	FilterEvents;
+		//! Individual motion sample kept while coalescing.
+		struct MotionSample
+		{
+			cbl::Int32			X;				//!< Cursor X position.
+			cbl::Int32			Y;				//!< Cursor Y position.
+			cbl::Int32			DiffX;			//!< Horizontal motion.
+			cbl::Int32			DiffY;			//!< Vertical motion.
+			cbl::Float64		Time;			//!< Input clock time of the sample.
+		};
+		//! Motion sample list.
+		typedef std::vector<MotionSample>	MotionSampleList;
 
 	/***** Properties *****/
 	public:
@@ -113,6 +127,20 @@ namespace dbl
 		bool IsButtonDown( Mouse::Button button ) const;
 		//! Check if cursor is clipped.
 		GETTER_AUTO( bool, ClipCursor );
+		//! Get the cursor position sampled at the start of this frame.
+		//! Uses the input thread's snapshot when it is running, otherwise the same as GetPosition().
+		const cbl::Vector2i & GetSampledPosition( void ) const;
+		//! Check if mouse motion is coalesced into a single move per frame.
+		inline bool IsMotionCoalescing( void ) const { return mCoalesceMotion; }
+		//! Get the individual motion samples that made up the last coalesced move.
+		//! Only filled if samples were requested with SetMotionCoalescing().
+		inline const MotionSampleList & GetMotionSamples( void ) const { return mFrameSamples; }
+		//! Fill the mouse part of an input snapshot with the state latched in the last Update().
+		void GetSnapshot( InputSnapshot & snapshot ) const;
+		//! Check if the locked mouse is reporting raw relative motion.
+		inline bool IsRawMotion( void ) const { return mRawMotion; }
+		//! Get the window input is being read from (NULL until initialised).
+		inline GameWindow * GetWindow( void ) const { return mWindow; }
 
 	/***** Events *****/
 	public:
@@ -154,29 +182,65 @@ namespace dbl
 		void LockMouse( bool showCursor = false );
 		//! Unlock the mouse from the center of the window.
 		void UnlockMouse( void );
+		//! Coalesce mouse motion into a single move (and drag) event per frame.
+		//! @param	state		Enable coalescing.
+		//! @param	keepSamples	Keep the individual samples (see GetMotionSamples()).
+		void SetMotionCoalescing( bool state, bool keepSamples = false );
+		//! Read input from a window other than the GameWindow service.
+		//! The cursor is released from the previous window and the current cursor state
+		//! (clipping, locking and visibility) is applied to the new one.
+		//! @param	window		Window to read input from (NULL for the GameWindow service).
+		void BindWindow( GameWindow * window );
 
 	/***** Event Handlers *****/
 	public:
 		void OnWindowLostFocus( void );
 		void OnWindowGainedFocus( void );
 		void OnWindowMouseMove( cbl::Int32 x, cbl::Int32 y );
+		void OnWindowMouseRawMotion( cbl::Int32 diffx, cbl::Int32 diffy );
 		void OnWindowMouseDown( cbl::Int32 x, cbl::Int32 y, Mouse::Button button );
 		void OnWindowMouseUp( cbl::Int32 x, cbl::Int32 y, Mouse::Button button );
 		void OnWindowMouseDblClick( cbl::Int32 x, cbl::Int32 y, Mouse::Button button );
 		void OnWindowMouseWheel( cbl::Int32 delta );
 		void OnWindowMouseLeave( void );
 
+	/***** Private Methods *****/
+	private:
+		//! Start listening to the bound window.
+		void AttachWindow( void );
+		//! Stop listening to the current window.
+		void DetachWindow( void );
+		//! Handle motion, either firing it immediately or accumulating it for the frame.
+		void ProcessMotion( cbl::Int32 x, cbl::Int32 y, cbl::Int32 diffx, cbl::Int32 diffy );
+		//! Fire move and drag events.
+		void DispatchMotion( cbl::Int32 x, cbl::Int32 y, cbl::Int32 diffx, cbl::Int32 diffy );
+		//! Fire the motion accumulated this frame.
+		void FlushMotion( void );
+
 	/***** Private Members *****/
 	private:
 		ButtonList			mButtons;		//!< Button stat	e list.
 		GameWindow			* mWindow;		//!< Game window to listen to input from.
+		GameWindow			* mBoundWindow;	//!< Window set with BindWindow() (NULL for the GameWindow service).
 		cbl::Vector2i		mPosition;		//!< Current mouse position;
 		cbl::Vector2i		mStoredPosition;
+		cbl::Vector2i		mSampledPosition;	//!< Cursor position sampled by the input thread at frame start.
 		bool				mClipCursor;
 		bool				mShowMouse;
 		bool				mLockMouse;		//!< Lock the mouse cursor.
 		bool				mFocused;
 		bool				mCentering;
+		bool				mRawMotion;		//!< Locked mouse reports raw relative motion.
+		bool				mCoalesceMotion;//!< Coalesce motion per frame.
+		bool				mKeepSamples;	//!< Keep individual motion samples.
+		bool				mMotionPending;	//!< Motion has been accumulated this frame.
+		cbl::Vector2i		mMotionPosition;//!< Last accumulated cursor position.
+		cbl::Vector2i		mMotionDelta;	//!< Accumulated motion.
+		MotionSampleList	mSamples;		//!< Samples accumulated this frame.
+		MotionSampleList	mFrameSamples;	//!< Samples of the last flushed move.
+		cbl::Vector2i		mFrameMotion;	//!< Motion dispatched since the last update.
+		cbl::Int32			mFrameWheel;	//!< Wheel delta since the last update.
+		InputSnapshot		mSnapshot;		//!< Mouse state latched at the last update.
 	};
 }
 
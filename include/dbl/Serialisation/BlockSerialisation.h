@@ -0,0 +1,164 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file BlockSerialisation.h
+ * @brief Contiguous block serialisation for containers of plain data.
+ */
+
+#ifndef __DBL_BLOCKSERIALISATION_H_
+#define __DBL_BLOCKSERIALISATION_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+// External Libraries //
+#include <vector>
+#include <type_traits>
+#include <unordered_map>
+
+namespace dbl
+{
+	//! Block element formats.
+	namespace BlockFormat
+	{
+		enum Type
+		{
+			Raw,		//!< Plain struct data. Written as a base64 blob in text formats.
+			Int8,
+			Uint8,
+			Int16,
+			Uint16,
+			Int32,
+			Uint32,
+			Int64,
+			Uint64,
+			Float32,
+			Float64,
+		};
+
+		//! Element format lookup. Defaults to raw data.
+		template< typename T > struct Of { static const Type Value = Raw; };
+		template<> struct Of<cbl::Int8> { static const Type Value = Int8; };
+		template<> struct Of<cbl::Uint8> { static const Type Value = Uint8; };
+		template<> struct Of<cbl::Int16> { static const Type Value = Int16; };
+		template<> struct Of<cbl::Uint16> { static const Type Value = Uint16; };
+		template<> struct Of<cbl::Int32> { static const Type Value = Int32; };
+		template<> struct Of<cbl::Uint32> { static const Type Value = Uint32; };
+		template<> struct Of<cbl::Int64> { static const Type Value = Int64; };
+		template<> struct Of<cbl::Uint64> { static const Type Value = Uint64; };
+		template<> struct Of<cbl::Float32> { static const Type Value = Float32; };
+		template<> struct Of<cbl::Float64> { static const Type Value = Float64; };
+	}
+
+	//! @brief Contiguous accessor for a container field of trivially copyable elements.
+	//! Serialisers use this to write the whole container as a single block instead
+	//! of dispatching through the container entry hooks for every element. Only the YAML
+	//! and JSON serialisers write blocks; cbl's binary serialiser is unchanged.
+	class DBL_API BlockField
+	{
+	/***** Public Members *****/
+	public:
+		cbl::CName			Owner;			//!< Owning type name.
+		cbl::String			Name;			//!< Field name.
+		cbl::Uint32			ElementSize;	//!< Size of a single element in bytes.
+		BlockFormat::Type	Format;			//!< Element format.
+
+	/***** Public Methods *****/
+	public:
+		//! Destructor.
+		virtual ~BlockField() {}
+		//! Get the number of elements in the container.
+		virtual size_t GetCount( const void* owner ) const = 0;
+		//! Get a pointer to the contiguous element data.
+		virtual const void* GetData( const void* owner ) const = 0;
+		//! Resize the container and get a pointer to its writable element data.
+		virtual void* Resize( void* owner, size_t count ) const = 0;
+
+	/***** Protected Methods *****/
+	protected:
+		//! Constructor.
+		BlockField( const cbl::CName& owner, const cbl::Char* name, cbl::Uint32 elementSize, BlockFormat::Type format );
+	};
+
+	//! @brief Registry of block serialisable container fields.
+	//! Register fields alongside their CBL_FIELD registration:
+	//! @code
+	//! typedb.Create<NavMesh>()
+	//!     .CBL_FIELD( Vertices, NavMesh );
+	//! DBL_BLOCK_FIELD( Vertices, NavMesh );
+	//! @endcode
+	class DBL_API BlockFields
+	{
+	/***** Public Static Methods *****/
+	public:
+		//! Register a std::vector field of trivially copyable elements.
+		template< typename OWNER, typename ELEM >
+		static void Register( std::vector<ELEM> OWNER::* member, const cbl::Char* name );
+		//! Find the block accessor for a field of an object type.
+		//! @return		NULL if the field is not block serialisable.
+		static const BlockField* Find( const cbl::Type* type, const cbl::Field* field );
+		//! Remove all registered block fields.
+		static void Clear( void );
+		//! Encode raw data to base64.
+		static void EncodeBase64( const void* data, size_t size, cbl::String& out );
+		//! Decode base64 data.
+		//! @return		False if the input is not valid base64.
+		static bool DecodeBase64( const cbl::Char* in, size_t length, std::vector<cbl::Uint8>& out );
+
+	/***** Private Types *****/
+	private:
+		typedef std::vector< BlockField* >									FieldList;
+		typedef std::unordered_map< const cbl::Field*, const BlockField* >	FieldCache;
+
+		//! std::vector block accessor.
+		template< typename OWNER, typename ELEM >
+		class VectorBlockField :
+			public BlockField
+		{
+		public:
+			typedef std::vector<ELEM> OWNER::*	MemberPtr;
+
+			VectorBlockField( MemberPtr member, const cbl::Char* name );
+			virtual size_t GetCount( const void* owner ) const;
+			virtual const void* GetData( const void* owner ) const;
+			virtual void* Resize( void* owner, size_t count ) const;
+
+		private:
+			MemberPtr	mMember;
+		};
+
+	/***** Private Static Methods *****/
+	private:
+		//! Add a new block field.
+		static void Add( BlockField* field );
+
+	/***** Private Static Members *****/
+	private:
+		static FieldList	sFields;	//!< Registered block fields.
+		static FieldCache	sCache;		//!< Field lookup cache.
+	};
+}
+
+//! Register a container field for block serialisation.
+#define DBL_BLOCK_FIELD( field, type ) \
+	::dbl::BlockFields::Register( &type::field, #field )
+
+#include "BlockSerialisation.inl"
+
+#endif // __DBL_BLOCKSERIALISATION_H_
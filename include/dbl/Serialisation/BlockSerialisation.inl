@@ -0,0 +1,61 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file BlockSerialisation.inl
+ * @brief Contiguous block serialisation for containers of plain data.
+ */
+
+namespace dbl
+{
+	template< typename OWNER, typename ELEM >
+	inline void BlockFields::Register( std::vector<ELEM> OWNER::* member, const cbl::Char* name )
+	{
+		// Block data is copied with memcpy, so only plain data can be registered.
+		CBL_STATIC_ASSERT( std::is_pod<ELEM>::value );
+		Add( new VectorBlockField<OWNER,ELEM>( member, name ) );
+	}
+
+	template< typename OWNER, typename ELEM >
+	inline BlockFields::VectorBlockField<OWNER,ELEM>::VectorBlockField( MemberPtr member, const cbl::Char* name )
+	: BlockField( cbl::TypeCName<OWNER>(), name, cbl::Uint32( sizeof( ELEM ) ), BlockFormat::Of<ELEM>::Value )
+	, mMember( member )
+	{
+	}
+
+	template< typename OWNER, typename ELEM >
+	inline size_t BlockFields::VectorBlockField<OWNER,ELEM>::GetCount( const void* owner ) const
+	{
+		return ( static_cast<const OWNER*>( owner )->*mMember ).size();
+	}
+
+	template< typename OWNER, typename ELEM >
+	inline const void* BlockFields::VectorBlockField<OWNER,ELEM>::GetData( const void* owner ) const
+	{
+		const std::vector<ELEM>& v = static_cast<const OWNER*>( owner )->*mMember;
+		return v.empty() ? NULL : &v[0];
+	}
+
+	template< typename OWNER, typename ELEM >
+	inline void* BlockFields::VectorBlockField<OWNER,ELEM>::Resize( void* owner, size_t count ) const
+	{
+		std::vector<ELEM>& v = static_cast<OWNER*>( owner )->*mMember;
+		v.resize( count );
+		return v.empty() ? NULL : &v[0];
+	}
+}
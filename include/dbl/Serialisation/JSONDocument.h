@@ -0,0 +1,135 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file JSONDocument.h
+ * @brief In-situ JSON reader.
+ */
+
+#ifndef __DBL_JSONDOCUMENT_H_
+#define __DBL_JSONDOCUMENT_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+// External Libraries //
+#include <vector>
+#include <iosfwd>
+
+namespace dbl
+{
+	//! JSON value types.
+	namespace JSONType
+	{
+		enum Type
+		{
+			Null,
+			Bool,
+			Number,
+			String,
+			Array,
+			Object,
+		};
+	}
+
+	//! @brief Parsed JSON value.
+	//! Text and keys point into the document buffer and are not null terminated.
+	struct JSONNode
+	{
+		static const cbl::Uint32 None = 0xFFFFFFFF;	//!< Invalid node index.
+
+		JSONType::Type		Type;			//!< Value type.
+		const cbl::Char		* Key;			//!< Member key (objects only).
+		cbl::Uint32			KeyLength;		//!< Member key length.
+		const cbl::Char		* Text;			//!< Scalar text (unescaped for strings).
+		cbl::Uint32			Length;			//!< Scalar text length.
+		cbl::Uint32			ChildCount;		//!< Number of array elements or object members.
+		cbl::Uint32			FirstChild;		//!< Index of the first child.
+		cbl::Uint32			NextSibling;	//!< Index of the next sibling.
+
+		//! Check if the value is a scalar (not an array or object).
+		bool IsScalar( void ) const { return Type != JSONType::Array && Type != JSONType::Object; }
+	};
+
+	//! @brief In-situ JSON reader.
+	//! The source text is loaded into one buffer and parsed in place: strings are
+	//! unescaped inside the buffer and nodes are stored in a single flat list that is
+	//! reused between documents. A stream can hold any number of top-level values
+	//! (e.g. newline delimited JSON); each call to GetNextDocument() parses the next one.
+	class DBL_API JSONDocument
+	{
+	/***** Public Static Members *****/
+	public:
+		static cbl::Uint32		MaxDepth;	//!< Maximum nesting depth. Defaults to 512.
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		JSONDocument();
+		//! Load JSON text from a stream.
+		bool Load( std::istream& is );
+		//! Load JSON text from memory (the text is copied).
+		void Load( const cbl::Char* text, size_t length );
+		//! Parse the next top-level value.
+		//! @return		False at the end of the stream or on a parse error.
+		bool GetNextDocument( void );
+		//! Get the root of the current document.
+		const JSONNode* GetRoot( void ) const;
+		//! Get the first child of an array or object.
+		const JSONNode* GetFirstChild( const JSONNode& node ) const;
+		//! Get the next sibling of a node.
+		const JSONNode* GetNextSibling( const JSONNode& node ) const;
+		//! Find a member of an object.
+		const JSONNode* FindValue( const JSONNode& node, const cbl::Char* key ) const;
+		//! Get the number of nodes in the current document.
+		size_t GetNodeCount( void ) const { return mNodes.size(); }
+
+	/***** Public Static Methods *****/
+	public:
+		//! Get the text of a scalar value.
+		//! @return		False if the node is not a scalar or is null.
+		static bool GetScalar( const JSONNode& node, cbl::String& value );
+
+	/***** Private Methods *****/
+	private:
+		//! Parse a value and return its node index.
+		cbl::Uint32 ParseValue( cbl::Uint32 depth );
+		//! Parse a string in place.
+		bool ParseString( const cbl::Char*& text, cbl::Uint32& length );
+		//! Parse a number.
+		bool ParseNumber( void );
+		//! Parse a literal (true, false, null).
+		bool ParseLiteral( const cbl::Char* literal, size_t length );
+		//! Add a new node.
+		cbl::Uint32 AddNode( JSONType::Type type );
+		//! Skip whitespace.
+		void SkipWhitespace( void );
+		//! Report a parse error.
+		cbl::Uint32 Error( const cbl::Char* message );
+
+	/***** Private Members *****/
+	private:
+		std::vector<cbl::Char>	mBuffer;	//!< Source text (modified in place).
+		std::vector<JSONNode>	mNodes;		//!< Nodes of the current document.
+		cbl::Char				* mCursor;	//!< Parse position.
+		cbl::Char				* mEnd;		//!< End of the source text.
+		bool					mFailed;	//!< Flag to indicate a parse error occurred.
+	};
+}
+
+#endif // __DBL_JSONDOCUMENT_H_
@@ -0,0 +1,101 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file JSONWriter.h
+ * @brief Streaming JSON writer.
+ */
+
+#ifndef __DBL_JSONWRITER_H_
+#define __DBL_JSONWRITER_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+// External Libraries //
+#include <vector>
+
+namespace dbl
+{
+	//! @brief Streaming JSON writer.
+	//! Writes compact JSON into a single growing buffer. Separators are inserted
+	//! automatically and every completed top-level value ends with a newline, so
+	//! multiple values form a newline delimited JSON stream.
+	class DBL_API JSONWriter
+	{
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		JSONWriter();
+		//! Begin an object.
+		JSONWriter& BeginObject( void );
+		//! End the current object.
+		JSONWriter& EndObject( void );
+		//! Begin an array.
+		JSONWriter& BeginArray( void );
+		//! End the current array.
+		JSONWriter& EndArray( void );
+		//! Write an object key. Must be followed by a value.
+		JSONWriter& Key( const cbl::Char* key );
+		//! Write a string value.
+		JSONWriter& String( const cbl::Char* str, size_t length );
+		//! Write a string value.
+		JSONWriter& String( const cbl::String& str ) { return String( str.c_str(), str.length() ); }
+		//! Write a string value.
+		JSONWriter& String( const cbl::Char* str );
+		//! Write a signed integer value.
+		JSONWriter& Int( cbl::Int64 value );
+		//! Write an unsigned integer value.
+		JSONWriter& Uint( cbl::Uint64 value );
+		//! Write a floating point value (non-finite values are written as null).
+		JSONWriter& Real( cbl::Float64 value );
+		//! Write a boolean value.
+		JSONWriter& Bool( bool value );
+		//! Write a null value.
+		JSONWriter& Null( void );
+		//! Write pre-formatted JSON (a number or literal) as a value.
+		JSONWriter& Raw( const cbl::Char* json, size_t length );
+		//! Clear the buffer and writer state.
+		void Clear( void );
+		//! Check if all objects and arrays have been closed.
+		bool IsComplete( void ) const { return mScopes.empty() && !mAfterKey; }
+		//! Get the written JSON.
+		const cbl::String& GetString( void ) const { return mBuffer; }
+		//! Get the written JSON.
+		const cbl::Char* c_str( void ) const { return mBuffer.c_str(); }
+		//! Get the size of the written JSON in bytes.
+		size_t size( void ) const { return mBuffer.size(); }
+
+	/***** Private Methods *****/
+	private:
+		//! Write the separator for a new value.
+		void BeginValue( void );
+		//! Finish a value (terminates top-level values).
+		void EndValue( void );
+		//! Write an escaped, quoted string.
+		void WriteString( const cbl::Char* str, size_t length );
+
+	/***** Private Members *****/
+	private:
+		cbl::String			mBuffer;	//!< Output buffer.
+		std::vector<bool>	mScopes;	//!< Open scopes (true if the scope already holds a value).
+		bool				mAfterKey;	//!< Flag to indicate a key was just written.
+	};
+}
+
+#endif // __DBL_JSONWRITER_H_
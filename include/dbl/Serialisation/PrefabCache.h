@@ -0,0 +1,83 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file PrefabCache.h
+ * @brief Object template cache for file loaded objects.
+ */
+
+#ifndef __DBL_PREFABCACHE_H_
+#define __DBL_PREFABCACHE_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+// External Libraries //
+#include <unordered_map>
+
+namespace dbl
+{
+	//! @brief Object template cache for file loaded objects.
+	//! The first load of an object file parses it as usual and keeps a compact binary
+	//! image of the resulting object. Later loads of the same file clone the object
+	//! from that image instead of parsing the file again. An image is dropped when the
+	//! file's contents change; reading and hashing the file is still far cheaper than parsing it.
+	class DBL_API PrefabCache
+	{
+	/***** Public Static Methods *****/
+	public:
+		//! Enable or disable the cache (enabled by default). Disabling clears it.
+		static void SetEnabled( bool enabled );
+		//! Check if the cache is enabled.
+		static bool IsEnabled( void ) { return sEnabled; }
+		//! Clone an object from the cached image of a file.
+		//! @return		False if the file has no valid image.
+		static bool Instantiate( const cbl::Char* file, cbl::ObjectPtr& obj );
+		//! Store the image of an object loaded from a file.
+		static void Store( const cbl::Char* file, const cbl::Object& obj );
+		//! Check if a file has a valid image.
+		static bool IsCached( const cbl::Char* file );
+		//! Remove the image of a file.
+		static void Invalidate( const cbl::Char* file );
+		//! Remove all images.
+		static void Clear( void );
+
+	/***** Private Types *****/
+	private:
+		//! Cached object image.
+		struct Entry
+		{
+			cbl::Uint64		Hash;		//!< File contents hash.
+			cbl::Uint64		Size;		//!< File size.
+			cbl::String		Image;		//!< Binary serialised object.
+		};
+		typedef std::unordered_map< cbl::String, Entry >	EntryMap;
+
+	/***** Private Static Methods *****/
+	private:
+		//! Find the entry of a file if it is still valid.
+		static const Entry* Find( const cbl::Char* file );
+
+	/***** Private Static Members *****/
+	private:
+		static EntryMap		sEntries;	//!< Cached images by file name.
+		static bool			sEnabled;	//!< Flag to indicate if the cache is enabled.
+	};
+}
+
+#endif // __DBL_PREFABCACHE_H_
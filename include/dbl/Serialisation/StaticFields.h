@@ -0,0 +1,64 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file StaticFields.h
+ * @brief Compile-time field lists for reflected types.
+ */
+
+#ifndef __DBL_STATICFIELDS_H_
+#define __DBL_STATICFIELDS_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+namespace dbl
+{
+	//! @brief Compile-time field list of a reflected type.
+	//! Specialised with DBL_STATIC_FIELDS_BEGIN/DBL_STATIC_FIELDS_END. The list mirrors the
+	//! type's CBL_FIELD registration (minus transient fields) so generated routines
+	//! produce the same layout as the reflective serialisers.
+	template< typename T >
+	struct StaticFields
+	{
+		static const bool Defined = false;	//!< True if the type has a field list.
+	};
+}
+
+//! Begin the compile-time field list of a type. Must be used at global scope.
+#define DBL_STATIC_FIELDS_BEGIN( type ) \
+	namespace dbl { \
+	template<> struct StaticFields< type > \
+	{ \
+		static const bool Defined = true; \
+		template< typename VISITOR, typename OBJ > \
+		static void Visit( VISITOR& v, OBJ& obj ) \
+		{
+
+//! Add a field to the compile-time field list.
+//! Fields must be scalars, strings or types with their own field list; pointers and
+//! containers fail to compile in the generated codecs.
+#define DBL_STATIC_FIELD( field ) \
+			v( #field, obj.field );
+
+//! End the compile-time field list of a type.
+#define DBL_STATIC_FIELDS_END() \
+		} \
+	}; }
+
+#endif // __DBL_STATICFIELDS_H_
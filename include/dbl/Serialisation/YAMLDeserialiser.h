@@ -32,6 +32,7 @@
 
 // External Libraries //
 #include <yaml-cpp/yaml.h>
+#include <vector>
 
 namespace dbl
 {
@@ -47,6 +48,8 @@ namespace dbl
 	public:
 		//! Constructor.
 		YAMLDeserialiser();
+		//! Enable or disable compile-time generated codecs (enabled by default).
+		YAMLDeserialiser& SetStaticCodecsEnabled( bool enabled );
 		//! Check if the stream has ended.
 		virtual bool IsStreamEnded( void ) const;
 		//! Get the next value type. Does not advanced the stream.
@@ -83,9 +86,18 @@ namespace dbl
 		//! Called when the stream has been set.
 		virtual void OnStreamSet( void );
 		
+	/***** Private Types *****/
+	private:
+		//! Object whose fields are being read.
+		typedef std::pair< const cbl::Type*, void* >	FieldOwner;
+		typedef std::vector< FieldOwner >				FieldOwnerStack;
+
 	/***** Private Members *****/
 	private:
+		FieldOwner			mCurrentValue;	//!< Last value read (owner of the next set of fields).
+		FieldOwnerStack		mFieldOwners;	//!< Owners of the fields currently being read.
 		bool				mHasDocument;	//!< Flag indicating if stream has a new YAML document.
+		bool				mStaticCodecs;	//!< Flag to indicate if generated codecs are used.
 		YAML::Node			mRoot;			//!< Current root YAML node.
 		YAML::Iterator		mBeginIt;		//!< YAML begin iterator for field containers.
 		YAML::Iterator		mEndIt;			//!< YAML end iterator for field containers.
@@ -30,6 +30,9 @@
 // Chewable Headers //
 #include "cbl/Serialisation/TreeSerialiser.h"
 
+// External Libraries //
+#include <vector>
+
 namespace dbl
 {
 	//! YAML Serialiser implementation.
@@ -44,6 +47,8 @@ namespace dbl
 	public:
 		//! Constructor.
 		YAMLSerialiser();
+		//! Enable or disable compile-time generated codecs (enabled by default).
+		YAMLSerialiser& SetStaticCodecsEnabled( bool enabled );
 		
 	/***** Protected Methods *****/
 	private:
@@ -82,10 +87,20 @@ namespace dbl
 		//! Called when the stream has been set.
 		virtual void OnStreamSet( void );
 		
+	/***** Private Types *****/
+	private:
+		//! Object whose fields are being written.
+		typedef std::pair< const cbl::Type*, const void* >	FieldOwner;
+		typedef std::vector< FieldOwner >					FieldOwnerStack;
+
 	/***** Private Members *****/
 	private:
-		bool			mInlineContainer;	//!< Flag to indicate if the field container has the inline flag set.
-		cbl::Uint32		mTraverseCount;		//!< Node traversal count.
+		bool				mInlineContainer;	//!< Flag to indicate if the field container has the inline flag set.
+		bool				mStaticCodecs;		//!< Flag to indicate if generated codecs are used.
+		cbl::Uint32			mTraverseCount;		//!< Node traversal count.
+		FieldOwner			mCurrentValue;		//!< Last value written (owner of the next set of fields).
+		FieldOwnerStack		mFieldOwners;		//!< Owners of the fields currently being written.
+		const cbl::Field	* mBlockField;		//!< Container field that was written as a single block.
 	};
 }
 
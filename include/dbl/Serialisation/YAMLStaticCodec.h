@@ -0,0 +1,98 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file YAMLStaticCodec.h
+ * @brief Compile-time generated YAML serialisation routines.
+ */
+
+#ifndef __DBL_YAMLSTATICCODEC_H_
+#define __DBL_YAMLSTATICCODEC_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Serialisation/StaticFields.h"
+
+// External Libraries //
+#include <yaml-cpp/yaml.h>
+#include <type_traits>
+#include <unordered_map>
+
+namespace dbl
+{
+	//! Generated YAML routines for a single type.
+	struct YAMLStaticCodec
+	{
+		typedef void (*WriteFunc)( YAML::Emitter& e, const void* obj );
+		typedef void (*ReadFunc)( const YAML::Node& node, void* obj );
+
+		cbl::CName		Name;	//!< Type name (guards against stale type pointers).
+		WriteFunc		Write;	//!< Write an object as a YAML map.
+		ReadFunc		Read;	//!< Read an object from a YAML map.
+	};
+
+	//! @brief Registry of compile-time generated YAML codecs.
+	//! YAMLSerialiser and YAMLDeserialiser use a registered codec in place of the
+	//! reflective field walk. The output is interchangeable with the reflective path.
+	//! @code
+	//! DBL_STATIC_FIELDS_BEGIN( dbl::GameWindowSize )
+	//!     DBL_STATIC_FIELD( Width )
+	//!     DBL_STATIC_FIELD( Height )
+	//! DBL_STATIC_FIELDS_END()
+	//!
+	//! typedb.Create<GameWindowSize>()
+	//!     .CBL_FIELD( Width, GameWindowSize )
+	//!     .CBL_FIELD( Height, GameWindowSize );
+	//! YAMLStaticCodecs::Register<GameWindowSize>();
+	//! @endcode
+	class DBL_API YAMLStaticCodecs
+	{
+	/***** Public Static Methods *****/
+	public:
+		//! Register the generated codec of a type. The type must already be in the type database.
+		template< typename T >
+		static void Register( void );
+		//! Find the codec of a type.
+		//! @return		NULL if the type has no generated codec.
+		static const YAMLStaticCodec* Find( const cbl::Type* type );
+		//! Remove all registered codecs.
+		static void Clear( void );
+
+		//! Write a value with the generated routine.
+		template< typename T >
+		static void Write( YAML::Emitter& e, const T& value );
+		//! Read a value with the generated routine.
+		template< typename T >
+		static void Read( const YAML::Node& node, T& value );
+
+	/***** Private Types *****/
+	private:
+		typedef std::unordered_map< const cbl::Type*, YAMLStaticCodec >	CodecMap;
+
+	/***** Private Static Methods *****/
+	private:
+		//! Add a codec for a type.
+		static void Add( const cbl::CName& name, YAMLStaticCodec::WriteFunc write, YAMLStaticCodec::ReadFunc read );
+		//! Get the registered codecs. Codecs are registered during static initialisation.
+		static CodecMap& GetCodecs( void );
+	};
+}
+
+#include "YAMLStaticCodec.inl"
+
+#endif // __DBL_YAMLSTATICCODEC_H_
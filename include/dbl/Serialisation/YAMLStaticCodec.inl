@@ -0,0 +1,265 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file YAMLStaticCodec.inl
+ * @brief Compile-time generated YAML serialisation routines.
+ */
+
+// External Libraries //
+#include <cstdio>
+
+namespace dbl
+{
+	namespace YAMLStaticDetail
+	{
+		//! Value categories handled by the generated routines.
+		enum Kind
+		{
+			K_FIELDS,		//!< Type with a static field list (written as a map).
+			K_STRING,		//!< String scalar.
+			K_SIGNED,		//!< Signed integer scalar.
+			K_UNSIGNED,		//!< Unsigned integer scalar.
+			K_FLOAT,		//!< Floating point scalar.
+			K_REFLECTED,	//!< Other scalars (enums, bools, ...) go through the type's string conversion.
+			K_UNSUPPORTED,	//!< Pointers and containers; use the reflective serialiser for these.
+		};
+
+		//! Check if a type is a container (has a const_iterator).
+		template< typename T >
+		struct IsContainer
+		{
+			template< typename U > static char Test( typename U::const_iterator* );
+			template< typename U > static long Test( ... );
+			static const bool Value = sizeof( Test<T>( 0 ) ) == sizeof( char );
+		};
+
+		template< typename T >
+		struct KindOf
+		{
+			static const int Value =
+				StaticFields<T>::Defined ? K_FIELDS :
+				std::is_same<T,bool>::value ? K_REFLECTED :
+				std::is_floating_point<T>::value ? K_FLOAT :
+				std::is_integral<T>::value ? ( std::is_signed<T>::value ? K_SIGNED : K_UNSIGNED ) :
+				std::is_pointer<T>::value || IsContainer<T>::Value ? K_UNSUPPORTED :
+				K_REFLECTED;
+		};
+
+		template<>
+		struct KindOf<cbl::String>
+		{
+			static const int Value = K_STRING;
+		};
+
+		template< int K >
+		struct KindTag {};
+
+		template< typename T > void Write( YAML::Emitter& e, const T& value );
+		template< typename T > void Read( const YAML::Node& node, T& value );
+
+		//! Field visitor writing key/value pairs.
+		struct Writer
+		{
+			YAML::Emitter& Emitter;
+			explicit Writer( YAML::Emitter& e ) : Emitter( e ) {}
+
+			template< typename T >
+			inline void operator()( const cbl::Char* name, const T& value )
+			{
+				Emitter << YAML::Key << name << YAML::Value;
+				Write( Emitter, value );
+			}
+		};
+
+		//! Field visitor reading values that are present in the map.
+		struct Reader
+		{
+			const YAML::Node& Map;
+			explicit Reader( const YAML::Node& node ) : Map( node ) {}
+
+			template< typename T >
+			inline void operator()( const cbl::Char* name, T& value )
+			{
+				if( const YAML::Node* child = Map.FindValue( name ) )
+					Read( *child, value );
+			}
+		};
+
+		/***** Writing *****/
+		template< typename T >
+		inline void Write( YAML::Emitter& e, const T& value, KindTag<K_FIELDS> )
+		{
+			e << YAML::BeginMap;
+			Writer w( e );
+			StaticFields<T>::Visit( w, value );
+			e << YAML::EndMap;
+		}
+
+		template< typename T >
+		inline void Write( YAML::Emitter& e, const T& value, KindTag<K_STRING> )
+		{
+			e << value;
+		}
+
+		template< typename T >
+		inline void Write( YAML::Emitter& e, const T& value, KindTag<K_SIGNED> )
+		{
+			char buffer[32];
+			sprintf( buffer, "%lld", (long long)value );
+			e << buffer;
+		}
+
+		template< typename T >
+		inline void Write( YAML::Emitter& e, const T& value, KindTag<K_UNSIGNED> )
+		{
+			char buffer[32];
+			sprintf( buffer, "%llu", (unsigned long long)value );
+			e << buffer;
+		}
+
+		template< typename T >
+		inline void Write( YAML::Emitter& e, const T& value, KindTag<K_FLOAT> )
+		{
+			char buffer[32];
+			sprintf( buffer, sizeof( T ) > 4 ? "%.17g" : "%.9g", double( value ) );
+			e << buffer;
+		}
+
+		template< typename T >
+		inline void Write( YAML::Emitter& e, const T& value, KindTag<K_REFLECTED> )
+		{
+			const cbl::Type* type = CBL_ENT.Types.Get( cbl::TypeCName<T>() );
+			if( !type || !type->ToString ) {
+				LOG_ERROR( "Static field of type " << cbl::TypeCName<T>().Text << " has no string conversion." );
+				e << YAML::Null;
+				return;
+			}
+
+			cbl::String str;
+			type->ToString( str, type, &value, NULL );
+			e << str;
+		}
+
+		template< typename T >
+		inline void Write( YAML::Emitter& e, const T& value )
+		{
+			// Pointers and containers can't be listed in a static field set.
+			CBL_STATIC_ASSERT( KindOf<T>::Value != K_UNSUPPORTED );
+			Write( e, value, KindTag< KindOf<T>::Value >() );
+		}
+
+		/***** Reading *****/
+		template< typename T >
+		inline void Read( const YAML::Node& node, T& value, KindTag<K_FIELDS> )
+		{
+			if( node.Type() != YAML::NodeType::Map )
+				return;
+
+			Reader r( node );
+			StaticFields<T>::Visit( r, value );
+		}
+
+		template< typename T >
+		inline void Read( const YAML::Node& node, T& value, KindTag<K_STRING> )
+		{
+			node.GetScalar( value );
+		}
+
+		template< typename T >
+		inline void Read( const YAML::Node& node, T& value, KindTag<K_SIGNED> )
+		{
+			cbl::String scalar;
+			long long parsed = 0;
+			if( node.GetScalar( scalar ) && sscanf( scalar.c_str(), "%lld", &parsed ) == 1 )
+				value = T( parsed );
+		}
+
+		template< typename T >
+		inline void Read( const YAML::Node& node, T& value, KindTag<K_UNSIGNED> )
+		{
+			cbl::String scalar;
+			unsigned long long parsed = 0;
+			if( node.GetScalar( scalar ) && sscanf( scalar.c_str(), "%llu", &parsed ) == 1 )
+				value = T( parsed );
+		}
+
+		template< typename T >
+		inline void Read( const YAML::Node& node, T& value, KindTag<K_FLOAT> )
+		{
+			cbl::String scalar;
+			double parsed = 0.0;
+			if( node.GetScalar( scalar ) && sscanf( scalar.c_str(), "%lf", &parsed ) == 1 )
+				value = T( parsed );
+		}
+
+		template< typename T >
+		inline void Read( const YAML::Node& node, T& value, KindTag<K_REFLECTED> )
+		{
+			const cbl::Type* type = CBL_ENT.Types.Get( cbl::TypeCName<T>() );
+			if( !type || !type->FromString ) {
+				LOG_ERROR( "Static field of type " << cbl::TypeCName<T>().Text << " has no string conversion." );
+				return;
+			}
+
+			cbl::String scalar;
+			if( node.GetScalar( scalar ) )
+				type->FromString( scalar.c_str(), type, &value, NULL );
+		}
+
+		template< typename T >
+		inline void Read( const YAML::Node& node, T& value )
+		{
+			CBL_STATIC_ASSERT( KindOf<T>::Value != K_UNSUPPORTED );
+			Read( node, value, KindTag< KindOf<T>::Value >() );
+		}
+
+		/***** Type-erased entry points *****/
+		template< typename T >
+		void WriteObject( YAML::Emitter& e, const void* obj )
+		{
+			Write( e, *static_cast<const T*>( obj ) );
+		}
+
+		template< typename T >
+		void ReadObject( const YAML::Node& node, void* obj )
+		{
+			try { Read( node, *static_cast<T*>( obj ) ); }
+			catch( const YAML::Exception& ex ) { LOG_ERROR( ex.what() ); }
+		}
+	}
+
+	template< typename T >
+	inline void YAMLStaticCodecs::Register( void )
+	{
+		CBL_STATIC_ASSERT( StaticFields<T>::Defined );
+		Add( cbl::TypeCName<T>(), &YAMLStaticDetail::WriteObject<T>, &YAMLStaticDetail::ReadObject<T> );
+	}
+
+	template< typename T >
+	inline void YAMLStaticCodecs::Write( YAML::Emitter& e, const T& value )
+	{
+		YAMLStaticDetail::Write( e, value );
+	}
+
+	template< typename T >
+	inline void YAMLStaticCodecs::Read( const YAML::Node& node, T& value )
+	{
+		YAMLStaticDetail::Read( node, value );
+	}
+}
@@ -29,13 +29,28 @@
 #include "dbl/Config.h"
 #include "dbl/Platform.h"
 // Core //
+#include "dbl/Core/DisplayModeCache.h"
+#include "dbl/Core/FramePacer.h"
+#include "dbl/Core/FrameTimer.h"
 #include "dbl/Core/Game.h"
 #include "dbl/Core/GameWindow.h"
 #include "dbl/Core/GameWindowSettings.h"
 #include "dbl/Core/LevelManager.h"
 #include "dbl/Core/LevelObject.h"
+#include "dbl/Core/StartupReport.h"
+#include "dbl/Core/WindowEvent.h"
 // Input //
+#include "dbl/Input/ActionBindings.h"
+#include "dbl/Input/ActionMap.h"
+#include "dbl/Input/ComboDetector.h"
+#include "dbl/Input/GamepadButtons.h"
+#include "dbl/Input/GamepadManager.h"
+#include "dbl/Input/IInputSource.h"
+#include "dbl/Input/InputEvent.h"
 #include "dbl/Input/InputFilter.h"
+#include "dbl/Input/InputRecorder.h"
+#include "dbl/Input/InputSnapshot.h"
+#include "dbl/Input/InputState.h"
 #include "dbl/Input/KeyboardManager.h"
 #include "dbl/Input/KeyCodes.h"
 #include "dbl/Input/MouseButtons.h"
@@ -43,5 +58,19 @@
 // Reflection //
 #include "dbl/Reflection/DblRegistrar.h"
 // Serialisation //
+#include "dbl/Serialisation/BlockSerialisation.h"
+#include "dbl/Serialisation/JSONDeserialiser.h"
+#include "dbl/Serialisation/JSONDocument.h"
+#include "dbl/Serialisation/JSONSerialiser.h"
+#include "dbl/Serialisation/JSONWriter.h"
+#include "dbl/Serialisation/PrefabCache.h"
 #include "dbl/Serialisation/YAMLDeserialiser.h"
 #include "dbl/Serialisation/YAMLSerialiser.h"
+#include "dbl/Serialisation/YAMLStaticCodec.h"
+// Threading //
+#include "dbl/Threading/Atomic.h"
+#include "dbl/Threading/EventBus.h"
+#include "dbl/Threading/RingBuffer.h"
+#include "dbl/Threading/Thread.h"
+#include "dbl/Threading/TripleBuffer.h"
+#include "dbl/Threading/WaitableTimer.h"
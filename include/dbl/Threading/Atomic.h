@@ -0,0 +1,127 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Atomic.h
+ * @brief Minimal atomic operations for lock-free structures.
+ */
+
+#ifndef __DBL_ATOMIC_H_
+#define __DBL_ATOMIC_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+// External Libraries //
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+#include <intrin.h>
+#pragma intrinsic( _ReadWriteBarrier )
+#pragma intrinsic( _InterlockedExchange )
+#pragma intrinsic( _InterlockedIncrement )
+#pragma intrinsic( _InterlockedCompareExchange )
+#if defined( _WIN64 )
+#pragma intrinsic( _InterlockedCompareExchangePointer )
+#endif
+#endif
+
+namespace dbl
+{
+	//! @brief Atomic operations on aligned 32-bit values.
+	//! Only the orderings the engine's lock-free containers need are provided.
+	namespace Atomic
+	{
+		//! Load a value with acquire semantics.
+		inline cbl::Uint32 LoadAcquire( const volatile cbl::Uint32 & value )
+		{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+			// x86/x64 loads already have acquire semantics; stop the compiler reordering.
+			cbl::Uint32 result = value;
+			_ReadWriteBarrier();
+			return result;
+#else
+			return __atomic_load_n( &value, __ATOMIC_ACQUIRE );
+#endif
+		}
+
+		//! Store a value with release semantics.
+		inline void StoreRelease( volatile cbl::Uint32 & target, cbl::Uint32 value )
+		{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+			// x86/x64 stores already have release semantics; stop the compiler reordering.
+			_ReadWriteBarrier();
+			target = value;
+#else
+			__atomic_store_n( &target, value, __ATOMIC_RELEASE );
+#endif
+		}
+
+		//! Swap in a new value with full ordering.
+		//! @return		The previous value.
+		inline cbl::Uint32 Exchange( volatile cbl::Uint32 & target, cbl::Uint32 value )
+		{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+			return cbl::Uint32( _InterlockedExchange( reinterpret_cast< volatile long * >( &target ), long( value ) ) );
+#else
+			return __atomic_exchange_n( &target, value, __ATOMIC_ACQ_REL );
+#endif
+		}
+
+		//! Add one with full ordering.
+		//! @return		The new value.
+		inline cbl::Uint32 Increment( volatile cbl::Uint32 & target )
+		{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+			return cbl::Uint32( _InterlockedIncrement( reinterpret_cast< volatile long * >( &target ) ) );
+#else
+			return __atomic_add_fetch( &target, 1, __ATOMIC_ACQ_REL );
+#endif
+		}
+
+		//! Load a pointer with acquire semantics.
+		template< typename TYPE >
+		inline TYPE * LoadAcquire( TYPE * const volatile & value )
+		{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+			TYPE * result = value;
+			_ReadWriteBarrier();
+			return result;
+#else
+			return __atomic_load_n( &value, __ATOMIC_ACQUIRE );
+#endif
+		}
+
+		//! Replace a pointer if it still holds the expected value, with full ordering.
+		//! @return		The previous value (equal to comparand if the swap happened).
+		template< typename TYPE >
+		inline TYPE * CompareExchange( TYPE * volatile & target, TYPE * value, TYPE * comparand )
+		{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+#if defined( _WIN64 )
+			return static_cast< TYPE * >( _InterlockedCompareExchangePointer( reinterpret_cast< void * volatile * >( &target ), value, comparand ) );
+#else
+			return reinterpret_cast< TYPE * >( _InterlockedCompareExchange( reinterpret_cast< volatile long * >( &target ), reinterpret_cast< long >( value ), reinterpret_cast< long >( comparand ) ) );
+#endif
+#else
+			__atomic_compare_exchange_n( &target, &comparand, value, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE );
+			return comparand;
+#endif
+		}
+	}
+}
+
+#endif // __DBL_ATOMIC_H_
@@ -0,0 +1,108 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file EventBus.h
+ * @brief Lock-free multiple producer, single consumer event queue.
+ */
+
+#ifndef __DBL_EVENTBUS_H_
+#define __DBL_EVENTBUS_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Threading/Atomic.h"
+#include "dbl/Threading/RingBuffer.h"
+
+// Chewable Headers //
+#include <cbl/Util/Noncopyable.h>
+
+// External Libraries //
+#include <vector>
+
+namespace dbl
+{
+	//! @brief Event queue that any thread can post to and one thread drains.
+	//! Every producer thread gets its own lock-free ring buffer the first time it posts, so
+	//! producers never contend with each other or with the consumer. Events from one thread
+	//! are drained in the order they were posted; there is no ordering between threads.
+	//! Queues are kept until the bus is destroyed, so prefer long-lived producer threads.
+	template< typename TYPE >
+	class EventBus :
+		cbl::Noncopyable
+	{
+	/***** Types *****/
+	public:
+		//! Drained event list.
+		typedef std::vector< TYPE >		EventList;
+
+	/***** Properties *****/
+	public:
+		//! Get the number of events dropped because a producer's queue was full.
+		inline cbl::Uint32 GetDroppedEvents( void ) const { return Atomic::LoadAcquire( mDropped ); }
+		//! Get the number of threads that have posted to the bus.
+		cbl::Uint32 GetProducerCount( void ) const;
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	queueSize	Minimum number of events each producer thread can have queued.
+		explicit EventBus( cbl::Uint32 queueSize );
+		//! Destructor.
+		~EventBus();
+		//! Queue an event (any thread).
+		//! @return		False if the calling thread's queue is full and the event was dropped.
+		bool Post( const TYPE & ev );
+		//! Append all queued events to a list (consumer only).
+		//! Events posted while draining are left for the next call.
+		//! @return		Number of events drained.
+		cbl::Uint32 Drain( EventList & events );
+
+	/***** Private Types *****/
+	private:
+		//! Queue owned by a single producer thread.
+		struct Producer
+		{
+			RingBuffer< TYPE >	Queue;		//!< Posted events.
+			cbl::Uint64			ThreadId;	//!< Owning thread.
+			Producer			* Next;		//!< Next producer in the list.
+
+			Producer( cbl::Uint32 size, cbl::Uint64 threadId )
+			: Queue( size )
+			, ThreadId( threadId )
+			, Next( NULL )
+			{
+			}
+		};
+
+	/***** Private Methods *****/
+	private:
+		//! Find or add the queue of the calling thread.
+		Producer * GetProducer( void );
+
+	/***** Private Members *****/
+	private:
+		Producer * volatile		mProducers;		//!< Producer queues (only ever prepended to).
+		cbl::Uint32				mQueueSize;		//!< Size of new producer queues.
+		volatile cbl::Uint32	mDropped;		//!< Events dropped due to full queues.
+	};
+}
+
+#include "EventBus.inl"
+
+#endif // __DBL_EVENTBUS_H_
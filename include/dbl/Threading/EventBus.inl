@@ -0,0 +1,103 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file EventBus.inl
+ * @brief Lock-free multiple producer, single consumer event queue.
+ */
+
+// Delectable Headers //
+#include "dbl/Threading/Thread.h"
+
+namespace dbl
+{
+	template< typename TYPE >
+	EventBus<TYPE>::EventBus( cbl::Uint32 queueSize )
+	: mProducers( NULL )
+	, mQueueSize( queueSize )
+	, mDropped( 0 )
+	{
+	}
+
+	template< typename TYPE >
+	EventBus<TYPE>::~EventBus()
+	{
+		Producer * producer = mProducers;
+		while( producer ) {
+			Producer * next = producer->Next;
+			delete producer;
+			producer = next;
+		}
+	}
+
+	template< typename TYPE >
+	cbl::Uint32 EventBus<TYPE>::GetProducerCount( void ) const
+	{
+		cbl::Uint32 count = 0;
+		for( Producer * producer = Atomic::LoadAcquire( mProducers ); producer; producer = producer->Next )
+			++count;
+		return count;
+	}
+
+	template< typename TYPE >
+	inline bool EventBus<TYPE>::Post( const TYPE & ev )
+	{
+		if( GetProducer()->Queue.Push( ev ) )
+			return true;
+
+		Atomic::Increment( mDropped );
+		return false;
+	}
+
+	template< typename TYPE >
+	cbl::Uint32 EventBus<TYPE>::Drain( EventList & events )
+	{
+		cbl::Uint32 count = 0;
+		TYPE ev;
+		for( Producer * producer = Atomic::LoadAcquire( mProducers ); producer; producer = producer->Next ) {
+			// Only take what was there on arrival so a busy producer can't hold up the frame.
+			for( cbl::Uint32 queued = producer->Queue.Size(); queued > 0 && producer->Queue.Pop( ev ); --queued ) {
+				events.push_back( ev );
+				++count;
+			}
+		}
+		return count;
+	}
+
+	template< typename TYPE >
+	typename EventBus<TYPE>::Producer * EventBus<TYPE>::GetProducer( void )
+	{
+		const cbl::Uint64 threadId = Thread::GetCurrentId();
+
+		Producer * head = Atomic::LoadAcquire( mProducers );
+		for( Producer * producer = head; producer; producer = producer->Next ) {
+			if( producer->ThreadId == threadId )
+				return producer;
+		}
+
+		// Only the calling thread can add its own queue, so nothing else can add a duplicate.
+		Producer * producer = new Producer( mQueueSize, threadId );
+		for( ;; ) {
+			producer->Next = head;
+			Producer * previous = Atomic::CompareExchange( mProducers, producer, head );
+			if( previous == head )
+				return producer;
+			head = previous;
+		}
+	}
+}
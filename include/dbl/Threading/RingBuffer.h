@@ -0,0 +1,77 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file RingBuffer.h
+ * @brief Lock-free single producer, single consumer ring buffer.
+ */
+
+#ifndef __DBL_RINGBUFFER_H_
+#define __DBL_RINGBUFFER_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Threading/Atomic.h"
+
+// Chewable Headers //
+#include <cbl/Util/Noncopyable.h>
+
+// External Libraries //
+#include <vector>
+
+namespace dbl
+{
+	//! @brief Bounded lock-free ring buffer.
+	//! Safe for exactly one producer thread and one consumer thread. Capacity is
+	//! rounded up to a power of two so indices wrap with a mask.
+	template< typename TYPE >
+	class RingBuffer :
+		cbl::Noncopyable
+	{
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	capacity	Minimum number of elements the buffer can hold.
+		explicit RingBuffer( cbl::Uint32 capacity );
+		//! Push an element (producer only).
+		//! @return		False if the buffer is full.
+		bool Push( const TYPE & value );
+		//! Pop an element (consumer only).
+		//! @return		False if the buffer is empty.
+		bool Pop( TYPE & value );
+		//! Approximate number of queued elements.
+		cbl::Uint32 Size( void ) const;
+		//! Check if the buffer is (approximately) empty.
+		bool Empty( void ) const;
+		//! Get the buffer capacity.
+		inline cbl::Uint32 Capacity( void ) const { return mMask + 1; }
+
+	/***** Private Members *****/
+	private:
+		std::vector< TYPE >		mBuffer;		//!< Element storage.
+		cbl::Uint32				mMask;			//!< Index wrap mask.
+		cbl::Uint8				mPad0[64];		//!< Keep the producer and consumer indices on separate cache lines.
+		volatile cbl::Uint32	mHead;			//!< Next slot to write (owned by the producer).
+		cbl::Uint8				mPad1[64];
+		volatile cbl::Uint32	mTail;			//!< Next slot to read (owned by the consumer).
+	};
+}
+
+#include "RingBuffer.inl"
+
+#endif // __DBL_RINGBUFFER_H_
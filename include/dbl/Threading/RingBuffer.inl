@@ -0,0 +1,75 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file RingBuffer.inl
+ * @brief Lock-free single producer, single consumer ring buffer.
+ */
+
+namespace dbl
+{
+	template< typename TYPE >
+	RingBuffer<TYPE>::RingBuffer( cbl::Uint32 capacity )
+	: mMask( 0 )
+	, mHead( 0 )
+	, mTail( 0 )
+	{
+		cbl::Uint32 size = 1;
+		while( size < capacity )
+			size <<= 1;
+
+		mBuffer.resize( size );
+		mMask = size - 1;
+	}
+
+	template< typename TYPE >
+	inline bool RingBuffer<TYPE>::Push( const TYPE & value )
+	{
+		const cbl::Uint32 head = mHead;
+		if( head - Atomic::LoadAcquire( mTail ) > mMask )
+			return false;
+
+		mBuffer[ head & mMask ] = value;
+		Atomic::StoreRelease( mHead, head + 1 );
+		return true;
+	}
+
+	template< typename TYPE >
+	inline bool RingBuffer<TYPE>::Pop( TYPE & value )
+	{
+		const cbl::Uint32 tail = mTail;
+		if( tail == Atomic::LoadAcquire( mHead ) )
+			return false;
+
+		value = mBuffer[ tail & mMask ];
+		Atomic::StoreRelease( mTail, tail + 1 );
+		return true;
+	}
+
+	template< typename TYPE >
+	inline cbl::Uint32 RingBuffer<TYPE>::Size( void ) const
+	{
+		return Atomic::LoadAcquire( mHead ) - Atomic::LoadAcquire( mTail );
+	}
+
+	template< typename TYPE >
+	inline bool RingBuffer<TYPE>::Empty( void ) const
+	{
+		return Size() == 0;
+	}
+}
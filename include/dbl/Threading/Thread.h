@@ -0,0 +1,89 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Thread.h
+ * @brief Native thread wrapper.
+ */
+
+#ifndef __DBL_THREAD_H_
+#define __DBL_THREAD_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+// Chewable Headers //
+#include <cbl/Util/Noncopyable.h>
+
+namespace dbl
+{
+	//! @brief Native thread wrapper.
+	//! The thread must be joined before the object is destroyed.
+	class DBL_API Thread :
+		cbl::Noncopyable
+	{
+	/***** Types *****/
+	public:
+		//! Thread entry point.
+		typedef void (*Function)( void * );
+
+	/***** Public Static Methods *****/
+	public:
+		//! Suspend the calling thread.
+		//! @param	milliseconds	Time to sleep for.
+		static void Sleep( cbl::Uint32 milliseconds );
+		//! Get an identifier for the calling thread, unique among running threads.
+		static cbl::Uint64 GetCurrentId( void );
+
+	/***** Properties *****/
+	public:
+		//! Check if the thread has been started and not joined.
+		inline bool IsRunning( void ) const { return mHandle != NULL; }
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		Thread();
+		//! Destructor.
+		~Thread();
+		//! Start the thread.
+		//! @param	function	Thread entry point.
+		//! @param	arg			Argument passed to the entry point.
+		//! @return				False if the thread is already running or could not be created.
+		bool Start( Function function, void * arg );
+		//! Wait for the thread to finish.
+		void Join( void );
+
+	/***** Private Static Methods *****/
+	private:
+		//! Native entry point.
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+		static unsigned int __stdcall Entry( void * self );
+#else
+		static void * Entry( void * self );
+#endif
+
+	/***** Private Members *****/
+	private:
+		void			* mHandle;		//!< Native thread handle.
+		Function		mFunction;		//!< Thread entry point.
+		void			* mArg;			//!< Entry point argument.
+	};
+}
+
+#endif // __DBL_THREAD_H_
@@ -0,0 +1,75 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file TripleBuffer.h
+ * @brief Wait-free single writer, single reader state buffer.
+ */
+
+#ifndef __DBL_TRIPLEBUFFER_H_
+#define __DBL_TRIPLEBUFFER_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Threading/Atomic.h"
+
+// Chewable Headers //
+#include <cbl/Util/Noncopyable.h>
+
+namespace dbl
+{
+	//! @brief Wait-free buffer for handing the latest copy of a state to another thread.
+	//! The writer fills its back buffer and publishes it; the reader picks up the most
+	//! recently published state. Neither side ever blocks or sees a partially written
+	//! state. Intermediate states published between two reads are skipped.
+	template< typename TYPE >
+	class TripleBuffer :
+		cbl::Noncopyable
+	{
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		TripleBuffer();
+		//! Get the buffer to write the next state into (writer only).
+		inline TYPE & GetWriteBuffer( void ) { return mBuffers[ mBack ]; }
+		//! Publish the write buffer (writer only).
+		//! The new write buffer holds stale data; copy the state forward if needed.
+		void Publish( void );
+		//! Pick up the latest published state (reader only).
+		//! @return		False if nothing new has been published since the last call.
+		bool Update( void );
+		//! Get the state picked up by the last Update (reader only).
+		inline const TYPE & GetReadBuffer( void ) const { return mBuffers[ mFront ]; }
+
+	/***** Private Types *****/
+	private:
+		//! Flag set in the shared index when it holds an unread state.
+		static const cbl::Uint32	sFresh = 0x4;
+
+	/***** Private Members *****/
+	private:
+		TYPE					mBuffers[3];	//!< State buffers.
+		cbl::Uint32				mBack;			//!< Writer's buffer index.
+		volatile cbl::Uint32	mMiddle;		//!< Shared buffer index and fresh flag.
+		cbl::Uint32				mFront;			//!< Reader's buffer index.
+	};
+}
+
+#include "TripleBuffer.inl"
+
+#endif // __DBL_TRIPLEBUFFER_H_
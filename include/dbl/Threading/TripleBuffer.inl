@@ -0,0 +1,49 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file TripleBuffer.inl
+ * @brief Wait-free single writer, single reader state buffer.
+ */
+
+namespace dbl
+{
+	template< typename TYPE >
+	TripleBuffer<TYPE>::TripleBuffer()
+	: mBack( 0 )
+	, mMiddle( 1 )
+	, mFront( 2 )
+	{
+	}
+
+	template< typename TYPE >
+	inline void TripleBuffer<TYPE>::Publish( void )
+	{
+		mBack = Atomic::Exchange( mMiddle, mBack | sFresh ) & ~sFresh;
+	}
+
+	template< typename TYPE >
+	inline bool TripleBuffer<TYPE>::Update( void )
+	{
+		if( !( Atomic::LoadAcquire( mMiddle ) & sFresh ) )
+			return false;
+
+		mFront = Atomic::Exchange( mMiddle, mFront ) & ~sFresh;
+		return true;
+	}
+}
@@ -0,0 +1,64 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file WaitableTimer.h
+ * @brief High resolution sleep timer.
+ */
+
+#ifndef __DBL_WAITABLETIMER_H_
+#define __DBL_WAITABLETIMER_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+
+// Chewable Headers //
+#include <cbl/Util/Noncopyable.h>
+
+namespace dbl
+{
+	//! @brief Timer for sleeping the calling thread with sub-millisecond precision.
+	//! Thread::Sleep() is limited to the scheduler tick (up to 15.6ms on Windows). Waits on
+	//! this timer use a high resolution kernel timer where the platform provides one.
+	class DBL_API WaitableTimer :
+		cbl::Noncopyable
+	{
+	/***** Properties *****/
+	public:
+		//! Check if waits wake close to the requested time.
+		//! Without a high resolution timer, waits may overshoot by a scheduler tick.
+		inline bool IsHighResolution( void ) const { return mHighResolution; }
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		WaitableTimer();
+		//! Destructor.
+		~WaitableTimer();
+		//! Block the calling thread.
+		//! @param	seconds		Time to wait for.
+		void Wait( cbl::Float64 seconds );
+
+	/***** Private Members *****/
+	private:
+		void			* mHandle;			//!< Native timer handle.
+		bool			mHighResolution;	//!< The timer is high resolution.
+	};
+}
+
+#endif // __DBL_WAITABLETIMER_H_
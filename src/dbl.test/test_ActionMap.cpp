@@ -0,0 +1,222 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_ActionMap.cpp
+ * @brief Unit testing for the action map.
+ */
+
+// Precompiled Headers //
+#include <dbl/StdAfx.h>
+
+// Delectable Headers //
+#include <dbl/Core/Game.h>
+#include <dbl/Input/ActionMap.h>
+#include <dbl/Serialisation/YAMLSerialiser.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+// External Libraries //
+#include <sstream>
+
+using namespace dbl;
+
+class ActionListener
+{
+public:
+	ActionListener() : pressCount( 0 ), releaseCount( 0 ), lastAction( ActionMap::sInvalidId ) {}
+
+	void OnActionPressed( cbl::Uint32 id )
+	{
+		++pressCount;
+		lastAction = id;
+	}
+
+	void OnActionReleased( cbl::Uint32 id )
+	{
+		++releaseCount;
+		lastAction = id;
+	}
+
+	cbl::Uint32	pressCount, releaseCount, lastAction;
+};
+
+class ActionMapFixture : public ::testing::Test
+{
+public:
+	ActionMapFixture()
+		: actionGame( "ActionMapFixture" )
+	{
+	}
+
+	void SetUp()
+	{
+		// No window is created; input is injected straight into the managers.
+		actionGame.Actions.Initialise();
+		actionGame.Actions.OnActionPressed	+= E::ActionPressed::Method<CBL_E_METHOD(ActionListener,OnActionPressed)>(&listener);
+		actionGame.Actions.OnActionReleased	+= E::ActionReleased::Method<CBL_E_METHOD(ActionListener,OnActionReleased)>(&listener);
+
+		ActionBinding jump;
+		jump.Name = "Jump";
+		jump.Keys.push_back( Key::Space );
+		jump.Keys.push_back( Key::W );
+		jump.Buttons.push_back( Mouse::Right );
+		bindings.Actions.push_back( jump );
+
+		ActionBinding fire;
+		fire.Name = "Fire";
+		fire.Keys.push_back( Key::Space );
+		fire.Buttons.push_back( Mouse::Left );
+		bindings.Actions.push_back( fire );
+
+		AxisBinding strafe;
+		strafe.Name = "Strafe";
+		strafe.Positive.push_back( Key::D );
+		strafe.Negative.push_back( Key::A );
+		bindings.Axes.push_back( strafe );
+	}
+
+	void TearDown()
+	{
+		actionGame.Actions.OnActionReleased	-= E::ActionReleased::Method<CBL_E_METHOD(ActionListener,OnActionReleased)>(&listener);
+		actionGame.Actions.OnActionPressed	-= E::ActionPressed::Method<CBL_E_METHOD(ActionListener,OnActionPressed)>(&listener);
+		actionGame.Actions.Shutdown();
+	}
+
+protected:
+	Game				actionGame;
+	ActionBindings		bindings;
+	ActionListener		listener;
+};
+
+TEST_F( ActionMapFixture, ActionMap_BindingTest )
+{
+	ActionMap& actions = actionGame.Actions;
+	KeyboardManager& keyboard = actionGame.Keyboard;
+	actions.SetBindings( bindings );
+
+	const cbl::Uint32 jump = actions.GetActionId( "Jump" );
+	const cbl::Uint32 fire = actions.GetActionId( "Fire" );
+	const cbl::Uint32 strafe = actions.GetAxisId( "Strafe" );
+	ASSERT_EQ( 0, jump );
+	ASSERT_EQ( 1, fire );
+	ASSERT_EQ( 0, strafe );
+	EXPECT_EQ( ActionMap::sInvalidId, actions.GetActionId( "Crouch" ) );
+
+	// One key fires every action bound to it.
+	keyboard.OnWindowKeyDown( Key::Space );
+	EXPECT_EQ( 2, listener.pressCount );
+	EXPECT_TRUE( actions.IsHeld( jump ) );
+	EXPECT_TRUE( actions.IsHeld( fire ) );
+	EXPECT_FALSE( actions.IsPressed( jump ) );
+	actions.Update( cbl::GameTime() );
+	EXPECT_TRUE( actions.IsPressed( jump ) );
+	EXPECT_TRUE( actions.IsPressed( fire ) );
+
+	// A second input on a held action doesn't press it again.
+	keyboard.OnWindowKeyDown( Key::W );
+	actionGame.Mouse.OnWindowMouseDown( 0, 0, Mouse::Right );
+	EXPECT_EQ( 2, listener.pressCount );
+	actions.Update( cbl::GameTime() );
+	EXPECT_FALSE( actions.IsPressed( jump ) );
+	EXPECT_TRUE( actions.IsHeld( jump ) );
+
+	keyboard.OnWindowKeyUp( Key::Space );
+	EXPECT_EQ( 1, listener.releaseCount );
+	EXPECT_EQ( fire, listener.lastAction );
+	keyboard.OnWindowKeyUp( Key::W );
+	actionGame.Mouse.OnWindowMouseUp( 0, 0, Mouse::Right );
+	EXPECT_EQ( 2, listener.releaseCount );
+	actions.Update( cbl::GameTime() );
+	EXPECT_TRUE( actions.IsReleased( jump ) );
+	EXPECT_TRUE( actions.IsReleased( fire ) );
+	EXPECT_FALSE( actions.IsHeld( jump ) );
+	actions.Update( cbl::GameTime() );
+	EXPECT_FALSE( actions.IsReleased( jump ) );
+
+	// Axes.
+	keyboard.OnWindowKeyDown( Key::D );
+	EXPECT_EQ( 1.0f, actions.GetAxis( strafe ) );
+	keyboard.OnWindowKeyDown( Key::A );
+	EXPECT_EQ( 0.0f, actions.GetAxis( strafe ) );
+	keyboard.OnWindowKeyUp( Key::D );
+	EXPECT_EQ( -1.0f, actions.GetAxis( strafe ) );
+
+	// Rebinding keeps held inputs.
+	bindings.Actions[0].Keys.push_back( Key::A );
+	actions.SetBindings( bindings );
+	EXPECT_TRUE( actions.IsHeld( jump ) );
+	EXPECT_EQ( -1.0f, actions.GetAxis( strafe ) );
+	keyboard.OnWindowKeyUp( Key::A );
+	EXPECT_FALSE( actions.IsHeld( jump ) );
+	EXPECT_EQ( 0.0f, actions.GetAxis( strafe ) );
+}
+
+TEST_F( ActionMapFixture, ActionMap_LoadBindingsTest )
+{
+	YAML::Emitter e;
+	YAMLSerialiser s;
+	s.SetStream( e )
+		.Serialise( bindings );
+	s.Output( "actions.yaml" );
+
+	ActionMap& actions = actionGame.Actions;
+	ASSERT_TRUE( actions.LoadBindings<YAMLDeserialiser>( "actions.yaml" ) );
+	ASSERT_EQ( 2, actions.GetActionCount() );
+	ASSERT_EQ( 1, actions.GetAxisCount() );
+	EXPECT_EQ( 1, actions.GetActionId( "Fire" ) );
+
+	actionGame.Mouse.OnWindowMouseDown( 0, 0, Mouse::Left );
+	EXPECT_TRUE( actions.IsHeld( actions.GetActionId( "Fire" ) ) );
+	EXPECT_FALSE( actions.IsHeld( actions.GetActionId( "Jump" ) ) );
+	actionGame.Mouse.OnWindowMouseUp( 0, 0, Mouse::Left );
+
+	EXPECT_FALSE( actions.LoadBindings<YAMLDeserialiser>( "missing_actions.yaml" ) );
+	EXPECT_EQ( 2, actions.GetActionCount() );
+}
+
+TEST_F( ActionMapFixture, ActionMap_DispatchTest )
+{
+	const cbl::Uint32 actionCount = 256;
+	const cbl::Uint32 presses = 100000;
+
+	// Each key is bound to a handful of the actions.
+	ActionBindings wide;
+	for( cbl::Uint32 i = 0; i < actionCount; ++i ) {
+		ActionBinding binding;
+		std::ostringstream name;
+		name << "Action" << i;
+		binding.Name = name.str();
+		binding.Keys.push_back( Key::Code( Key::A + i % 26 ) );
+		wide.Actions.push_back( binding );
+	}
+
+	ActionMap& actions = actionGame.Actions;
+	KeyboardManager& keyboard = actionGame.Keyboard;
+	actions.SetBindings( wide );
+
+	for( cbl::Uint32 i = 0; i < presses; ++i ) {
+		keyboard.OnWindowKeyDown( Key::Code( Key::A + i % 26 ) );
+		keyboard.OnWindowKeyUp( Key::Code( Key::A + i % 26 ) );
+	}
+
+	// Each key has 9 or 10 actions bound to it.
+	EXPECT_GT( listener.pressCount, presses * 9 );
+	EXPECT_EQ( listener.pressCount, listener.releaseCount );
+}
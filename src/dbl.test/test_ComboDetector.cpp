@@ -0,0 +1,191 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_ComboDetector.cpp
+ * @brief Unit testing for the combo detector.
+ */
+
+// Precompiled Headers //
+#include <dbl/StdAfx.h>
+
+// Delectable Headers //
+#include <dbl/Core/Game.h>
+#include <dbl/Input/ComboDetector.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+// External Libraries //
+#include <algorithm>
+
+using namespace dbl;
+
+class ComboListener
+{
+public:
+	void OnCombo( cbl::Uint32 id )
+	{
+		hits.push_back( id );
+	}
+
+	std::vector< cbl::Uint32 >	hits;
+};
+
+class ComboDetectorFixture : public ::testing::Test
+{
+public:
+	ComboDetectorFixture()
+		: comboGame( "ComboDetectorFixture" )
+		, combos( comboGame )
+	{
+	}
+
+	void SetUp()
+	{
+		combos.OnCombo += E::Combo::Method<CBL_E_METHOD(ComboListener,OnCombo)>(&listener);
+	}
+
+	void TearDown()
+	{
+		combos.OnCombo -= E::Combo::Method<CBL_E_METHOD(ComboListener,OnCombo)>(&listener);
+	}
+
+protected:
+	Game				comboGame;
+	ComboDetector		combos;
+	ComboListener		listener;
+};
+
+TEST_F( ComboDetectorFixture, ComboDetector_ChordTest )
+{
+	const cbl::Uint32 save = combos.AddChord( Key::S, Key::Modifier::Ctrl );
+	const cbl::Uint32 cut = combos.AddChord( Key::X, Key::Modifier::Ctrl | Key::Modifier::Shift );
+	EXPECT_EQ( ComboDetector::sInvalidId, combos.AddChord( Key::Count, 0 ) );
+
+	// Holding the modifiers doesn't break anything.
+	combos.ProcessKey( Key::LCtrl, Key::Modifier::Ctrl, 0.0 );
+	combos.ProcessKey( Key::S, Key::Modifier::Ctrl, 0.1 );
+	ASSERT_EQ( 1, listener.hits.size() );
+	EXPECT_EQ( save, listener.hits[0] );
+
+	// Modifiers must match exactly.
+	combos.ProcessKey( Key::S, 0, 0.2 );
+	combos.ProcessKey( Key::X, Key::Modifier::Ctrl, 0.3 );
+	EXPECT_EQ( 1, listener.hits.size() );
+
+	combos.ProcessKey( Key::LShift, Key::Modifier::Ctrl | Key::Modifier::Shift, 1.0 );
+	combos.ProcessKey( Key::X, Key::Modifier::Ctrl | Key::Modifier::Shift, 1.1 );
+	ASSERT_EQ( 2, listener.hits.size() );
+	EXPECT_EQ( cut, listener.hits[1] );
+}
+
+TEST_F( ComboDetectorFixture, ComboDetector_SequenceTest )
+{
+	const cbl::Uint32 dash = combos.AddDoubleTap( Key::W, 0.25 );
+	ComboStep fireball[3] = { ComboStep( Key::Down ), ComboStep( Key::Right ), ComboStep( Key::P ) };
+	const cbl::Uint32 fireballId = combos.AddSequence( fireball, 3, 0.2 );
+	ComboStep uppercut[3] = { ComboStep( Key::Right ), ComboStep( Key::Down ), ComboStep( Key::Right ) };
+	const cbl::Uint32 uppercutId = combos.AddSequence( uppercut, 3, 0.2 );
+	ComboStep jab[2] = { ComboStep( Key::Right ), ComboStep( Key::P ) };
+	const cbl::Uint32 jabId = combos.AddSequence( jab, 2, 0.2 );
+
+	// Taps too far apart don't count.
+	combos.ProcessKey( Key::W, 0, 2.0 );
+	combos.ProcessKey( Key::W, 0, 2.5 );
+	EXPECT_TRUE( listener.hits.empty() );
+	combos.ProcessKey( Key::W, 0, 2.6 );
+	ASSERT_EQ( 1, listener.hits.size() );
+	EXPECT_EQ( dash, listener.hits[0] );
+
+	// A triple tap is a single double tap.
+	combos.ProcessKey( Key::W, 0, 2.7 );
+	EXPECT_EQ( 1, listener.hits.size() );
+	listener.hits.clear();
+
+	// Combos that end in the same suffix complete together.
+	combos.ProcessKey( Key::Down, 0, 3.0 );
+	combos.ProcessKey( Key::Right, 0, 3.1 );
+	combos.ProcessKey( Key::P, 0, 3.2 );
+	ASSERT_EQ( 2, listener.hits.size() );
+	EXPECT_EQ( fireballId, listener.hits[0] );
+	EXPECT_EQ( jabId, listener.hits[1] );
+	listener.hits.clear();
+
+	// Other keys break a sequence.
+	combos.ProcessKey( Key::Down, 0, 4.0 );
+	combos.ProcessKey( Key::Q, 0, 4.05 );
+	combos.ProcessKey( Key::Right, 0, 4.1 );
+	combos.ProcessKey( Key::P, 0, 4.2 );
+	ASSERT_EQ( 1, listener.hits.size() );
+	EXPECT_EQ( jabId, listener.hits[0] );
+	listener.hits.clear();
+
+	// Sequences that overlap their own prefix.
+	combos.ProcessKey( Key::Right, 0, 5.0 );
+	combos.ProcessKey( Key::Down, 0, 5.1 );
+	combos.ProcessKey( Key::Right, 0, 5.2 );
+	ASSERT_EQ( 1, listener.hits.size() );
+	EXPECT_EQ( uppercutId, listener.hits[0] );
+}
+
+TEST_F( ComboDetectorFixture, ComboDetector_KeyboardTest )
+{
+	const cbl::Uint32 save = combos.AddChord( Key::S, Key::Modifier::Ctrl );
+	combos.Initialise();
+
+	comboGame.Keyboard.OnWindowKeyDown( Key::LCtrl );
+	comboGame.Keyboard.OnWindowKeyDown( Key::S );
+	ASSERT_EQ( 1, listener.hits.size() );
+	EXPECT_EQ( save, listener.hits[0] );
+
+	// Held keys don't repeat the combo.
+	comboGame.Keyboard.Update( cbl::GameTime() );
+	comboGame.Keyboard.OnWindowKeyDown( Key::S );
+	EXPECT_EQ( 1, listener.hits.size() );
+
+	combos.Shutdown();
+}
+
+TEST_F( ComboDetectorFixture, ComboDetector_ManyCombosTest )
+{
+	const cbl::Uint32 comboCount = 1000;
+	const cbl::Uint32 target = 123;
+
+	cbl::Uint32 targetId = ComboDetector::sInvalidId;
+	ComboStep targetSteps[4];
+	for( cbl::Uint32 i = 0; i < comboCount; ++i ) {
+		ComboStep steps[4];
+		for( cbl::Uint32 j = 0; j < 4; ++j )
+			steps[j] = ComboStep( Key::Code( Key::A + ( i >> ( j * 2 ) ) % 26 ) );
+		const cbl::Uint32 id = combos.AddSequence( steps, 4, 1.0 );
+		if( i == target ) {
+			targetId = id;
+			std::copy( steps, steps + 4, targetSteps );
+		}
+	}
+
+	// Sequences share their common prefixes.
+	const cbl::Uint32 states = combos.GetStateCount();
+	EXPECT_GT( states, 4u );
+	EXPECT_LE( states, comboCount * 4 + 1 );
+
+	for( cbl::Uint32 j = 0; j < 4; ++j )
+		combos.ProcessKey( targetSteps[j].Code, 0, j * 0.1 );
+	EXPECT_TRUE( std::find( listener.hits.begin(), listener.hits.end(), targetId ) != listener.hits.end() );
+}
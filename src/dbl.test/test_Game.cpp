@@ -27,6 +27,11 @@
 // Delectable Headers //
 #include <dbl/Core/Game.h>
 
+// External Libraries //
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
 // Google Test //
 #include <gtest/gtest.h>
 
@@ -62,6 +67,37 @@ protected:
 
 		cbl::Float64		Timeout;
 	};
+
+	class PacedGame : public ::dbl::Game
+	{
+	public:
+		explicit PacedGame( const cbl::Char * name, cbl::Uint32 frames )
+			: Game( name ),
+			Frames( frames )
+		{
+		}
+
+	public:
+
+		virtual void Update( cbl::GameTime const & time )
+		{
+			Game::Update( time );
+
+			// Record the deadline the pacer set and the clock once it returned.
+			Deadlines.push_back( Pacer.GetNextFrame() );
+			Times.push_back( Window.GetInputTime() );
+			if( Deadlines.size() >= Frames )
+			{
+				this->Exit();
+			}
+		}
+
+	public:
+
+		cbl::Uint32					Frames;
+		std::vector< cbl::Float64 >	Deadlines;
+		std::vector< cbl::Float64 >	Times;
+	};
 public:
 	GameFixture()
 		: windowedGame( "Windowed Game", 2.0 )
@@ -76,4 +112,102 @@ protected:
 TEST_F( GameFixture, GameFixture_Test )
 {
 	windowedGame.Run();
-}
\ No newline at end of file
+}
+
+TEST_F( GameFixture, GameFixture_HeadlessTest )
+{
+	// Run the full component stack without a display, driven by injected input.
+	const bool headless = GameWindow::sHeadless;
+	GameWindow::sHeadless = true;
+
+	TestGame headlessGame( "Headless Game", 0.5 );
+	headlessGame.Window.InjectInputEvent( InputEvent::Make( InputEventType::KeyDown, 0.0, Key::Space ) );
+	headlessGame.Run();
+	GameWindow::sHeadless = headless;
+
+	EXPECT_TRUE( headlessGame.Window.IsHeadless() );
+	EXPECT_TRUE( headlessGame.Keyboard.IsKeyDown( Key::Space ) );
+}
+
+TEST_F( GameFixture, GameFixture_FramePacing )
+{
+	const bool headless = GameWindow::sHeadless;
+	GameWindow::sHeadless = true;
+
+	// Idle throttling is opt-in.
+	PacedGame unthrottledGame( "Unthrottled Game", 5 );
+	unthrottledGame.Window.InjectInputEvent( InputEvent::Make( InputEventType::LostFocus, 0.0 ) );
+	unthrottledGame.Run();
+	EXPECT_EQ( 0.0, unthrottledGame.Pacer.GetIdleFrameRate() );
+	EXPECT_TRUE( unthrottledGame.Pacer.IsIdle() );
+	EXPECT_EQ( 0.0, unthrottledGame.Pacer.GetWaitTime() );
+
+	// Focused deadlines advance by whole periods and are never run ahead of.
+	const cbl::Float64 period = 1.0 / 60.0;
+	PacedGame pacedGame( "Paced Game", 10 );
+	pacedGame.Pacer.SetFrameRate( 60.0 );
+	pacedGame.Run();
+	EXPECT_FALSE( pacedGame.Pacer.IsIdle() );
+	ASSERT_GE( pacedGame.Deadlines.size(), 10u );
+	for( size_t i = 1; i < pacedGame.Deadlines.size(); ++i )
+	{
+		EXPECT_GE( pacedGame.Deadlines[i] - pacedGame.Deadlines[i - 1], period - 1e-9 );
+		EXPECT_GE( pacedGame.Times[i], pacedGame.Deadlines[i - 1] );
+	}
+
+	// Losing focus with an idle frame rate schedules the next frame no more than an idle period out.
+	const cbl::Float64 idlePeriod = 1.0 / 10.0;
+	PacedGame idleGame( "Idle Game", 3 );
+	idleGame.Pacer.SetIdleFrameRate( 10.0 );
+	idleGame.Window.InjectInputEvent( InputEvent::Make( InputEventType::LostFocus, 0.0 ) );
+	idleGame.Run();
+	EXPECT_TRUE( idleGame.Pacer.IsIdle() );
+	for( size_t i = 0; i < idleGame.Deadlines.size(); ++i )
+		EXPECT_LE( idleGame.Deadlines[i] - idleGame.Times[i], idlePeriod + 1e-9 );
+
+	GameWindow::sHeadless = headless;
+}
+
+TEST_F( GameFixture, GameFixture_DeferredStartup )
+{
+	const bool headless = GameWindow::sHeadless;
+	const bool deferCreation = GameWindow::sDeferCreation;
+	const bool logStartup = Game::sLogStartupReport;
+	GameWindow::sHeadless = true;
+	GameWindow::sDeferCreation = true;
+	Game::sLogStartupReport = true;
+
+	{
+		std::ofstream level( "prefetch_level.yaml" );
+		for( cbl::Uint32 i = 0; i < 1000; ++i )
+			level << "- Object: " << i << "\n";
+	}
+
+	TestGame deferredGame( "Deferred Game", 0.2 );
+	deferredGame.Levels.Prefetch( "prefetch_level.yaml" );
+	deferredGame.Run();
+
+	GameWindow::sHeadless = headless;
+	GameWindow::sDeferCreation = deferCreation;
+	Game::sLogStartupReport = logStartup;
+	std::remove( "prefetch_level.yaml" );
+
+	// The window is created by the first update, after the other components initialise.
+	EXPECT_GT( deferredGame.Window.GetFrameIndex(), 0u );
+	ASSERT_TRUE( deferredGame.Startup.IsFinished() );
+	EXPECT_GT( deferredGame.Startup.GetTotalTime(), 0.0 );
+
+	bool resolutions = false, creation = false, prefetch = false;
+	const StartupReport::PhaseList & phases = deferredGame.Startup.GetPhases();
+	for( size_t i = 0; i < phases.size(); ++i ) {
+		if( phases[i].Name == "Window resolutions" )
+			resolutions = phases[i].Background;
+		else if( phases[i].Name == "Window creation" )
+			creation = !phases[i].Background;
+		else if( phases[i].Name == "Level prefetch: prefetch_level.yaml" )
+			prefetch = phases[i].Background;
+	}
+	EXPECT_TRUE( resolutions );
+	EXPECT_TRUE( creation );
+	EXPECT_TRUE( prefetch );
+}
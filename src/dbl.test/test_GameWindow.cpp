@@ -26,11 +26,33 @@
 
 // Delectable Headers //
 #include <dbl/Core/GameWindow.h>
+#include <dbl/Core/DisplayModeCache.h>
+#include <dbl/Core/FrameTimer.h>
+#include <dbl/Serialisation/JSONWriter.h>
+#include <dbl/Threading/Thread.h>
 
 // Chewable Headers //
 #include <cbl/Util/Stopwatch.h>
 #include <cbl/Core/Game.h>
 
+// External Libraries //
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+#include <direct.h>
+#define _makeFolder( path )		_mkdir( path )
+#define _removeFolder( path )	_rmdir( path )
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#include <xcb/xcb.h>
+#include <X11/keysym.h>
+#define _makeFolder( path )		mkdir( path, 0755 )
+#define _removeFolder( path )	rmdir( path )
+#endif
+
 // Google Test //
 #include <gtest/gtest.h>
 
@@ -284,4 +306,755 @@ TEST_F( GameWindowFixture, GameWindow_BestWindowSize )
 	ASSERT_FALSE( windowDestroyed );
 	gameWindow.Shutdown();
 	ASSERT_TRUE( windowDestroyed );
-}
\ No newline at end of file
+}
+struct InputQueueListener
+{
+	InputQueueListener( GameWindow& window )
+		: Window( window ), KeyDownTime( -1.0 ), Batches( 0 )
+	{
+	}
+
+	void OnWindowKeyDown( Key::Code )
+	{
+		KeyDownTime = Window.GetInputEventTime();
+	}
+
+	void OnWindowInputBatch( const InputEventList& events )
+	{
+		++Batches;
+		Events.insert( Events.end(), events.begin(), events.end() );
+	}
+
+	GameWindow&		Window;
+	cbl::Float64	KeyDownTime;
+	cbl::Uint32		Batches;
+	InputEventList	Events;
+};
+
+TEST_F( GameWindowFixture, GameWindow_InputQueue )
+{
+	gameWindow.Initialise();
+
+	InputQueueListener listener( gameWindow );
+	gameWindow.OnWindowKeyDown		+= E::WindowKeyDown::Method<CBL_E_METHOD(InputQueueListener,OnWindowKeyDown)>(&listener);
+	gameWindow.OnWindowInputBatch	+= E::WindowInputBatch::Method<CBL_E_METHOD(InputQueueListener,OnWindowInputBatch)>(&listener);
+
+	// Flush anything the platform queued while creating the window.
+	gameWindow.Update( cbl::GameTime() );
+	listener.Events.clear();
+	listener.Batches = 0;
+
+	cbl::Float64 now = gameWindow.GetInputTime();
+	ASSERT_TRUE( gameWindow.PushInputEvent( InputEvent::Make( InputEventType::KeyDown, now + 0.001, Key::Q ) ) );
+	ASSERT_TRUE( gameWindow.PushInputEvent( InputEvent::Make( InputEventType::MouseMove, now + 0.002, 0, 10, 20 ) ) );
+	ASSERT_TRUE( gameWindow.PushInputEvent( InputEvent::Make( InputEventType::KeyUp, now + 0.003, Key::Q ) ) );
+
+	// Nothing is delivered until the window updates.
+	EXPECT_EQ( 0, listener.Batches );
+	EXPECT_LT( listener.KeyDownTime, 0.0 );
+
+	gameWindow.Update( cbl::GameTime() );
+	EXPECT_EQ( 1, listener.Batches );
+	EXPECT_DOUBLE_EQ( now + 0.001, listener.KeyDownTime );
+
+	std::vector< cbl::Uint32 > types;
+	for( size_t i = 0; i < listener.Events.size(); ++i )
+		if( listener.Events[i].Time > now )
+			types.push_back( listener.Events[i].Type );
+	ASSERT_EQ( 3, types.size() );
+	EXPECT_EQ( InputEventType::KeyDown, types[0] );
+	EXPECT_EQ( InputEventType::MouseMove, types[1] );
+	EXPECT_EQ( InputEventType::KeyUp, types[2] );
+
+	// Overflowing the queue drops events instead of blocking the platform layer.
+	cbl::Uint32 pushed = 0;
+	while( gameWindow.PushInputEvent( InputEvent::Make( InputEventType::KeyChar, now, 'x' ) ) )
+		++pushed;
+	EXPECT_GE( pushed, GameWindow::sInputQueueSize );
+	EXPECT_EQ( 1, gameWindow.GetDroppedInputEvents() );
+	gameWindow.Update( cbl::GameTime() );
+
+	gameWindow.OnWindowInputBatch	-= E::WindowInputBatch::Method<CBL_E_METHOD(InputQueueListener,OnWindowInputBatch)>(&listener);
+	gameWindow.OnWindowKeyDown		-= E::WindowKeyDown::Method<CBL_E_METHOD(InputQueueListener,OnWindowKeyDown)>(&listener);
+	gameWindow.Shutdown();
+}
+
+TEST_F( GameWindowFixture, GameWindow_InputThread )
+{
+	gameWindow.Initialise();
+
+	const cbl::Uint32 sequence = gameWindow.GetInputState().Sequence;
+	if( !gameWindow.SetInputThreadEnabled( true ) ) {
+		Stdout << "[GameWindow] Input thread is not supported on this platform." << std::endl;
+		gameWindow.Shutdown();
+		return;
+	}
+	ASSERT_TRUE( gameWindow.IsInputThreadEnabled() );
+
+	stopwatch.Start();
+	while( gameWindow.GetInputState().Sequence == sequence && stopwatch.GetElapsedTime().TotalSeconds() < timeout )
+	{
+		gameWindow.Update( cbl::GameTime() );
+	}
+	stopwatch.Stop();
+
+	EXPECT_GT( gameWindow.GetInputState().Sequence, sequence );
+
+	ASSERT_TRUE( gameWindow.SetInputThreadEnabled( false ) );
+	ASSERT_FALSE( gameWindow.IsInputThreadEnabled() );
+	gameWindow.Shutdown();
+}
+
+TEST_F( GameWindowFixture, GameWindow_Headless )
+{
+	const bool headless = GameWindow::sHeadless;
+	GameWindow::sHeadless = true;
+	gameWindow.Initialise();
+	GameWindow::sHeadless = headless;
+
+	ASSERT_TRUE( gameWindow.IsHeadless() );
+	EXPECT_TRUE( gameWindow.GetGameWindowHandle() == NULL );
+	EXPECT_TRUE( gameWindow.GetDesktopResolution() == GameWindow::sVirtualResolution );
+	EXPECT_EQ( gameWindow.GetResolution().Width, gameWindow.GetWindowDimensions().Width );
+	EXPECT_TRUE( gameWindow.SetRelativeMouseMode( true ) );
+
+	InputQueueListener listener( gameWindow );
+	gameWindow.OnWindowKeyDown		+= E::WindowKeyDown::Method<CBL_E_METHOD(InputQueueListener,OnWindowKeyDown)>(&listener);
+	gameWindow.OnWindowInputBatch	+= E::WindowInputBatch::Method<CBL_E_METHOD(InputQueueListener,OnWindowInputBatch)>(&listener);
+
+	// Injected events are stamped on arrival and delivered on the next update.
+	ASSERT_TRUE( gameWindow.InjectInputEvent( InputEvent::Make( InputEventType::KeyDown, 0.0, Key::Q ) ) );
+	gameWindow.CenterCursorPosition();
+	gameWindow.Update( cbl::GameTime() );
+	EXPECT_EQ( 1, listener.Batches );
+	EXPECT_GT( listener.KeyDownTime, 0.0 );
+	ASSERT_EQ( 2, listener.Events.size() );
+	EXPECT_EQ( InputEventType::MouseMove, listener.Events[1].Type );
+	EXPECT_EQ( cbl::Int32( gameWindow.GetWindowDimensions().Width / 2 ), listener.Events[1].X );
+
+	// Nothing arrives unless it is injected.
+	for( cbl::Uint32 i = 0; i < 100; ++i )
+		gameWindow.Update( cbl::GameTime() );
+	EXPECT_EQ( 1, listener.Batches );
+
+	gameWindow.OnWindowInputBatch	-= E::WindowInputBatch::Method<CBL_E_METHOD(InputQueueListener,OnWindowInputBatch)>(&listener);
+	gameWindow.OnWindowKeyDown		-= E::WindowKeyDown::Method<CBL_E_METHOD(InputQueueListener,OnWindowKeyDown)>(&listener);
+	gameWindow.Shutdown();
+}
+
+struct WindowEventListener
+{
+	WindowEventListener()
+		: Closed( 0 ), Resized( 0 ), Width( 0 )
+	{
+	}
+
+	void OnWindowClosed( void )
+	{
+		++Closed;
+	}
+
+	void OnWindowResized( cbl::Uint32, cbl::Uint32, cbl::Uint32 width, cbl::Uint32, cbl::Uint16, cbl::Real )
+	{
+		++Resized;
+		Width = width;
+	}
+
+	cbl::Uint32		Closed;
+	cbl::Uint32		Resized;
+	cbl::Uint32		Width;
+};
+
+void _postWindowEvents( void * arg )
+{
+	GameWindow* window = static_cast< GameWindow* >( arg );
+	window->PostWindowEvent( WindowEvent::MakeResized( 800, 600, 800, 600, 32, 800.0f / 600.0f ) );
+	window->PostWindowEvent( WindowEvent::Make( WindowEventType::Closed ) );
+}
+
+TEST_F( GameWindowFixture, GameWindow_PostWindowEvent )
+{
+	const bool headless = GameWindow::sHeadless;
+	GameWindow::sHeadless = true;
+	gameWindow.Initialise();
+	GameWindow::sHeadless = headless;
+
+	WindowEventListener listener;
+	gameWindow.OnWindowClosed	+= E::WindowClosed::Method<CBL_E_METHOD(WindowEventListener,OnWindowClosed)>(&listener);
+	gameWindow.OnWindowResized	+= E::WindowSize::Method<CBL_E_METHOD(WindowEventListener,OnWindowResized)>(&listener);
+
+	// The window posts its initial size when it's created.
+	gameWindow.Update( cbl::GameTime() );
+	EXPECT_EQ( 1, listener.Resized );
+	EXPECT_EQ( gameWindow.GetWindowDimensions().Width, listener.Width );
+
+	// Events posted from another thread are only raised on the main thread's update.
+	Thread producer;
+	ASSERT_TRUE( producer.Start( &_postWindowEvents, &gameWindow ) );
+	producer.Join();
+	EXPECT_EQ( 0, listener.Closed );
+
+	gameWindow.Update( cbl::GameTime() );
+	EXPECT_EQ( 2, listener.Resized );
+	EXPECT_EQ( 800, listener.Width );
+	EXPECT_EQ( 1, listener.Closed );
+	EXPECT_EQ( 0, gameWindow.GetDroppedWindowEvents() );
+
+	gameWindow.OnWindowResized	-= E::WindowSize::Method<CBL_E_METHOD(WindowEventListener,OnWindowResized)>(&listener);
+	gameWindow.OnWindowClosed	-= E::WindowClosed::Method<CBL_E_METHOD(WindowEventListener,OnWindowClosed)>(&listener);
+	gameWindow.Shutdown();
+}
+
+struct DragDropListener
+{
+	DragDropListener()
+		: Batches( 0 ), LastBatches( 0 ), BatchFiles( 0 ), Drops( 0 ), DropFiles( 0 )
+	{
+	}
+
+	void OnWindowDragDropBatch( cbl::Int32, cbl::Int32, const cbl::FileInfo::List & files, bool last )
+	{
+		++Batches;
+		BatchFiles += cbl::Uint32( files.size() );
+		if( last )
+			++LastBatches;
+	}
+
+	void OnWindowDragDrop( cbl::Int32, cbl::Int32, const cbl::FileInfo::List & files )
+	{
+		++Drops;
+		DropFiles = cbl::Uint32( files.size() );
+	}
+
+	cbl::Uint32		Batches;
+	cbl::Uint32		LastBatches;
+	cbl::Uint32		BatchFiles;
+	cbl::Uint32		Drops;
+	cbl::Uint32		DropFiles;
+};
+
+TEST_F( GameWindowFixture, GameWindow_DragDropBatches )
+{
+	static const cbl::Uint32 sFolderFiles = 300;
+
+	// Build a small tree: dragdrop/a/<300 files>, dragdrop/b/c/leaf.txt and a loose file.
+	_makeFolder( "dragdrop" );
+	_makeFolder( "dragdrop/a" );
+	_makeFolder( "dragdrop/b" );
+	_makeFolder( "dragdrop/b/c" );
+	std::vector< cbl::String > created;
+	for( cbl::Uint32 i = 0; i < sFolderFiles; ++i ) {
+		std::ostringstream name;
+		name << "dragdrop/a/file" << i << ".txt";
+		created.push_back( name.str() );
+	}
+	created.push_back( "dragdrop/b/c/leaf.txt" );
+	created.push_back( "dragdrop_loose.txt" );
+	for( size_t i = 0; i < created.size(); ++i )
+		std::ofstream( created[i].c_str() ) << i;
+
+	const bool headless = GameWindow::sHeadless;
+	const cbl::Uint32 batchSize = GameWindow::sDragDropBatchSize;
+	GameWindow::sHeadless = true;
+	GameWindow::sDragDropBatchSize = 64;
+	gameWindow.Initialise();
+
+	DragDropListener listener;
+	gameWindow.OnWindowDragDropBatch	+= E::WindowDragDropBatch::Method<CBL_E_METHOD(DragDropListener,OnWindowDragDropBatch)>(&listener);
+	gameWindow.OnWindowDragDrop			+= E::WindowDragDrop::Method<CBL_E_METHOD(DragDropListener,OnWindowDragDrop)>(&listener);
+
+	std::vector< cbl::String > paths;
+	paths.push_back( "dragdrop" );
+	paths.push_back( "dragdrop_loose.txt" );
+	gameWindow.DropFiles( 10, 20, paths );
+
+	// Dropping never blocks the window; files turn up over the following updates.
+	stopwatch.Start();
+	while( listener.Drops == 0 && stopwatch.GetElapsedTime().TotalSeconds() < 5.0 )
+		gameWindow.Update( cbl::GameTime() );
+	stopwatch.Stop();
+
+	EXPECT_EQ( 1, listener.Drops );
+	EXPECT_EQ( 1, listener.LastBatches );
+	EXPECT_GE( listener.Batches, created.size() / 64 );
+	EXPECT_EQ( created.size(), listener.BatchFiles );
+	EXPECT_EQ( created.size(), listener.DropFiles );
+
+	gameWindow.OnWindowDragDrop			-= E::WindowDragDrop::Method<CBL_E_METHOD(DragDropListener,OnWindowDragDrop)>(&listener);
+	gameWindow.OnWindowDragDropBatch	-= E::WindowDragDropBatch::Method<CBL_E_METHOD(DragDropListener,OnWindowDragDropBatch)>(&listener);
+	gameWindow.Shutdown();
+	GameWindow::sDragDropBatchSize = batchSize;
+	GameWindow::sHeadless = headless;
+
+	for( size_t i = 0; i < created.size(); ++i )
+		std::remove( created[i].c_str() );
+	_removeFolder( "dragdrop/b/c" );
+	_removeFolder( "dragdrop/b" );
+	_removeFolder( "dragdrop/a" );
+	_removeFolder( "dragdrop" );
+}
+
+TEST( DisplayModeCache, DisplayModeCache_FindStore )
+{
+	const cbl::FileInfo cacheFile = DisplayModeCache::sCacheFile;
+	DisplayModeCache::sCacheFile = cbl::FileInfo( "displaymodes_test.bin" );
+	DisplayModeCache::Invalidate();
+
+	DisplayModeCache::DisplayModeList modes;
+	modes.push_back( GameWindowSize( 1920, 1080, 32 ) );
+	modes.push_back( GameWindowSize( 800, 600, 32 ) );
+	modes.push_back( GameWindowSize( 1920, 1080, 32 ) );
+	modes.push_back( GameWindowSize( 800, 600, 16 ) );
+	DisplayModeCache::Sort( modes );
+	ASSERT_EQ( 3, modes.size() );
+	EXPECT_TRUE( modes[0] == GameWindowSize( 800, 600, 16 ) );
+	EXPECT_TRUE( modes[2] == GameWindowSize( 1920, 1080, 32 ) );
+
+	DisplayModeCache::DisplayModeList found;
+	EXPECT_FALSE( DisplayModeCache::Find( "Monitor", found ) );
+	DisplayModeCache::Store( "Monitor", modes );
+	ASSERT_TRUE( DisplayModeCache::Find( "Monitor", found ) );
+	EXPECT_EQ( modes.size(), found.size() );
+	EXPECT_FALSE( DisplayModeCache::Find( "Other monitor", found ) );
+
+	std::ifstream file( "displaymodes_test.bin", std::ios::in | std::ios::binary );
+	EXPECT_TRUE( file.is_open() );
+	file.close();
+
+	// A display change discards everything.
+	const cbl::Uint32 generation = DisplayModeCache::GetGeneration();
+	DisplayModeCache::Invalidate();
+	EXPECT_NE( generation, DisplayModeCache::GetGeneration() );
+	EXPECT_FALSE( DisplayModeCache::Find( "Monitor", found ) );
+
+	DisplayModeCache::sCacheFile = cacheFile;
+	std::remove( "displaymodes_test.bin" );
+}
+
+TEST( FrameTimer, FrameTimer_StatsAndTrace )
+{
+	static const cbl::Uint32 sFrames = 150;
+
+	// 10ms frames with a 40ms hitch every 50 frames, into a buffer that only holds 100.
+	FrameTimer timer( 100 );
+	cbl::Float64 time = 1.0;
+	for( cbl::Uint32 frame = 1; frame <= sFrames + 1; ++frame ) {
+		timer.BeginFrame( frame, time );
+		timer.Lap( FramePhase::Pump, time + 0.001 );
+		timer.Lap( FramePhase::Update, time + 0.006 );
+		timer.Lap( FramePhase::Wait, time + 0.008 );
+		time += frame % 50 == 0 ? 0.04 : 0.01;
+	}
+
+	ASSERT_EQ( 100, timer.GetCount() );
+	EXPECT_EQ( sFrames - 99, timer.GetFrame( 0 ).Frame );
+	EXPECT_EQ( sFrames, timer.GetLastFrame().Frame );
+	EXPECT_NEAR( 0.04, timer.GetLastFrame().Duration, 1e-9 );
+	EXPECT_NEAR( 0.005, timer.GetLastFrame().Phases[FramePhase::Update].Duration, 1e-9 );
+	EXPECT_NEAR( 0.032, timer.GetLastFrame().Phases[FramePhase::Draw].Duration, 1e-9 );
+
+	FrameStats stats;
+	timer.GetStats( stats );
+	EXPECT_EQ( 100, stats.Frames );
+	EXPECT_NEAR( 0.01, stats.P50, 1e-9 );
+	EXPECT_NEAR( 0.04, stats.P99, 1e-9 );
+	EXPECT_NEAR( 0.04, stats.Max, 1e-9 );
+	EXPECT_EQ( 2, stats.Hitches );
+
+	// Every frame and each of its four phases is a complete event.
+	JSONWriter writer;
+	timer.WriteTrace( writer );
+	EXPECT_TRUE( writer.IsComplete() );
+	const cbl::String & trace = writer.GetString();
+	size_t events = 0;
+	for( size_t at = trace.find( "\"ph\":\"X\"" ); at != cbl::String::npos; at = trace.find( "\"ph\":\"X\"", at + 1 ) )
+		++events;
+	EXPECT_EQ( 100 * ( 1 + FramePhase::Count ), events );
+	EXPECT_NE( cbl::String::npos, trace.find( "\"cat\":\"hitch\"" ) );
+
+	timer.Clear();
+	EXPECT_EQ( 100, timer.GetCapacity() );
+	EXPECT_EQ( 0, timer.GetCount() );
+}
+
+TEST( FrameTimer, FrameTimer_RepeatedLaps )
+{
+	FrameTimer timer( 4 );
+	timer.BeginFrame( 1, 1.0 );
+	timer.Lap( FramePhase::Pump, 1.001 );
+	timer.Lap( FramePhase::Update, 1.003 );
+	timer.Lap( FramePhase::Pump, 1.004 );
+	timer.Lap( FramePhase::Pump, 1.005 );
+	timer.Lap( FramePhase::Wait, 1.008 );
+	timer.BeginFrame( 2, 1.010 );
+
+	// Pump is lapped twice around Update; its total covers both, but each lap is its own span.
+	const FrameTiming & frame = timer.GetLastFrame();
+	EXPECT_NEAR( 0.003, frame.Phases[FramePhase::Pump].Duration, 1e-9 );
+	ASSERT_EQ( 5, frame.LapCount );
+	EXPECT_EQ( FramePhase::Pump, frame.Laps[2].Phase );
+	EXPECT_NEAR( 0.002, frame.Laps[2].Duration, 1e-9 );
+	EXPECT_EQ( FramePhase::Draw, frame.Laps[4].Phase );
+
+	cbl::Float64 end = frame.Start;
+	for( cbl::Uint32 i = 0; i < frame.LapCount; ++i ) {
+		EXPECT_NEAR( end, frame.Laps[i].Start, 1e-9 );
+		end = frame.Laps[i].Start + frame.Laps[i].Duration;
+	}
+	EXPECT_NEAR( frame.Start + frame.Duration, end, 1e-9 );
+
+	// Laps past the limit still count towards the phase totals.
+	const cbl::Uint32 maxLaps = FrameTiming::sMaxLaps;
+	cbl::Float64 time = 2.0;
+	timer.BeginFrame( 3, time );
+	for( cbl::Uint32 i = 0; i < maxLaps * 2; ++i )
+		timer.Lap( i % 2 ? FramePhase::Update : FramePhase::Pump, time += 0.001 );
+	timer.BeginFrame( 4, time );
+	EXPECT_EQ( maxLaps, timer.GetLastFrame().LapCount );
+	EXPECT_NEAR( 0.001 * maxLaps, timer.GetLastFrame().Phases[FramePhase::Update].Duration, 1e-9 );
+}
+
+struct DisplayChangeListener
+{
+	DisplayChangeListener() : Changes( 0 ) {}
+	void OnWindowDisplayChanged( void ) { ++Changes; }
+	cbl::Uint32 Changes;
+};
+
+TEST_F( GameWindowFixture, GameWindow_DisplayChanged )
+{
+	const bool headless = GameWindow::sHeadless;
+	GameWindow::sHeadless = true;
+	gameWindow.Initialise();
+	GameWindow::sHeadless = headless;
+
+	EXPECT_TRUE( gameWindow.IsValidResolution( GameWindow::sVirtualResolution.Width, GameWindow::sVirtualResolution.Height ) );
+	EXPECT_FALSE( gameWindow.IsValidResolution( 1, 1 ) );
+
+	DisplayChangeListener listener;
+	gameWindow.OnWindowDisplayChanged += E::WindowDisplayChanged::Method<CBL_E_METHOD(DisplayChangeListener,OnWindowDisplayChanged)>(&listener);
+
+	// Resolutions are only refreshed when the display changes.
+	const GameWindowSize virtualResolution = GameWindow::sVirtualResolution;
+	GameWindow::sVirtualResolution = GameWindowSize( 640, 480, 32 );
+	gameWindow.Update( cbl::GameTime() );
+	EXPECT_EQ( 0, listener.Changes );
+	EXPECT_FALSE( gameWindow.IsValidResolution( 640, 480 ) );
+
+	ASSERT_TRUE( gameWindow.PostWindowEvent( WindowEvent::Make( WindowEventType::DisplayChanged ) ) );
+	gameWindow.Update( cbl::GameTime() );
+	EXPECT_EQ( 1, listener.Changes );
+	EXPECT_TRUE( gameWindow.IsValidResolution( 640, 480 ) );
+	EXPECT_TRUE( gameWindow.GetDesktopResolution() == GameWindow::sVirtualResolution );
+	GameWindow::sVirtualResolution = virtualResolution;
+
+	gameWindow.OnWindowDisplayChanged -= E::WindowDisplayChanged::Method<CBL_E_METHOD(DisplayChangeListener,OnWindowDisplayChanged)>(&listener);
+	gameWindow.Shutdown();
+}
+
+TEST_F( GameWindowFixture, GameWindow_DeferCreation )
+{
+	const bool headless = GameWindow::sHeadless;
+	const bool deferCreation = GameWindow::sDeferCreation;
+	GameWindow::sHeadless = true;
+	GameWindow::sDeferCreation = true;
+	gameWindow.Initialise();
+	GameWindow::sHeadless = headless;
+	GameWindow::sDeferCreation = deferCreation;
+
+	// Initialise only starts enumerating resolutions; they're waited on when read.
+	EXPECT_FALSE( gameWindow.IsCreated() );
+	EXPECT_FALSE( windowCreated );
+	gameWindow.SetTitle( "Deferred" );
+	EXPECT_EQ( 1, gameWindow.GetAvailableResolutions().size() );
+	EXPECT_FALSE( gameWindow.IsCreated() );
+
+	gameWindow.Update( cbl::GameTime() );
+	EXPECT_TRUE( gameWindow.IsCreated() );
+	EXPECT_TRUE( windowCreated );
+	EXPECT_EQ( cbl::String( "Deferred" ), gameWindow.GetSettings().Title );
+
+	gameWindow.Shutdown();
+	EXPECT_TRUE( windowDestroyed );
+
+	// A window that's never used is never created.
+	GameWindow unusedWindow( dummyGame );
+	GameWindow::sHeadless = true;
+	GameWindow::sDeferCreation = true;
+	unusedWindow.Initialise();
+	GameWindow::sHeadless = headless;
+	GameWindow::sDeferCreation = deferCreation;
+	unusedWindow.Shutdown();
+	EXPECT_FALSE( unusedWindow.IsCreated() );
+}
+
+TEST_F( GameWindowFixture, GameWindow_MultipleWindows )
+{
+	const bool headless = GameWindow::sHeadless;
+	GameWindow::sHeadless = true;
+	GameWindow viewport( dummyGame );
+	gameWindow.Initialise();
+	viewport.Initialise();
+	GameWindow::sHeadless = headless;
+
+	InputQueueListener mainListener( gameWindow ), viewportListener( viewport );
+	gameWindow.OnWindowInputBatch	+= E::WindowInputBatch::Method<CBL_E_METHOD(InputQueueListener,OnWindowInputBatch)>(&mainListener);
+	viewport.OnWindowInputBatch		+= E::WindowInputBatch::Method<CBL_E_METHOD(InputQueueListener,OnWindowInputBatch)>(&viewportListener);
+
+	// Each window only dispatches its own events.
+	ASSERT_TRUE( gameWindow.InjectInputEvent( InputEvent::Make( InputEventType::KeyDown, 0.0, Key::Q ) ) );
+	ASSERT_TRUE( viewport.InjectInputEvent( InputEvent::Make( InputEventType::KeyDown, 0.0, Key::W ) ) );
+	ASSERT_TRUE( viewport.InjectInputEvent( InputEvent::Make( InputEventType::KeyUp, 0.0, Key::W ) ) );
+
+	// The first window updated in a frame pumps events for both.
+	for( cbl::Uint32 frame = 1; frame <= 3; ++frame ) {
+		const cbl::Uint32 pumps = GameWindow::GetPumpCount();
+		gameWindow.Update( cbl::GameTime() );
+		viewport.Update( cbl::GameTime() );
+		EXPECT_EQ( pumps + 1, GameWindow::GetPumpCount() );
+	}
+
+	EXPECT_EQ( 1, mainListener.Batches );
+	ASSERT_EQ( 1, mainListener.Events.size() );
+	EXPECT_EQ( cbl::Uint32( Key::Q ), mainListener.Events[0].Code );
+	EXPECT_EQ( 1, viewportListener.Batches );
+	ASSERT_EQ( 2, viewportListener.Events.size() );
+	EXPECT_EQ( cbl::Uint32( Key::W ), viewportListener.Events[0].Code );
+
+	// A window updated on its own still pumps every frame.
+	const cbl::Uint32 pumps = GameWindow::GetPumpCount();
+	viewport.Update( cbl::GameTime() );
+	viewport.Update( cbl::GameTime() );
+	EXPECT_EQ( pumps + 2, GameWindow::GetPumpCount() );
+
+	viewport.OnWindowInputBatch		-= E::WindowInputBatch::Method<CBL_E_METHOD(InputQueueListener,OnWindowInputBatch)>(&viewportListener);
+	gameWindow.OnWindowInputBatch	-= E::WindowInputBatch::Method<CBL_E_METHOD(InputQueueListener,OnWindowInputBatch)>(&mainListener);
+	viewport.Shutdown();
+	gameWindow.Shutdown();
+}
+
+TEST_F( GameWindowFixture, GameWindow_PersistSettings )
+{
+	std::remove( "persist.cfg" );
+	std::remove( "persist.cfg.bin" );
+
+	const cbl::FileInfo settingsFile = GameWindow::sSettingsFile;
+	const bool headless = GameWindow::sHeadless;
+	const bool persistSettings = GameWindow::sPersistSettings;
+	const cbl::Float64 saveDelay = GameWindow::sSettingsSaveDelay;
+	GameWindow::sSettingsFile = cbl::FileInfo( "persist.cfg" );
+	GameWindow::sHeadless = true;
+	GameWindow::sPersistSettings = true;
+	GameWindow::sSettingsSaveDelay = 0.05;
+	gameWindow.Initialise();
+
+	// A burst of changes is written once, after the delay.
+	gameWindow.SetTitle( "Persisted" );
+	gameWindow.SetFullscreen( true );
+	gameWindow.Update( cbl::GameTime() );
+	EXPECT_FALSE( std::ifstream( "persist.cfg" ).is_open() );
+	Thread::Sleep( 100 );
+	gameWindow.Update( cbl::GameTime() );
+	gameWindow.FlushSettings();
+	EXPECT_TRUE( std::ifstream( "persist.cfg" ).is_open() );
+	EXPECT_TRUE( std::ifstream( "persist.cfg.bin" ).is_open() );
+	EXPECT_FALSE( std::ifstream( "persist.cfg.tmp" ).is_open() );
+	gameWindow.Shutdown();
+
+	// The next window picks the settings up from the cache.
+	GameWindow reloaded( dummyGame );
+	reloaded.Initialise();
+	EXPECT_EQ( cbl::String( "Persisted" ), reloaded.GetSettings().Title );
+	EXPECT_TRUE( reloaded.IsFullscreen() );
+	reloaded.Shutdown();
+
+	// A damaged cache falls back to the settings file and is rebuilt.
+	std::ofstream( "persist.cfg.bin", std::ios::out | std::ios::binary | std::ios::trunc ) << "DBLW";
+	GameWindow rebuilt( dummyGame );
+	rebuilt.Initialise();
+	EXPECT_EQ( cbl::String( "Persisted" ), rebuilt.GetSettings().Title );
+	rebuilt.Shutdown();
+
+	std::ifstream cache( "persist.cfg.bin", std::ios::in | std::ios::binary );
+	cache.seekg( 0, std::ios::end );
+	EXPECT_GT( cache.tellg(), std::streamoff( 4 ) );
+	cache.close();
+
+	GameWindow::sSettingsFile = settingsFile;
+	GameWindow::sHeadless = headless;
+	GameWindow::sPersistSettings = persistSettings;
+	GameWindow::sSettingsSaveDelay = saveDelay;
+	std::remove( "persist.cfg" );
+	std::remove( "persist.cfg.bin" );
+}
+
+TEST_F( GameWindowFixture, GameWindow_WaitForEvents )
+{
+	// Uses the native window when a display is available (e.g. under Xvfb).
+	gameWindow.Initialise();
+
+	// Drain the events generated by creating the window.
+	gameWindow.Update( cbl::GameTime() );
+	for( cbl::Uint32 i = 0; i < 20 && gameWindow.WaitForEvents( 0.05 ); ++i )
+		gameWindow.Update( cbl::GameTime() );
+
+	// An idle window blocks for the timeout instead of returning straight away.
+	stopwatch.Start();
+	const bool woken = gameWindow.WaitForEvents( 0.05 );
+	stopwatch.Stop();
+
+	if( !woken ) {
+		EXPECT_GE( stopwatch.GetElapsedTime().TotalSeconds(), 0.04 );
+		EXPECT_LT( stopwatch.GetElapsedTime().TotalSeconds(), 0.5 );
+	}
+
+	gameWindow.Shutdown();
+}
+
+#if CBL_PLATFORM != CBL_PLATFORM_WIN32
+struct XcbInputListener
+{
+	void OnWindowInputBatch( const InputEventList& events )
+	{
+		Events.insert( Events.end(), events.begin(), events.end() );
+	}
+
+	cbl::Uint32 Count( InputEventType::Type type, cbl::Uint32 code ) const
+	{
+		cbl::Uint32 count = 0;
+		for( size_t i = 0; i < Events.size(); ++i )
+			if( Events[i].Type == cbl::Uint32( type ) && Events[i].Code == code )
+				++count;
+		return count;
+	}
+
+	InputEventList	Events;
+};
+
+//! Send a synthetic event. With no event mask, X delivers it to the client that created the window.
+void _sendXcbEvent( xcb_connection_t * connection, xcb_window_t window, const void * ev )
+{
+	xcb_send_event( connection, 0, window, XCB_EVENT_MASK_NO_EVENT, static_cast< const char * >( ev ) );
+}
+
+xcb_keycode_t _findXcbKeycode( xcb_connection_t * connection, xcb_keysym_t keysym )
+{
+	const xcb_setup_t * setup = xcb_get_setup( connection );
+	const cbl::Uint8 count = cbl::Uint8( setup->max_keycode - setup->min_keycode + 1 );
+	xcb_get_keyboard_mapping_reply_t * reply = xcb_get_keyboard_mapping_reply( connection,
+		xcb_get_keyboard_mapping( connection, setup->min_keycode, count ), NULL );
+	if( !reply )
+		return 0;
+
+	xcb_keycode_t found = 0;
+	const xcb_keysym_t * keysyms = xcb_get_keyboard_mapping_keysyms( reply );
+	for( cbl::Uint32 i = 0; i < count && !found; ++i )
+		if( keysyms[ i * reply->keysyms_per_keycode ] == keysym )
+			found = xcb_keycode_t( setup->min_keycode + i );
+
+	free( reply );
+	return found;
+}
+
+xcb_atom_t _internXcbAtom( xcb_connection_t * connection, const cbl::Char * name )
+{
+	xcb_atom_t atom = XCB_NONE;
+	if( xcb_intern_atom_reply_t * reply = xcb_intern_atom_reply( connection,
+		xcb_intern_atom( connection, 0, cbl::Uint16( strlen( name ) ), name ), NULL ) ) {
+		atom = reply->atom;
+		free( reply );
+	}
+	return atom;
+}
+
+TEST_F( GameWindowFixture, GameWindow_XcbEvents )
+{
+	// Needs a display (e.g. Xvfb); there's nothing to translate without one.
+	gameWindow.Initialise();
+	if( gameWindow.IsHeadless() ) {
+		gameWindow.Shutdown();
+		return;
+	}
+
+	gameWindow.Update( cbl::GameTime() );
+	for( cbl::Uint32 i = 0; i < 20 && gameWindow.WaitForEvents( 0.05 ); ++i )
+		gameWindow.Update( cbl::GameTime() );
+
+	xcb_connection_t * connection = xcb_connect( NULL, NULL );
+	ASSERT_EQ( 0, xcb_connection_has_error( connection ) );
+	const xcb_window_t window = xcb_window_t( reinterpret_cast< size_t >( gameWindow.GetGameWindowHandle() ) );
+	const xcb_keycode_t keyA = _findXcbKeycode( connection, XK_a );
+	ASSERT_NE( 0, keyA );
+
+	XcbInputListener input;
+	WindowEventListener events;
+	gameWindow.OnWindowInputBatch	+= E::WindowInputBatch::Method<CBL_E_METHOD(XcbInputListener,OnWindowInputBatch)>(&input);
+	gameWindow.OnWindowClosed		+= E::WindowClosed::Method<CBL_E_METHOD(WindowEventListener,OnWindowClosed)>(&events);
+	gameWindow.OnWindowResized		+= E::WindowSize::Method<CBL_E_METHOD(WindowEventListener,OnWindowResized)>(&events);
+
+	// A press, then an auto-repeat (a release and press with the same time), then the real release.
+	xcb_key_press_event_t key;
+	memset( &key, 0, sizeof( key ) );
+	key.detail		= keyA;
+	key.event		= window;
+	key.same_screen	= 1;
+	key.response_type = XCB_KEY_PRESS;		key.time = 1000;	_sendXcbEvent( connection, window, &key );
+	key.response_type = XCB_KEY_RELEASE;	key.time = 1100;	_sendXcbEvent( connection, window, &key );
+	key.response_type = XCB_KEY_PRESS;		key.time = 1100;	_sendXcbEvent( connection, window, &key );
+	key.response_type = XCB_KEY_RELEASE;	key.time = 1200;	_sendXcbEvent( connection, window, &key );
+
+	// A right click, then a wheel notch (button 4).
+	xcb_button_press_event_t button;
+	memset( &button, 0, sizeof( button ) );
+	button.event		= window;
+	button.same_screen	= 1;
+	button.event_x		= 10;
+	button.event_y		= 20;
+	button.detail = 3;	button.response_type = XCB_BUTTON_PRESS;	button.time = 1300;	_sendXcbEvent( connection, window, &button );
+	button.detail = 3;	button.response_type = XCB_BUTTON_RELEASE;	button.time = 1400;	_sendXcbEvent( connection, window, &button );
+	button.detail = 4;	button.response_type = XCB_BUTTON_PRESS;	button.time = 1500;	_sendXcbEvent( connection, window, &button );
+
+	xcb_configure_notify_event_t configure;
+	memset( &configure, 0, sizeof( configure ) );
+	configure.response_type	= XCB_CONFIGURE_NOTIFY;
+	configure.event			= window;
+	configure.window		= window;
+	configure.width			= cbl::Uint16( gameWindow.GetWindowDimensions().Width + 10 );
+	configure.height		= cbl::Uint16( gameWindow.GetWindowDimensions().Height + 10 );
+	_sendXcbEvent( connection, window, &configure );
+
+	xcb_client_message_event_t close;
+	memset( &close, 0, sizeof( close ) );
+	close.response_type		= XCB_CLIENT_MESSAGE;
+	close.format			= 32;
+	close.window			= window;
+	close.type				= _internXcbAtom( connection, "WM_PROTOCOLS" );
+	close.data.data32[0]	= _internXcbAtom( connection, "WM_DELETE_WINDOW" );
+	_sendXcbEvent( connection, window, &close );
+
+	// Round trip so the server has handled every event before the window reads them.
+	free( xcb_get_input_focus_reply( connection, xcb_get_input_focus( connection ), NULL ) );
+
+	for( cbl::Uint32 i = 0; i < 50 && events.Closed == 0; ++i ) {
+		gameWindow.WaitForEvents( 0.1 );
+		gameWindow.Update( cbl::GameTime() );
+	}
+
+	EXPECT_EQ( 1, events.Closed );
+	EXPECT_GE( events.Resized, 1u );
+	EXPECT_EQ( cbl::Uint32( configure.width ), events.Width );
+	// The repeated press is reported, but not the release that came with it.
+	EXPECT_EQ( 2, input.Count( InputEventType::KeyDown, Key::A ) );
+	EXPECT_EQ( 1, input.Count( InputEventType::KeyUp, Key::A ) );
+	EXPECT_EQ( 2, input.Count( InputEventType::KeyChar, 'a' ) );
+	EXPECT_EQ( 1, input.Count( InputEventType::MouseDown, Mouse::Right ) );
+	EXPECT_EQ( 1, input.Count( InputEventType::MouseUp, Mouse::Right ) );
+	EXPECT_EQ( 1, input.Count( InputEventType::MouseWheel, 0 ) );
+
+	gameWindow.OnWindowResized		-= E::WindowSize::Method<CBL_E_METHOD(WindowEventListener,OnWindowResized)>(&events);
+	gameWindow.OnWindowClosed		-= E::WindowClosed::Method<CBL_E_METHOD(WindowEventListener,OnWindowClosed)>(&events);
+	gameWindow.OnWindowInputBatch	-= E::WindowInputBatch::Method<CBL_E_METHOD(XcbInputListener,OnWindowInputBatch)>(&input);
+	xcb_disconnect( connection );
+	gameWindow.Shutdown();
+}
+#endif
@@ -0,0 +1,221 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_GamepadManager.cpp
+ * @brief Unit testing for the gamepad manager.
+ */
+
+// Precompiled Headers //
+#include <dbl/StdAfx.h>
+
+// Delectable Headers //
+#include <dbl/Core/Game.h>
+#include <dbl/Input/GamepadManager.h>
+#include <dbl/Threading/Thread.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+// External Dependencies //
+#include <cstdio>
+#include <cstring>
+
+#if CBL_PLATFORM == CBL_PLATFORM_LINUX
+#include <linux/input.h>
+#endif
+
+using namespace dbl;
+
+class GamepadListener
+{
+public:
+	GamepadListener()
+		: clicks( 0 ), ups( 0 ), moves( 0 ), connects( 0 ), disconnects( 0 )
+	{
+	}
+
+	void OnButtonClick( cbl::Uint32, Gamepad::Button )	{ ++clicks; }
+	void OnButtonUp( cbl::Uint32, Gamepad::Button )		{ ++ups; }
+	void OnAxisMove( cbl::Uint32, Gamepad::Axis, cbl::Float32 )	{ ++moves; }
+	void OnConnected( cbl::Uint32 )						{ ++connects; }
+	void OnDisconnected( cbl::Uint32 )					{ ++disconnects; }
+
+	cbl::Uint32	clicks, ups, moves, connects, disconnects;
+};
+
+class GamepadManagerFixture : public ::testing::Test
+{
+public:
+	GamepadManagerFixture()
+		: gamepadGame( "GamepadManagerFixture" )
+		, gamepads( gamepadGame )
+	{
+	}
+
+	void SetUp()
+	{
+		// Drive the manager with injected events only.
+		backendEnabled = GamepadManager::sBackendEnabled;
+		GamepadManager::sBackendEnabled = false;
+		gamepads.Initialise();
+		gamepads.OnButtonClick	+= E::GamepadButtonClick::Method<CBL_E_METHOD(GamepadListener,OnButtonClick)>(&listener);
+		gamepads.OnButtonUp		+= E::GamepadButtonUp::Method<CBL_E_METHOD(GamepadListener,OnButtonUp)>(&listener);
+		gamepads.OnAxisMove		+= E::GamepadAxis::Method<CBL_E_METHOD(GamepadListener,OnAxisMove)>(&listener);
+		gamepads.OnConnected	+= E::GamepadConnected::Method<CBL_E_METHOD(GamepadListener,OnConnected)>(&listener);
+		gamepads.OnDisconnected	+= E::GamepadDisconnected::Method<CBL_E_METHOD(GamepadListener,OnDisconnected)>(&listener);
+	}
+
+	void TearDown()
+	{
+		gamepads.OnDisconnected	-= E::GamepadDisconnected::Method<CBL_E_METHOD(GamepadListener,OnDisconnected)>(&listener);
+		gamepads.OnConnected	-= E::GamepadConnected::Method<CBL_E_METHOD(GamepadListener,OnConnected)>(&listener);
+		gamepads.OnAxisMove		-= E::GamepadAxis::Method<CBL_E_METHOD(GamepadListener,OnAxisMove)>(&listener);
+		gamepads.OnButtonUp		-= E::GamepadButtonUp::Method<CBL_E_METHOD(GamepadListener,OnButtonUp)>(&listener);
+		gamepads.OnButtonClick	-= E::GamepadButtonClick::Method<CBL_E_METHOD(GamepadListener,OnButtonClick)>(&listener);
+		gamepads.Shutdown();
+		GamepadManager::sBackendEnabled = backendEnabled;
+	}
+
+protected:
+	Game				gamepadGame;
+	GamepadManager		gamepads;
+	GamepadListener		listener;
+	bool				backendEnabled;
+	cbl::GameTime		time;
+};
+
+TEST_F( GamepadManagerFixture, GamepadManager_InjectTest )
+{
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Connected, 1 ) );
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Button, 1, Gamepad::A, 1.0f ) );
+	EXPECT_FALSE( gamepads.IsConnected( 1 ) );
+
+	gamepads.Update( time );
+	EXPECT_TRUE( gamepads.IsConnected( 1 ) );
+	EXPECT_FALSE( gamepads.IsConnected( 0 ) );
+	EXPECT_TRUE( gamepads.IsButtonDown( 1, Gamepad::A ) );
+	EXPECT_TRUE( gamepads.GetState( 1 ).IsButtonPressed( Gamepad::A ) );
+	EXPECT_EQ( 1, listener.connects );
+	EXPECT_EQ( 1, listener.clicks );
+
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Button, 1, Gamepad::A, 1.0f ) );
+	gamepads.Update( time );
+	EXPECT_EQ( 1, listener.clicks );
+	EXPECT_TRUE( gamepads.GetState( 1 ).IsButtonDown( Gamepad::A ) );
+	EXPECT_FALSE( gamepads.GetState( 1 ).IsButtonPressed( Gamepad::A ) );
+
+	// Disconnecting releases everything.
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Disconnected, 1 ) );
+	gamepads.Update( time );
+	EXPECT_FALSE( gamepads.IsButtonDown( 1, Gamepad::A ) );
+	EXPECT_TRUE( gamepads.GetState( 1 ).IsButtonReleased( Gamepad::A ) );
+	EXPECT_EQ( 1, listener.ups );
+	EXPECT_EQ( 1, listener.disconnects );
+	EXPECT_FALSE( gamepads.GetState( Gamepad::MaxPads ).Connected );
+}
+
+TEST_F( GamepadManagerFixture, GamepadManager_DeadzoneTest )
+{
+	const cbl::Float32 dz = GamepadManager::sStickDeadzone;
+
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Axis, 0, Gamepad::LeftX, dz * 0.5f ) );
+	gamepads.Update( time );
+	EXPECT_EQ( 0.0f, gamepads.GetAxis( 0, Gamepad::LeftX ) );
+	EXPECT_EQ( 0, listener.moves );
+
+	// Each axis is inside the deadzone but the stick as a whole isn't.
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Axis, 0, Gamepad::LeftY, dz * 0.9f ) );
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Axis, 0, Gamepad::LeftX, dz * 0.9f ) );
+	gamepads.Update( time );
+	EXPECT_GT( gamepads.GetAxis( 0, Gamepad::LeftX ), 0.0f );
+	EXPECT_FLOAT_EQ( gamepads.GetAxis( 0, Gamepad::LeftX ), gamepads.GetAxis( 0, Gamepad::LeftY ) );
+
+	// Full deflection still reaches one.
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Axis, 0, Gamepad::LeftY, 0.0f ) );
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Axis, 0, Gamepad::LeftX, -1.0f ) );
+	gamepads.Update( time );
+	EXPECT_FLOAT_EQ( -1.0f, gamepads.GetAxis( 0, Gamepad::LeftX ) );
+	EXPECT_EQ( 0.0f, gamepads.GetAxis( 0, Gamepad::LeftY ) );
+
+	// Triggers use a linear deadzone.
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Axis, 0, Gamepad::RightTrigger, GamepadManager::sTriggerDeadzone * 0.5f ) );
+	gamepads.Update( time );
+	EXPECT_EQ( 0.0f, gamepads.GetAxis( 0, Gamepad::RightTrigger ) );
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Axis, 0, Gamepad::RightTrigger, 1.0f ) );
+	gamepads.Update( time );
+	EXPECT_FLOAT_EQ( 1.0f, gamepads.GetState( 0 ).Axes[ Gamepad::RightTrigger ] );
+}
+
+TEST_F( GamepadManagerFixture, GamepadManager_FilterTest )
+{
+	gamepads.Filter.SetStackSize( 2 );
+	gamepads.Filter.Set( 0, true );
+	GamepadManager::FilterEvent & menu = gamepads.Filter[0];
+	menu.OnButtonUp += E::GamepadButtonUp::Method<CBL_E_METHOD(GamepadListener,OnButtonUp)>(&listener);
+
+	gamepads.InjectEvent( GamepadEvent::Make( GamepadEventType::Button, 2, Gamepad::Start, 1.0f ) );
+	gamepads.Update( time );
+	EXPECT_TRUE( menu.IsButtonDown( 2, Gamepad::Start ) );
+	EXPECT_FALSE( menu.IsButtonDown( 0, Gamepad::Start ) );
+
+	// A higher layer takes over and the lower layer's held button is released.
+	gamepads.Filter.Set( 1, true );
+	gamepads.Update( time );
+	EXPECT_FALSE( menu.IsButtonDown( 2, Gamepad::Start ) );
+	EXPECT_EQ( 1, listener.ups );
+	EXPECT_TRUE( gamepads.IsButtonDown( 2, Gamepad::Start ) );
+
+	menu.OnButtonUp -= E::GamepadButtonUp::Method<CBL_E_METHOD(GamepadListener,OnButtonUp)>(&listener);
+}
+
+#if CBL_PLATFORM == CBL_PLATFORM_LINUX
+TEST_F( GamepadManagerFixture, GamepadManager_RecordedStreamTest )
+{
+	// Record an evdev stream: A pressed, left stick pushed fully right, A released.
+	const cbl::Char * path = "gamepad_stream.bin";
+	const cbl::Uint32 count = 256;
+	FILE * file = fopen( path, "wb" );
+	ASSERT_TRUE( file != NULL );
+	for( cbl::Uint32 i = 0; i < count; ++i ) {
+		input_event ev[4];
+		memset( ev, 0, sizeof( ev ) );
+		ev[0].type = EV_KEY; ev[0].code = BTN_SOUTH; ev[0].value = ( i + 1 < count ) ? 1 : 0;
+		ev[1].type = EV_ABS; ev[1].code = ABS_X; ev[1].value = cbl::Int32( ( i * 997 ) % 65536 ) - 32768;
+		ev[2].type = EV_ABS; ev[2].code = ABS_X; ev[2].value = 32767;
+		ev[3].type = EV_SYN; ev[3].code = SYN_REPORT;
+		fwrite( ev, sizeof( ev ), 1, file );
+	}
+	fclose( file );
+
+	// The backend isn't enabled; opening a device starts it.
+	ASSERT_TRUE( gamepads.OpenDevice( path ) );
+	for( cbl::Uint32 i = 0; i < 500 && listener.ups == 0; ++i ) {
+		Thread::Sleep( 2 );
+		gamepads.Update( time );
+	}
+
+	EXPECT_TRUE( gamepads.IsConnected( 0 ) );
+	EXPECT_EQ( 1, listener.clicks );
+	EXPECT_EQ( 1, listener.ups );
+	EXPECT_FLOAT_EQ( 1.0f, gamepads.GetAxis( 0, Gamepad::LeftX ) );
+	EXPECT_EQ( 0, gamepads.GetDroppedEvents() );
+
+	remove( path );
+}
+#endif
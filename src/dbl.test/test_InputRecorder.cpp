@@ -0,0 +1,223 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_InputRecorder.cpp
+ * @brief Unit testing for input recording and replay.
+ */
+
+// Precompiled Headers //
+#include <dbl/StdAfx.h>
+
+// Delectable Headers //
+#include <dbl/Core/Game.h>
+#include <dbl/Input/InputRecorder.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+// External Libraries //
+#include <sstream>
+
+using namespace dbl;
+
+class InputRecorderFixture : public ::testing::Test
+{
+public:
+	InputRecorderFixture()
+		: recordGame( "InputRecorder_Record" )
+		, replayGame( "InputRecorder_Replay" )
+	{
+	}
+
+	void SetUp()
+	{
+		// Neither window is created; input is injected straight into the queues.
+		recordGame.Keyboard.Initialise();
+		recordGame.Mouse.Initialise();
+		replayGame.Keyboard.Initialise();
+		replayGame.Mouse.Initialise();
+	}
+
+	void TearDown()
+	{
+		replayGame.Mouse.Shutdown();
+		replayGame.Keyboard.Shutdown();
+		recordGame.Mouse.Shutdown();
+		recordGame.Keyboard.Shutdown();
+	}
+
+	void Step( Game& game )
+	{
+		game.Window.Update( cbl::GameTime() );
+		game.Keyboard.Update( cbl::GameTime() );
+		game.Mouse.Update( cbl::GameTime() );
+	}
+
+	void Push( InputEventType::Type type, cbl::Uint32 code = 0, cbl::Int32 x = 0, cbl::Int32 y = 0 )
+	{
+		recordGame.Window.PushInputEvent( InputEvent::Make( type, recordGame.Window.GetInputTime(), code, x, y ) );
+	}
+
+protected:
+	Game		recordGame;
+	Game		replayGame;
+};
+
+//! Starts recording from inside an input batch handler, and hands the recorder the rest of
+//! that batch as an event that calls handlers added mid-dispatch would.
+struct InputRecorderStarter
+{
+	InputRecorderStarter( InputRecorder & recorder, GameWindow & window, std::ostream & stream )
+		: Recorder( recorder ), Window( window ), Stream( stream ), Started( false )
+	{
+	}
+
+	void OnWindowInputBatch( const InputEventList & events )
+	{
+		if( Started )
+			return;
+
+		Started = Recorder.Start( Window, Stream );
+		if( Started )
+			Recorder.OnWindowInputBatch( events );
+	}
+
+	InputRecorder&	Recorder;
+	GameWindow&		Window;
+	std::ostream&	Stream;
+	bool			Started;
+};
+
+TEST_F( InputRecorderFixture, InputRecorder_RoundTrip )
+{
+	std::stringstream recording( std::ios::in | std::ios::out | std::ios::binary );
+
+	InputRecorder recorder;
+	ASSERT_TRUE( recorder.Start( recordGame.Window, recording ) );
+
+	// Frame 1: press W and move the mouse.
+	Push( InputEventType::KeyDown, Key::W );
+	Push( InputEventType::MouseMove, 0, 100, 50 );
+	Step( recordGame );
+	// Frame 2: nothing.
+	Step( recordGame );
+	// Frame 3: press the left button.
+	Push( InputEventType::MouseDown, Mouse::Left, 100, 50 );
+	Step( recordGame );
+	// Frame 4: release everything.
+	Push( InputEventType::MouseUp, Mouse::Left, 100, 50 );
+	Push( InputEventType::KeyUp, Key::W );
+	Step( recordGame );
+
+	recorder.Stop();
+	EXPECT_EQ( 5, recorder.GetEventCount() );
+
+	InputReplay replay;
+	ASSERT_TRUE( replay.Open( recording ) );
+	replayGame.Window.SetInputSource( &replay );
+
+	Step( replayGame );
+	EXPECT_TRUE( replayGame.Keyboard.IsKeyDown( Key::W ) );
+	EXPECT_EQ( 100, replayGame.Mouse.GetPosition().X );
+	EXPECT_EQ( 50, replayGame.Mouse.GetPosition().Y );
+	EXPECT_FALSE( replayGame.Mouse.IsButtonDown( Mouse::Left ) );
+
+	Step( replayGame );
+	EXPECT_TRUE( replayGame.Keyboard.IsKeyDown( Key::W ) );
+	EXPECT_FALSE( replayGame.Mouse.IsButtonDown( Mouse::Left ) );
+
+	Step( replayGame );
+	EXPECT_TRUE( replayGame.Mouse.IsButtonDown( Mouse::Left ) );
+
+	Step( replayGame );
+	EXPECT_FALSE( replayGame.Keyboard.IsKeyDown( Key::W ) );
+	EXPECT_FALSE( replayGame.Mouse.IsButtonDown( Mouse::Left ) );
+	EXPECT_TRUE( replay.IsFinished() );
+	EXPECT_EQ( 4, replay.GetFrame() );
+
+	replayGame.Window.SetInputSource( NULL );
+}
+
+TEST_F( InputRecorderFixture, InputRecorder_RejectsBadFiles )
+{
+	std::stringstream garbage( "not a recording" );
+	InputReplay replay;
+	EXPECT_FALSE( replay.Open( garbage ) );
+	EXPECT_TRUE( replay.IsFinished() );
+	EXPECT_FALSE( replay.Open( "missing_recording.dbli" ) );
+}
+
+TEST_F( InputRecorderFixture, InputRecorder_LongReplay )
+{
+	const cbl::Uint32 frames = 10000;
+	std::stringstream recording( std::ios::in | std::ios::out | std::ios::binary );
+
+	InputRecorder recorder;
+	ASSERT_TRUE( recorder.Start( recordGame.Window, recording ) );
+	for( cbl::Uint32 i = 0; i < frames; ++i ) {
+		Push( InputEventType::MouseMove, 0, i % 640, i % 480 );
+		Push( i % 2 ? InputEventType::KeyUp : InputEventType::KeyDown, Key::Space );
+		Step( recordGame );
+	}
+	recorder.Stop();
+
+	InputReplay replay;
+	ASSERT_TRUE( replay.Open( recording ) );
+	replayGame.Window.SetInputSource( &replay );
+
+	while( !replay.IsFinished() )
+		Step( replayGame );
+
+	EXPECT_EQ( frames, replay.GetFrame() );
+	EXPECT_EQ( frames * 2, recorder.GetEventCount() );
+
+	replayGame.Window.SetInputSource( NULL );
+}
+
+TEST_F( InputRecorderFixture, InputRecorder_StartDuringDispatch )
+{
+	std::stringstream recording( std::ios::in | std::ios::out | std::ios::binary );
+
+	InputRecorder recorder;
+	InputRecorderStarter starter( recorder, recordGame.Window, recording );
+	recordGame.Window.OnWindowInputBatch += E::WindowInputBatch::Method<CBL_E_METHOD(InputRecorderStarter,OnWindowInputBatch)>(&starter);
+	Push( InputEventType::MouseMove, 0, 10, 10 );
+	Step( recordGame );
+	recordGame.Window.OnWindowInputBatch -= E::WindowInputBatch::Method<CBL_E_METHOD(InputRecorderStarter,OnWindowInputBatch)>(&starter);
+	ASSERT_TRUE( starter.Started );
+
+	// The batch being dispatched during Start() is replayed with the first frame, rather than
+	// wrapping around to a frame that never comes.
+	Push( InputEventType::KeyDown, Key::W );
+	Step( recordGame );
+	recorder.Stop();
+
+	InputReplay replay;
+	ASSERT_TRUE( replay.Open( recording ) );
+	replayGame.Window.SetInputSource( &replay );
+
+	Step( replayGame );
+	EXPECT_TRUE( replayGame.Keyboard.IsKeyDown( Key::W ) );
+	EXPECT_EQ( 10, replayGame.Mouse.GetPosition().X );
+	EXPECT_EQ( 10, replayGame.Mouse.GetPosition().Y );
+	EXPECT_TRUE( replay.IsFinished() );
+	EXPECT_EQ( 1, replay.GetFrame() );
+
+	replayGame.Window.SetInputSource( NULL );
+}
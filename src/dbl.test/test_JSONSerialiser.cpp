@@ -0,0 +1,526 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_JSONSerialiser.cpp
+ * @brief Unit testing for the JSON serialiser.
+ */
+
+// Precompiled Headers //
+#include <dbl/StdAfx.h>
+
+// Delectable Headers //
+#include <dbl/Serialisation/BlockSerialisation.h>
+#include <dbl/Serialisation/JSONSerialiser.h>
+#include <dbl/Serialisation/JSONDeserialiser.h>
+#include <dbl/Serialisation/YAMLSerialiser.h>
+#include <dbl/Serialisation/YAMLDeserialiser.h>
+#include <dbl/Serialisation/PrefabCache.h>
+
+// Chewable Headers //
+#include <cbl/Core/Object.h>
+#include <cbl/Core/ObjectPart.h>
+#include <cbl/Core/ObjectManager.h>
+#include <cbl/Util/Stopwatch.h>
+
+// External Libraries //
+#include <cstdio>
+#include <limits>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+#include <yaml-cpp/yaml.h>
+
+using namespace dbl;
+
+namespace cbl
+{
+	struct DummAccessJSON {};
+	template<>
+	DummAccessJSON* EntityManager::New<DummAccessJSON>( void ) const
+	{
+		this->EntityManager::~EntityManager();
+		this->EntityManager::EntityManager();
+		cbl::CblRegistrar::RegisterCblTypes();
+		dbl::DblRegistrar::RegisterDblTypes();
+		return NULL;
+	}
+}
+void ForceReconstructEntityManager_JSON( void )
+{
+	using namespace cbl;
+	const_cast<EntityManager*>( EntityManager::InstancePtr() )->New<DummAccessJSON>();
+}
+
+struct JSONBaseTest
+	: public cbl::Entity
+{
+	virtual ~JSONBaseTest() {}
+	cbl::Int32	T1;
+	cbl::String	Text;
+	JSONBaseTest() : T1( 0 ) {}
+
+	virtual cbl::Entity::OPTIONS OnPreChanged( void ) { return cbl::Entity::O_NORMAL; }
+	virtual void OnChanged( void ) {}
+	virtual cbl::Entity::OPTIONS OnPreSaved( void ) const { return cbl::Entity::O_NORMAL; }
+	virtual void OnSaved( void ) const {}
+};
+
+struct JSONChildTest : public JSONBaseTest
+{
+	virtual ~JSONChildTest() {}
+	cbl::Float32	T2;
+	JSONChildTest() : T2( 0.0f ) {}
+};
+
+struct JSONContainerTest
+{
+	typedef std::map<cbl::Int32,JSONBaseTest*> MapType;
+	cbl::Int32					Number;
+	cbl::String					Name;
+	std::vector<JSONBaseTest*>	Vector;
+	MapType						Map;
+
+	JSONContainerTest() : Number( 0 ) {}
+
+	~JSONContainerTest() {
+		for( size_t t = 0; t < Vector.size(); ++t ) {
+			CBL_DELETE( Vector[t] );
+		}
+		CBL_FOREACH( MapType, it, Map ) {
+			CBL_DELETE( it->second );
+		}
+	}
+};
+
+struct JSONTreeTest : public JSONBaseTest
+{
+	std::vector<JSONTreeTest*>	Children;
+
+	virtual ~JSONTreeTest() {
+		for( size_t t = 0; t < Children.size(); ++t ) {
+			CBL_DELETE( Children[t] );
+		}
+	}
+};
+
+CBL_TYPE( JSONBaseTest, JSONBaseTest );
+CBL_TYPE( JSONChildTest, JSONChildTest );
+CBL_TYPE( JSONContainerTest, JSONContainerTest );
+CBL_TYPE( JSONTreeTest, JSONTreeTest );
+
+class JSONSerialiserFixture : public ::testing::Test
+{
+public:
+	void SetUp()
+	{
+		CBL_ENT.Types.Create<JSONBaseTest>()
+			.CBL_FIELD( T1, JSONBaseTest )
+			.CBL_FIELD( Text, JSONBaseTest );
+		CBL_ENT.Types.Create<JSONChildTest>()
+			.Base<JSONBaseTest>()
+			.CBL_FIELD( T2, JSONChildTest );
+		CBL_ENT.Types.Create<JSONContainerTest>()
+			.CBL_FIELD( Number, JSONContainerTest )
+			.CBL_FIELD( Name, JSONContainerTest )
+			.CBL_FIELD( Vector, JSONContainerTest )
+			.CBL_FIELD( Map, JSONContainerTest );
+		CBL_ENT.Types.Create<JSONTreeTest>()
+			.Base<JSONBaseTest>()
+			.CBL_FIELD( Children, JSONTreeTest );
+	}
+
+	void TearDown()
+	{
+		ForceReconstructEntityManager_JSON();
+	}
+
+	//! Fill a container with typed entries.
+	static void Fill( JSONContainerTest& c, cbl::Uint32 count )
+	{
+		static const cbl::Char* sTexts[] = { "plain", "with \"quotes\"", "back\\slash", "tab\tand\nnewline", "123", "true", "" };
+		c.Number = 42;
+		c.Name = "Container: #1";
+
+		for( cbl::Uint32 i = 0; i < count; ++i ) {
+			JSONBaseTest* b;
+			if( i % 2 ) {
+				b = CBL_ENT.New<JSONBaseTest>();
+			} else {
+				JSONChildTest* child = CBL_ENT.New<JSONChildTest>();
+				child->T2 = cbl::Float32( i ) * 0.5f;
+				b = child;
+			}
+			b->T1 = cbl::Int32( i ) * 3 - 7;
+			b->Text = sTexts[ i % ( sizeof( sTexts ) / sizeof( sTexts[0] ) ) ];
+
+			if( i % 3 )
+				c.Vector.push_back( b );
+			else
+				c.Map.insert( std::make_pair( cbl::Int32( i ), b ) );
+		}
+	}
+
+	static void ExpectEqual( const JSONBaseTest& lhs, const JSONBaseTest& rhs )
+	{
+		ASSERT_EQ( lhs.T1, rhs.T1 );
+		ASSERT_EQ( lhs.Text, rhs.Text );
+
+		const JSONChildTest* lc = dynamic_cast<const JSONChildTest*>( &lhs );
+		const JSONChildTest* rc = dynamic_cast<const JSONChildTest*>( &rhs );
+		ASSERT_EQ( lc != NULL, rc != NULL );
+		if( lc )
+			ASSERT_EQ( lc->T2, rc->T2 );
+	}
+
+	static void ExpectEqual( const JSONContainerTest& lhs, const JSONContainerTest& rhs )
+	{
+		ASSERT_EQ( lhs.Number, rhs.Number );
+		ASSERT_EQ( lhs.Name, rhs.Name );
+		ASSERT_EQ( lhs.Vector.size(), rhs.Vector.size() );
+		ASSERT_EQ( lhs.Map.size(), rhs.Map.size() );
+
+		for( size_t i = 0; i < lhs.Vector.size(); ++i )
+			ExpectEqual( *lhs.Vector[i], *rhs.Vector[i] );
+
+		JSONContainerTest::MapType::const_iterator it = lhs.Map.begin();
+		JSONContainerTest::MapType::const_iterator it2 = rhs.Map.begin();
+		for( ; it != lhs.Map.end(); ++it, ++it2 ) {
+			ASSERT_EQ( it->first, it2->first );
+			ExpectEqual( *it->second, *it2->second );
+		}
+	}
+};
+
+TEST( JSONDocumentTest, JSONDocument_ParseTest )
+{
+	const cbl::Char json[] =
+		"{\"a\":1,\"b\":[true,false,null,-2.5e3],\"c\":{\"d\":\"x\\\"y\\\\z\\n\\u00e9\\ud83d\\ude00\"}}\n"
+		"[]\n"
+		"  \"second\"  ";
+
+	JSONDocument doc;
+	doc.Load( json, sizeof( json ) - 1 );
+
+	ASSERT_TRUE( doc.GetNextDocument() );
+	const JSONNode* root = doc.GetRoot();
+	ASSERT_TRUE( root != NULL );
+	ASSERT_EQ( JSONType::Object, root->Type );
+	ASSERT_EQ( 3u, root->ChildCount );
+
+	cbl::String value;
+	const JSONNode* a = doc.FindValue( *root, "a" );
+	ASSERT_TRUE( a && JSONDocument::GetScalar( *a, value ) );
+	ASSERT_EQ( "1", value );
+
+	const JSONNode* b = doc.FindValue( *root, "b" );
+	ASSERT_TRUE( b && b->Type == JSONType::Array && b->ChildCount == 4 );
+	const JSONNode* e = doc.GetFirstChild( *b );
+	ASSERT_EQ( JSONType::Bool, e->Type );
+	e = doc.GetNextSibling( *doc.GetNextSibling( *e ) );
+	ASSERT_EQ( JSONType::Null, e->Type );
+	ASSERT_FALSE( JSONDocument::GetScalar( *e, value ) );
+	e = doc.GetNextSibling( *e );
+	ASSERT_TRUE( JSONDocument::GetScalar( *e, value ) );
+	ASSERT_EQ( "-2.5e3", value );
+
+	const JSONNode* c = doc.FindValue( *root, "c" );
+	const JSONNode* d = doc.FindValue( *c, "d" );
+	ASSERT_TRUE( d && JSONDocument::GetScalar( *d, value ) );
+	ASSERT_EQ( "x\"y\\z\n\xC3\xA9\xF0\x9F\x98\x80", value );
+	ASSERT_TRUE( doc.FindValue( *c, "missing" ) == NULL );
+
+	ASSERT_TRUE( doc.GetNextDocument() );
+	ASSERT_EQ( JSONType::Array, doc.GetRoot()->Type );
+	ASSERT_EQ( 0u, doc.GetRoot()->ChildCount );
+
+	ASSERT_TRUE( doc.GetNextDocument() );
+	ASSERT_TRUE( JSONDocument::GetScalar( *doc.GetRoot(), value ) );
+	ASSERT_EQ( "second", value );
+
+	ASSERT_FALSE( doc.GetNextDocument() );
+}
+
+TEST( JSONDocumentTest, JSONDocument_ErrorTest )
+{
+	const cbl::Char* invalid[] = {
+		"{\"a\":1,}",
+		"[1 2]",
+		"\"unterminated",
+		"{\"a\" 1}",
+		"-",
+		"1.",
+		"tru",
+		"\"\\x\"",
+		"\"\\ud83d\"",
+	};
+
+	for( size_t i = 0; i < sizeof( invalid ) / sizeof( invalid[0] ); ++i ) {
+		JSONDocument doc;
+		doc.Load( invalid[i], strlen( invalid[i] ) );
+		ASSERT_FALSE( doc.GetNextDocument() ) << invalid[i];
+	}
+
+	// Nesting is limited.
+	cbl::String deep( JSONDocument::MaxDepth + 1, '[' );
+	deep.append( JSONDocument::MaxDepth + 1, ']' );
+	JSONDocument doc;
+	doc.Load( deep.c_str(), deep.length() );
+	ASSERT_FALSE( doc.GetNextDocument() );
+}
+
+TEST( JSONWriterTest, JSONWriter_OutputTest )
+{
+	JSONWriter w;
+	w.BeginObject()
+		.Key( "s" ).String( "a\"b\\c\n\x01" )
+		.Key( "n" ).Int( -5 )
+		.Key( "u" ).Uint( 7 )
+		.Key( "r" ).Real( 0.5 )
+		.Key( "l" ).BeginArray().Bool( true ).Null().EndArray()
+		.Key( "o" ).BeginObject().EndObject()
+	.EndObject();
+	w.BeginArray().EndArray();
+
+	ASSERT_TRUE( w.IsComplete() );
+	ASSERT_EQ( "{\"s\":\"a\\\"b\\\\c\\n\\u0001\",\"n\":-5,\"u\":7,\"r\":0.5,\"l\":[true,null],\"o\":{}}\n[]\n", w.GetString() );
+}
+
+TEST_F( JSONSerialiserFixture, JSONSerialiser_RoundTripTest )
+{
+	JSONContainerTest source;
+	Fill( source, 12 );
+
+	JSONWriter w;
+	JSONSerialiser()
+		.SetStream( w )
+		.Serialise( source );
+	ASSERT_TRUE( w.IsComplete() );
+
+	JSONDocument doc;
+	doc.Load( w.c_str(), w.size() );
+
+	JSONContainerTest result;
+	JSONDeserialiser()
+		.SetStream( doc )
+		.Deserialise( result );
+
+	ExpectEqual( source, result );
+}
+
+TEST_F( JSONSerialiserFixture, JSONSerialiser_NestedContainerTest )
+{
+	JSONTreeTest source;
+	source.T1 = 1;
+	for( cbl::Int32 i = 0; i < 3; ++i ) {
+		source.Children.push_back( CBL_ENT.New<JSONTreeTest>() );
+		source.Children.back()->T1 = 10 + i;
+	}
+
+	JSONWriter w;
+	JSONSerialiser()
+		.SetStream( w )
+		.Serialise( source );
+	ASSERT_TRUE( w.IsComplete() );
+
+	// The leaves' Children field is the same cbl::Field as the root's. Make it
+	// something other than an array so it's skipped without pushing a container.
+	cbl::String json = w.GetString();
+	const cbl::String empty = "\"Children\":[]";
+	for( size_t at = json.find( empty ); at != cbl::String::npos; at = json.find( empty, at ) )
+		json.replace( at, empty.length(), "\"Children\":0" );
+
+	JSONDocument doc;
+	doc.Load( json.c_str(), json.length() );
+
+	JSONTreeTest result;
+	JSONDeserialiser()
+		.SetStream( doc )
+		.Deserialise( result );
+
+	ASSERT_EQ( 1, result.T1 );
+	ASSERT_EQ( 3u, result.Children.size() );
+	for( size_t i = 0; i < result.Children.size(); ++i ) {
+		ASSERT_EQ( source.Children[i]->T1, result.Children[i]->T1 );
+		ASSERT_TRUE( result.Children[i]->Children.empty() );
+	}
+}
+
+TEST_F( JSONSerialiserFixture, JSONSerialiser_BenchmarkTest )
+{
+	const cbl::Uint32 objects = 200;
+	std::vector<JSONContainerTest*> sources;
+	for( cbl::Uint32 i = 0; i < objects; ++i ) {
+		sources.push_back( new JSONContainerTest() );
+		Fill( *sources.back(), 16 );
+	}
+
+	cbl::Float64 jsonTime = 0.0, yamlTime = 0.0;
+	{
+		cbl::Stopwatch timer;
+		JSONWriter w;
+		JSONSerialiser js;
+		js.SetStream( w );
+		for( cbl::Uint32 i = 0; i < objects; ++i )
+			js.Serialise( *sources[i] );
+
+		JSONDocument doc;
+		doc.Load( w.c_str(), w.size() );
+		JSONDeserialiser jd;
+		jd.SetStream( doc );
+		for( cbl::Uint32 i = 0; i < objects; ++i ) {
+			JSONContainerTest result;
+			jd.Deserialise( result );
+			if( i == 0 ) ExpectEqual( *sources[0], result );
+		}
+		jsonTime = timer.GetElapsedTime().TotalSeconds();
+	}
+	{
+		cbl::Stopwatch timer;
+		YAML::Emitter e;
+		YAMLSerialiser ys;
+		ys.SetStream( e );
+		for( cbl::Uint32 i = 0; i < objects; ++i )
+			ys.Serialise( *sources[i] );
+
+		std::istringstream is( e.c_str() );
+		YAML::Parser parser( is );
+		YAMLDeserialiser yd;
+		yd.SetStream( parser );
+		for( cbl::Uint32 i = 0; i < objects; ++i ) {
+			JSONContainerTest result;
+			yd.Deserialise( result );
+		}
+		yamlTime = timer.GetElapsedTime().TotalSeconds();
+	}
+
+	// Wall-clock times are only reported (in the XML output); they're too noisy to assert on.
+	RecordProperty( "JSONMicroseconds", int( jsonTime * 1000000.0 ) );
+	RecordProperty( "YAMLMicroseconds", int( yamlTime * 1000000.0 ) );
+
+	for( size_t i = 0; i < sources.size(); ++i )
+		delete sources[i];
+}
+
+struct JSONBlockTest
+{
+	std::vector<cbl::Float64>	Values;
+	std::vector<cbl::Float32>	Weights;
+};
+
+CBL_TYPE( JSONBlockTest, JSONBlockTest );
+
+TEST( JSONSerialiserBlocks, JSONSerialiser_BlockNaNTest )
+{
+	CBL_ENT.Types.Create<JSONBlockTest>()
+		.CBL_FIELD( Values, JSONBlockTest )
+		.CBL_FIELD( Weights, JSONBlockTest );
+	DBL_BLOCK_FIELD( Values, JSONBlockTest );
+	DBL_BLOCK_FIELD( Weights, JSONBlockTest );
+
+	JSONBlockTest t;
+	t.Values.push_back( 1.5 );
+	t.Values.push_back( std::numeric_limits<cbl::Float64>::quiet_NaN() );
+	t.Values.push_back( std::numeric_limits<cbl::Float64>::infinity() );
+	t.Weights.push_back( std::numeric_limits<cbl::Float32>::quiet_NaN() );
+	t.Weights.push_back( -0.25f );
+
+	JSONWriter w;
+	JSONSerialiser()
+		.SetStream( w )
+		.Serialise( t );
+	ASSERT_TRUE( w.IsComplete() );
+
+	// NaN and infinity aren't valid JSON numbers.
+	const cbl::String json = w.GetString();
+	ASSERT_EQ( cbl::String::npos, json.find( "nan" ) );
+	ASSERT_EQ( cbl::String::npos, json.find( "inf" ) );
+
+	JSONDocument doc;
+	doc.Load( json.c_str(), json.length() );
+
+	JSONBlockTest r;
+	JSONDeserialiser()
+		.SetStream( doc )
+		.Deserialise( r );
+
+	ASSERT_EQ( t.Values.size(), r.Values.size() );
+	ASSERT_EQ( t.Weights.size(), r.Weights.size() );
+	ASSERT_EQ( 1.5, r.Values[0] );
+	ASSERT_TRUE( r.Values[1] != r.Values[1] );
+	// Infinity has no JSON representation either, so it comes back as NaN.
+	ASSERT_TRUE( r.Values[2] != r.Values[2] );
+	ASSERT_TRUE( r.Weights[0] != r.Weights[0] );
+	ASSERT_EQ( -0.25f, r.Weights[1] );
+
+	BlockFields::Clear();
+	ForceReconstructEntityManager_JSON();
+}
+
+class JSONObjectPartTest :
+	public cbl::ObjectPart
+{
+public:
+	JSONObjectPartTest()
+	: Int(50), Float(32.0f)
+	{}
+	virtual ~JSONObjectPartTest() {}
+
+	virtual void Initialise( void ) {}
+	virtual void Shutdown( void ) {}
+
+	cbl::Int32		Int;
+	cbl::Float32	Float;
+};
+
+CBL_TYPE( JSONObjectPartTest, JSONObjectPartTest );
+
+TEST( JSONSerialiserObjects, JSONSerialiser_ObjectFileTest )
+{
+	static const cbl::Char* sObjectFile = "object.json";
+	cbl::ObjectManager objMgr;
+
+	CBL_ENT.Types.Create<JSONObjectPartTest>()
+		.Base<cbl::ObjectPart>()
+		.CBL_FIELD( Int, JSONObjectPartTest )
+		.CBL_FIELD( Float, JSONObjectPartTest );
+
+	cbl::Object* obj = objMgr.Create<cbl::Object>( "JSONObject" );
+	JSONObjectPartTest* part = obj->Parts.Add<JSONObjectPartTest>();
+	part->Int = -1234;
+	part->Float = 0.75f;
+	objMgr.SaveObjectToFile<JSONSerialiser>( sObjectFile, obj );
+	objMgr.Destroy( obj );
+	objMgr.Purge();
+
+	cbl::ObjectPtr loaded = objMgr.LoadObjectFromFile<JSONDeserialiser>( sObjectFile, "JSONObject_Loaded", false );
+	ASSERT_TRUE( loaded != NULL );
+	ASSERT_EQ( cbl::String( "JSONObject_Loaded" ), loaded->GetName() );
+
+	JSONObjectPartTest* result = loaded->Parts.Get<JSONObjectPartTest>();
+	ASSERT_TRUE( result != NULL );
+	ASSERT_EQ( -1234, result->Int );
+	ASSERT_EQ( 0.75f, result->Float );
+
+	PrefabCache::Clear();
+	objMgr.ForceFullPurge();
+	std::remove( sObjectFile );
+
+	ForceReconstructEntityManager_JSON();
+}
@@ -112,4 +112,182 @@ protected:
 TEST_F( KeyboardManagerFixture, KeyboardManager_KeyTest )
 {
 	keyboardGame.Run();
-}
\ No newline at end of file
+}
+class KeyboardFilterListener
+{
+public:
+	KeyboardFilterListener()
+		: downCount( 0 ), upCount( 0 ), lastModifiers( 0 )
+	{
+	}
+
+	void OnKeyDown( dbl::Key::Code, cbl::Uint16 modifiers )
+	{
+		++downCount;
+		lastModifiers = modifiers;
+	}
+
+	void OnKeyUp( dbl::Key::Code, cbl::Uint16 modifiers )
+	{
+		++upCount;
+		lastModifiers = modifiers;
+	}
+
+public:
+	cbl::Uint32		downCount;
+	cbl::Uint32		upCount;
+	cbl::Uint16		lastModifiers;
+};
+
+TEST_F( KeyboardManagerFixture, KeyboardManager_HeldKeySetTest )
+{
+	KeySet keys;
+	EXPECT_TRUE( keys.Insert( Key::A ) );
+	EXPECT_FALSE( keys.Insert( Key::A ) );
+	EXPECT_TRUE( keys.Insert( Key::LShift ) );
+	EXPECT_TRUE( keys.Insert( Key::RShift ) );
+	EXPECT_EQ( Key::Modifier::Shift, keys.GetModifiers() );
+	EXPECT_TRUE( keys.Remove( Key::LShift ) );
+	EXPECT_EQ( Key::Modifier::Shift, keys.GetModifiers() );
+	EXPECT_TRUE( keys.Remove( Key::RShift ) );
+	EXPECT_EQ( 0, keys.GetModifiers() );
+	EXPECT_FALSE( keys.Remove( Key::RShift ) );
+	ASSERT_EQ( 1, keys.Size() );
+	EXPECT_EQ( Key::A, keys.Get( 0 ) );
+	keys.Clear();
+	EXPECT_TRUE( keys.Empty() );
+	EXPECT_FALSE( keys[ Key::A ] );
+}
+
+TEST_F( KeyboardManagerFixture, KeyboardManager_FilterLayerTest )
+{
+	const cbl::Uint32 layers = 500;
+	const cbl::Uint32 frames = 10000;
+
+	KeyboardManager& keyboard = keyboardGame.Keyboard;
+	keyboard.Filter.SetStackSize( layers );
+
+	KeyboardFilterListener lower, upper;
+	keyboard.Filter[0].OnKeyDown	+= E::KeyDown::Method<CBL_E_METHOD(KeyboardFilterListener,OnKeyDown)>(&lower);
+	keyboard.Filter[0].OnKeyUp		+= E::KeyUp::Method<CBL_E_METHOD(KeyboardFilterListener,OnKeyUp)>(&lower);
+	keyboard.Filter[layers-1].OnKeyDown	+= E::KeyDown::Method<CBL_E_METHOD(KeyboardFilterListener,OnKeyDown)>(&upper);
+	keyboard.Filter[layers-1].OnKeyUp	+= E::KeyUp::Method<CBL_E_METHOD(KeyboardFilterListener,OnKeyUp)>(&upper);
+
+	// Hold keys on the lowest layer.
+	keyboard.Filter.Set( 0, true );
+	keyboard.OnWindowKeyDown( Key::LCtrl );
+	keyboard.OnWindowKeyDown( Key::S );
+	EXPECT_EQ( Key::Modifier::Ctrl, keyboard.GetModifiers() );
+	keyboard.Update( cbl::GameTime() );
+	EXPECT_EQ( 2, lower.downCount );
+	EXPECT_EQ( Key::Modifier::Ctrl, lower.lastModifiers );
+
+	// Activating a higher layer releases everything held underneath it.
+	keyboard.Filter.Set( layers-1, true );
+	keyboard.Update( cbl::GameTime() );
+	EXPECT_EQ( 2, lower.upCount );
+	EXPECT_EQ( 0, lower.lastModifiers );
+	EXPECT_FALSE( keyboard.Filter[0].IsKeyDown( Key::S ) );
+	EXPECT_TRUE( keyboard.IsKeyDown( Key::S ) );
+
+	keyboard.OnWindowKeyDown( Key::W );
+	EXPECT_TRUE( keyboard.Filter[layers-1].IsKeyDown( Key::W ) );
+
+	// A held key fires on the active layer every update.
+	for( cbl::Uint32 i = 0; i < frames; ++i )
+		keyboard.Update( cbl::GameTime() );
+	EXPECT_EQ( frames, upper.downCount );
+
+	keyboard.OnWindowLostFocus();
+	EXPECT_EQ( 1, upper.upCount );
+	EXPECT_FALSE( keyboard.IsKeyDown( Key::S ) );
+	EXPECT_EQ( 0, keyboard.GetModifiers() );
+
+	keyboard.Filter[layers-1].OnKeyUp	-= E::KeyUp::Method<CBL_E_METHOD(KeyboardFilterListener,OnKeyUp)>(&upper);
+	keyboard.Filter[layers-1].OnKeyDown	-= E::KeyDown::Method<CBL_E_METHOD(KeyboardFilterListener,OnKeyDown)>(&upper);
+	keyboard.Filter[0].OnKeyUp		-= E::KeyUp::Method<CBL_E_METHOD(KeyboardFilterListener,OnKeyUp)>(&lower);
+	keyboard.Filter[0].OnKeyDown	-= E::KeyDown::Method<CBL_E_METHOD(KeyboardFilterListener,OnKeyDown)>(&lower);
+	keyboard.Filter.SetStackSize( 0 );
+}
+
+TEST_F( KeyboardManagerFixture, KeyboardManager_BindWindowTest )
+{
+	const bool headless = GameWindow::sHeadless;
+	GameWindow::sHeadless = true;
+	GameWindow viewport( keyboardGame ), debugView( keyboardGame );
+	viewport.Initialise();
+	debugView.Initialise();
+	GameWindow::sHeadless = headless;
+
+	// A manager bound before initialising never listens to the GameWindow service.
+	KeyboardManager viewportKeys( keyboardGame );
+	viewportKeys.BindWindow( &viewport );
+	viewportKeys.Initialise();
+	EXPECT_EQ( &viewport, viewportKeys.GetWindow() );
+
+	ASSERT_TRUE( viewport.InjectInputEvent( InputEvent::Make( InputEventType::KeyDown, 0.0, Key::Q ) ) );
+	ASSERT_TRUE( debugView.InjectInputEvent( InputEvent::Make( InputEventType::KeyDown, 0.0, Key::W ) ) );
+	viewport.Update( cbl::GameTime() );
+	debugView.Update( cbl::GameTime() );
+	EXPECT_TRUE( viewportKeys.IsKeyDown( Key::Q ) );
+	EXPECT_FALSE( viewportKeys.IsKeyDown( Key::W ) );
+
+	// Rebinding releases keys held in the old window.
+	viewportKeys.BindWindow( &debugView );
+	EXPECT_EQ( &debugView, viewportKeys.GetWindow() );
+	EXPECT_FALSE( viewportKeys.IsKeyDown( Key::Q ) );
+
+	ASSERT_TRUE( viewport.InjectInputEvent( InputEvent::Make( InputEventType::KeyDown, 0.0, Key::E ) ) );
+	ASSERT_TRUE( debugView.InjectInputEvent( InputEvent::Make( InputEventType::KeyDown, 0.0, Key::R ) ) );
+	viewport.Update( cbl::GameTime() );
+	debugView.Update( cbl::GameTime() );
+	EXPECT_FALSE( viewportKeys.IsKeyDown( Key::E ) );
+	EXPECT_TRUE( viewportKeys.IsKeyDown( Key::R ) );
+
+	viewportKeys.Shutdown();
+	EXPECT_TRUE( viewportKeys.GetWindow() == NULL );
+	debugView.Shutdown();
+	viewport.Shutdown();
+}
+
+TEST( InputFilterTest, InputFilter_TopTrackingTest )
+{
+	const cbl::Uint32 layers = 32;
+
+	KeyboardManager::FilterEvents filter;
+	EXPECT_EQ( NULL, filter.Top() );
+	EXPECT_EQ( 0, filter.TopIndex() );
+
+	filter.SetStackSize( layers );
+	EXPECT_EQ( layers, filter.TopIndex() );
+
+	filter.Set( 3, true );
+	filter.Set( 10, true );
+	filter.Set( 7, true );
+	EXPECT_EQ( 10, filter.TopIndex() );
+	EXPECT_EQ( &filter[10], filter.Top() );
+	EXPECT_TRUE( filter.GetActive( 10 ) );
+	EXPECT_FALSE( filter.GetActive( 7 ) );
+
+	// Deactivating the top falls back to the next active level.
+	filter.Set( 10, false );
+	EXPECT_EQ( 7, filter.TopIndex() );
+	filter.Set( 3, false );
+	EXPECT_EQ( 7, filter.TopIndex() );
+	filter.Set( 7, false );
+	EXPECT_EQ( NULL, filter.Top() );
+	EXPECT_EQ( layers, filter.TopIndex() );
+
+	// Shrinking the stack drops active levels above the new size.
+	filter.Set( 2, true );
+	filter.Set( layers-1, true );
+	filter.SetStackSize( 16 );
+	EXPECT_EQ( 2, filter.TopIndex() );
+
+	// Levels keep their filter events when the stack grows, and don't share them.
+	KeyboardManager::FilterEvent* top = filter.Top();
+	filter.SetStackSize( layers * 4 );
+	EXPECT_EQ( top, filter.Top() );
+	EXPECT_EQ( top, &filter[2] );
+	EXPECT_NE( &filter[layers], &filter[layers+1] );
+}
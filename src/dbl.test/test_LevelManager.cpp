@@ -57,6 +57,7 @@ public:
 	, LoadBeginDone( false )
 	, LoadEndDone( false )
 	, Binary( false )
+	, JSON( false )
 	{
 		LM.MaxLoadBatchTime = DBL_MAX;
 
@@ -83,6 +84,7 @@ public:
 			}
 			LM.Save<YAMLSerialiser>( "lmobjs.yaml" );
 			LM.Save<cbl::BinarySerialiser>( "lmobjs.bin" );
+			LM.Save<JSONSerialiser>( "lmobjs.json" );
 		}
 
 		Objects.DestroyAll();
@@ -105,6 +107,8 @@ public:
 			CheckNoObjects();
 			if( Binary )
 				LM.Load<cbl::BinaryDeserialiser>( "lmobjs.bin" );
+			else if( JSON )
+				LM.Load<JSONDeserialiser>( "lmobjs.json" );
 			else
 				LM.Load<YAMLDeserialiser>( "lmobjs.yaml" );
 		}
@@ -150,6 +154,7 @@ public:
 	bool		LoadBeginDone;
 	bool		LoadEndDone;
 	bool		Binary;
+	bool		JSON;
 };
 
 namespace cbl
@@ -206,4 +211,23 @@ TEST( LevelManagerTestFixture, LevelManagerTest_Binary )
 	ASSERT_TRUE( game.LoadEndDone );
 
 	ForceReconstructEntityManager_LM();
-}
\ No newline at end of file
+}
+
+TEST( LevelManagerTestFixture, LevelManagerTest_JSON )
+{
+	CBL_ENT.Types.Create<LMPartTest>()
+		.Base<cbl::ObjectPart>()
+		.CBL_FIELD( Value, LMPartTest );
+
+	LevelManagerGameTest game( "LMTest" );
+	game.JSON = true;
+
+	game.Run();
+
+	ASSERT_TRUE( game.SaveBeginDone );
+	ASSERT_TRUE( game.SaveEndDone );
+	ASSERT_TRUE( game.LoadBeginDone );
+	ASSERT_TRUE( game.LoadEndDone );
+
+	ForceReconstructEntityManager_LM();
+}
@@ -28,6 +28,8 @@
 #include <dbl/Input/MouseManager.h>
 //#include <dbl/Input/MouseEvents.h>
 #include <dbl/Core/Game.h>
+#include <dbl/Input/InputSnapshot.h>
+#include <dbl/Threading/Thread.h>
 
 // Chewable Headers //
 #include <cbl/Util/Stopwatch.h>
@@ -160,3 +162,137 @@ TEST_F( MouseManagerFixture, MouseManager_KeyTest )
 {
 	mouseGame.Run();
 }
+
+struct MouseMotionListener
+{
+	MouseMotionListener() : moveCount( 0 ), dragCount( 0 ), x( 0 ), y( 0 ), diffx( 0 ), diffy( 0 ) {}
+
+	void OnMouseMove( cbl::Int32 mx, cbl::Int32 my, cbl::Int32 dx, cbl::Int32 dy )
+	{
+		++moveCount;
+		x = mx; y = my; diffx = dx; diffy = dy;
+	}
+
+	void OnMouseDrag( cbl::Int32, cbl::Int32, cbl::Int32, cbl::Int32, Mouse::Button )
+	{
+		++dragCount;
+	}
+
+	cbl::Uint32	moveCount, dragCount;
+	cbl::Int32	x, y, diffx, diffy;
+};
+
+TEST_F( MouseManagerFixture, MouseManager_CoalescedMotionTest )
+{
+	const cbl::Uint32 frames = 1000;
+	const cbl::Uint32 moves = 100;
+
+	MouseManager& mouse = mouseGame.Mouse;
+	MouseMotionListener listener;
+	mouse.OnMouseMove	+= E::MouseMove::Method<CBL_E_METHOD(MouseMotionListener,OnMouseMove)>(&listener);
+	mouse.OnMouseDrag	+= E::MouseDrag::Method<CBL_E_METHOD(MouseMotionListener,OnMouseDrag)>(&listener);
+
+	mouse.OnWindowMouseMove( 10, 10 );
+	EXPECT_EQ( 1, listener.moveCount );
+
+	// Several moves in one frame become a single move with the summed delta.
+	mouse.SetMotionCoalescing( true, true );
+	mouse.OnWindowMouseDown( 10, 10, Mouse::Left );
+	mouse.OnWindowMouseMove( 12, 11 );
+	mouse.OnWindowMouseMove( 15, 13 );
+	mouse.OnWindowMouseMove( 20, 20 );
+	EXPECT_EQ( 1, listener.moveCount );
+	mouse.Update( cbl::GameTime() );
+	EXPECT_EQ( 2, listener.moveCount );
+	EXPECT_EQ( 1, listener.dragCount );
+	EXPECT_EQ( 20, listener.x );
+	EXPECT_EQ( 20, listener.y );
+	EXPECT_EQ( 10, listener.diffx );
+	EXPECT_EQ( 10, listener.diffy );
+
+	ASSERT_EQ( 3, mouse.GetMotionSamples().size() );
+	EXPECT_EQ( 12, mouse.GetMotionSamples()[0].X );
+	EXPECT_EQ( 3, mouse.GetMotionSamples()[1].DiffX );
+	EXPECT_EQ( 7, mouse.GetMotionSamples()[2].DiffY );
+
+	// Frames without motion fire nothing.
+	mouse.OnWindowMouseUp( 20, 20, Mouse::Left );
+	mouse.Update( cbl::GameTime() );
+	EXPECT_EQ( 2, listener.moveCount );
+	EXPECT_TRUE( mouse.GetMotionSamples().empty() );
+
+	// Many moves a frame still fire once a frame.
+	for( cbl::Uint32 i = 0; i < frames; ++i ) {
+		for( cbl::Uint32 j = 0; j < moves; ++j )
+			mouse.OnWindowMouseMove( cbl::Int32( i * moves + j ), 20 );
+		mouse.Update( cbl::GameTime() );
+	}
+	EXPECT_EQ( 2 + frames, listener.moveCount );
+
+	mouse.SetMotionCoalescing( false );
+	mouse.OnMouseDrag	-= E::MouseDrag::Method<CBL_E_METHOD(MouseMotionListener,OnMouseDrag)>(&listener);
+	mouse.OnMouseMove	-= E::MouseMove::Method<CBL_E_METHOD(MouseMotionListener,OnMouseMove)>(&listener);
+}
+
+struct SnapshotJob
+{
+	InputSnapshot	snapshot;
+	bool			fireHeld;
+	cbl::Int32		motion;
+};
+
+void _readSnapshot( void * arg )
+{
+	SnapshotJob* job = static_cast< SnapshotJob* >( arg );
+	job->fireHeld = job->snapshot.IsButtonDown( Mouse::Left ) && job->snapshot.IsKeyDown( Key::LCtrl );
+	job->motion = job->snapshot.DiffX + job->snapshot.DiffY;
+}
+
+TEST_F( MouseManagerFixture, MouseManager_InputSnapshotTest )
+{
+	MouseManager& mouse = mouseGame.Mouse;
+	KeyboardManager& keyboard = mouseGame.Keyboard;
+
+	keyboard.OnWindowKeyDown( Key::LCtrl );
+	mouse.OnWindowMouseMove( 10, 10 );
+	mouse.OnWindowMouseMove( 14, 13 );
+	mouse.OnWindowMouseDown( 14, 13, Mouse::Left );
+	mouse.OnWindowMouseWheel( 120 );
+
+	// Nothing is visible until the managers latch the frame.
+	InputSnapshot snapshot;
+	mouseGame.GetInputSnapshot( snapshot );
+	EXPECT_FALSE( snapshot.IsKeyDown( Key::LCtrl ) );
+	EXPECT_FALSE( snapshot.IsButtonDown( Mouse::Left ) );
+
+	keyboard.Update( cbl::GameTime() );
+	mouse.Update( cbl::GameTime() );
+	mouseGame.GetInputSnapshot( snapshot );
+	EXPECT_TRUE( snapshot.IsKeyPressed( Key::LCtrl ) );
+	EXPECT_EQ( Key::Modifier::Ctrl, snapshot.Modifiers );
+	EXPECT_TRUE( snapshot.IsButtonPressed( Mouse::Left ) );
+	EXPECT_EQ( 14, snapshot.X );
+	EXPECT_EQ( 13, snapshot.Y );
+	EXPECT_EQ( 120, snapshot.Wheel );
+
+	// Hand a copy to another thread while the managers move on.
+	SnapshotJob job;
+	job.snapshot = snapshot;
+	job.fireHeld = false;
+	job.motion = 0;
+	Thread worker;
+	ASSERT_TRUE( worker.Start( _readSnapshot, &job ) );
+	keyboard.OnWindowKeyUp( Key::LCtrl );
+	mouse.OnWindowMouseUp( 14, 13, Mouse::Left );
+	worker.Join();
+	EXPECT_TRUE( job.fireHeld );
+	EXPECT_EQ( snapshot.DiffX + snapshot.DiffY, job.motion );
+
+	keyboard.Update( cbl::GameTime() );
+	mouse.Update( cbl::GameTime() );
+	mouseGame.GetInputSnapshot( snapshot );
+	EXPECT_TRUE( snapshot.IsKeyReleased( Key::LCtrl ) );
+	EXPECT_TRUE( snapshot.IsButtonReleased( Mouse::Left ) );
+	EXPECT_EQ( 0, snapshot.DiffX );
+	EXPECT_EQ( 0, snapshot.Wheel );
+}
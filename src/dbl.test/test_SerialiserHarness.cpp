@@ -0,0 +1,457 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_SerialiserHarness.cpp
+ * @brief Round-trip fuzz and throughput harness for the serialisers.
+ */
+
+// Precompiled Headers //
+#include <dbl/StdAfx.h>
+
+// Delectable Headers //
+#include <dbl/Serialisation/YAMLSerialiser.h>
+#include <dbl/Serialisation/YAMLDeserialiser.h>
+#include <dbl/Threading/Atomic.h>
+#include <dbl/Threading/Thread.h>
+
+// Chewable Headers //
+#include <cbl/Serialisation/BinarySerialiser.h>
+#include <cbl/Serialisation/BinaryDeserialiser.h>
+#include <cbl/Util/Stopwatch.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+#include <yaml-cpp/yaml.h>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+using namespace dbl;
+
+/***** Allocation counting *****/
+// The replaced operators serve the whole test binary, including other tests' worker threads,
+// so allocations are only counted inside an AllocationScope and on the thread that opened it.
+volatile cbl::Uint32 sHarnessAllocations	= 0;
+volatile cbl::Uint32 sHarnessCounting		= 0;
+cbl::Uint64 sHarnessThread					= 0;
+
+// On Win32 the replacements only serve this executable. A dbl or cbl DLL allocates through its own
+// CRT, so the serialisers' allocations are only seen when the libraries are linked statically.
+#if CBL_PLATFORM != CBL_PLATFORM_WIN32 || defined( DBL_STATIC_LIB )
+static const bool sHarnessCountsLibraries	= true;
+#else
+static const bool sHarnessCountsLibraries	= false;
+#endif
+
+void* operator new( size_t size )
+{
+	if( Atomic::LoadAcquire( sHarnessCounting ) && Thread::GetCurrentId() == sHarnessThread )
+		Atomic::Increment( sHarnessAllocations );
+	if( void* p = malloc( size ? size : 1 ) )
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[]( size_t size )
+{
+	return operator new( size );
+}
+
+void operator delete( void* p ) throw()
+{
+	free( p );
+}
+
+void operator delete[]( void* p ) throw()
+{
+	free( p );
+}
+
+//! Counts the current thread's allocations while in scope. Scopes don't nest.
+class AllocationScope
+{
+public:
+	AllocationScope() {
+		sHarnessThread = Thread::GetCurrentId();
+		Atomic::Exchange( sHarnessAllocations, 0 );
+		Atomic::StoreRelease( sHarnessCounting, 1 );
+	}
+
+	~AllocationScope() {
+		Atomic::StoreRelease( sHarnessCounting, 0 );
+	}
+
+	cbl::Uint32 GetCount( void ) const {
+		return Atomic::LoadAcquire( sHarnessAllocations );
+	}
+};
+
+/***** Fuzz types *****/
+struct FuzzLeaf
+{
+	cbl::Int32		Integer;
+	cbl::Float32	Real;
+	cbl::String		Text;
+
+	FuzzLeaf() : Integer( 0 ), Real( 0.0f ) {}
+};
+
+struct FuzzNode
+	: public cbl::Entity
+{
+	cbl::Int32					Id;
+	cbl::String					Name;
+	std::vector<cbl::Int32>		Values;
+	std::vector<FuzzLeaf>		Leaves;
+	std::vector<FuzzNode*>		Children;
+
+	FuzzNode() : Id( 0 ) {}
+	virtual ~FuzzNode() {
+		for( size_t i = 0; i < Children.size(); ++i )
+			CBL_DELETE( Children[i] );
+	}
+
+	virtual cbl::Entity::OPTIONS OnPreChanged( void ) { return cbl::Entity::O_NORMAL; }
+	virtual void OnChanged( void ) {}
+	virtual cbl::Entity::OPTIONS OnPreSaved( void ) const { return cbl::Entity::O_NORMAL; }
+	virtual void OnSaved( void ) const {}
+};
+
+CBL_TYPE( FuzzLeaf, FuzzLeaf );
+CBL_TYPE( FuzzNode, FuzzNode );
+
+namespace cbl
+{
+	struct DummAccessHarness {};
+	template<>
+	DummAccessHarness* EntityManager::New<DummAccessHarness>( void ) const
+	{
+		this->EntityManager::~EntityManager();
+		this->EntityManager::EntityManager();
+		cbl::CblRegistrar::RegisterCblTypes();
+		dbl::DblRegistrar::RegisterDblTypes();
+		return NULL;
+	}
+}
+void ForceReconstructEntityManager_Harness( void )
+{
+	using namespace cbl;
+	const_cast<EntityManager*>( EntityManager::InstancePtr() )->New<DummAccessHarness>();
+}
+
+/***** Graph generation *****/
+//! Deterministic generator so failures can be reproduced from the seed.
+class FuzzRandom
+{
+public:
+	explicit FuzzRandom( cbl::Uint32 seed ) : mState( seed ? seed : 1 ) {}
+
+	cbl::Uint32 Next( void ) {
+		mState = mState * 1664525u + 1013904223u;
+		return mState >> 8;
+	}
+
+	cbl::Uint32 Range( cbl::Uint32 lo, cbl::Uint32 hi ) {
+		return lo + Next() % ( hi - lo + 1 );
+	}
+
+private:
+	cbl::Uint32	mState;
+};
+
+//! Limits of a generated graph.
+struct FuzzShape
+{
+	cbl::Uint32	MaxDepth;
+	cbl::Uint32	MaxChildren;
+	cbl::Uint32	MaxValues;
+	cbl::Uint32	MaxLeaves;
+	cbl::Uint32	MaxText;
+};
+
+void _fuzzText( FuzzRandom& rng, cbl::Uint32 maxLength, cbl::String& out )
+{
+	// Include characters that need quoting or escaping in text formats.
+	static const cbl::Char sChars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 :#-'\"{}[],&*!|>%@`\\";
+	cbl::Uint32 length = rng.Range( 1, maxLength );
+	out.resize( length );
+	for( cbl::Uint32 i = 0; i < length; ++i )
+		out[i] = sChars[ rng.Next() % ( sizeof( sChars ) - 1 ) ];
+}
+
+FuzzNode* _fuzzNode( FuzzRandom& rng, const FuzzShape& shape, cbl::Uint32 depth, cbl::Uint32& count )
+{
+	FuzzNode* node = CBL_ENT.New<FuzzNode>();
+	node->Id = cbl::Int32( rng.Next() ) - 0x400000;
+	_fuzzText( rng, shape.MaxText, node->Name );
+	++count;
+
+	node->Values.resize( rng.Range( 0, shape.MaxValues ) );
+	for( size_t i = 0; i < node->Values.size(); ++i )
+		node->Values[i] = cbl::Int32( rng.Next() ) - 0x400000;
+
+	node->Leaves.resize( rng.Range( 0, shape.MaxLeaves ) );
+	for( size_t i = 0; i < node->Leaves.size(); ++i ) {
+		FuzzLeaf& leaf = node->Leaves[i];
+		leaf.Integer = cbl::Int32( rng.Next() );
+		// Quarter steps are exact in decimal text, so text formats compare exactly.
+		leaf.Real = cbl::Float32( cbl::Int32( rng.Range( 0, 8000 ) ) - 4000 ) * 0.25f;
+		_fuzzText( rng, shape.MaxText, leaf.Text );
+	}
+
+	if( depth < shape.MaxDepth ) {
+		cbl::Uint32 children = rng.Range( 0, shape.MaxChildren );
+		for( cbl::Uint32 i = 0; i < children; ++i )
+			node->Children.push_back( _fuzzNode( rng, shape, depth + 1, count ) );
+	}
+
+	return node;
+}
+
+::testing::AssertionResult _fuzzEqual( const FuzzNode& lhs, const FuzzNode& rhs )
+{
+	if( lhs.Id != rhs.Id || lhs.Name != rhs.Name )
+		return ::testing::AssertionFailure() << "Node " << lhs.Id << " differs.";
+	if( lhs.Values != rhs.Values )
+		return ::testing::AssertionFailure() << "Node " << lhs.Id << " values differ.";
+	if( lhs.Leaves.size() != rhs.Leaves.size() || lhs.Children.size() != rhs.Children.size() )
+		return ::testing::AssertionFailure() << "Node " << lhs.Id << " sizes differ.";
+
+	for( size_t i = 0; i < lhs.Leaves.size(); ++i ) {
+		const FuzzLeaf& l = lhs.Leaves[i];
+		const FuzzLeaf& r = rhs.Leaves[i];
+		if( l.Integer != r.Integer || l.Real != r.Real || l.Text != r.Text )
+			return ::testing::AssertionFailure() << "Node " << lhs.Id << " leaf " << i << " differs.";
+	}
+
+	for( size_t i = 0; i < lhs.Children.size(); ++i ) {
+		if( !lhs.Children[i] || !rhs.Children[i] )
+			return ::testing::AssertionFailure() << "Node " << lhs.Id << " child " << i << " missing.";
+		::testing::AssertionResult result = _fuzzEqual( *lhs.Children[i], *rhs.Children[i] );
+		if( !result )
+			return result;
+	}
+
+	return ::testing::AssertionSuccess();
+}
+
+/***** Round trips *****/
+//! Measurements of a single round trip.
+struct RoundTripStats
+{
+	size_t			Bytes;
+	cbl::Float64	WriteSeconds;
+	cbl::Float64	ReadSeconds;
+	cbl::Uint32		WriteAllocations;
+	cbl::Uint32		ReadAllocations;
+
+	RoundTripStats() : Bytes( 0 ), WriteSeconds( 0.0 ), ReadSeconds( 0.0 ), WriteAllocations( 0 ), ReadAllocations( 0 ) {}
+};
+
+void _roundTripYAML( const FuzzNode& source, FuzzNode& result, RoundTripStats& stats )
+{
+	YAML::Emitter e;
+	{
+		AllocationScope allocations;
+		cbl::Stopwatch timer;
+		YAMLSerialiser()
+			.SetStream( e )
+			.Serialise( source );
+		stats.WriteSeconds		= timer.GetElapsedTime().TotalSeconds();
+		stats.WriteAllocations	= allocations.GetCount();
+	}
+
+	stats.Bytes = e.size();
+	std::istringstream is( e.c_str() );
+
+	AllocationScope allocations;
+	cbl::Stopwatch timer;
+	YAML::Parser parser( is );
+	YAMLDeserialiser()
+		.SetStream( parser )
+		.Deserialise( result );
+	stats.ReadSeconds		= timer.GetElapsedTime().TotalSeconds();
+	stats.ReadAllocations	= allocations.GetCount();
+}
+
+void _roundTripBinary( const FuzzNode& source, FuzzNode& result, RoundTripStats& stats )
+{
+	std::ostringstream os( std::ios_base::binary );
+	{
+		AllocationScope allocations;
+		cbl::Stopwatch timer;
+		cbl::BinarySerialiser bs;
+		bs.SetStream( os );
+		bs.Serialise( source );
+		stats.WriteSeconds		= timer.GetElapsedTime().TotalSeconds();
+		stats.WriteAllocations	= allocations.GetCount();
+	}
+
+	const std::string data = os.str();
+	stats.Bytes = data.size();
+	std::istringstream is( data, std::ios_base::binary );
+
+	AllocationScope allocations;
+	cbl::Stopwatch timer;
+	cbl::BinaryDeserialiser bd;
+	bd.SetStream( is );
+	bd.Deserialise( result );
+	stats.ReadSeconds		= timer.GetElapsedTime().TotalSeconds();
+	stats.ReadAllocations	= allocations.GetCount();
+}
+
+class SerialiserHarnessFixture : public ::testing::Test
+{
+public:
+	void SetUp()
+	{
+		CBL_ENT.Types.Create<FuzzLeaf>()
+			.CBL_FIELD( Integer, FuzzLeaf )
+			.CBL_FIELD( Real, FuzzLeaf )
+			.CBL_FIELD( Text, FuzzLeaf );
+		CBL_ENT.Types.Create<FuzzNode>()
+			.CBL_FIELD( Id, FuzzNode )
+			.CBL_FIELD( Name, FuzzNode )
+			.CBL_FIELD( Values, FuzzNode )
+			.CBL_FIELD( Leaves, FuzzNode )
+			.CBL_FIELD( Children, FuzzNode );
+	}
+
+	void TearDown()
+	{
+		ForceReconstructEntityManager_Harness();
+	}
+
+	//! Round trip a graph through both paths, then across formats, and compare.
+	void RoundTrip( const FuzzNode& source, cbl::Uint32 objects, bool report )
+	{
+		RoundTripStats stats;
+		{
+			FuzzNode result;
+			_roundTripYAML( source, result, stats );
+			ASSERT_TRUE( _fuzzEqual( source, result ) );
+			if( report ) Report( "YAML", stats, objects );
+		}
+		{
+			FuzzNode result;
+			_roundTripBinary( source, result, stats );
+			ASSERT_TRUE( _fuzzEqual( source, result ) );
+			if( report ) Report( "Binary", stats, objects );
+		}
+
+		// YAML -> binary, and binary -> YAML.
+		{
+			FuzzNode fromYAML, result;
+			_roundTripYAML( source, fromYAML, stats );
+			_roundTripBinary( fromYAML, result, stats );
+			ASSERT_TRUE( _fuzzEqual( source, result ) );
+		}
+		{
+			FuzzNode fromBinary, result;
+			_roundTripBinary( source, fromBinary, stats );
+			_roundTripYAML( fromBinary, result, stats );
+			ASSERT_TRUE( _fuzzEqual( source, result ) );
+		}
+	}
+
+	//! Record a round trip's measurements as test properties (in the XML output).
+	void Report( const cbl::String& path, const RoundTripStats& stats, cbl::Uint32 objects )
+	{
+		const cbl::Float64 kb = cbl::Float64( stats.Bytes ) / 1024.0;
+		RecordProperty( ( path + "Bytes" ).c_str(), int( stats.Bytes ) );
+		RecordProperty( ( path + "WriteKBps" ).c_str(), stats.WriteSeconds > 0.0 ? int( kb / stats.WriteSeconds ) : 0 );
+		RecordProperty( ( path + "ReadKBps" ).c_str(), stats.ReadSeconds > 0.0 ? int( kb / stats.ReadSeconds ) : 0 );
+		if( !sHarnessCountsLibraries )
+			return;
+		RecordProperty( ( path + "WriteAllocationsPerObject" ).c_str(), int( stats.WriteAllocations / objects ) );
+		RecordProperty( ( path + "ReadAllocationsPerObject" ).c_str(), int( stats.ReadAllocations / objects ) );
+	}
+};
+
+TEST_F( SerialiserHarnessFixture, SerialiserHarness_RandomGraphs )
+{
+	const FuzzShape shape = { 4, 4, 32, 8, 24 };
+
+	for( cbl::Uint32 seed = 1; seed <= 16; ++seed ) {
+		SCOPED_TRACE( seed );
+		FuzzRandom rng( seed );
+		cbl::Uint32 count = 0;
+		FuzzNode* root = _fuzzNode( rng, shape, 0, count );
+		RoundTrip( *root, count, false );
+		CBL_DELETE( root );
+	}
+}
+
+TEST_F( SerialiserHarnessFixture, SerialiserHarness_Throughput )
+{
+	const FuzzShape shape = { 5, 5, 64, 8, 32 };
+
+	FuzzRandom rng( 0xDB1 );
+	cbl::Uint32 count = 0;
+	FuzzNode* root = _fuzzNode( rng, shape, 0, count );
+	RecordProperty( "Objects", int( count ) );
+	RoundTrip( *root, count, true );
+	CBL_DELETE( root );
+}
+
+TEST_F( SerialiserHarnessFixture, SerialiserHarness_DeepNesting )
+{
+	const FuzzShape shape = { 0, 0, 2, 1, 8 };
+	const cbl::Uint32 depth = 256;
+
+	FuzzRandom rng( 7 );
+	cbl::Uint32 count = 0;
+	FuzzNode* root = _fuzzNode( rng, shape, 0, count );
+	FuzzNode* tail = root;
+	for( cbl::Uint32 i = 0; i < depth; ++i ) {
+		tail->Children.push_back( _fuzzNode( rng, shape, 0, count ) );
+		tail = tail->Children.back();
+	}
+
+	RoundTrip( *root, count, false );
+	CBL_DELETE( root );
+}
+
+TEST_F( SerialiserHarnessFixture, SerialiserHarness_HugeSequence )
+{
+	FuzzNode* root = CBL_ENT.New<FuzzNode>();
+	root->Values.resize( 200000 );
+	for( size_t i = 0; i < root->Values.size(); ++i )
+		root->Values[i] = cbl::Int32( i * 7919 ) - 100000;
+
+	RoundTrip( *root, 1, true );
+	CBL_DELETE( root );
+}
+
+TEST_F( SerialiserHarnessFixture, SerialiserHarness_LongStrings )
+{
+	FuzzRandom rng( 11 );
+	FuzzNode* root = CBL_ENT.New<FuzzNode>();
+	_fuzzText( rng, 1, root->Name );
+	root->Name.reserve( 1 << 20 );
+	while( root->Name.size() < ( 1 << 20 ) ) {
+		cbl::String chunk;
+		_fuzzText( rng, 256, chunk );
+		root->Name += chunk;
+	}
+
+	RoundTrip( *root, 1, true );
+	CBL_DELETE( root );
+}
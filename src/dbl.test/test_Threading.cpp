@@ -0,0 +1,187 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_Threading.cpp
+ * @brief Unit testing for the lock-free threading primitives.
+ */
+
+// Precompiled Headers //
+#include <dbl/StdAfx.h>
+
+// Delectable Headers //
+#include <dbl/Threading/EventBus.h>
+#include <dbl/Threading/RingBuffer.h>
+#include <dbl/Threading/Thread.h>
+#include <dbl/Threading/TripleBuffer.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace dbl;
+
+namespace
+{
+	const cbl::Uint32 sItemCount = 1000000;
+
+	void _produceSequence( void * arg )
+	{
+		RingBuffer< cbl::Uint32 >* buffer = static_cast< RingBuffer< cbl::Uint32 >* >( arg );
+		for( cbl::Uint32 i = 0; i < sItemCount; ) {
+			if( buffer->Push( i ) )
+				++i;
+		}
+	}
+
+	const cbl::Uint32 sProducerCount = 4;
+	const cbl::Uint32 sPostCount = 100000;
+
+	struct PostedEvent
+	{
+		cbl::Uint32 Producer;
+		cbl::Uint32 Sequence;
+	};
+
+	struct BusProducer
+	{
+		EventBus< PostedEvent >*	Bus;
+		cbl::Uint32					Index;
+	};
+
+	void _postSequence( void * arg )
+	{
+		BusProducer* producer = static_cast< BusProducer* >( arg );
+		for( cbl::Uint32 i = 0; i < sPostCount; ) {
+			PostedEvent ev = { producer->Index, i };
+			if( producer->Bus->Post( ev ) )
+				++i;
+		}
+	}
+
+	struct SampledPair
+	{
+		cbl::Uint32 Value;
+		cbl::Uint32 Check;
+	};
+
+	void _publishPairs( void * arg )
+	{
+		TripleBuffer< SampledPair >* buffer = static_cast< TripleBuffer< SampledPair >* >( arg );
+		for( cbl::Uint32 i = 1; i <= sItemCount; ++i ) {
+			SampledPair& pair = buffer->GetWriteBuffer();
+			pair.Value = i;
+			pair.Check = ~i;
+			buffer->Publish();
+		}
+	}
+}
+
+TEST( ThreadingTest, Threading_RingBufferSingleThread )
+{
+	RingBuffer< cbl::Uint32 > buffer( 5 );
+	ASSERT_EQ( 8, buffer.Capacity() );
+	EXPECT_TRUE( buffer.Empty() );
+
+	for( cbl::Uint32 i = 0; i < 8; ++i )
+		EXPECT_TRUE( buffer.Push( i ) );
+	EXPECT_FALSE( buffer.Push( 8 ) );
+	EXPECT_EQ( 8, buffer.Size() );
+
+	cbl::Uint32 value = 0;
+	for( cbl::Uint32 i = 0; i < 8; ++i ) {
+		ASSERT_TRUE( buffer.Pop( value ) );
+		EXPECT_EQ( i, value );
+	}
+	EXPECT_FALSE( buffer.Pop( value ) );
+}
+
+TEST( ThreadingTest, Threading_RingBufferProducerConsumer )
+{
+	RingBuffer< cbl::Uint32 > buffer( 1024 );
+
+	Thread producer;
+	ASSERT_TRUE( producer.Start( &_produceSequence, &buffer ) );
+
+	cbl::Uint32 expected = 0, value = 0;
+	while( expected < sItemCount ) {
+		if( buffer.Pop( value ) ) {
+			ASSERT_EQ( expected, value );
+			++expected;
+		}
+	}
+	producer.Join();
+
+	EXPECT_TRUE( buffer.Empty() );
+}
+
+TEST( ThreadingTest, Threading_TripleBufferLatestState )
+{
+	TripleBuffer< SampledPair > buffer;
+	EXPECT_FALSE( buffer.Update() );
+
+	Thread writer;
+	ASSERT_TRUE( writer.Start( &_publishPairs, &buffer ) );
+
+	// Every state picked up must be complete and newer than the last.
+	cbl::Uint32 last = 0;
+	while( last < sItemCount ) {
+		if( buffer.Update() ) {
+			const SampledPair& pair = buffer.GetReadBuffer();
+			ASSERT_EQ( ~pair.Value, pair.Check );
+			ASSERT_GT( pair.Value, last );
+			last = pair.Value;
+		}
+	}
+	writer.Join();
+
+	EXPECT_FALSE( buffer.Update() );
+}
+
+TEST( ThreadingTest, Threading_EventBusMultipleProducers )
+{
+	EventBus< PostedEvent > bus( 256 );
+
+	Thread threads[ sProducerCount ];
+	BusProducer producers[ sProducerCount ];
+	for( cbl::Uint32 i = 0; i < sProducerCount; ++i ) {
+		producers[i].Bus = &bus;
+		producers[i].Index = i;
+		ASSERT_TRUE( threads[i].Start( &_postSequence, &producers[i] ) );
+	}
+
+	// Each producer's events must arrive complete and in order.
+	cbl::Uint32 expected[ sProducerCount ] = { 0 };
+	cbl::Uint32 received = 0;
+	EventBus< PostedEvent >::EventList events;
+	while( received < sProducerCount * sPostCount ) {
+		events.clear();
+		bus.Drain( events );
+		for( size_t i = 0; i < events.size(); ++i ) {
+			ASSERT_LT( events[i].Producer, sProducerCount );
+			ASSERT_EQ( expected[ events[i].Producer ], events[i].Sequence );
+			++expected[ events[i].Producer ];
+		}
+		received += cbl::Uint32( events.size() );
+	}
+	for( cbl::Uint32 i = 0; i < sProducerCount; ++i )
+		threads[i].Join();
+
+	EXPECT_EQ( sProducerCount, bus.GetProducerCount() );
+	events.clear();
+	EXPECT_EQ( 0, bus.Drain( events ) );
+}
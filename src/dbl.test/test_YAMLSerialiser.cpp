@@ -27,11 +27,19 @@
 // Delectable Headers //
 #include <dbl/Serialisation/YAMLSerialiser.h>
 #include <dbl/Serialisation/YAMLDeserialiser.h>
+#include <dbl/Serialisation/BlockSerialisation.h>
+#include <dbl/Serialisation/YAMLStaticCodec.h>
+#include <dbl/Serialisation/PrefabCache.h>
+
+// Chewable Headers //
+#include <cbl/Util/Stopwatch.h>
 
 // Google Test //
 #include <gtest/gtest.h>
 
 #include <yaml-cpp/yaml.h>
+#include <fstream>
+#include <sstream>
 
 using namespace dbl;
 
@@ -613,4 +621,230 @@ TEST( YAMLSerialiserInheritedPointer, YAML_InheriatedPointer )
 	CBL_DELETE( t.BasePointer );
 
 	ForceReconstructEntityManager_YAML();
-}
\ No newline at end of file
+}
+
+struct BlockPoint
+{
+	cbl::Float32	X;
+	cbl::Float32	Y;
+	cbl::Float32	Z;
+};
+
+struct BlockTest
+{
+	std::vector<cbl::Int32>		Heights;
+	std::vector<BlockPoint>		Points;
+};
+
+CBL_TYPE( BlockPoint, BlockPoint );
+CBL_TYPE( BlockTest, BlockTest );
+
+TEST( YAMLSerialiserBlocks, YAML_BlockTest )
+{
+	CBL_ENT.Types.Create<BlockPoint>()
+		.CBL_FIELD( X, BlockPoint )
+		.CBL_FIELD( Y, BlockPoint )
+		.CBL_FIELD( Z, BlockPoint );
+	CBL_ENT.Types.Create<BlockTest>()
+		.CBL_FIELD( Heights, BlockTest )
+		.CBL_FIELD( Points, BlockTest );
+	DBL_BLOCK_FIELD( Heights, BlockTest );
+	DBL_BLOCK_FIELD( Points, BlockTest );
+
+	BlockTest t;
+	for( cbl::Int32 i = 0; i < 1000; ++i ) {
+		t.Heights.push_back( i * 3 - 500 );
+		BlockPoint p = { cbl::Float32( i ), cbl::Float32( i ) * 0.5f, -cbl::Float32( i ) };
+		t.Points.push_back( p );
+	}
+
+	YAML::Emitter e;
+	YAMLSerialiser s;
+	s
+		.SetStream( e )
+		.Serialise( t );
+
+	{
+		std::istringstream is( e.c_str() );
+		YAML::Parser parser( is );
+		YAML::Node doc;
+		ASSERT_TRUE( parser.GetNextDocument( doc ) );
+		const YAML::Node* heights	= doc.FindValue( "Heights" );
+		const YAML::Node* points	= doc.FindValue( "Points" );
+		ASSERT_TRUE( heights != NULL && points != NULL );
+		ASSERT_EQ( heights->Type(), YAML::NodeType::Sequence );
+		ASSERT_EQ( heights->size(), t.Heights.size() );
+		// Plain structs are written as a single base64 blob.
+		ASSERT_EQ( points->Type(), YAML::NodeType::Scalar );
+	}
+
+	BlockTest r;
+	std::istringstream is( e.c_str() );
+	YAML::Parser parser( is );
+	YAMLDeserialiser()
+		.SetStream( parser )
+		.Deserialise( r );
+
+	ASSERT_EQ( t.Heights.size(), r.Heights.size() );
+	ASSERT_EQ( t.Points.size(), r.Points.size() );
+	for( size_t i = 0; i < t.Heights.size(); ++i )
+		ASSERT_EQ( t.Heights[i], r.Heights[i] );
+	ASSERT_EQ( 0, memcmp( &t.Points[0], &r.Points[0], t.Points.size() * sizeof( BlockPoint ) ) );
+
+	BlockFields::Clear();
+	ForceReconstructEntityManager_YAML();
+}
+
+void _expectSettingsEqual( const GameWindowSettings& lhs, const GameWindowSettings& rhs )
+{
+	ASSERT_EQ( lhs.Title, rhs.Title );
+	ASSERT_EQ( lhs.Style.Close, rhs.Style.Close );
+	ASSERT_EQ( lhs.Style.Minimize, rhs.Style.Minimize );
+	ASSERT_EQ( lhs.Style.Fullscreen, rhs.Style.Fullscreen );
+	ASSERT_TRUE( lhs.Resolution == rhs.Resolution );
+}
+
+TEST( YAMLSerialiserStaticCodec, YAML_StaticCodecTest )
+{
+	GameWindowSettings settings( "Static Codec Window", 1280, 720, 32 );
+	settings.Style.Minimize		= true;
+	settings.Style.Fullscreen	= true;
+
+	ASSERT_TRUE( YAMLStaticCodecs::Find( CBL_ENT.Types.Get( cbl::TypeCName<GameWindowSettings>() ) ) != NULL );
+
+	YAML::Emitter generated, reflected;
+	YAMLSerialiser()
+		.SetStaticCodecsEnabled( true )
+		.SetStream( generated )
+		.Serialise( settings );
+	YAMLSerialiser()
+		.SetStaticCodecsEnabled( false )
+		.SetStream( reflected )
+		.Serialise( settings );
+
+	// Generated output read back reflectively, and vice versa.
+	{
+		GameWindowSettings result( "", 0, 0, 0 );
+		std::istringstream is( generated.c_str() );
+		YAML::Parser parser( is );
+		YAMLDeserialiser()
+			.SetStaticCodecsEnabled( false )
+			.SetStream( parser )
+			.Deserialise( result );
+		_expectSettingsEqual( settings, result );
+	}
+	{
+		GameWindowSettings result( "", 0, 0, 0 );
+		std::istringstream is( reflected.c_str() );
+		YAML::Parser parser( is );
+		YAMLDeserialiser()
+			.SetStaticCodecsEnabled( true )
+			.SetStream( parser )
+			.Deserialise( result );
+		_expectSettingsEqual( settings, result );
+	}
+
+	// Benchmark both paths.
+	const cbl::Uint32 iterations = 2000;
+	cbl::Float64 times[2];
+	for( cbl::Uint32 pass = 0; pass < 2; ++pass ) {
+		bool useStatic = pass == 0;
+		cbl::Stopwatch timer;
+		for( cbl::Uint32 i = 0; i < iterations; ++i ) {
+			YAML::Emitter e;
+			YAMLSerialiser()
+				.SetStaticCodecsEnabled( useStatic )
+				.SetStream( e )
+				.Serialise( settings );
+
+			GameWindowSettings result;
+			std::istringstream is( e.c_str() );
+			YAML::Parser parser( is );
+			YAMLDeserialiser()
+				.SetStaticCodecsEnabled( useStatic )
+				.SetStream( parser )
+				.Deserialise( result );
+		}
+		times[pass] = timer.GetElapsedTime().TotalSeconds();
+	}
+
+	// Recorded in the XML output for comparison between runs.
+	RecordProperty( "Iterations", int( iterations ) );
+	RecordProperty( "GeneratedMicroseconds", int( times[0] * 1000000.0 ) );
+	RecordProperty( "ReflectiveMicroseconds", int( times[1] * 1000000.0 ) );
+}
+
+TEST( YAMLSerialiserPrefab, YAML_PrefabCacheTest )
+{
+	static const cbl::Uint32 sCloneCount = 50;
+	static const cbl::Char* sPrefabFile = "prefab.yaml";
+	cbl::ObjectManager objMgr;
+
+	CBL_ENT.Types.Create<TestObjectPart>()
+		.Base<cbl::ObjectPart>()
+		.CBL_FIELD( Int, TestObjectPart )
+		.CBL_FIELD( Float, TestObjectPart );
+
+	cbl::Object* prefab = objMgr.Create<cbl::Object>( "Prefab" );
+	TestObjectPart* part = prefab->Parts.Add<TestObjectPart>();
+	part->Int = 10;
+	part->Float = 2.5f;
+	objMgr.SaveObjectToFile<YAMLSerialiser>( sPrefabFile, prefab );
+	objMgr.Destroy( prefab );
+	objMgr.Purge();
+
+	ASSERT_FALSE( PrefabCache::IsCached( sPrefabFile ) );
+
+	for( cbl::Uint32 i = 0; i < sCloneCount; ++i ) {
+		char objName[255] = { '\0' };
+		sprintf( objName, "Clone_%d", i );
+		cbl::ObjectPtr clone = objMgr.LoadObjectFromFile<YAMLDeserialiser>( sPrefabFile, objName, false );
+		ASSERT_TRUE( clone != NULL );
+		ASSERT_TRUE( PrefabCache::IsCached( sPrefabFile ) );
+
+		TestObjectPart* top = clone->Parts.Get<TestObjectPart>();
+		ASSERT_TRUE( top != NULL );
+		ASSERT_EQ( 10, top->Int );
+		ASSERT_EQ( 2.5f, top->Float );
+	}
+
+	// A hand edit that keeps the file the same size is still picked up.
+	{
+		std::ifstream in( sPrefabFile, std::ios::in | std::ios::binary );
+		std::ostringstream text;
+		text << in.rdbuf();
+		in.close();
+
+		cbl::String yaml = text.str();
+		const size_t at = yaml.find( "Int: 10" );
+		ASSERT_NE( cbl::String::npos, at );
+		yaml.replace( at, 7, "Int: 20" );
+
+		std::ofstream out( sPrefabFile, std::ios::out | std::ios::binary );
+		out << yaml;
+	}
+
+	ASSERT_FALSE( PrefabCache::IsCached( sPrefabFile ) );
+	cbl::ObjectPtr edited = objMgr.LoadObjectFromFile<YAMLDeserialiser>( sPrefabFile, "Clone_Edited", false );
+	ASSERT_TRUE( edited != NULL );
+	ASSERT_EQ( 20, edited->Parts.Get<TestObjectPart>()->Int );
+
+	// Rewriting the file drops the cached template.
+	prefab = objMgr.Create<cbl::Object>( "Prefab" );
+	part = prefab->Parts.Add<TestObjectPart>();
+	part->Int = 123456;
+	part->Float = 2.5f;
+	objMgr.SaveObjectToFile<YAMLSerialiser>( sPrefabFile, prefab );
+	objMgr.Destroy( prefab );
+	objMgr.Purge();
+
+	ASSERT_FALSE( PrefabCache::IsCached( sPrefabFile ) );
+	cbl::ObjectPtr clone = objMgr.LoadObjectFromFile<YAMLDeserialiser>( sPrefabFile, "Clone_Changed", false );
+	ASSERT_TRUE( clone != NULL );
+	ASSERT_EQ( 123456, clone->Parts.Get<TestObjectPart>()->Int );
+
+	PrefabCache::Clear();
+	objMgr.ForceFullPurge();
+
+	ForceReconstructEntityManager_YAML();
+}
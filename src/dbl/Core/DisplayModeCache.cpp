@@ -0,0 +1,192 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file DisplayModeCache.cpp
+ * @brief Display mode cache.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Core/DisplayModeCache.h"
+#include "SettingsWriter.h"
+
+// External Dependencies //
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace dbl;
+
+static const cbl::Uint32	sCacheMagic		= 0x4D4C4244;	//!< "DBLM"
+static const cbl::Uint32	sCacheVersion	= 1;
+static const cbl::Uint32	sMaxCacheCount	= 0x10000;		//!< Sanity limit on monitor, name and mode counts.
+
+cbl::FileInfo DisplayModeCache::sCacheFile				= cbl::FileInfo( "displaymodes.bin" );
+DisplayModeCache::MonitorMap DisplayModeCache::sMonitors;
+bool DisplayModeCache::sLoaded							= false;
+cbl::Uint32 DisplayModeCache::sGeneration				= 1;
+
+//! Write a value to a binary stream.
+template< typename T >
+void _write( std::ostream & os, const T & value )
+{
+	os.write( reinterpret_cast< const char * >( &value ), sizeof( value ) );
+}
+
+//! Read a value from a binary stream.
+template< typename T >
+bool _read( std::istream & is, T & value )
+{
+	return bool( is.read( reinterpret_cast< char * >( &value ), sizeof( value ) ) );
+}
+
+//! Display mode ordering: width, then height, then colour depth.
+bool _lessMode( const GameWindowSize & lhs, const GameWindowSize & rhs )
+{
+	if( lhs.Width != rhs.Width )
+		return lhs.Width < rhs.Width;
+	if( lhs.Height != rhs.Height )
+		return lhs.Height < rhs.Height;
+	return lhs.BitsPerPixel < rhs.BitsPerPixel;
+}
+
+bool DisplayModeCache::Find( const cbl::String & monitor, DisplayModeList & modes )
+{
+	Load();
+
+	MonitorMap::const_iterator it = sMonitors.find( monitor );
+	if( it == sMonitors.end() )
+		return false;
+
+	modes = it->second;
+	return true;
+}
+
+void DisplayModeCache::Store( const cbl::String & monitor, const DisplayModeList & modes )
+{
+	Load();
+
+	sMonitors[ monitor ] = modes;
+	Save();
+}
+
+void DisplayModeCache::Invalidate( void )
+{
+	// Don't read the file again; everything in it is stale now.
+	sMonitors.clear();
+	sLoaded = true;
+	++sGeneration;
+	Save();
+}
+
+cbl::Uint32 DisplayModeCache::GetGeneration( void )
+{
+	return sGeneration;
+}
+
+void DisplayModeCache::Sort( DisplayModeList & modes )
+{
+	std::sort( modes.begin(), modes.end(), &_lessMode );
+	modes.erase( std::unique( modes.begin(), modes.end() ), modes.end() );
+}
+
+void DisplayModeCache::Load( void )
+{
+	if( sLoaded )
+		return;
+	sLoaded = true;
+
+	const cbl::String fileName = sCacheFile.GetFullFileName();
+	if( fileName.empty() )
+		return;
+
+	std::ifstream is( fileName.c_str(), std::ios::in | std::ios::binary );
+	if( !is.is_open() )
+		return;
+
+	cbl::Uint32 magic = 0, version = 0, monitorCount = 0;
+	if( !_read( is, magic ) || !_read( is, version ) || !_read( is, monitorCount ) ||
+		magic != sCacheMagic || version != sCacheVersion || monitorCount > sMaxCacheCount ) {
+		LOG( cbl::LogLevel::Warning << fileName << " is not a display mode cache, ignoring it." );
+		return;
+	}
+
+	MonitorMap monitors;
+	bool valid = true;
+	for( cbl::Uint32 i = 0; i < monitorCount; ++i ) {
+		cbl::Uint32 nameLength = 0, modeCount = 0;
+		if( !_read( is, nameLength ) || nameLength > sMaxCacheCount ) {
+			valid = false;
+			break;
+		}
+
+		cbl::String monitor( nameLength, '\0' );
+		if( nameLength > 0 && !is.read( &monitor[0], nameLength ) ) {
+			valid = false;
+			break;
+		}
+		if( !_read( is, modeCount ) || modeCount > sMaxCacheCount ) {
+			valid = false;
+			break;
+		}
+
+		DisplayModeList & modes = monitors[ monitor ];
+		modes.resize( modeCount );
+		for( cbl::Uint32 j = 0; j < modeCount && is; ++j ) {
+			_read( is, modes[j].Width );
+			_read( is, modes[j].Height );
+			_read( is, modes[j].BitsPerPixel );
+		}
+	}
+
+	// A truncated or corrupt cache is worse than none; the modes will be enumerated again.
+	if( !valid || !is ) {
+		LOG( cbl::LogLevel::Warning << fileName << " is truncated or corrupt, ignoring it." );
+		return;
+	}
+
+	sMonitors.swap( monitors );
+}
+
+void DisplayModeCache::Save( void )
+{
+	const cbl::String fileName = sCacheFile.GetFullFileName();
+	if( fileName.empty() )
+		return;
+
+	// Build the cache in memory so a failed write never leaves a half-written file behind.
+	std::ostringstream os( std::ios::out | std::ios::binary );
+	_write( os, sCacheMagic );
+	_write( os, sCacheVersion );
+	_write( os, cbl::Uint32( sMonitors.size() ) );
+	CBL_FOREACH_CONST( MonitorMap, it, sMonitors ) {
+		_write( os, cbl::Uint32( it->first.length() ) );
+		os.write( it->first.c_str(), std::streamsize( it->first.length() ) );
+		_write( os, cbl::Uint32( it->second.size() ) );
+		CBL_FOREACH_CONST( DisplayModeList, mode, it->second ) {
+			_write( os, mode->Width );
+			_write( os, mode->Height );
+			_write( os, mode->BitsPerPixel );
+		}
+	}
+
+	SettingsWriter::WriteAtomic( fileName, os.str() );
+}
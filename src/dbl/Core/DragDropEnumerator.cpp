@@ -0,0 +1,215 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file DragDropEnumerator.cpp
+ * @brief Background expansion of dropped folders.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "DragDropEnumerator.h"
+
+// External Libraries //
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string.h>
+#endif
+
+using namespace dbl;
+
+static const cbl::Uint32	sBatchQueueSize		= 16;	//!< Batches that can wait for the main thread.
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+static const cbl::Char		sPathSeparator		= '\\';
+#else
+static const cbl::Char		sPathSeparator		= '/';
+#endif
+
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+//! Convert a path to an extended-length path, which isn't limited to MAX_PATH.
+std::wstring _toLongPath( const cbl::String & path )
+{
+	std::wstring wide;
+	const int length = ::MultiByteToWideChar( CP_ACP, 0, path.c_str(), int( path.length() ), NULL, 0 );
+	wide.resize( size_t( length ) );
+	if( length > 0 )
+		::MultiByteToWideChar( CP_ACP, 0, path.c_str(), int( path.length() ), &wide[0], length );
+
+	if( wide.compare( 0, 4, L"\\\\?\\" ) == 0 )
+		return wide;
+
+	// The prefix turns off path parsing, so it only works on absolute paths.
+	const DWORD fullLength = ::GetFullPathNameW( wide.c_str(), 0, NULL, NULL );
+	if( fullLength > 0 ) {
+		std::wstring full( size_t( fullLength ), L'\0' );
+		full.resize( ::GetFullPathNameW( wide.c_str(), fullLength, &full[0], NULL ) );
+		wide.swap( full );
+	}
+
+	if( wide.compare( 0, 2, L"\\\\" ) == 0 )
+		return L"\\\\?\\UNC\\" + wide.substr( 2 );
+	return L"\\\\?\\" + wide;
+}
+
+//! Convert a file name from the wide character API.
+cbl::String _fromWide( const wchar_t * name )
+{
+	cbl::String narrow;
+	const int length = ::WideCharToMultiByte( CP_ACP, 0, name, -1, NULL, 0, NULL, NULL );
+	if( length > 1 ) {
+		narrow.resize( size_t( length - 1 ) );
+		::WideCharToMultiByte( CP_ACP, 0, name, -1, &narrow[0], length, NULL, NULL );
+	}
+	return narrow;
+}
+#endif
+
+//! Check if a path is a folder that should be expanded.
+bool _isFolder( const cbl::String & path )
+{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	const DWORD attributes = ::GetFileAttributesW( _toLongPath( path ).c_str() );
+	return attributes != INVALID_FILE_ATTRIBUTES && ( attributes & FILE_ATTRIBUTE_DIRECTORY );
+#else
+	struct stat info;
+	return stat( path.c_str(), &info ) == 0 && S_ISDIR( info.st_mode );
+#endif
+}
+
+DragDropEnumerator::DragDropEnumerator( cbl::Int32 x, cbl::Int32 y, const PathList & paths, cbl::Uint32 batchSize )
+: mX( x )
+, mY( y )
+, mPaths( paths )
+, mBatchSize( batchSize > 0 ? batchSize : 1 )
+, mBatches( sBatchQueueSize )
+, mCancelled( 0 )
+, mFinished( 0 )
+{
+}
+
+DragDropEnumerator::~DragDropEnumerator()
+{
+	Atomic::StoreRelease( mCancelled, 1 );
+	if( mThread.IsRunning() )
+		mThread.Join();
+}
+
+bool DragDropEnumerator::Start( void )
+{
+	return mThread.Start( &DragDropEnumerator::Run, this );
+}
+
+bool DragDropEnumerator::PopBatch( cbl::FileInfo::List & files )
+{
+	return mBatches.Pop( files );
+}
+
+void DragDropEnumerator::Run( void * self )
+{
+	DragDropEnumerator * enumerator = static_cast< DragDropEnumerator * >( self );
+
+	for( size_t i = 0; i < enumerator->mPaths.size(); ++i ) {
+		if( _isFolder( enumerator->mPaths[i] ) )
+			enumerator->EnumerateFolder( enumerator->mPaths[i] );
+		else
+			enumerator->AddFile( enumerator->mPaths[i] );
+	}
+
+	enumerator->QueueBatch();
+	Atomic::StoreRelease( enumerator->mFinished, 1 );
+}
+
+void DragDropEnumerator::EnumerateFolder( const cbl::String & root )
+{
+	// Walk with an explicit stack; deep trees would otherwise overflow the thread's stack.
+	PathList folders( 1, root );
+	while( !folders.empty() && !Atomic::LoadAcquire( mCancelled ) ) {
+		const cbl::String folder = folders.back();
+		folders.pop_back();
+
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+		WIN32_FIND_DATAW data;
+		HANDLE find = ::FindFirstFileW( ( _toLongPath( folder ) + L"\\*" ).c_str(), &data );
+		if( find == INVALID_HANDLE_VALUE )
+			continue;
+
+		do {
+			if( wcscmp( data.cFileName, L"." ) == 0 || wcscmp( data.cFileName, L".." ) == 0 )
+				continue;
+
+			const cbl::String path = folder + sPathSeparator + _fromWide( data.cFileName );
+			if( !( data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) )
+				AddFile( path );
+			// Junctions and symbolic links can loop back on themselves.
+			else if( !( data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT ) )
+				folders.push_back( path );
+		} while( ::FindNextFileW( find, &data ) && !Atomic::LoadAcquire( mCancelled ) );
+
+		::FindClose( find );
+#else
+		DIR * dir = opendir( folder.c_str() );
+		if( !dir )
+			continue;
+
+		while( dirent * entry = readdir( dir ) ) {
+			if( strcmp( entry->d_name, "." ) == 0 || strcmp( entry->d_name, ".." ) == 0 )
+				continue;
+			if( Atomic::LoadAcquire( mCancelled ) )
+				break;
+
+			const cbl::String path = folder + sPathSeparator + entry->d_name;
+			bool isFolder = entry->d_type == DT_DIR;
+			if( entry->d_type == DT_UNKNOWN ) {
+				// Not every file system fills in the type. Links aren't followed.
+				struct stat info;
+				isFolder = lstat( path.c_str(), &info ) == 0 && S_ISDIR( info.st_mode );
+			}
+
+			if( isFolder )
+				folders.push_back( path );
+			else
+				AddFile( path );
+		}
+
+		closedir( dir );
+#endif
+	}
+}
+
+void DragDropEnumerator::AddFile( const cbl::String & file )
+{
+	mBatch.push_back( cbl::FileInfo( file.c_str() ) );
+	if( mBatch.size() >= mBatchSize )
+		QueueBatch();
+}
+
+void DragDropEnumerator::QueueBatch( void )
+{
+	// Wait for the main thread to catch up rather than lose files.
+	while( !mBatches.Push( mBatch ) ) {
+		if( Atomic::LoadAcquire( mCancelled ) )
+			return;
+		Thread::Sleep( 1 );
+	}
+	mBatch.clear();
+}
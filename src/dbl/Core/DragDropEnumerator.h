@@ -0,0 +1,107 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file DragDropEnumerator.h
+ * @brief Background expansion of dropped folders.
+ */
+
+#ifndef __DBL_DRAGDROPENUMERATOR_H_
+#define __DBL_DRAGDROPENUMERATOR_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Threading/RingBuffer.h"
+#include "dbl/Threading/Thread.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Util/Noncopyable.h>
+
+// External Libraries //
+#include <vector>
+
+namespace dbl
+{
+	//! @brief Expands a set of dropped paths into files on its own thread.
+	//! Folders are walked recursively without following links. Files are handed to the main
+	//! thread in batches through a lock-free queue as they are found; the last batch is
+	//! queued even if it is empty, so there is always at least one.
+	class DragDropEnumerator :
+		cbl::Noncopyable
+	{
+	/***** Types *****/
+	public:
+		//! Dropped path list.
+		typedef std::vector< cbl::String >	PathList;
+
+	/***** Properties *****/
+	public:
+		//! Get the drop position.
+		inline cbl::Int32 GetX( void ) const { return mX; }
+		inline cbl::Int32 GetY( void ) const { return mY; }
+		//! Check if every batch has been queued.
+		inline bool IsFinished( void ) const { return Atomic::LoadAcquire( mFinished ) != 0; }
+		//! Check if there are no batches waiting.
+		inline bool IsEmpty( void ) const { return mBatches.Empty(); }
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	x, y		Drop position.
+		//! @param	paths		Dropped files and folders.
+		//! @param	batchSize	Maximum number of files per batch.
+		DragDropEnumerator( cbl::Int32 x, cbl::Int32 y, const PathList & paths, cbl::Uint32 batchSize );
+		//! Destructor.
+		//! Cancels the enumeration and waits for the thread to finish.
+		~DragDropEnumerator();
+		//! Start enumerating.
+		bool Start( void );
+		//! Take the next batch of files (main thread only).
+		//! @return		False if no batch is waiting.
+		bool PopBatch( cbl::FileInfo::List & files );
+
+	/***** Private Static Methods *****/
+	private:
+		//! Thread entry point.
+		static void Run( void * self );
+
+	/***** Private Methods *****/
+	private:
+		//! Walk a folder and everything under it.
+		void EnumerateFolder( const cbl::String & folder );
+		//! Add a file to the current batch, queueing it when full.
+		void AddFile( const cbl::String & file );
+		//! Queue the current batch.
+		void QueueBatch( void );
+
+	/***** Private Members *****/
+	private:
+		cbl::Int32							mX;				//!< Drop x position.
+		cbl::Int32							mY;				//!< Drop y position.
+		PathList							mPaths;			//!< Dropped paths.
+		cbl::Uint32							mBatchSize;		//!< Maximum files per batch.
+		cbl::FileInfo::List					mBatch;			//!< Batch being filled (worker only).
+		RingBuffer< cbl::FileInfo::List >	mBatches;		//!< Batches waiting for the main thread.
+		Thread								mThread;		//!< Enumeration thread.
+		volatile cbl::Uint32				mCancelled;		//!< Stop enumerating.
+		volatile cbl::Uint32				mFinished;		//!< The last batch has been queued.
+	};
+}
+
+#endif // __DBL_DRAGDROPENUMERATOR_H_
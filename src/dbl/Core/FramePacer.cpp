@@ -0,0 +1,171 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file FramePacer.cpp
+ * @brief Frame rate limiting component.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Core/FramePacer.h"
+#include "dbl/Core/GameWindow.h"
+
+// Chewable Headers //
+#include <cbl/Debug/Assert.h>
+#include <cbl/Debug/Logging.h>
+#include <cbl/Core/Game.h>
+
+// External Libraries //
+#include <climits>
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+using namespace dbl;
+
+cbl::Float64 FramePacer::sDefaultFrameRate		= 0.0;
+cbl::Float64 FramePacer::sDefaultIdleFrameRate	= 0.0;
+cbl::Float64 FramePacer::sSpinTime				= 0.002;
+
+FramePacer::FramePacer( cbl::Game & game )
+: cbl::GameComponent( game )
+, mWindow( NULL )
+, mFrameRate( sDefaultFrameRate )
+, mIdleFrameRate( sDefaultIdleFrameRate )
+, mNextFrame( 0.0 )
+, mWaitTime( 0.0 )
+, mFocused( true )
+, mIdle( false )
+{
+	// Wait after everything else has updated; the window pumps whatever woke us first thing next frame.
+	this->UpdateOrder = INT_MAX;
+}
+
+FramePacer::~FramePacer()
+{
+}
+
+void FramePacer::Initialise( void )
+{
+	mWindow = Game.Services.Get< GameWindow >();
+	CBL_ASSERT_TRUE( mWindow );
+
+	LOG( "Initialising frame pacer." );
+	if( !mTimer.IsHighResolution() )
+		LOG( cbl::LogLevel::Warning << "High resolution timer is not available, frame pacing will yield for the last " << sSpinTime * 1000.0 << "ms." );
+
+	mWindow->OnWindowLostFocus		+= E::Window::Method<CBL_E_METHOD( FramePacer, OnWindowLostFocus )>(this);
+	mWindow->OnWindowGainedFocus	+= E::Window::Method<CBL_E_METHOD( FramePacer, OnWindowGainedFocus )>(this);
+
+	mFocused	= true;
+	mNextFrame	= mWindow->GetInputTime();
+}
+
+void FramePacer::Shutdown( void )
+{
+	if( !mWindow )
+		return;
+
+	LOG( "Shutting down frame pacer." );
+
+	mWindow->OnWindowGainedFocus	-= E::Window::Method<CBL_E_METHOD( FramePacer, OnWindowGainedFocus )>(this);
+	mWindow->OnWindowLostFocus		-= E::Window::Method<CBL_E_METHOD( FramePacer, OnWindowLostFocus )>(this);
+
+	mWindow = NULL;
+}
+
+void FramePacer::Update( const cbl::GameTime & )
+{
+	if( !mWindow )
+		return;
+
+	mIdle = !mFocused || mWindow->IsMinimised();
+	const cbl::Float64 rate = mIdle ? mIdleFrameRate : mFrameRate;
+	const cbl::Float64 start = mWindow->GetInputTime();
+	FrameTimer & timer = mWindow->GetFrameTimer();
+	timer.Lap( FramePhase::Update, start );
+
+	if( rate <= 0.0 ) {
+		mNextFrame	= start;
+		mWaitTime	= 0.0;
+		return;
+	}
+
+	// Frames that ran long don't get caught up with a burst of short ones.
+	const cbl::Float64 period = 1.0 / rate;
+	if( mNextFrame < start - period )
+		mNextFrame = start;
+	// Don't keep sleeping towards a far away deadline after switching to a faster rate.
+	if( mNextFrame > start + period )
+		mNextFrame = start + period;
+
+	if( mIdle )
+		WaitForEventsUntil( mNextFrame );
+	else
+		WaitUntil( mNextFrame );
+
+	const cbl::Float64 end = mWindow->GetInputTime();
+	timer.Lap( FramePhase::Wait, end );
+	mWaitTime = end - start;
+	mNextFrame += period;
+}
+
+void FramePacer::WaitUntil( cbl::Float64 deadline )
+{
+	// Coarse timers can overshoot by a whole tick, so stop short and yield for the rest.
+	const cbl::Float64 spin = mTimer.IsHighResolution() ? 0.0 : sSpinTime;
+	cbl::Float64 now = mWindow->GetInputTime();
+	if( deadline - now > spin )
+		mTimer.Wait( deadline - now - spin );
+
+	while( mWindow->GetInputTime() < deadline ) {
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+		::SwitchToThread();
+#else
+		sched_yield();
+#endif
+	}
+}
+
+void FramePacer::WaitForEventsUntil( cbl::Float64 deadline )
+{
+	// Input wakes the game straight away so background windows still respond promptly.
+	cbl::Float64 now = mWindow->GetInputTime();
+	while( now < deadline ) {
+		if( mWindow->WaitForEvents( deadline - now ) ) {
+			mNextFrame = now;
+			return;
+		}
+		now = mWindow->GetInputTime();
+	}
+}
+
+void FramePacer::OnWindowLostFocus( void )
+{
+	mFocused = false;
+}
+
+void FramePacer::OnWindowGainedFocus( void )
+{
+	mFocused = true;
+}
@@ -0,0 +1,207 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file FrameTimer.cpp
+ * @brief Per-frame timing capture.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Core/FrameTimer.h"
+#include "dbl/Serialisation/JSONWriter.h"
+
+// External Dependencies //
+#include <algorithm>
+#include <fstream>
+
+using namespace dbl;
+
+static const cbl::Char *	sPhaseNames[FramePhase::Count]	= { "Pump", "Update", "Wait", "Draw" };
+static const cbl::Float64	sMicroseconds					= 1000000.0;
+
+cbl::Float64 FrameTimer::sHitchThreshold = 2.0;
+
+const cbl::Char * FramePhase::GetName( Type phase )
+{
+	return phase < Count ? sPhaseNames[phase] : "";
+}
+
+//! Write a complete ("X") trace event.
+void _writeTraceEvent( JSONWriter & writer, const cbl::Char * name, const cbl::Char * category, cbl::Float64 start, cbl::Float64 duration, cbl::Uint32 frame )
+{
+	writer.BeginObject()
+		.Key( "name" ).String( name )
+		.Key( "cat" ).String( category )
+		.Key( "ph" ).String( "X" )
+		.Key( "ts" ).Real( start * sMicroseconds )
+		.Key( "dur" ).Real( duration * sMicroseconds )
+		.Key( "pid" ).Uint( 1 )
+		.Key( "tid" ).Uint( 1 )
+		.Key( "args" ).BeginObject()
+			.Key( "frame" ).Uint( frame )
+		.EndObject()
+	.EndObject();
+}
+
+FrameTimer::FrameTimer( cbl::Uint32 capacity )
+: mFrames( capacity > 0 ? capacity : 1 )
+, mHead( 0 )
+, mCount( 0 )
+, mLapTime( 0.0 )
+, mTiming( false )
+{
+	mDurations.reserve( mFrames.size() );
+	Clear();
+}
+
+const FrameTiming & FrameTimer::GetFrame( cbl::Uint32 index ) const
+{
+	CBL_ASSERT( index < mCount, "Frame index out of range." );
+	const cbl::Uint32 capacity = GetCapacity();
+	return mFrames[ ( mHead + capacity - mCount + index ) % capacity ];
+}
+
+void FrameTimer::BeginFrame( cbl::Uint32 frame, cbl::Float64 time )
+{
+	if( mTiming ) {
+		Lap( FramePhase::Draw, time );
+		mCurrent.Duration = time - mCurrent.Start;
+
+		mFrames[mHead] = mCurrent;
+		mHead = ( mHead + 1 ) % GetCapacity();
+		if( mCount < GetCapacity() )
+			++mCount;
+	}
+
+	mCurrent.Frame		= frame;
+	mCurrent.Start		= time;
+	mCurrent.Duration	= 0.0;
+	for( cbl::Uint32 i = 0; i < FramePhase::Count; ++i ) {
+		mCurrent.Phases[i].Start	= time;
+		mCurrent.Phases[i].Duration	= 0.0;
+	}
+	mCurrent.LapCount	= 0;
+
+	mLapTime = time;
+	mTiming = true;
+}
+
+void FrameTimer::Lap( FramePhase::Type phase, cbl::Float64 time )
+{
+	if( !mTiming || time <= mLapTime )
+		return;
+
+	FrameTiming::Phase & total = mCurrent.Phases[phase];
+	if( total.Duration == 0.0 )
+		total.Start = mLapTime;
+	total.Duration += time - mLapTime;
+
+	// Repeated laps of a phase get their own spans so they don't overlap the phases in between.
+	FrameTiming::Lap * last = mCurrent.LapCount > 0 ? &mCurrent.Laps[mCurrent.LapCount - 1] : NULL;
+	if( last && last->Phase == phase ) {
+		last->Duration += time - mLapTime;
+	}
+	else if( mCurrent.LapCount < FrameTiming::sMaxLaps ) {
+		FrameTiming::Lap & lap = mCurrent.Laps[mCurrent.LapCount++];
+		lap.Phase		= phase;
+		lap.Start		= mLapTime;
+		lap.Duration	= time - mLapTime;
+	}
+	mLapTime = time;
+}
+
+void FrameTimer::Clear( void )
+{
+	mHead = 0;
+	mCount = 0;
+	mTiming = false;
+}
+
+void FrameTimer::GetStats( FrameStats & stats ) const
+{
+	stats.Frames	= mCount;
+	stats.P50		= 0.0;
+	stats.P99		= 0.0;
+	stats.Max		= 0.0;
+	stats.Hitches	= 0;
+	if( mCount == 0 )
+		return;
+
+	// The scratch buffer was reserved up front; resizing within it doesn't allocate.
+	mDurations.resize( mCount );
+	for( cbl::Uint32 i = 0; i < mCount; ++i )
+		mDurations[i] = GetFrame( i ).Duration;
+
+	// Partial sorts only: everything after the median is at least as long, so the
+	// 99th percentile and the maximum are searched for in that half alone.
+	const DurationList::iterator p50 = mDurations.begin() + size_t( ( mCount - 1 ) * 0.5 );
+	const DurationList::iterator p99 = mDurations.begin() + size_t( ( mCount - 1 ) * 0.99 );
+	std::nth_element( mDurations.begin(), p50, mDurations.end() );
+	std::nth_element( p50, p99, mDurations.end() );
+
+	stats.P50 = *p50;
+	stats.P99 = *p99;
+	stats.Max = *std::max_element( p99, mDurations.end() );
+
+	const cbl::Float64 hitch = stats.P50 * sHitchThreshold;
+	for( DurationList::const_iterator it = mDurations.begin(); it != mDurations.end(); ++it )
+		if( *it > hitch )
+			++stats.Hitches;
+}
+
+void FrameTimer::WriteTrace( JSONWriter & writer ) const
+{
+	FrameStats stats;
+	GetStats( stats );
+	const cbl::Float64 hitch = stats.P50 * sHitchThreshold;
+
+	writer.BeginObject()
+		.Key( "displayTimeUnit" ).String( "ms" )
+		.Key( "traceEvents" ).BeginArray();
+
+	for( cbl::Uint32 i = 0; i < mCount; ++i ) {
+		const FrameTiming & frame = GetFrame( i );
+
+		// Phases nest inside their frame on the same track.
+		_writeTraceEvent( writer, "Frame", frame.Duration > hitch ? "hitch" : "frame", frame.Start, frame.Duration, frame.Frame );
+		for( cbl::Uint32 l = 0; l < frame.LapCount; ++l ) {
+			const FrameTiming::Lap & lap = frame.Laps[l];
+			_writeTraceEvent( writer, sPhaseNames[lap.Phase], "phase", lap.Start, lap.Duration, frame.Frame );
+		}
+	}
+
+	writer.EndArray()
+		.EndObject();
+}
+
+bool FrameTimer::SaveTrace( const cbl::Char * fileName ) const
+{
+	std::ofstream file( fileName, std::ios::out | std::ios::binary | std::ios::trunc );
+	if( !file.is_open() ) {
+		LOG_ERROR( "Unable to write to file: " << fileName );
+		return false;
+	}
+
+	JSONWriter writer;
+	WriteTrace( writer );
+	file.write( writer.c_str(), std::streamsize( writer.size() ) );
+	return bool( file );
+}
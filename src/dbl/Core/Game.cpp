@@ -27,41 +27,93 @@
 // Delectable Headers //
 #include "dbl/Core/Game.h"
 #include "dbl/Core/GameWindow.h"
+#include "dbl/Core/FramePacer.h"
 #include "dbl/Input/KeyboardManager.h"
 #include "dbl/Input/MouseManager.h"
+#include "dbl/Input/GamepadManager.h"
+#include "dbl/Input/ActionMap.h"
 
 // Using 'this' is fine because the components only needs it to store the game reference.
 #pragma warning( disable : 4355 )
 
 using namespace dbl;
 
+bool Game::sLogStartupReport = false;
+
 Game::Game( const cbl::Char * name )
 : cbl::Game( name )
 , Window( *this )
+, Pacer( *this )
 , Keyboard( *this )
 , Mouse( *this )
+, Gamepads( *this )
+, Actions( *this )
 , Levels( *this )
 {
 	Components.Add( &Window );
+	Components.Add( &Pacer );
 	Components.Add( &Keyboard );
 	Components.Add( &Mouse );
+	Components.Add( &Gamepads );
+	Components.Add( &Actions );
 	Components.Add( &Levels );
 
 	Services.Add< GameWindow >( &Window );
+	Services.Add< FramePacer >( &Pacer );
 	Services.Add< KeyboardManager >( &Keyboard );
 	Services.Add< MouseManager >( &Mouse );
+	Services.Add< GamepadManager >( &Gamepads );
+	Services.Add< ActionMap >( &Actions );
 	Services.Add< LevelManager >( &Levels );
+	Services.Add< StartupReport >( &Startup );
 }
 
 Game::~Game()
 {
+	Services.Remove< StartupReport >();
 	Services.Remove< LevelManager >();
+	Services.Remove< ActionMap >();
+	Services.Remove< GamepadManager >();
 	Services.Remove< MouseManager >();
 	Services.Remove< KeyboardManager >();
+	Services.Remove< FramePacer >();
 	Services.Remove< GameWindow >();
 
 	Components.Remove( &Levels );
+	Components.Remove( &Actions );
+	Components.Remove( &Gamepads );
 	Components.Remove( &Mouse );
 	Components.Remove( &Keyboard );
 	Components.Remove( &Window );
-}
\ No newline at end of file
+	Components.Remove( &Pacer );
+}
+
+void Game::Initialise( void )
+{
+	Startup.Begin();
+	cbl::Game::Initialise();
+	Startup.AddSince( "Initialise components", 0.0 );
+}
+
+void Game::Update( const cbl::GameTime & time )
+{
+	if( Startup.IsFinished() ) {
+		cbl::Game::Update( time );
+		return;
+	}
+
+	const cbl::Float64 start = Startup.GetTime();
+	cbl::Game::Update( time );
+	Startup.AddSince( "First update", start );
+	Startup.End();
+
+	if( sLogStartupReport )
+		Startup.Log();
+}
+
+void Game::GetInputSnapshot( InputSnapshot & snapshot ) const
+{
+	Keyboard.GetSnapshot( snapshot );
+	Mouse.GetSnapshot( snapshot );
+	snapshot.Frame = Window.GetFrameIndex();
+}
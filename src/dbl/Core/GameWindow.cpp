@@ -26,27 +26,186 @@
 
 // Delectable Headers //
 #include "dbl/Core/GameWindow.h"
+#include "dbl/Core/DisplayModeCache.h"
+#include "dbl/Core/StartupReport.h"
+#include "dbl/Input/IInputSource.h"
+#include "dbl/Threading/Atomic.h"
 #include "IPlatformWindow.h"
+#include "DragDropEnumerator.h"
+#include "SettingsWriter.h"
 
 // Chewable Headers //
 #include <cbl/Util/FileSystem.h>
 
 // External Dependencies //
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
 #include <windows.h>
+#endif
 
 using namespace dbl;
 
+static const cbl::Char *	sSettingsCacheExtension	= ".bin";
+static const cbl::Uint32	sSettingsCacheMagic		= 0x57424C44;	//!< "DBLW"
+static const cbl::Uint32	sSettingsCacheVersion	= 1;
+
+//! Resolution index key.
+inline cbl::Uint64 _resolutionKey( cbl::Uint32 width, cbl::Uint32 height )
+{
+	return ( cbl::Uint64( width ) << 32 ) | height;
+}
+
+//! Write a value to the settings cache.
+template< typename T >
+void _writeSetting( std::ostream & os, const T & value )
+{
+	os.write( reinterpret_cast< const char * >( &value ), sizeof( value ) );
+}
+
+//! Read a value from the settings cache.
+template< typename T >
+bool _readSetting( std::istream & is, T & value )
+{
+	return bool( is.read( reinterpret_cast< char * >( &value ), sizeof( value ) ) );
+}
+
+//! Hash the settings file text the cache was built from (64-bit FNV-1a).
+cbl::Uint64 _hashSettings( const cbl::String & text )
+{
+	cbl::Uint64 hash = 14695981039346656037ULL;
+	for( size_t i = 0; i < text.length(); ++i ) {
+		hash ^= cbl::Uint8( text[i] );
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+//! Read a whole file.
+bool _readSettingsFile( const cbl::Char * fileName, cbl::String & text )
+{
+	std::ifstream is( fileName, std::ios::in | std::ios::binary );
+	if( !is.is_open() )
+		return false;
+
+	std::ostringstream contents;
+	contents << is.rdbuf();
+	text = contents.str();
+	return true;
+}
+
+//! Build the binary cache of the settings written to a settings file.
+//! Only the serialised fields are cached.
+cbl::String _buildSettingsCache( const GameWindowSettings & settings, cbl::Uint64 hash )
+{
+	std::ostringstream os( std::ios::out | std::ios::binary );
+	_writeSetting( os, sSettingsCacheMagic );
+	_writeSetting( os, sSettingsCacheVersion );
+	_writeSetting( os, hash );
+	_writeSetting( os, cbl::Uint32( settings.Title.length() ) );
+	os.write( settings.Title.c_str(), std::streamsize( settings.Title.length() ) );
+	_writeSetting( os, cbl::Uint8( settings.Style.Close ) );
+	_writeSetting( os, cbl::Uint8( settings.Style.Minimize ) );
+	_writeSetting( os, cbl::Uint8( settings.Style.Fullscreen ) );
+	_writeSetting( os, settings.Resolution.Width );
+	_writeSetting( os, settings.Resolution.Height );
+	_writeSetting( os, settings.Resolution.BitsPerPixel );
+	return os.str();
+}
+
+//! Load settings from a binary cache.
+//! @return		False if there's no cache or it wasn't built from the settings file text with this hash.
+bool _loadSettingsCache( const cbl::String & fileName, cbl::Uint64 hash, GameWindowSettings & settings )
+{
+	std::ifstream is( fileName.c_str(), std::ios::in | std::ios::binary );
+	if( !is.is_open() )
+		return false;
+
+	cbl::Uint32 magic = 0, version = 0, titleLength = 0;
+	cbl::Uint64 cacheHash = 0;
+	if( !_readSetting( is, magic ) || !_readSetting( is, version ) || !_readSetting( is, cacheHash ) ||
+		magic != sSettingsCacheMagic || version != sSettingsCacheVersion || cacheHash != hash ||
+		!_readSetting( is, titleLength ) || titleLength > 0x10000 )
+		return false;
+
+	GameWindowSettings cached = settings;
+	cbl::Uint8 close = 0, minimize = 0, fullscreen = 0;
+	cached.Title.assign( titleLength, '\0' );
+	if( titleLength > 0 )
+		is.read( &cached.Title[0], titleLength );
+	_readSetting( is, close );
+	_readSetting( is, minimize );
+	_readSetting( is, fullscreen );
+	_readSetting( is, cached.Resolution.Width );
+	_readSetting( is, cached.Resolution.Height );
+	_readSetting( is, cached.Resolution.BitsPerPixel );
+	if( !is )
+		return false;
+
+	cached.Style.Close		= close != 0;
+	cached.Style.Minimize	= minimize != 0;
+	cached.Style.Fullscreen	= fullscreen != 0;
+	settings = cached;
+	return true;
+}
+
+//! Serialise settings to a settings file and its binary cache.
+void _serialiseSettings( const GameWindowSettings & settings, const cbl::String & fileName, SettingsWriter::FileList & files )
+{
+	YAML::Emitter e;
+	dbl::YAMLSerialiser s;
+	s.SetStream( e )
+		.Serialise( settings );
+
+	files.resize( 2 );
+	files[0].Name		= fileName;
+	files[0].Contents	= e.c_str();
+	files[1].Name		= fileName + sSettingsCacheExtension;
+	files[1].Contents	= _buildSettingsCache( settings, _hashSettings( files[0].Contents ) );
+}
+
 cbl::FileInfo GameWindow::sSettingsFile			= cbl::FileInfo( "window.cfg" );
+bool GameWindow::sPersistSettings				= false;
+cbl::Float64 GameWindow::sSettingsSaveDelay		= 1.0;
 cbl::Uint32 GameWindow::sMinimumResolutionX		= 640;
 cbl::Uint32 GameWindow::sMinimumResolutionY		= 480;
 bool GameWindow::sDefaultFullscreen				= false;
+cbl::Uint32 GameWindow::sInputQueueSize			= 1024;
+cbl::Uint32 GameWindow::sEventQueueSize			= 256;
+cbl::Uint32 GameWindow::sDragDropBatchSize		= 256;
+cbl::Uint32 GameWindow::sFrameHistory			= 1024;
+bool GameWindow::sInputThread					= false;
+bool GameWindow::sHeadless						= false;
+bool GameWindow::sDeferCreation					= false;
+GameWindowSize GameWindow::sVirtualResolution	= GameWindowSize( 1024, 768, 32 );
+cbl::Uint32 GameWindow::sPumpCount				= 0;
+volatile cbl::Uint32 GameWindow::sResolutionLock	= 0;
 
 GameWindow::GameWindow( cbl::Game & game )
 : cbl::GameComponent( game )
 , mPlatformWindow( NULL )
 , mDesktopResolution(0,0,0)
+, mWindowEvents( sEventQueueSize )
+, mInputQueue( sInputQueueSize )
+, mInputEventTime( 0.0 )
+, mDroppedInputEvents( 0 )
+, mInputSource( NULL )
+, mFrameIndex( 0 )
+, mFrameTimer( sFrameHistory )
+, mHeadless( false )
+, mCreatePending( false )
+, mResolutionStart( 0.0 )
+, mResolutionTime( 0.0 )
+, mDisplayGeneration( 0 )
+, mLastPump( sPumpCount )
+, mSettingsWriter( new SettingsWriter() )
+, mSettingsPending( false )
+, mSettingsChangeTime( 0.0 )
 {
 	this->UpdateOrder = INT_MIN; // Ensure that all window events come as early as possible.
+	mInputClock.Start();
 }
 
 GameWindow::GameWindow( cbl::Game & game, const GameWindowSettings & settings )
@@ -54,63 +213,197 @@ GameWindow::GameWindow( cbl::Game & game, const GameWindowSettings & settings )
 , mSettings( settings )
 , mPlatformWindow( NULL )
 , mDesktopResolution(0,0,0)
+, mWindowEvents( sEventQueueSize )
+, mInputQueue( sInputQueueSize )
+, mInputEventTime( 0.0 )
+, mDroppedInputEvents( 0 )
+, mInputSource( NULL )
+, mFrameIndex( 0 )
+, mFrameTimer( sFrameHistory )
+, mHeadless( false )
+, mCreatePending( false )
+, mResolutionStart( 0.0 )
+, mResolutionTime( 0.0 )
+, mDisplayGeneration( 0 )
+, mLastPump( sPumpCount )
+, mSettingsWriter( new SettingsWriter() )
+, mSettingsPending( false )
+, mSettingsChangeTime( 0.0 )
 {
+	mInputClock.Start();
 }
 
 GameWindow::~GameWindow()
 {
+	WaitForResolutions();
+	ClearDragDrops();
+	FlushSettings();
+	CBL_DELETE( mSettingsWriter );
 	CBL_DELETE( mPlatformWindow );
 }
 
+const GameWindow::GameWindowSizeList & GameWindow::GetAvailableResolutions( void ) const
+{
+	WaitForResolutions();
+	return mAvailableResolutions;
+}
+
+const GameWindowSize & GameWindow::GetDesktopResolution( void ) const
+{
+	WaitForResolutions();
+	return mDesktopResolution;
+}
+
 GameWindowHandle GameWindow::GetGameWindowHandle()
 {
+	EnsureCreated();
 	CBL_ASSERT_TRUE( mPlatformWindow );
 	return mPlatformWindow->GetHandle();
 }
 
 bool GameWindow::IsValidResolution( cbl::Uint32 width, cbl::Uint32 height ) const
 {
-	CBL_FOREACH_CONST( GameWindowSizeList, it, mAvailableResolutions ) {
-		if( it->Width == width && it->Height == height ) return true;
-	}
+	WaitForResolutions();
+	return mResolutionIndex.count( _resolutionKey( width, height ) ) != 0;
+}
 
-	return false;
+cbl::Float64 GameWindow::GetInputTime( void )
+{
+	return mInputClock.GetElapsedTime().TotalSeconds();
 }
 
-void GameWindow::Initialise( void )
+bool GameWindow::IsInputThreadEnabled( void ) const
 {
-	PopulateResolutions();
-	SetCurrentDesktopResolution();
+	return mPlatformWindow && mPlatformWindow->IsInputThreadEnabled();
+}
 
+void GameWindow::Initialise( void )
+{
 	CBL_ASSERT( mPlatformWindow == NULL, "Platform window has already been created!" );
 
-	if( !IsValidResolution( mSettings.Resolution.Width, mSettings.Resolution.Height ) )
-		DefaultToFullscreen();
+	mHeadless = sHeadless;
+	if( !mHeadless && !IPlatformWindow::HasDisplay() ) {
+		LOG( cbl::LogLevel::Warning << "No display available, creating a headless window." );
+		mHeadless = true;
+	}
 
-	mPlatformWindow = IPlatformWindow::Create( this, mSettings );
+	if( sDeferCreation ) {
+		// Resolutions are enumerated while the other components initialise.
+		StartupReport * report = Game.Services.Get< StartupReport >();
+		mResolutionStart = report ? report->GetTime() : 0.0;
+		mCreatePending = true;
+		if( !mResolutionThread.Start( &GameWindow::RefreshResolutionsThread, this ) ) {
+			LOG( cbl::LogLevel::Warning << "Unable to start resolution thread, enumerating resolutions now." );
+			RefreshResolutions( false );
+		}
+	}
+	else {
+		RefreshResolutions( false );
+	}
 
-	OnWindowCreated();
+	// Settings only wait for the resolutions if they have to fall back to the desktop resolution.
+	const cbl::String settingsFile = sSettingsFile.GetFullFileName();
+	if( sPersistSettings && cbl::FileSystem::FileCheckExists( settingsFile.c_str() ) )
+		LoadSettings< YAMLDeserialiser >( settingsFile.c_str() );
+
+	if( !mCreatePending )
+		CreatePlatformWindow();
 }
 
 void GameWindow::Shutdown( void )
 {
-	CBL_ASSERT_TRUE( mPlatformWindow );
-	//XMLTools<GameWindowSettings>::Export( "GameWindowSettings", mSettings, sSettingsFile.GetFullFileName().c_str() );
-	LOG( sSettingsFile.GetFile() << " settings file saved." );
+	WaitForResolutions();
+	mCreatePending = false;
 
-	OnWindowDestroyed();
+	const bool settingsPending = mSettingsPending;
+	FlushSettings();
+	if( settingsPending )
+		LOG( sSettingsFile.GetFile() << " settings file saved." );
+
+	ClearDragDrops();
+	if( mPlatformWindow )
+		OnWindowDestroyed();
 
 	CBL_DELETE( mPlatformWindow );
 }
 
 void GameWindow::Update( const cbl::GameTime & )
 {
+	++mFrameIndex;
+	EnsureCreated();
+	mFrameTimer.BeginFrame( mFrameIndex, GetInputTime() );
+
+	// The first window updated since the last pump pumps events for every window.
+	if( mLastPump == sPumpCount )
+		PumpEvents();
+	mLastPump = sPumpCount;
+
+	if( mPlatformWindow )
+		mPlatformWindow->ReadInputState( mInputState );
+
+	// Settings are written once they stop changing, one write at a time.
+	if( mSettingsPending && GetInputTime() - mSettingsChangeTime >= sSettingsSaveDelay )
+		StartSettingsWrite();
+
+	DispatchWindowEvents();
+	DispatchDragDrops();
+
+	if( mInputSource ) {
+		// Live input is discarded so the source fully determines the frame's input.
+		InputEvent ev;
+		while( mInputQueue.Pop( ev ) ) {}
+		mInputSource->PollInput( *this );
+	}
+
+	DispatchInputEvents();
+	mFrameTimer.Lap( FramePhase::Pump, GetInputTime() );
+}
+
+void GameWindow::PumpEvents( void )
+{
+	IPlatformWindow::PumpEvents();
+	++sPumpCount;
+}
+
+bool GameWindow::IsMinimised( void ) const
+{
+	return mPlatformWindow && mPlatformWindow->IsMinimised();
+}
+
+int GameWindow::GetEventFd( void ) const
+{
+	return mPlatformWindow ? mPlatformWindow->GetEventFd() : -1;
+}
+
+bool GameWindow::WaitForEvents( cbl::Float64 timeout )
+{
+	EnsureCreated();
 	CBL_ASSERT_TRUE( mPlatformWindow );
-	mPlatformWindow->ProcessWindowEvents();
+	return mPlatformWindow->WaitForEvents( timeout );
+}
+
+bool GameWindow::SetRelativeMouseMode( bool state )
+{
+	return mPlatformWindow ? mPlatformWindow->SetRelativeMouseMode( state ) : !state;
+}
+
+bool GameWindow::IsRelativeMouseMode( void ) const
+{
+	return mPlatformWindow && mPlatformWindow->IsRelativeMouseMode();
+}
+
+void GameWindow::SetInputSource( IInputSource * source )
+{
+	mInputSource = source;
 }
 
 void GameWindow::SetWindowSettings( const GameWindowSettings & settings )
 {
+	if( mCreatePending ) {
+		mSettings = settings;
+		OnSettingsChanged();
+		return;
+	}
 	CBL_ASSERT_TRUE( mPlatformWindow );
 
 	mSettings = settings;
@@ -118,10 +411,12 @@ void GameWindow::SetWindowSettings( const GameWindowSettings & settings )
 	mPlatformWindow->DoSetTitle();
 	mPlatformWindow->DoSetFullscreen();
 	mPlatformWindow->DoSetStyle();
+	OnSettingsChanged();
 }
 
 void GameWindow::CenterPosition( void )
 {
+	EnsureCreated();
 	CBL_ASSERT_TRUE( mPlatformWindow );
 	mPlatformWindow->DoSetSizePosition();
 }
@@ -134,11 +429,13 @@ void GameWindow::SetResolution( cbl::Uint32 width, cbl::Uint32 height, cbl::Uint
 			mSettings.Resolution.Height			= height;
 			mSettings.Resolution.BitsPerPixel	= bpp;
 			mPlatformWindow->DoSetSizePosition();
+			OnSettingsChanged();
 		}
 	}
 	else {
 		mSettings.Resolution.Width	= width;
 		mSettings.Resolution.Height	= height;
+		OnSettingsChanged();
 	}
 }
 
@@ -147,6 +444,7 @@ void GameWindow::SetTitle( const cbl::Char * const title )
 	mSettings.Title = title;
 	if( mPlatformWindow )
 		mPlatformWindow->DoSetTitle();
+	OnSettingsChanged();
 }
 
 void GameWindow::SetStyle( bool close, bool minimize )
@@ -155,6 +453,7 @@ void GameWindow::SetStyle( bool close, bool minimize )
 	mSettings.Style.Minimize = minimize;
 	if( mPlatformWindow )
 		mPlatformWindow->DoSetStyle();
+	OnSettingsChanged();
 }
 
 void GameWindow::SetFullscreen( bool state )
@@ -166,22 +465,26 @@ void GameWindow::SetFullscreen( bool state )
 	
 	if( mPlatformWindow )
 		mPlatformWindow->DoSetFullscreen();
+	OnSettingsChanged();
 }
 
 void GameWindow::Show( bool state )
 {
+	EnsureCreated();
 	CBL_ASSERT_TRUE( mPlatformWindow );
 	mPlatformWindow->Show( state );
 }
 
 void GameWindow::ShowCursor( bool state )
 {
+	EnsureCreated();
 	CBL_ASSERT_TRUE( mPlatformWindow );
 	mPlatformWindow->ShowCursor( state );
 }
 
 void GameWindow::SetCursor( const cbl::Char * file )
 {
+	EnsureCreated();
 	if( file == NULL ) {
 		mPlatformWindow->SetCursor( NULL );
 		mCursorResource = "";
@@ -196,51 +499,341 @@ void GameWindow::SetCursor( const cbl::Char * file )
 
 void GameWindow::SetCursorPosition( cbl::Int32 x, cbl::Int32 y )
 {
+	EnsureCreated();
 	mPlatformWindow->SetCursorPosition( x, y );
 }
 
 void GameWindow::CenterCursorPosition( void )
 {
+	EnsureCreated();
 	mPlatformWindow->SetCursorPosition( mSettings.Dimensions.Width / 2, mSettings.Dimensions.Height / 2 );
 }
 
 void GameWindow::ClipCursor( bool state )
 {
+	EnsureCreated();
 	mPlatformWindow->ClipCursor( state );
 }
 
 void GameWindow::SetAcceptDragDrop( bool state )
 {
+	EnsureCreated();
 	mPlatformWindow->SetAcceptDragDrop( state );
 }
 
+bool GameWindow::SetInputThreadEnabled( bool state )
+{
+	EnsureCreated();
+	CBL_ASSERT_TRUE( mPlatformWindow );
+	return mPlatformWindow->SetInputThreadEnabled( state );
+}
+
+void GameWindow::QueueSaveSettings( void )
+{
+	mSettingsPending = true;
+	mSettingsChangeTime = GetInputTime();
+}
+
+void GameWindow::FlushSettings( void )
+{
+	// The newer settings have to wait for the write in progress.
+	mSettingsWriter->Wait();
+	if( mSettingsPending )
+		StartSettingsWrite();
+	mSettingsWriter->Wait();
+}
+
+bool GameWindow::StartSettingsWrite( void )
+{
+	if( mSettingsWriter->IsBusy() )
+		return false;
+
+	SettingsWriter::FileList files;
+	_serialiseSettings( mSettings, sSettingsFile.GetFullFileName(), files );
+	mSettingsPending = false;
+
+	if( !mSettingsWriter->Start( files ) ) {
+		LOG( cbl::LogLevel::Warning << "Unable to start settings thread, saving settings now." );
+		CBL_FOREACH_CONST( SettingsWriter::FileList, it, files )
+			SettingsWriter::WriteAtomic( it->Name, it->Contents );
+	}
+	return true;
+}
+
+bool GameWindow::PushInputEvent( const InputEvent & ev )
+{
+	if( mInputQueue.Push( ev ) )
+		return true;
+
+	if( mDroppedInputEvents++ == 0 )
+		LOG( cbl::LogLevel::Warning << "Input queue is full, dropping input events. Increase GameWindow::sInputQueueSize." );
+	return false;
+}
+
+bool GameWindow::PostWindowEvent( const WindowEvent & ev )
+{
+	if( mWindowEvents.Post( ev ) )
+		return true;
+
+	if( mWindowEvents.GetDroppedEvents() == 1 )
+		LOG( cbl::LogLevel::Warning << "Window event queue is full, dropping window events. Increase GameWindow::sEventQueueSize." );
+	return false;
+}
+
+bool GameWindow::InjectInputEvent( const InputEvent & ev )
+{
+	if( ev.Time > 0.0 )
+		return PushInputEvent( ev );
+
+	InputEvent stamped = ev;
+	stamped.Time = GetInputTime();
+	return PushInputEvent( stamped );
+}
+
+void GameWindow::DispatchWindowEvents( void )
+{
+	mWindowEventBatch.clear();
+	mWindowEvents.Drain( mWindowEventBatch );
+
+	for( size_t i = 0; i < mWindowEventBatch.size(); ++i )
+		DispatchWindowEvent( mWindowEventBatch[i] );
+}
+
+void GameWindow::DispatchWindowEvent( const WindowEvent & ev )
+{
+	switch( ev.Type ) {
+		case WindowEventType::Resized:		OnWindowResized( ev.Width, ev.Height, cbl::Uint32( ev.X ), cbl::Uint32( ev.Y ), cbl::Uint16( ev.Code ), ev.AspectRatio ); break;
+		case WindowEventType::Fullscreen:	OnWindowFullscreen( ev.Code != 0, ev.X != 0 ); break;
+		case WindowEventType::Closed:		OnWindowClosed(); break;
+		case WindowEventType::DisplayChanged:
+			// Modes are only enumerated again when the configuration actually changes.
+			WaitForResolutions();
+			RefreshResolutions( true );
+			OnWindowDisplayChanged();
+			break;
+	}
+}
+
+void GameWindow::RefreshResolutions( bool displayChanged )
+{
+	if( mHeadless ) {
+		// There's no display to query; the virtual resolution is the only mode.
+		mAvailableResolutions.assign( 1, sVirtualResolution );
+		mDesktopResolution = sVirtualResolution;
+	}
+	else {
+		// Several windows can be enumerating at once, and the mode cache isn't thread safe.
+		while( Atomic::Exchange( sResolutionLock, 1 ) != 0 )
+			Thread::Sleep( 1 );
+		// Every window is notified of the same change; only the first to handle it discards the cache.
+		if( displayChanged && mDisplayGeneration == DisplayModeCache::GetGeneration() )
+			DisplayModeCache::Invalidate();
+		PopulateResolutions();
+		SetCurrentDesktopResolution();
+		mDisplayGeneration = DisplayModeCache::GetGeneration();
+		Atomic::StoreRelease( sResolutionLock, 0 );
+	}
+
+	mResolutionIndex.clear();
+	CBL_FOREACH_CONST( GameWindowSizeList, it, mAvailableResolutions )
+		mResolutionIndex.insert( _resolutionKey( it->Width, it->Height ) );
+}
+
+void GameWindow::RefreshResolutionsThread( void * self )
+{
+	GameWindow * window = static_cast< GameWindow * >( self );
+
+	cbl::Stopwatch clock;
+	clock.Start();
+	window->RefreshResolutions( false );
+	window->mResolutionTime = clock.GetElapsedTime().TotalSeconds();
+}
+
+void GameWindow::WaitForResolutions( void ) const
+{
+	if( !mResolutionThread.IsRunning() )
+		return;
+
+	mResolutionThread.Join();
+	if( StartupReport * report = Game.Services.Get< StartupReport >() )
+		report->Add( "Window resolutions", mResolutionStart, mResolutionTime, true );
+}
+
+void GameWindow::CreatePlatformWindow( void )
+{
+	WaitForResolutions();
+	mCreatePending = false;
+
+	StartupReport * report = Game.Services.Get< StartupReport >();
+	const cbl::Float64 start = report ? report->GetTime() : 0.0;
+
+	if( !IsValidResolution( mSettings.Resolution.Width, mSettings.Resolution.Height ) )
+		DefaultToFullscreen();
+
+	mPlatformWindow = IPlatformWindow::Create( this, mSettings, mHeadless );
+
+	if( sInputThread && !mPlatformWindow->SetInputThreadEnabled( true ) )
+		LOG( cbl::LogLevel::Warning << "Input thread is not available, sampling input on the main thread." );
+
+	if( report && !report->IsFinished() )
+		report->AddSince( "Window creation", start );
+
+	OnWindowCreated();
+}
+
+void GameWindow::DropFiles( cbl::Int32 x, cbl::Int32 y, const std::vector< cbl::String > & paths )
+{
+	mDragDrops.push_back( new DragDropEnumerator( x, y, paths, sDragDropBatchSize ) );
+	if( mDragDrops.size() == 1 )
+		StartDragDrop();
+}
+
+void GameWindow::StartDragDrop( void )
+{
+	// A drop that can't be expanded would never finish and block every drop behind it.
+	while( !mDragDrops.empty() && !mDragDrops.front()->Start() ) {
+		LOG_ERROR( "Unable to start drag and drop thread, discarding drop." );
+		delete mDragDrops.front();
+		mDragDrops.pop_front();
+	}
+}
+
+void GameWindow::DispatchDragDrops( void )
+{
+	cbl::FileInfo::List batch;
+	while( !mDragDrops.empty() ) {
+		DragDropEnumerator * drop = mDragDrops.front();
+
+		// Everything is queued before the finished flag is set, so check it first.
+		const bool finished = drop->IsFinished();
+		while( drop->PopBatch( batch ) ) {
+			const bool last = finished && drop->IsEmpty();
+			mDragDropFiles.insert( mDragDropFiles.end(), batch.begin(), batch.end() );
+			OnWindowDragDropBatch( drop->GetX(), drop->GetY(), batch, last );
+			if( last )
+				OnWindowDragDrop( drop->GetX(), drop->GetY(), mDragDropFiles );
+		}
+
+		if( !finished )
+			return;
+
+		mDragDropFiles.clear();
+		mDragDrops.pop_front();
+		delete drop;
+
+		StartDragDrop();
+	}
+}
+
+void GameWindow::ClearDragDrops( void )
+{
+	CBL_FOREACH( DragDropList, it, mDragDrops )
+		delete *it;
+	mDragDrops.clear();
+	mDragDropFiles.clear();
+}
+
+bool _inputEventEarlier( const InputEvent & lhs, const InputEvent & rhs )
+{
+	return lhs.Time < rhs.Time;
+}
+
+void GameWindow::DispatchInputEvents( void )
+{
+	// Drain everything first so handlers never run interleaved with the platform pump.
+	mInputBatch.clear();
+	InputEvent ev;
+	while( mInputQueue.Pop( ev ) )
+		mInputBatch.push_back( ev );
+
+	if( mInputBatch.empty() )
+		return;
+
+	// Events sampled on the input thread and the main thread are merged by time.
+	for( size_t i = 1; i < mInputBatch.size(); ++i ) {
+		if( mInputBatch[i].Time < mInputBatch[i-1].Time ) {
+			std::stable_sort( mInputBatch.begin(), mInputBatch.end(), _inputEventEarlier );
+			break;
+		}
+	}
+
+	for( size_t i = 0; i < mInputBatch.size(); ++i )
+		DispatchInputEvent( mInputBatch[i] );
+
+	OnWindowInputBatch( mInputBatch );
+}
+
+void GameWindow::DispatchInputEvent( const InputEvent & ev )
+{
+	mInputEventTime = ev.Time;
+
+	switch( ev.Type ) {
+		case InputEventType::KeyDown:		OnWindowKeyDown( Key::Code( ev.Code ) ); break;
+		case InputEventType::KeyUp:			OnWindowKeyUp( Key::Code( ev.Code ) ); break;
+		case InputEventType::KeyChar:		OnWindowKeyChar( ev.Code ); break;
+		case InputEventType::MouseMove:		OnWindowMouseMove( ev.X, ev.Y ); break;
+		case InputEventType::MouseDown:		OnWindowMouseDown( ev.X, ev.Y, Mouse::Button( ev.Code ) ); break;
+		case InputEventType::MouseUp:		OnWindowMouseUp( ev.X, ev.Y, Mouse::Button( ev.Code ) ); break;
+		case InputEventType::MouseDblClick:	OnWindowMouseDblClick( ev.X, ev.Y, Mouse::Button( ev.Code ) ); break;
+		case InputEventType::MouseWheel:	OnWindowMouseWheel( ev.X ); break;
+		case InputEventType::MouseEnter:	OnWindowMouseEnter(); break;
+		case InputEventType::MouseLeave:	OnWindowMouseLeave(); break;
+		case InputEventType::GainedFocus:	OnWindowGainedFocus(); break;
+		case InputEventType::LostFocus:		OnWindowLostFocus(); break;
+		case InputEventType::MouseRawMotion:	OnWindowMouseRawMotion( ev.X, ev.Y ); break;
+	}
+}
+
 template<>
 void GameWindow::SaveSettings<YAMLSerialiser>( const cbl::Char* fileName ) const
 {
-	YAML::Emitter e;
-	dbl::YAMLSerialiser s;
-
-	s.SetStream( e )
-		.Serialise( mSettings );
-	s.Output( fileName );
+	// A queued write may be using the same temporary files.
+	mSettingsWriter->Wait();
+	if( sSettingsFile.GetFullFileName() == fileName )
+		mSettingsPending = false;
+
+	SettingsWriter::FileList files;
+	_serialiseSettings( mSettings, fileName, files );
+	CBL_FOREACH_CONST( SettingsWriter::FileList, it, files )
+		SettingsWriter::WriteAtomic( it->Name, it->Contents );
 }
 
 template<>
 void GameWindow::LoadSettings<YAMLDeserialiser>( const cbl::Char* fileName )
 {
-	bool def = false;
-	try {
-		std::ifstream windowFile( fileName );
-		YAML::Parser parser( windowFile );
+	cbl::String text;
+	const bool read = _readSettingsFile( fileName, text );
+	const cbl::Uint64 hash = _hashSettings( text );
+	const cbl::String cacheName = cbl::String( fileName ) + sSettingsCacheExtension;
+
+	// Skip the YAML parser while the cache matches the file.
+	if( read && _loadSettingsCache( cacheName, hash, mSettings ) )
+		return;
 
-		dbl::YAMLDeserialiser yaml;
-		yaml.SetStream( parser );
-		def = !yaml.Deserialise( mSettings );
-	} catch( const YAML::Exception& ) {
-		def = true;
+	bool def = !read;
+	if( read ) {
+		try {
+			std::istringstream windowFile( text );
+			YAML::Parser parser( windowFile );
+
+			dbl::YAMLDeserialiser yaml;
+			yaml.SetStream( parser );
+			def = !yaml.Deserialise( mSettings );
+		} catch( const YAML::Exception& ) {
+			def = true;
+		}
 	}
 
-	if( def ) {
+	if( !def ) {
+		// The file was missing its cache or changed by hand; rebuild the cache in the background.
+		SettingsWriter::FileList files( 1 );
+		files[0].Name		= cacheName;
+		files[0].Contents	= _buildSettingsCache( mSettings, hash );
+		mSettingsWriter->Wait();
+		if( !mSettingsWriter->Start( files ) )
+			SettingsWriter::WriteAtomic( files[0].Name, files[0].Contents );
+	}
+	else {
 		LOG( cbl::LogLevel::Warning << "Unable to load window.cfg file." << ( sDefaultFullscreen ? "Defaulting to desktop resolution." : "" )  );
 		DefaultToFullscreen();
 	}
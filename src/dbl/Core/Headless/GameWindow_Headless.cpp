@@ -0,0 +1,78 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file GameWindow_Headless.cpp
+ * @brief Display queries for platforms without a native window.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Core/GameWindow.h"
+
+#if CBL_PLATFORM != CBL_PLATFORM_WIN32 && CBL_PLATFORM != CBL_PLATFORM_LINUX
+
+using namespace dbl;
+
+void GameWindow::PopulateResolutions( void )
+{
+	mAvailableResolutions.assign( 1, sVirtualResolution );
+}
+
+void GameWindow::SetCurrentDesktopResolution( void )
+{
+	mDesktopResolution = sVirtualResolution;
+}
+
+void GameWindow::GetWorkableArea( cbl::Uint32& left, cbl::Uint32& top, cbl::Uint32& right, cbl::Uint32& bottom, GameWindowStyle& )
+{
+	left	= 0;
+	top		= 0;
+	right	= sVirtualResolution.Width;
+	bottom	= sVirtualResolution.Height;
+}
+
+void GameWindow::GetWorkableAreaCenter( cbl::Uint32& x, cbl::Uint32& y, GameWindowStyle& )
+{
+	x = sVirtualResolution.Width / 2;
+	y = sVirtualResolution.Height / 2;
+}
+
+void GameWindow::GetBestClientWindowDimensions( cbl::Uint32 targetw, cbl::Uint32 targeth, GameWindowStyle&, cbl::Uint32& bestw, cbl::Uint32& besth )
+{
+	// Scale down to fit the virtual display, keeping the aspect ratio.
+	bestw = targetw;
+	besth = targeth;
+	if( bestw > sVirtualResolution.Width ) {
+		besth = cbl::Uint32( cbl::Float64( besth ) * sVirtualResolution.Width / bestw + 0.5 );
+		bestw = sVirtualResolution.Width;
+	}
+	if( besth > sVirtualResolution.Height ) {
+		bestw = cbl::Uint32( cbl::Float64( bestw ) * sVirtualResolution.Height / besth + 0.5 );
+		besth = sVirtualResolution.Height;
+	}
+}
+
+cbl::Uint32 GameWindow::GetSystemWindowStyle( GameWindowStyle& )
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,118 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file HeadlessPlatformWindow.cpp
+ * @brief Display-less window implementation.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "HeadlessPlatformWindow.h"
+#include "dbl/Core/GameWindow.h"
+
+using namespace dbl;
+
+HeadlessPlatformWindow::HeadlessPlatformWindow( GameWindow * const host, GameWindowSettings & settings )
+: IPlatformWindow( host, settings )
+, mRelativeMouse( false )
+{
+	DoSetSizePosition();
+}
+
+HeadlessPlatformWindow::~HeadlessPlatformWindow()
+{
+}
+
+GameWindowHandle HeadlessPlatformWindow::GetHandle( void )
+{
+	return NULL;
+}
+
+void HeadlessPlatformWindow::DoSetSizePosition( void )
+{
+	// There's no frame or desktop, so the client area is always the full resolution.
+	mSettings.Dimensions.Width = mSettings.Resolution.Width;
+	mSettings.Dimensions.Height = mSettings.Resolution.Height;
+	mSettings.AspectRatio = cbl::Real( mSettings.Dimensions.Width ) / cbl::Real( mSettings.Dimensions.Height );
+
+	mHost->PostWindowEvent( WindowEvent::MakeResized(
+		mSettings.Resolution.Width,
+		mSettings.Resolution.Height,
+		mSettings.Dimensions.Width,
+		mSettings.Dimensions.Height,
+		mSettings.Resolution.BitsPerPixel,
+		mSettings.AspectRatio
+	) );
+}
+
+void HeadlessPlatformWindow::DoSetTitle( void )
+{
+}
+
+void HeadlessPlatformWindow::DoSetStyle( void )
+{
+}
+
+void HeadlessPlatformWindow::DoSetFullscreen( void )
+{
+	DoSetSizePosition();
+	mHost->PostWindowEvent( WindowEvent::Make( WindowEventType::Fullscreen, mSettings.Style.Fullscreen ? 1 : 0 ) );
+}
+
+void HeadlessPlatformWindow::Show( bool )
+{
+}
+
+void HeadlessPlatformWindow::ShowCursor( bool )
+{
+}
+
+void HeadlessPlatformWindow::SetCursor( const cbl::Char * )
+{
+}
+
+void HeadlessPlatformWindow::SetCursorPosition( cbl::Int32 x, cbl::Int32 y )
+{
+	mHost->PushInputEvent( InputEvent::Make( InputEventType::MouseMove, mHost->GetInputTime(), 0, x, y ) );
+}
+
+void HeadlessPlatformWindow::ClipCursor( bool )
+{
+}
+
+void HeadlessPlatformWindow::ProcessWindowEvents( void )
+{
+}
+
+void HeadlessPlatformWindow::SetAcceptDragDrop( bool )
+{
+}
+
+bool HeadlessPlatformWindow::SetRelativeMouseMode( bool state )
+{
+	mRelativeMouse = state;
+	return true;
+}
+
+bool HeadlessPlatformWindow::IsRelativeMouseMode( void ) const
+{
+	return mRelativeMouse;
+}
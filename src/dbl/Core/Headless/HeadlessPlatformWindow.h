@@ -0,0 +1,86 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file HeadlessPlatformWindow.h
+ * @brief Display-less window implementation.
+ */
+
+#ifndef __DBL_HEADLESSPLATFORMWINDOW_H_
+#define __DBL_HEADLESSPLATFORMWINDOW_H_
+
+// Delectable Headers //
+#include "../IPlatformWindow.h"
+
+namespace dbl
+{
+	//! @brief Platform window with no display.
+	//! Used for servers and benchmarks. The window reports GameWindow::sVirtualResolution,
+	//! has no platform input of its own and delivers events queued with
+	//! GameWindow::InjectInputEvent(). This class is created in the GameWindow through a
+	//! static factory method and should not be instantiated manually.
+	class HeadlessPlatformWindow :
+		public IPlatformWindow
+	{
+	/***** Properties *****/
+	public:
+		//! Get the game window handle.
+		//! @return			Always NULL.
+		virtual GameWindowHandle	GetHandle( void );
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	s		Reference to window settings.
+		HeadlessPlatformWindow( GameWindow * const host, GameWindowSettings & s );
+		//! Destructor.
+		virtual ~HeadlessPlatformWindow();
+		//! Apply the resolution to the window dimensions.
+		virtual void DoSetSizePosition( void );
+		//! Reset window title (no-op).
+		virtual void DoSetTitle( void );
+		//! Reset window style (no-op).
+		virtual void DoSetStyle( void );
+		//! Reset window fullscreen mode using referenced window settings.
+		virtual void DoSetFullscreen( void );
+		//! Show/hide window (no-op).
+		virtual void Show( bool state );
+		//! Show/hide window cursor (no-op).
+		virtual void ShowCursor( bool state );
+		//! Load and set cursor to a file (no-op).
+		virtual void SetCursor( const cbl::Char * file );
+		//! Move the virtual cursor. Queues a mouse move like a platform cursor warp.
+		virtual void SetCursorPosition( cbl::Int32 x, cbl::Int32 y );
+		//! Lock the cursor into the platform window (no-op).
+		virtual void ClipCursor( bool clip );
+		//! Process window events (no-op; injected events are queued directly).
+		virtual void ProcessWindowEvents( void );
+		//! Set whether the drag and drop works (no-op).
+		virtual void SetAcceptDragDrop( bool state );
+		//! Accept injected relative mouse motion.
+		virtual bool SetRelativeMouseMode( bool state );
+		//! Check if relative mouse motion is being reported.
+		virtual bool IsRelativeMouseMode( void ) const;
+
+	/***** Private Members *****/
+	private:
+		bool						mRelativeMouse;		//!< Relative mouse mode requested.
+	};
+}
+
+#endif // __DBL_HEADLESSPLATFORMWINDOW_H_
@@ -26,25 +26,107 @@
 
 // Delectable Headers //
 #include "IPlatformWindow.h"
+#include "Headless/HeadlessPlatformWindow.h"
+#include "dbl/Threading/Thread.h"
+
+// External Dependencies //
+#include <algorithm>
 
 #if CBL_PLATFORM == CBL_PLATFORM_WIN32
 #include "Win32/Win32PlatformWindow.h"
 typedef ::dbl::Win32PlatformWindow PlatformWindowType;
+#elif CBL_PLATFORM == CBL_PLATFORM_LINUX
+#include "Linux/LinuxPlatformWindow.h"
+typedef ::dbl::LinuxPlatformWindow PlatformWindowType;
+#else
+// No native window on this platform yet.
+typedef ::dbl::HeadlessPlatformWindow PlatformWindowType;
 #endif
 
 using namespace dbl;
 
-IPlatformWindow * IPlatformWindow::Create( GameWindow * const host, GameWindowSettings & settings )
+IPlatformWindow::PlatformWindowList IPlatformWindow::sWindows;
+
+IPlatformWindow * IPlatformWindow::Create( GameWindow * const host, GameWindowSettings & settings, bool headless )
 {
+	if( headless )
+		return new HeadlessPlatformWindow( host, settings );
 	return new PlatformWindowType( host, settings );
 }
 
+bool IPlatformWindow::HasDisplay( void )
+{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	return true;
+#elif CBL_PLATFORM == CBL_PLATFORM_LINUX
+	return LinuxPlatformWindow::HasDisplay();
+#else
+	return false;
+#endif
+}
+
+void IPlatformWindow::PumpEvents( void )
+{
+	CBL_FOREACH( PlatformWindowList, it, sWindows )
+		( *it )->ProcessWindowEvents();
+
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	// Messages for every window on the thread come out of the same queue.
+	Win32PlatformWindow::PumpMessages();
+#endif
+}
+
 IPlatformWindow::IPlatformWindow( GameWindow * const host, GameWindowSettings & settings )
 : mHost( host )
 , mSettings( settings )
 {
+	sWindows.push_back( this );
 }
 
 IPlatformWindow::~IPlatformWindow()
 {
+	sWindows.erase( std::remove( sWindows.begin(), sWindows.end(), this ), sWindows.end() );
+}
+
+bool IPlatformWindow::SetInputThreadEnabled( bool state )
+{
+	return !state;
+}
+
+bool IPlatformWindow::IsInputThreadEnabled( void ) const
+{
+	return false;
+}
+
+bool IPlatformWindow::ReadInputState( InputState & )
+{
+	return false;
+}
+
+bool IPlatformWindow::SetRelativeMouseMode( bool state )
+{
+	return !state;
+}
+
+bool IPlatformWindow::IsRelativeMouseMode( void ) const
+{
+	return false;
+}
+
+int IPlatformWindow::GetEventFd( void ) const
+{
+	return -1;
+}
+
+bool IPlatformWindow::IsMinimised( void ) const
+{
+	return false;
+}
+
+bool IPlatformWindow::WaitForEvents( cbl::Float64 timeout )
+{
+	// Nothing can wake the wait early, so an indefinite wait returns straight away.
+	if( timeout > 0.0 )
+		Thread::Sleep( cbl::Uint32( timeout * 1000.0 ) );
+	return false;
 }
@@ -33,6 +33,10 @@
 // Delectable Headers //
 #include "dbl/Delectable.h"
 #include "dbl/Core/GameWindowSettings.h"
+#include "dbl/Input/InputState.h"
+
+// External Libraries //
+#include <vector>
 
 namespace dbl
 {
@@ -55,7 +59,12 @@ namespace dbl
 		//! Create a new platform window instance.
 		//! @param	host	Host window.
 		//! @param	s		Platform window settings reference.
-		static IPlatformWindow * Create( GameWindow * const host, GameWindowSettings & s );
+		//! @param	headless	Create a window with no display.
+		static IPlatformWindow * Create( GameWindow * const host, GameWindowSettings & s, bool headless );
+		//! Check if a native window can be created.
+		static bool HasDisplay( void );
+		//! Process events for every platform window in a single pass.
+		static void PumpEvents( void );
 
 	/***** Properties *****/
 	public:
@@ -91,10 +100,34 @@ namespace dbl
 		//! Lock the cursor into the platform window.
 		//! @param	state	Clip state.
 		virtual void ClipCursor( bool state ) = 0;
-		//! Process window events.
+		//! Process events queued for this window.
+		//! Events shared by every window are handled by PumpEvents() afterwards.
 		virtual void ProcessWindowEvents( void ) = 0;
 		//! Set whether the drag and drop works.
 		virtual void SetAcceptDragDrop( bool state ) = 0;
+		//! Start or stop sampling input on a dedicated thread.
+		//! @return		False if the platform has no input thread support.
+		virtual bool SetInputThreadEnabled( bool state );
+		//! Check if input is being sampled on a dedicated thread.
+		virtual bool IsInputThreadEnabled( void ) const;
+		//! Read the latest state published by the input thread.
+		//! @return		False if no new state has been published since the last read.
+		virtual bool ReadInputState( InputState & state );
+		//! Start or stop reporting relative device motion (InputEventType::MouseRawMotion).
+		//! @return		False if the platform has no relative motion support.
+		virtual bool SetRelativeMouseMode( bool state );
+		//! Check if relative device motion is being reported.
+		virtual bool IsRelativeMouseMode( void ) const;
+		//! Get a file descriptor that becomes readable when window events arrive.
+		//! @return		-1 if the platform has no such descriptor.
+		virtual int GetEventFd( void ) const;
+		//! Check if the window is minimised or hidden.
+		virtual bool IsMinimised( void ) const;
+		//! Block until window events arrive or the timeout expires.
+		//! The default implementation just sleeps for the timeout.
+		//! @param	timeout	Maximum wait in seconds (negative waits indefinitely).
+		//! @return		False if the timeout expired without any events.
+		virtual bool WaitForEvents( cbl::Float64 timeout );
 
 	/***** Protected Methods *****/
 	protected:
@@ -106,6 +139,11 @@ namespace dbl
 	protected:
 		GameWindow							* mHost;				//!< Pointer to host window.
 		GameWindowSettings					& mSettings;			//!< Const reference to windows settings.
+
+	/***** Private Static Members *****/
+	private:
+		typedef std::vector< IPlatformWindow * >	PlatformWindowList;
+		static PlatformWindowList			sWindows;				//!< Every live platform window.
 	};
 }
 
@@ -27,9 +27,16 @@
 // Delectable Headers //
 #include "dbl/Core/LevelManager.h"
 #include "dbl/Core/LevelObject.h"
+#include "dbl/Core/StartupReport.h"
+#include "dbl/Threading/Atomic.h"
+
+// External Dependencies //
+#include <fstream>
 
 using namespace dbl;
 
+static const size_t		sPrefetchChunkSize	= 64 * 1024;	//!< Read size used when prefetching.
+
 LevelManager::LevelManager( cbl::Game& game )
 : cbl::DrawableGameComponent( game )
 , MaxLoadBatchTime( 1.0f )
@@ -45,6 +52,7 @@ LevelManager::LevelManager( cbl::Game& game )
 
 LevelManager::~LevelManager()
 {
+	CollectPrefetches( true );
 }
 
 void LevelManager::Initialise( void )
@@ -53,6 +61,7 @@ void LevelManager::Initialise( void )
 
 void LevelManager::Shutdown( void )
 {
+	CollectPrefetches( true );
 	mLevelObjects.clear();
 
 	CBL_DELETE( mSerialiser );
@@ -107,6 +116,58 @@ void LevelManager::Unload( void )
 	}
 }
 
+void LevelManager::Prefetch( const cbl::Char* file )
+{
+	StartupReport* report = Game.Services.Get< StartupReport >();
+
+	LevelPrefetch* prefetch = new LevelPrefetch();
+	prefetch->File		= file;
+	prefetch->Start		= report ? report->GetTime() : 0.0;
+	prefetch->Duration	= 0.0;
+	prefetch->Finished	= 0;
+	if( !prefetch->Worker.Start( &LevelManager::PrefetchThread, prefetch ) ) {
+		LOG( cbl::LogLevel::Warning << "Unable to start prefetch thread for " << file << "." );
+		delete prefetch;
+		return;
+	}
+	mPrefetches.push_back( prefetch );
+}
+
+void LevelManager::PrefetchThread( void* self )
+{
+	LevelPrefetch* prefetch = static_cast< LevelPrefetch* >( self );
+
+	cbl::Stopwatch clock;
+	clock.Start();
+
+	// The data is discarded; reading it is enough to bring it into the file system cache.
+	std::ifstream is( prefetch->File.c_str(), std::ios::in | std::ios::binary );
+	std::vector<char> chunk( sPrefetchChunkSize );
+	while( is.read( &chunk[0], std::streamsize( chunk.size() ) ) ) {}
+
+	prefetch->Duration = clock.GetElapsedTime().TotalSeconds();
+	Atomic::StoreRelease( prefetch->Finished, 1 );
+}
+
+void LevelManager::CollectPrefetches( bool wait )
+{
+	StartupReport* report = Game.Services.Get< StartupReport >();
+
+	PrefetchList::iterator it = mPrefetches.begin();
+	while( it != mPrefetches.end() ) {
+		if( !wait && !Atomic::LoadAcquire( (*it)->Finished ) ) {
+			++it;
+			continue;
+		}
+
+		(*it)->Worker.Join();
+		if( report )
+			report->Add( ( "Level prefetch: " + (*it)->File ).c_str(), (*it)->Start, (*it)->Duration, true );
+		delete *it;
+		it = mPrefetches.erase( it );
+	}
+}
+
 void LevelManager::SetupLoad( const cbl::Char* file, bool unload )
 {
 	if( unload )
@@ -29,6 +29,7 @@
 #include "dbl/Core/LevelObject.h"
 
 YAML::Parser	sLocalParser;
+dbl::JSONDocument	sLocalJSONDocument;
 std::ifstream	sLocalFileInStream;
 std::ofstream	sLocalFileOutStream;
 
@@ -37,6 +38,9 @@ using namespace dbl;
 template<>
 void LevelManager::Load<YAMLDeserialiser>( const cbl::Char* file, bool unload )
 {
+	// Read alongside a prefetch that's still running rather than waiting for it.
+	CollectPrefetches( false );
+
 	if( sLocalFileInStream.is_open() )
 		sLocalFileInStream.close();
 
@@ -86,9 +90,65 @@ void LevelManager::Save<YAMLSerialiser>( const cbl::Char* file ) const
 	const_cast<LevelManager*>(this)->OnLevelSaveEnd( mLoadedLevel );
 }
 
+template<>
+void LevelManager::Load<JSONDeserialiser>( const cbl::Char* file, bool unload )
+{
+	CollectPrefetches( false );
+
+	if( sLocalFileInStream.is_open() )
+		sLocalFileInStream.close();
+
+	sLocalFileInStream.open( file, std::ios_base::binary );
+	if( !sLocalFileInStream.is_open() ) {
+		LOG_ERROR( "Unable to open JSON file for reading: " << file );
+		return;
+	}
+
+	// The whole file is read into the document; the stream is not needed after this.
+	bool loaded = sLocalJSONDocument.Load( sLocalFileInStream );
+	sLocalFileInStream.close();
+	if( !loaded ) {
+		LOG_ERROR( "Unable to read JSON file: " << file );
+		return;
+	}
+
+	CBL_DELETE( mDeserialiser );
+
+	mDeserialiser = new JSONDeserialiser();
+	mDeserialiser->SetStream( sLocalJSONDocument );
+
+	SetupLoad( file, unload );
+}
+
+template<>
+void LevelManager::Save<JSONSerialiser>( const cbl::Char* file ) const
+{
+	CBL_DELETE( mSerialiser );
+
+	mLoadedLevel = file;
+	const_cast<LevelManager*>(this)->OnLevelSaveBegin( mLoadedLevel );
+
+	JSONWriter w;
+	mSerialiser = new JSONSerialiser();
+	mSerialiser->SetStream( w );
+
+	for( size_t i = 0; i < mLevelObjects.size(); ++i ) {
+		if( cbl::ObjectPtr obj = Game.Objects.Get( mLevelObjects[i] ) )
+			mSerialiser->Serialise( *obj );
+	}
+
+	((JSONSerialiser*)(mSerialiser))->Output( mLoadedLevel.GetFullFile().c_str() );
+
+	LOG( mLoadedLevel.GetFile() << " level saved." );
+
+	const_cast<LevelManager*>(this)->OnLevelSaveEnd( mLoadedLevel );
+}
+
 template<>
 void LevelManager::Load<cbl::BinaryDeserialiser>( const cbl::Char* file, bool unload )
 {
+	CollectPrefetches( false );
+
 	if( sLocalFileInStream.is_open() )
 		sLocalFileInStream.close();
 
@@ -0,0 +1,108 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file GameWindow_Linux.cpp
+ * @brief Display queries for X11.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Core/GameWindow.h"
+#include "dbl/Core/DisplayModeCache.h"
+
+#if CBL_PLATFORM == CBL_PLATFORM_LINUX
+
+// External Dependencies //
+#include <xcb/xcb.h>
+
+using namespace dbl;
+
+//! Get the size of the default X screen (or the virtual resolution without a display).
+//! The screen is queried again only after the display mode cache is invalidated; resolution
+//! change notifications need RandR, which isn't used.
+const GameWindowSize & _getScreenSize( void )
+{
+	static GameWindowSize size( 0, 0, 0 );
+	static cbl::Uint32 generation = 0;
+	if( generation == DisplayModeCache::GetGeneration() )
+		return size;
+	generation = DisplayModeCache::GetGeneration();
+
+	size = GameWindow::sVirtualResolution;
+	int screen = 0;
+	xcb_connection_t * connection = xcb_connect( NULL, &screen );
+	if( !xcb_connection_has_error( connection ) ) {
+		xcb_screen_iterator_t it = xcb_setup_roots_iterator( xcb_get_setup( connection ) );
+		for( ; screen > 0 && it.rem > 1; --screen )
+			xcb_screen_next( &it );
+		size = GameWindowSize( it.data->width_in_pixels, it.data->height_in_pixels, it.data->root_depth );
+	}
+	xcb_disconnect( connection );
+	return size;
+}
+
+void GameWindow::PopulateResolutions( void )
+{
+	// Without RandR the only mode known is the current one.
+	mAvailableResolutions.assign( 1, _getScreenSize() );
+}
+
+void GameWindow::SetCurrentDesktopResolution( void )
+{
+	mDesktopResolution = _getScreenSize();
+}
+
+void GameWindow::GetWorkableArea( cbl::Uint32& left, cbl::Uint32& top, cbl::Uint32& right, cbl::Uint32& bottom, GameWindowStyle& )
+{
+	left	= 0;
+	top		= 0;
+	right	= _getScreenSize().Width;
+	bottom	= _getScreenSize().Height;
+}
+
+void GameWindow::GetWorkableAreaCenter( cbl::Uint32& x, cbl::Uint32& y, GameWindowStyle& )
+{
+	x = _getScreenSize().Width / 2;
+	y = _getScreenSize().Height / 2;
+}
+
+void GameWindow::GetBestClientWindowDimensions( cbl::Uint32 targetw, cbl::Uint32 targeth, GameWindowStyle&, cbl::Uint32& bestw, cbl::Uint32& besth )
+{
+	// Decorations are drawn by the window manager outside the client area, so only fit the screen.
+	const GameWindowSize & screen = _getScreenSize();
+	bestw = targetw;
+	besth = targeth;
+	if( bestw > screen.Width ) {
+		besth = cbl::Uint32( cbl::Float64( besth ) * screen.Width / bestw + 0.5 );
+		bestw = screen.Width;
+	}
+	if( besth > screen.Height ) {
+		bestw = cbl::Uint32( cbl::Float64( bestw ) * screen.Height / besth + 0.5 );
+		besth = screen.Height;
+	}
+}
+
+cbl::Uint32 GameWindow::GetSystemWindowStyle( GameWindowStyle& )
+{
+	return 0;
+}
+
+#endif
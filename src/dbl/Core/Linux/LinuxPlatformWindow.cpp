@@ -0,0 +1,631 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file LinuxPlatformWindow.cpp
+ * @brief Linux (X11/XCB) window implementation.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "LinuxPlatformWindow.h"
+#include "dbl/Core/GameWindow.h"
+
+// Chewable Headers //
+#include <cbl/Debug/Logging.h>
+
+// External Dependencies //
+#include <X11/keysym.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace dbl;
+
+cbl::Uint32 LinuxPlatformWindow::sDoubleClickTime	= 500;
+
+static const cbl::Char * const	sAtomNames[]	= { "WM_PROTOCOLS", "WM_DELETE_WINDOW", "_NET_WM_NAME", "_NET_WM_STATE", "_NET_WM_STATE_FULLSCREEN", "UTF8_STRING" };
+static const cbl::Int32			sClickSlop		= 4;	//!< Maximum cursor travel between clicks of a double click.
+static const cbl::Uint32		sNetWmStateRemove	= 0;
+static const cbl::Uint32		sNetWmStateAdd		= 1;
+
+Key::Code ConvertKeysym( xcb_keysym_t keysym );
+
+bool LinuxPlatformWindow::HasDisplay( void )
+{
+	const cbl::Char * display = getenv( "DISPLAY" );
+	return display && *display;
+}
+
+LinuxPlatformWindow::LinuxPlatformWindow( GameWindow * const host, GameWindowSettings & s )
+: IPlatformWindow( host, s )
+, mConnection( NULL )
+, mScreen( NULL )
+, mWindow( 0 )
+, mHiddenCursor( 0 )
+, mPending( NULL )
+, mShowCursor( true )
+, mClippedCursor( false )
+, mClosed( false )
+, mMinimised( true )
+, mLastClickButton( Mouse::Count )
+, mLastClickTime( 0 )
+, mLastClickX( 0 )
+, mLastClickY( 0 )
+, mTimeOffset( 0.0 )
+, mHasTimeOffset( false )
+, mLastInputTime( 0.0 )
+{
+	memset( mAtoms, 0, sizeof( mAtoms ) );
+	memset( mKeys, 0, sizeof( mKeys ) );
+	memset( mKeysyms, 0, sizeof( mKeysyms ) );
+
+	int screen = 0;
+	mConnection = xcb_connect( NULL, &screen );
+	if( xcb_connection_has_error( mConnection ) ) {
+		LOG_ERROR( "Unable to connect to the X server." );
+		xcb_disconnect( mConnection );
+		mConnection = NULL;
+		return;
+	}
+
+	xcb_screen_iterator_t it = xcb_setup_roots_iterator( xcb_get_setup( mConnection ) );
+	for( ; screen > 0 && it.rem > 1; --screen )
+		xcb_screen_next( &it );
+	mScreen = it.data;
+
+	const cbl::Uint32 mask = XCB_CW_BACK_PIXEL | XCB_CW_EVENT_MASK;
+	const cbl::Uint32 values[] = {
+		mScreen->black_pixel,
+		XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE |
+		XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE | XCB_EVENT_MASK_POINTER_MOTION |
+		XCB_EVENT_MASK_ENTER_WINDOW | XCB_EVENT_MASK_LEAVE_WINDOW |
+		XCB_EVENT_MASK_FOCUS_CHANGE | XCB_EVENT_MASK_STRUCTURE_NOTIFY
+	};
+
+	mWindow = xcb_generate_id( mConnection );
+	xcb_create_window( mConnection, XCB_COPY_FROM_PARENT, mWindow, mScreen->root,
+		0, 0, cbl::Uint16( mSettings.Resolution.Width ), cbl::Uint16( mSettings.Resolution.Height ), 0,
+		XCB_WINDOW_CLASS_INPUT_OUTPUT, mScreen->root_visual, mask, values );
+
+	InternAtoms();
+	LoadKeyboardMapping();
+
+	// Ask for a close message instead of having the connection killed.
+	xcb_change_property( mConnection, XCB_PROP_MODE_REPLACE, mWindow, mAtoms[ WmProtocols ], XCB_ATOM_ATOM, 32, 1, &mAtoms[ WmDeleteWindow ] );
+
+	// A 1x1 empty bitmap makes an invisible cursor.
+	xcb_pixmap_t blank = xcb_generate_id( mConnection );
+	xcb_create_pixmap( mConnection, 1, blank, mWindow, 1, 1 );
+	mHiddenCursor = xcb_generate_id( mConnection );
+	xcb_create_cursor( mConnection, mHiddenCursor, blank, blank, 0, 0, 0, 0, 0, 0, 0, 0 );
+	xcb_free_pixmap( mConnection, blank );
+
+	DoSetTitle();
+	DoSetSizePosition();
+	xcb_map_window( mConnection, mWindow );
+	if( mSettings.Style.Fullscreen )
+		DoSetFullscreen();
+
+	xcb_flush( mConnection );
+}
+
+LinuxPlatformWindow::~LinuxPlatformWindow()
+{
+	free( mPending );
+
+	if( !mConnection )
+		return;
+
+	xcb_free_cursor( mConnection, mHiddenCursor );
+	xcb_destroy_window( mConnection, mWindow );
+	xcb_disconnect( mConnection );
+}
+
+GameWindowHandle LinuxPlatformWindow::GetHandle( void )
+{
+	return reinterpret_cast< GameWindowHandle >( uintptr_t( mWindow ) );
+}
+
+void LinuxPlatformWindow::DoSetSizePosition( void )
+{
+	if( !mConnection )
+		return;
+
+	cbl::Int32 x = 0, y = 0;
+	if( mSettings.Style.Fullscreen ) {
+		mSettings.Dimensions.Width = mSettings.Resolution.Width;
+		mSettings.Dimensions.Height = mSettings.Resolution.Height;
+	}
+	else {
+		GameWindow::GetBestClientWindowDimensions( mSettings.Resolution.Width, mSettings.Resolution.Height, mSettings.Style, mSettings.Dimensions.Width, mSettings.Dimensions.Height );
+
+		cbl::Uint32 cx, cy;
+		GameWindow::GetWorkableAreaCenter( cx, cy, mSettings.Style );
+		x = cbl::Int32( cx ) - cbl::Int32( mSettings.Dimensions.Width ) / 2;
+		y = cbl::Int32( cy ) - cbl::Int32( mSettings.Dimensions.Height ) / 2;
+	}
+	mSettings.AspectRatio = cbl::Real( mSettings.Dimensions.Width ) / cbl::Real( mSettings.Dimensions.Height );
+
+	const cbl::Uint32 values[] = { cbl::Uint32( x ), cbl::Uint32( y ), mSettings.Dimensions.Width, mSettings.Dimensions.Height };
+	xcb_configure_window( mConnection, mWindow,
+		XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y | XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT, values );
+	xcb_flush( mConnection );
+
+	mHost->PostWindowEvent( WindowEvent::MakeResized(
+		mSettings.Resolution.Width,
+		mSettings.Resolution.Height,
+		mSettings.Dimensions.Width,
+		mSettings.Dimensions.Height,
+		mSettings.Resolution.BitsPerPixel,
+		mSettings.AspectRatio
+	) );
+}
+
+void LinuxPlatformWindow::DoSetTitle( void )
+{
+	if( !mConnection )
+		return;
+
+	const cbl::Uint32 length = cbl::Uint32( mSettings.Title.length() );
+	xcb_change_property( mConnection, XCB_PROP_MODE_REPLACE, mWindow, XCB_ATOM_WM_NAME, XCB_ATOM_STRING, 8, length, mSettings.Title.c_str() );
+	xcb_change_property( mConnection, XCB_PROP_MODE_REPLACE, mWindow, mAtoms[ NetWmName ], mAtoms[ Utf8String ], 8, length, mSettings.Title.c_str() );
+	xcb_flush( mConnection );
+}
+
+void LinuxPlatformWindow::DoSetStyle( void )
+{
+	// Decorations belong to the window manager; there's no portable way to drop individual buttons.
+}
+
+void LinuxPlatformWindow::DoSetFullscreen( void )
+{
+	if( !mConnection )
+		return;
+
+	// Ask the window manager to toggle the fullscreen state.
+	xcb_client_message_event_t ev;
+	memset( &ev, 0, sizeof( ev ) );
+	ev.response_type	= XCB_CLIENT_MESSAGE;
+	ev.format			= 32;
+	ev.window			= mWindow;
+	ev.type				= mAtoms[ NetWmState ];
+	ev.data.data32[0]	= mSettings.Style.Fullscreen ? sNetWmStateAdd : sNetWmStateRemove;
+	ev.data.data32[1]	= mAtoms[ NetWmStateFullscreen ];
+	ev.data.data32[3]	= 1; // Normal application.
+	xcb_send_event( mConnection, 0, mScreen->root,
+		XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY | XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT, reinterpret_cast< const char * >( &ev ) );
+
+	DoSetSizePosition();
+	mHost->PostWindowEvent( WindowEvent::Make( WindowEventType::Fullscreen, mSettings.Style.Fullscreen ? 1 : 0 ) );
+}
+
+void LinuxPlatformWindow::Show( bool state )
+{
+	if( !mConnection )
+		return;
+
+	if( state )
+		xcb_map_window( mConnection, mWindow );
+	else
+		xcb_unmap_window( mConnection, mWindow );
+	xcb_flush( mConnection );
+}
+
+void LinuxPlatformWindow::ShowCursor( bool state )
+{
+	mShowCursor = state;
+	if( !mConnection )
+		return;
+
+	const cbl::Uint32 cursor = state ? cbl::Uint32( XCB_CURSOR_NONE ) : mHiddenCursor;
+	xcb_change_window_attributes( mConnection, mWindow, XCB_CW_CURSOR, &cursor );
+	xcb_flush( mConnection );
+}
+
+void LinuxPlatformWindow::SetCursor( const cbl::Char * )
+{
+	// Loading cursor files needs libXcursor; the default pointer is used.
+}
+
+void LinuxPlatformWindow::SetCursorPosition( cbl::Int32 x, cbl::Int32 y )
+{
+	if( !mConnection )
+		return;
+
+	xcb_warp_pointer( mConnection, XCB_NONE, mWindow, 0, 0, 0, 0, cbl::Int16( x ), cbl::Int16( y ) );
+	xcb_flush( mConnection );
+}
+
+void LinuxPlatformWindow::ClipCursor( bool clip )
+{
+	if( !mConnection || mClippedCursor == clip )
+		return;
+
+	mClippedCursor = clip;
+	if( clip ) {
+		// Grabs fail while the window is unmapped; the pointer just stays free.
+		xcb_grab_pointer( mConnection, 1, mWindow,
+			XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE | XCB_EVENT_MASK_POINTER_MOTION,
+			XCB_GRAB_MODE_ASYNC, XCB_GRAB_MODE_ASYNC, mWindow, XCB_NONE, XCB_CURRENT_TIME );
+	}
+	else {
+		xcb_ungrab_pointer( mConnection, XCB_CURRENT_TIME );
+	}
+	xcb_flush( mConnection );
+}
+
+void LinuxPlatformWindow::ProcessWindowEvents( void )
+{
+	if( !mConnection )
+		return;
+
+	// xcb reads everything waiting on the socket at once; drain it without going back to the server.
+	while( xcb_generic_event_t * ev = NextEvent() ) {
+		ProcessEvent( ev );
+		free( ev );
+	}
+
+	if( !mClosed && xcb_connection_has_error( mConnection ) ) {
+		mClosed = true;
+		LOG_ERROR( "Lost the connection to the X server." );
+		mHost->PostWindowEvent( WindowEvent::Make( WindowEventType::Closed ) );
+	}
+}
+
+void LinuxPlatformWindow::SetAcceptDragDrop( bool )
+{
+	// XDND isn't supported.
+}
+
+int LinuxPlatformWindow::GetEventFd( void ) const
+{
+	return mConnection ? xcb_get_file_descriptor( mConnection ) : -1;
+}
+
+bool LinuxPlatformWindow::IsMinimised( void ) const
+{
+	return mMinimised;
+}
+
+bool LinuxPlatformWindow::WaitForEvents( cbl::Float64 timeout )
+{
+	if( !mConnection )
+		return IPlatformWindow::WaitForEvents( timeout );
+
+	// Events xcb has already read won't make the socket readable again.
+	if( PeekEvent() )
+		return true;
+
+	xcb_flush( mConnection );
+
+	pollfd fd;
+	fd.fd		= xcb_get_file_descriptor( mConnection );
+	fd.events	= POLLIN;
+	fd.revents	= 0;
+	return poll( &fd, 1, timeout < 0.0 ? -1 : int( timeout * 1000.0 ) ) > 0;
+}
+
+void LinuxPlatformWindow::InternAtoms( void )
+{
+	// Send every request before waiting on any reply.
+	xcb_intern_atom_cookie_t cookies[ AtomCount ];
+	for( cbl::Uint32 i = 0; i < AtomCount; ++i )
+		cookies[i] = xcb_intern_atom( mConnection, 0, cbl::Uint16( strlen( sAtomNames[i] ) ), sAtomNames[i] );
+
+	for( cbl::Uint32 i = 0; i < AtomCount; ++i ) {
+		if( xcb_intern_atom_reply_t * reply = xcb_intern_atom_reply( mConnection, cookies[i], NULL ) ) {
+			mAtoms[i] = reply->atom;
+			free( reply );
+		}
+	}
+}
+
+void LinuxPlatformWindow::LoadKeyboardMapping( void )
+{
+	const xcb_setup_t * setup = xcb_get_setup( mConnection );
+	const cbl::Uint32 first = setup->min_keycode;
+	const cbl::Uint32 count = cbl::Uint32( setup->max_keycode ) - first + 1;
+
+	xcb_get_keyboard_mapping_reply_t * reply = xcb_get_keyboard_mapping_reply( mConnection,
+		xcb_get_keyboard_mapping( mConnection, xcb_keycode_t( first ), cbl::Uint8( count ) ), NULL );
+	if( !reply )
+		return;
+
+	const xcb_keysym_t * keysyms = xcb_get_keyboard_mapping_keysyms( reply );
+	const cbl::Uint32 perCode = reply->keysyms_per_keycode;
+	for( cbl::Uint32 i = 0; i < count && first + i < 256; ++i ) {
+		const xcb_keysym_t * syms = keysyms + i * perCode;
+		const cbl::Uint32 code = first + i;
+		mKeysyms[code][0] = perCode > 0 ? syms[0] : 0;
+		mKeysyms[code][1] = perCode > 1 && syms[1] != 0 ? syms[1] : mKeysyms[code][0];
+
+		// Keypad digits are the shifted level when num lock is off.
+		mKeys[code] = ConvertKeysym( mKeysyms[code][0] );
+		if( mKeys[code] == 0 )
+			mKeys[code] = ConvertKeysym( mKeysyms[code][1] );
+	}
+
+	free( reply );
+}
+
+xcb_generic_event_t * LinuxPlatformWindow::NextEvent( void )
+{
+	if( mPending ) {
+		xcb_generic_event_t * ev = mPending;
+		mPending = NULL;
+		return ev;
+	}
+	return xcb_poll_for_event( mConnection );
+}
+
+xcb_generic_event_t * LinuxPlatformWindow::PeekEvent( void )
+{
+	if( !mPending )
+		mPending = xcb_poll_for_queued_event( mConnection );
+	return mPending;
+}
+
+void LinuxPlatformWindow::ProcessEvent( xcb_generic_event_t * ev )
+{
+	switch( ev->response_type & ~0x80 )
+	{
+		// Key down event.
+		case XCB_KEY_PRESS: {
+			const xcb_key_press_event_t * key = reinterpret_cast< const xcb_key_press_event_t * >( ev );
+			if( mKeys[ key->detail ] != 0 )
+				QueueInput( InputEventType::KeyDown, key->time, mKeys[ key->detail ] );
+			if( cbl::Uint32 unicode = GetKeyChar( key->detail, key->state ) )
+				QueueInput( InputEventType::KeyChar, key->time, unicode );
+			} break;
+		// Key up event.
+		case XCB_KEY_RELEASE: {
+			const xcb_key_release_event_t * key = reinterpret_cast< const xcb_key_release_event_t * >( ev );
+			// Auto-repeat arrives as a release and press with the same time; report only the
+			// repeated press, like Windows does.
+			const xcb_generic_event_t * next = PeekEvent();
+			if( next && ( next->response_type & ~0x80 ) == XCB_KEY_PRESS ) {
+				const xcb_key_press_event_t * press = reinterpret_cast< const xcb_key_press_event_t * >( next );
+				if( press->detail == key->detail && press->time == key->time )
+					break;
+			}
+			if( mKeys[ key->detail ] != 0 )
+				QueueInput( InputEventType::KeyUp, key->time, mKeys[ key->detail ] );
+			} break;
+		// Mouse button down event.
+		case XCB_BUTTON_PRESS:
+			ProcessButtonPress( reinterpret_cast< const xcb_button_press_event_t * >( ev ) );
+			break;
+		// Mouse button up event.
+		case XCB_BUTTON_RELEASE: {
+			const xcb_button_release_event_t * button = reinterpret_cast< const xcb_button_release_event_t * >( ev );
+			switch( button->detail ) {
+				case 1: QueueInput( InputEventType::MouseUp, button->time, Mouse::Left, button->event_x, button->event_y ); break;
+				case 2: QueueInput( InputEventType::MouseUp, button->time, Mouse::Middle, button->event_x, button->event_y ); break;
+				case 3: QueueInput( InputEventType::MouseUp, button->time, Mouse::Right, button->event_x, button->event_y ); break;
+				case 8: QueueInput( InputEventType::MouseUp, button->time, Mouse::XButton1, button->event_x, button->event_y ); break;
+				case 9: QueueInput( InputEventType::MouseUp, button->time, Mouse::XButton2, button->event_x, button->event_y ); break;
+			}
+			} break;
+		// Mouse move event.
+		case XCB_MOTION_NOTIFY: {
+			const xcb_motion_notify_event_t * motion = reinterpret_cast< const xcb_motion_notify_event_t * >( ev );
+			QueueInput( InputEventType::MouseMove, motion->time, 0, motion->event_x, motion->event_y );
+			} break;
+		case XCB_ENTER_NOTIFY:
+			QueueInput( InputEventType::MouseEnter, reinterpret_cast< const xcb_enter_notify_event_t * >( ev )->time );
+			break;
+		case XCB_LEAVE_NOTIFY:
+			QueueInput( InputEventType::MouseLeave, reinterpret_cast< const xcb_leave_notify_event_t * >( ev )->time );
+			break;
+		// Window gained focus event.
+		case XCB_FOCUS_IN:
+			// Ignore the focus changes caused by our own pointer grabs.
+			if( reinterpret_cast< const xcb_focus_in_event_t * >( ev )->mode == XCB_NOTIFY_MODE_NORMAL )
+				QueueInput( InputEventType::GainedFocus, 0 );
+			break;
+		// Window lost focus event.
+		case XCB_FOCUS_OUT:
+			if( reinterpret_cast< const xcb_focus_out_event_t * >( ev )->mode == XCB_NOTIFY_MODE_NORMAL )
+				QueueInput( InputEventType::LostFocus, 0 );
+			break;
+		// Window resized by the user or window manager.
+		case XCB_CONFIGURE_NOTIFY: {
+			const xcb_configure_notify_event_t * configure = reinterpret_cast< const xcb_configure_notify_event_t * >( ev );
+			if( configure->width == mSettings.Dimensions.Width && configure->height == mSettings.Dimensions.Height )
+				break;
+
+			mSettings.Dimensions.Width = configure->width;
+			mSettings.Dimensions.Height = configure->height;
+			mSettings.AspectRatio = cbl::Real( mSettings.Dimensions.Width ) / cbl::Real( mSettings.Dimensions.Height );
+			mHost->PostWindowEvent( WindowEvent::MakeResized(
+				mSettings.Resolution.Width,
+				mSettings.Resolution.Height,
+				mSettings.Dimensions.Width,
+				mSettings.Dimensions.Height,
+				mSettings.Resolution.BitsPerPixel,
+				mSettings.AspectRatio
+			) );
+			} break;
+		// Close button.
+		case XCB_CLIENT_MESSAGE: {
+			const xcb_client_message_event_t * message = reinterpret_cast< const xcb_client_message_event_t * >( ev );
+			if( message->type == mAtoms[ WmProtocols ] && message->data.data32[0] == mAtoms[ WmDeleteWindow ] )
+				mHost->PostWindowEvent( WindowEvent::Make( WindowEventType::Closed ) );
+			} break;
+		// Window manager iconified, hid or restored the window.
+		case XCB_MAP_NOTIFY:
+			mMinimised = false;
+			break;
+		case XCB_UNMAP_NOTIFY:
+			mMinimised = true;
+			break;
+		// Keyboard layout changed.
+		case XCB_MAPPING_NOTIFY:
+			if( reinterpret_cast< const xcb_mapping_notify_event_t * >( ev )->request == XCB_MAPPING_KEYBOARD )
+				LoadKeyboardMapping();
+			break;
+	}
+}
+
+void LinuxPlatformWindow::ProcessButtonPress( const xcb_button_press_event_t * ev )
+{
+	Mouse::Button button;
+	switch( ev->detail ) {
+		case 1: button = Mouse::Left; break;
+		case 2: button = Mouse::Middle; break;
+		case 3: button = Mouse::Right; break;
+		case 8: button = Mouse::XButton1; break;
+		case 9: button = Mouse::XButton2; break;
+		// Wheel notches are reported as presses of buttons 4 and 5.
+		case 4: QueueInput( InputEventType::MouseWheel, ev->time, 0, 1 ); return;
+		case 5: QueueInput( InputEventType::MouseWheel, ev->time, 0, -1 ); return;
+		default: return;
+	}
+
+	// X has no double click message; detect it like Windows does, replacing the second press.
+	const bool dblClick = button == mLastClickButton && ev->time - mLastClickTime <= sDoubleClickTime &&
+		abs( ev->event_x - mLastClickX ) <= sClickSlop && abs( ev->event_y - mLastClickY ) <= sClickSlop;
+
+	mLastClickButton	= dblClick ? Mouse::Count : button;
+	mLastClickTime		= ev->time;
+	mLastClickX			= ev->event_x;
+	mLastClickY			= ev->event_y;
+
+	QueueInput( dblClick ? InputEventType::MouseDblClick : InputEventType::MouseDown, ev->time, button, ev->event_x, ev->event_y );
+}
+
+cbl::Uint32 LinuxPlatformWindow::GetKeyChar( xcb_keycode_t code, cbl::Uint16 state ) const
+{
+	if( state & XCB_MOD_MASK_CONTROL )
+		return 0;
+
+	// Caps lock only shifts letters.
+	xcb_keysym_t keysym = mKeysyms[code][0];
+	bool shift = ( state & XCB_MOD_MASK_SHIFT ) != 0;
+	if( ( state & XCB_MOD_MASK_LOCK ) && keysym >= XK_a && keysym <= XK_z )
+		shift = !shift;
+	if( shift )
+		keysym = mKeysyms[code][1];
+
+	switch( keysym ) {
+		case XK_BackSpace:	return '\b';
+		case XK_Tab:		return '\t';
+		case XK_Return:
+		case XK_KP_Enter:	return '\r';
+		case XK_Escape:		return 0x1B;
+	}
+
+	// Latin-1 keysyms match their code points; others are offset by 0x01000000.
+	if( ( keysym >= 0x20 && keysym <= 0x7E ) || ( keysym >= 0xA0 && keysym <= 0xFF ) )
+		return keysym;
+	if( ( keysym & 0xFF000000 ) == 0x01000000 )
+		return keysym & 0x00FFFFFF;
+
+	return 0;
+}
+
+void LinuxPlatformWindow::QueueInput( InputEventType::Type type, xcb_timestamp_t stamp, cbl::Uint32 code, cbl::Int32 x, cbl::Int32 y )
+{
+	cbl::Float64 now = mHost->GetInputTime();
+	cbl::Float64 time = now;
+
+	if( stamp != 0 ) {
+		// Events can only arrive late, so the smallest offset seen is the closest to the server clock.
+		// Re-measure if the server time has wrapped.
+		const cbl::Float64 server = cbl::Float64( stamp ) / 1000.0;
+		if( !mHasTimeOffset || now - server < mTimeOffset || server + mTimeOffset < mLastInputTime - 1.0 ) {
+			mTimeOffset = now - server;
+			mHasTimeOffset = true;
+		}
+		time = server + mTimeOffset;
+	}
+
+	// Keep times monotonic.
+	if( time < mLastInputTime )
+		time = mLastInputTime;
+	if( time > now )
+		time = now;
+	mLastInputTime = time;
+
+	mHost->PushInputEvent( InputEvent::Make( type, time, code, x, y ) );
+}
+
+Key::Code ConvertKeysym( xcb_keysym_t keysym )
+{
+	if( keysym >= XK_a && keysym <= XK_z )
+		return Key::Code( Key::A + ( keysym - XK_a ) );
+	if( keysym >= XK_A && keysym <= XK_Z )
+		return Key::Code( Key::A + ( keysym - XK_A ) );
+	if( keysym >= XK_0 && keysym <= XK_9 )
+		return Key::Code( Key::Num0 + ( keysym - XK_0 ) );
+	if( keysym >= XK_KP_0 && keysym <= XK_KP_9 )
+		return Key::Code( Key::Numpad0 + ( keysym - XK_KP_0 ) );
+	if( keysym >= XK_F1 && keysym <= XK_F15 )
+		return Key::Code( Key::F1 + ( keysym - XK_F1 ) );
+
+	switch( keysym )
+	{
+		case XK_Escape :		return Key::Escape;
+		case XK_Control_L :		return Key::LCtrl;
+		case XK_Shift_L :		return Key::LShift;
+		case XK_Alt_L :			return Key::LAlt;
+		case XK_Super_L :		return Key::LSystem;
+		case XK_Control_R :		return Key::RCtrl;
+		case XK_Shift_R :		return Key::RShift;
+		case XK_Alt_R :			return Key::RAlt;
+		case XK_Super_R :		return Key::RSystem;
+		case XK_Menu :			return Key::Menu;
+		case XK_bracketleft :	return Key::LBracket;
+		case XK_bracketright :	return Key::RBracket;
+		case XK_semicolon :		return Key::SemiColon;
+		case XK_comma :			return Key::Comma;
+		case XK_period :		return Key::Period;
+		case XK_apostrophe :	return Key::Quote;
+		case XK_slash :			return Key::Slash;
+		case XK_backslash :		return Key::BackSlash;
+		case XK_grave :			return Key::Tilde;
+		case XK_equal :			return Key::Equal;
+		case XK_minus :			return Key::Dash;
+		case XK_space :			return Key::Space;
+		case XK_Return :		return Key::Return;
+		case XK_KP_Enter :		return Key::Return;
+		case XK_BackSpace :		return Key::Back;
+		case XK_Tab :			return Key::Tab;
+		case XK_Prior :			return Key::PageUp;
+		case XK_Next :			return Key::PageDown;
+		case XK_End :			return Key::End;
+		case XK_Home :			return Key::Home;
+		case XK_Insert :		return Key::Insert;
+		case XK_Delete :		return Key::Delete;
+		case XK_KP_Add :		return Key::Add;
+		case XK_KP_Subtract :	return Key::Subtract;
+		case XK_KP_Multiply :	return Key::Multiply;
+		case XK_KP_Divide :		return Key::Divide;
+		case XK_Left :			return Key::Left;
+		case XK_Right :			return Key::Right;
+		case XK_Up :			return Key::Up;
+		case XK_Down :			return Key::Down;
+		case XK_Pause :			return Key::Pause;
+	}
+
+	return Key::Code( 0 );
+}
@@ -0,0 +1,160 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file LinuxPlatformWindow.h
+ * @brief Linux (X11/XCB) window implementation.
+ */
+
+#ifndef __DBL_LINUXPLATFORMWINDOW_H_
+#define __DBL_LINUXPLATFORMWINDOW_H_
+
+// Delectable Headers //
+#include "../IPlatformWindow.h"
+#include "dbl/Input/InputEvent.h"
+
+// External Dependencies //
+#include <xcb/xcb.h>
+
+namespace dbl
+{
+	//! @brief X11 platform window using XCB.
+	//! Events are read in batches from the connection and queued on the host window. The
+	//! connection's file descriptor is exposed so the game loop can block on it instead of
+	//! spinning. This class is created in the GameWindow through a static factory method and
+	//! should not be instantiated manually.
+	class LinuxPlatformWindow :
+		public IPlatformWindow
+	{
+	/***** Public Static Members *****/
+	public:
+		static cbl::Uint32			sDoubleClickTime;	//!< Maximum time between clicks of a double click (in milliseconds). Defaults to 500.
+
+	/***** Public Static Methods *****/
+	public:
+		//! Check if an X display has been configured.
+		static bool HasDisplay( void );
+
+	/***** Properties *****/
+	public:
+		//! Get the game window handle.
+		//! @return			Returns the X window id.
+		virtual GameWindowHandle	GetHandle( void );
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	s		Reference to window settings.
+		LinuxPlatformWindow( GameWindow * const host, GameWindowSettings & s );
+		//! Destructor.
+		//! Automatically destroys window when deleted.
+		virtual ~LinuxPlatformWindow();
+		//! Set window size and center it on the screen.
+		virtual void DoSetSizePosition( void );
+		//! Reset window title using referenced window settings.
+		virtual void DoSetTitle( void );
+		//! Reset window style using referenced window settings.
+		virtual void DoSetStyle( void );
+		//! Reset window fullscreen mode using referenced window settings.
+		virtual void DoSetFullscreen( void );
+		//! Show/hide window.
+		//! @param	state	Window visibility state.
+		virtual void Show( bool state );
+		//! Show/hide window cursor.
+		//! @param	state	Window cursor visibility state.
+		virtual void ShowCursor( bool state );
+		//! Load and set cursor to a file.
+		virtual void SetCursor( const cbl::Char * file );
+		//! Set the cursor position within the window.
+		//! @param	x		Window cursor x position.
+		//! @param	y		Window cursor y position.
+		virtual void SetCursorPosition( cbl::Int32 x, cbl::Int32 y );
+		//! Lock the cursor into the platform window.
+		//! @param	clip	Clip state.
+		virtual void ClipCursor( bool clip );
+		//! Process window events.
+		virtual void ProcessWindowEvents( void );
+		//! Set whether the drag and drop works.
+		virtual void SetAcceptDragDrop( bool state );
+		//! Get the X connection's file descriptor.
+		virtual int GetEventFd( void ) const;
+		//! Check if the window is unmapped (minimised or hidden).
+		virtual bool IsMinimised( void ) const;
+		//! Block until X events arrive or the timeout expires.
+		virtual bool WaitForEvents( cbl::Float64 timeout );
+
+	/***** Private Types *****/
+	private:
+		//! Atoms used by the window.
+		enum AtomId
+		{
+			WmProtocols,
+			WmDeleteWindow,
+			NetWmName,
+			NetWmState,
+			NetWmStateFullscreen,
+			Utf8String,
+
+			AtomCount,
+		};
+
+	/***** Private Methods *****/
+	private:
+		//! Intern all atoms in a single round trip.
+		void InternAtoms( void );
+		//! Read the keyboard mapping and rebuild the key code table.
+		void LoadKeyboardMapping( void );
+		//! Get the next event (including one read ahead by PeekEvent()).
+		xcb_generic_event_t * NextEvent( void );
+		//! Look at the next already-read event without removing it.
+		xcb_generic_event_t * PeekEvent( void );
+		//! Process individual window event.
+		void ProcessEvent( xcb_generic_event_t * ev );
+		//! Handle a mouse button press.
+		void ProcessButtonPress( const xcb_button_press_event_t * ev );
+		//! Get the unicode character a key produces.
+		cbl::Uint32 GetKeyChar( xcb_keycode_t code, cbl::Uint16 state ) const;
+		//! Timestamp an input event and queue it on the host window.
+		//! @param	stamp	X server time (0 for events that carry no time).
+		void QueueInput( InputEventType::Type type, xcb_timestamp_t stamp, cbl::Uint32 code = 0, cbl::Int32 x = 0, cbl::Int32 y = 0 );
+
+	/***** Private Members *****/
+	private:
+		xcb_connection_t	* mConnection;			//!< X server connection.
+		xcb_screen_t		* mScreen;				//!< Screen the window is on.
+		xcb_window_t		mWindow;				//!< X window id.
+		xcb_cursor_t		mHiddenCursor;			//!< Blank cursor used to hide the pointer.
+		xcb_atom_t			mAtoms[ AtomCount ];	//!< Interned atoms.
+		xcb_generic_event_t	* mPending;				//!< Event read ahead of time.
+		Key::Code			mKeys[ 256 ];			//!< Key code for each X keycode.
+		xcb_keysym_t		mKeysyms[ 256 ][ 2 ];	//!< Unshifted and shifted keysym for each X keycode.
+		bool				mShowCursor;			//!< Show cursor flag.
+		bool				mClippedCursor;			//!< Pointer is grabbed to the window.
+		bool				mClosed;				//!< Connection loss has been reported.
+		bool				mMinimised;				//!< The window is unmapped.
+		cbl::Uint32			mLastClickButton;		//!< Last pressed mouse button (for double clicks).
+		xcb_timestamp_t		mLastClickTime;			//!< Time of the last press.
+		cbl::Int32			mLastClickX;			//!< Position of the last press.
+		cbl::Int32			mLastClickY;
+		cbl::Float64		mTimeOffset;			//!< X server time to input clock offset.
+		bool				mHasTimeOffset;			//!< The offset has been measured.
+		cbl::Float64		mLastInputTime;			//!< Timestamp of the last queued input event.
+	};
+}
+
+#endif // __DBL_LINUXPLATFORMWINDOW_H_
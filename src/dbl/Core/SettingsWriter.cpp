@@ -0,0 +1,109 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file SettingsWriter.cpp
+ * @brief Atomic settings file writes on a worker thread.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "SettingsWriter.h"
+
+// External Libraries //
+#include <cstdio>
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace dbl;
+
+bool SettingsWriter::WriteAtomic( const cbl::String & name, const cbl::String & contents )
+{
+	const cbl::String temp = name + ".tmp";
+
+	FILE * file = fopen( temp.c_str(), "wb" );
+	if( !file ) {
+		LOG( cbl::LogLevel::Warning << "Unable to write " << temp << "." );
+		return false;
+	}
+
+	bool written = fwrite( contents.data(), 1, contents.size(), file ) == contents.size() && fflush( file ) == 0;
+
+	// Make sure the data is on disk before the rename makes it visible.
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	written = written && _commit( _fileno( file ) ) == 0;
+#else
+	written = written && fsync( fileno( file ) ) == 0;
+#endif
+	written = fclose( file ) == 0 && written;
+
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	written = written && ::MoveFileExA( temp.c_str(), name.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != FALSE;
+#else
+	written = written && rename( temp.c_str(), name.c_str() ) == 0;
+#endif
+
+	if( !written ) {
+		LOG( cbl::LogLevel::Warning << "Unable to write " << name << "." );
+		remove( temp.c_str() );
+	}
+	return written;
+}
+
+SettingsWriter::SettingsWriter()
+: mFinished( 0 )
+{
+}
+
+SettingsWriter::~SettingsWriter()
+{
+	Wait();
+}
+
+bool SettingsWriter::Start( const FileList & files )
+{
+	if( IsBusy() )
+		return false;
+
+	Wait();
+	mFiles = files;
+	Atomic::StoreRelease( mFinished, 0 );
+	return mThread.Start( &SettingsWriter::Run, this );
+}
+
+void SettingsWriter::Wait( void )
+{
+	if( mThread.IsRunning() )
+		mThread.Join();
+}
+
+void SettingsWriter::Run( void * self )
+{
+	SettingsWriter * writer = static_cast< SettingsWriter * >( self );
+
+	CBL_FOREACH_CONST( FileList, it, writer->mFiles )
+		WriteAtomic( it->Name, it->Contents );
+
+	Atomic::StoreRelease( writer->mFinished, 1 );
+}
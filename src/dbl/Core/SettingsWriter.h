@@ -0,0 +1,96 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file SettingsWriter.h
+ * @brief Atomic settings file writes on a worker thread.
+ */
+
+#ifndef __DBL_SETTINGSWRITER_H_
+#define __DBL_SETTINGSWRITER_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Threading/Atomic.h"
+#include "dbl/Threading/Thread.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Util/Noncopyable.h>
+
+// External Libraries //
+#include <vector>
+
+namespace dbl
+{
+	//! @brief Writes a set of files on its own thread.
+	//! Each file is written to a temporary file next to it and renamed over the original,
+	//! so a crash mid-write never leaves a truncated file behind.
+	class SettingsWriter :
+		cbl::Noncopyable
+	{
+	/***** Types *****/
+	public:
+		//! File to write.
+		struct File
+		{
+			cbl::String		Name;		//!< File name.
+			cbl::String		Contents;	//!< File contents.
+		};
+
+		//! File list.
+		typedef std::vector< File >		FileList;
+
+	/***** Public Static Methods *****/
+	public:
+		//! Write a file through a temporary file and rename it over the original.
+		//! @return		False if the file could not be written; the original is left untouched.
+		static bool WriteAtomic( const cbl::String & name, const cbl::String & contents );
+
+	/***** Properties *****/
+	public:
+		//! Check if files are still being written.
+		inline bool IsBusy( void ) const { return mThread.IsRunning() && !Atomic::LoadAcquire( mFinished ); }
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		SettingsWriter();
+		//! Destructor.
+		//! Waits for the files being written.
+		~SettingsWriter();
+		//! Start writing files.
+		//! @return		False if the previous files are still being written or the thread could not be started.
+		bool Start( const FileList & files );
+		//! Wait for the files being written.
+		void Wait( void );
+
+	/***** Private Static Methods *****/
+	private:
+		//! Thread entry point.
+		static void Run( void * self );
+
+	/***** Private Members *****/
+	private:
+		FileList					mFiles;			//!< Files being written.
+		Thread						mThread;		//!< Writer thread.
+		volatile cbl::Uint32		mFinished;		//!< Every file has been written.
+	};
+}
+
+#endif // __DBL_SETTINGSWRITER_H_
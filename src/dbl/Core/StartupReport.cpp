@@ -0,0 +1,87 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file StartupReport.cpp
+ * @brief Startup time breakdown.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Core/StartupReport.h"
+
+// External Dependencies //
+#include <iomanip>
+#include <sstream>
+
+using namespace dbl;
+
+StartupReport::StartupReport()
+: mTotalTime( 0.0 )
+, mFinished( false )
+{
+}
+
+void StartupReport::Begin( void )
+{
+	mPhases.clear();
+	mTotalTime = 0.0;
+	mFinished = false;
+	mClock.Stop();
+	mClock.Start();
+}
+
+void StartupReport::End( void )
+{
+	mTotalTime = GetTime();
+	mFinished = true;
+}
+
+cbl::Float64 StartupReport::GetTime( void ) const
+{
+	return mClock.GetElapsedTime().TotalSeconds();
+}
+
+void StartupReport::Add( const cbl::Char * name, cbl::Float64 start, cbl::Float64 duration, bool background )
+{
+	Phase phase;
+	phase.Name			= name;
+	phase.Start			= start;
+	phase.Duration		= duration;
+	phase.Background	= background;
+	mPhases.push_back( phase );
+}
+
+void StartupReport::AddSince( const cbl::Char * name, cbl::Float64 start )
+{
+	Add( name, start, GetTime() - start );
+}
+
+void StartupReport::Log( void ) const
+{
+	std::ostringstream report;
+	report << std::fixed << std::setprecision( 1 );
+	report << "Startup took " << mTotalTime * 1000.0 << "ms:";
+	CBL_FOREACH_CONST( PhaseList, it, mPhases ) {
+		report << "\n  " << std::setw( 8 ) << it->Duration * 1000.0 << "ms  "
+			<< it->Name << " (at " << it->Start * 1000.0 << "ms" << ( it->Background ? ", background)" : ")" );
+	}
+	LOG( report.str() );
+}
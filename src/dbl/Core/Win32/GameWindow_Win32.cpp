@@ -27,73 +27,100 @@
 // Delectable Headers //
 #include "dbl/Input/MouseManager.h"
 #include "dbl/Core/GameWindow.h"
+#include "dbl/Core/DisplayModeCache.h"
 
 // External Dependencies //
 #include <windows.h>
 
 using namespace dbl;
 
-void GameWindow::PopulateResolutions( void )
+//! Find the primary display adapter and monitor.
+//! @param	adapter		Adapter device name, used to enumerate modes.
+//! @param	monitor		Monitor identity, used to key the display mode cache.
+bool _getPrimaryDisplay( cbl::String & adapter, cbl::String & monitor )
 {
-	mAvailableResolutions.clear();
-
-	DWORD count = 0;
-	DEVMODE devmode;
-	memset( &devmode, 0, sizeof( devmode ) );
 	DISPLAY_DEVICE device;
-	memset( &device, 0, sizeof( DISPLAY_DEVICE ) );
+	memset( &device, 0, sizeof( device ) );
 	device.cb = sizeof( device );
 
 	// Get the primary display adapter.
-	cbl::String primaryDeviceName;
+	DWORD count = 0;
 	while( ::EnumDisplayDevices( NULL, count, &device, 0 ) != 0 ) {
-		if( device.StateFlags & DISPLAY_DEVICE_PRIMARY_DEVICE ) {
-			primaryDeviceName = device.DeviceName;
+		if( device.StateFlags & DISPLAY_DEVICE_PRIMARY_DEVICE )
 			break;
-		}
 		++count;
 	}
-	
+	if( !( device.StateFlags & DISPLAY_DEVICE_PRIMARY_DEVICE ) )
+		return false;
+
+	adapter = device.DeviceName;
+	monitor = device.DeviceID;
+
+	// Get the adapter's first monitor; its hardware ID tells monitors apart.
 	memset( &device, 0, sizeof( device ) );
-	device.cb = sizeof( DISPLAY_DEVICE );
-	count = 0;
-	// Get the primary monitor.
-	while( ::EnumDisplayDevices( primaryDeviceName.c_str(), count, &device, 0 ) != 0 ) {
-		if( device.StateFlags & DISPLAY_DEVICE_PRIMARY_DEVICE ) {
-			primaryDeviceName = device.DeviceName;
-			break;
-		}
-		++count;
+	device.cb = sizeof( device );
+	if( ::EnumDisplayDevices( adapter.c_str(), 0, &device, 0 ) != 0 ) {
+		monitor += '|';
+		monitor += device.DeviceID;
 	}
+	return true;
+}
+
+//! Enumerate an adapter's display modes (slow; this goes through the driver).
+void _enumerateDisplayModes( const cbl::String & adapter, DisplayModeCache::DisplayModeList & modes )
+{
+	modes.clear();
 
-	count = 0;
-	while( ::EnumDisplaySettings( primaryDeviceName.c_str(), count, &devmode ) != 0 ) {
-		if( sMinimumResolutionX > 0 && sMinimumResolutionY > 0 &&
-			( devmode.dmPelsWidth < sMinimumResolutionX ||
-			devmode.dmPelsHeight < sMinimumResolutionY ) ) {
-			++count;
-			continue;
+	DEVMODE devmode;
+	memset( &devmode, 0, sizeof( devmode ) );
+	devmode.dmSize = sizeof( devmode );
+
+	for( DWORD count = 0; ::EnumDisplaySettings( adapter.c_str(), count, &devmode ) != 0; ++count ) {
+		if( devmode.dmBitsPerPel >= 16 ) {
+			modes.push_back( GameWindowSize(
+				cbl::Uint32( devmode.dmPelsWidth ),
+				cbl::Uint32( devmode.dmPelsHeight ),
+				cbl::Uint16( devmode.dmBitsPerPel )
+			) );
 		}
+	}
 
-		GameWindowSize dims(
-			cbl::Uint32( devmode.dmPelsWidth ),
-			cbl::Uint32( devmode.dmPelsHeight ),
-			cbl::Uint16( devmode.dmBitsPerPel )
-		);
-
-		if( dims.BitsPerPixel >= 16 ) {
-			bool add = true;
-			for( cbl::Uint32 i = 0; i < mAvailableResolutions.size(); ++i ) {
-				if( mAvailableResolutions[i] == dims ) {
-					add = false;
-					break;
-				}
-			}
-			if( add )
-				mAvailableResolutions.push_back( dims );
+	// Drivers list each size once per refresh rate.
+	DisplayModeCache::Sort( modes );
+}
+
+//! Get the work area, which is cached until the display configuration changes.
+const RECT & _getWorkArea( void )
+{
+	static RECT area;
+	static cbl::Uint32 generation = 0;
+	if( generation != DisplayModeCache::GetGeneration() ) {
+		::SystemParametersInfo( SPI_GETWORKAREA, 0, &area, 0 );
+		generation = DisplayModeCache::GetGeneration();
+	}
+	return area;
+}
+
+void GameWindow::PopulateResolutions( void )
+{
+	mAvailableResolutions.clear();
+
+	cbl::String adapter, monitor;
+	if( _getPrimaryDisplay( adapter, monitor ) ) {
+		if( !DisplayModeCache::Find( monitor, mAvailableResolutions ) ) {
+			_enumerateDisplayModes( adapter, mAvailableResolutions );
+			DisplayModeCache::Store( monitor, mAvailableResolutions );
 		}
+	}
 
-		++count;
+	if( sMinimumResolutionX > 0 && sMinimumResolutionY > 0 ) {
+		GameWindowSizeList::iterator it = mAvailableResolutions.begin();
+		while( it != mAvailableResolutions.end() ) {
+			if( it->Width < sMinimumResolutionX || it->Height < sMinimumResolutionY )
+				it = mAvailableResolutions.erase( it );
+			else
+				++it;
+		}
 	}
 }
 
@@ -101,13 +128,14 @@ void GameWindow::SetCurrentDesktopResolution( void )
 {
 	mDesktopResolution.Width		= cbl::Uint32( ::GetSystemMetrics( SM_CXSCREEN ) );
 	mDesktopResolution.Height		= cbl::Uint32( ::GetSystemMetrics( SM_CYSCREEN ) );
-	mDesktopResolution.BitsPerPixel	= cbl::Uint16( ::GetDeviceCaps( GetDC(NULL), BITSPIXEL ) );
+	HDC screen = ::GetDC( NULL );
+	mDesktopResolution.BitsPerPixel	= cbl::Uint16( ::GetDeviceCaps( screen, BITSPIXEL ) );
+	::ReleaseDC( NULL, screen );
 }
 
 void GameWindow::GetWorkableArea( cbl::Uint32& left, cbl::Uint32& top, cbl::Uint32& right, cbl::Uint32& bottom, GameWindowStyle& style )
 {
-	RECT area;
-	::SystemParametersInfo( SPI_GETWORKAREA, 0, &area, 0 );
+	const RECT & area = _getWorkArea();
 	left	= area.left;
 	top		= area.top;
 	right	= area.right;
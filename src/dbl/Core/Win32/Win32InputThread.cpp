@@ -0,0 +1,308 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Win32InputThread.cpp
+ * @brief Windows raw input sampling thread.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "Win32InputThread.h"
+#include "dbl/Core/GameWindow.h"
+
+// Chewable Headers //
+#include <cbl/Debug/Logging.h>
+
+using namespace dbl;
+
+Key::Code ConvertVirtualCode( WPARAM virtualKey, LPARAM flags );
+
+const cbl::Char * const		sInputClassName		= "DELECTABLE_INPUT_CLASS";
+
+Win32InputThread::Win32InputThread( HWND target, cbl::Float64 timeOffset )
+: mTarget( target )
+, mHwnd( NULL )
+, mTimeOffset( timeOffset )
+, mEvents( GameWindow::sInputQueueSize )
+, mReady( NULL )
+, mDirty( false )
+, mRawMotion( 0 )
+, mDroppedEvents( 0 )
+{
+}
+
+Win32InputThread::~Win32InputThread()
+{
+	Stop();
+}
+
+bool Win32InputThread::Start( void )
+{
+	if( mThread.IsRunning() )
+		return true;
+
+	mReady = ::CreateEvent( NULL, TRUE, FALSE, NULL );
+	if( !mThread.Start( &Win32InputThread::Run, this ) ) {
+		::CloseHandle( mReady );
+		mReady = NULL;
+		return false;
+	}
+
+	// Wait until raw input is registered so no input is missed after we return.
+	::WaitForSingleObject( mReady, INFINITE );
+	::CloseHandle( mReady );
+	mReady = NULL;
+
+	if( !mHwnd ) {
+		mThread.Join();
+		return false;
+	}
+
+	return true;
+}
+
+void Win32InputThread::Stop( void )
+{
+	if( !mThread.IsRunning() )
+		return;
+
+	::PostMessage( mHwnd, WM_CLOSE, 0, 0 );
+	mThread.Join();
+	mHwnd = NULL;
+}
+
+bool Win32InputThread::ReadState( InputState & state )
+{
+	if( !mState.Update() )
+		return false;
+
+	state = mState.GetReadBuffer();
+	return true;
+}
+
+cbl::Float64 Win32InputThread::GetCounterTime( void )
+{
+	static LARGE_INTEGER sFrequency = { 0 };
+	if( sFrequency.QuadPart == 0 )
+		::QueryPerformanceFrequency( &sFrequency );
+
+	LARGE_INTEGER counter;
+	::QueryPerformanceCounter( &counter );
+	return cbl::Float64( counter.QuadPart ) / cbl::Float64( sFrequency.QuadPart );
+}
+
+void Win32InputThread::Run( void * self )
+{
+	static_cast< Win32InputThread* >( self )->Run();
+}
+
+void Win32InputThread::Run( void )
+{
+	WNDCLASSA wc;
+	ZeroMemory( &wc, sizeof( wc ) );
+	wc.lpfnWndProc		= &Win32InputThread::WindowProc;
+	wc.hInstance		= GetModuleHandle( NULL );
+	wc.lpszClassName	= sInputClassName;
+	::RegisterClassA( &wc );
+
+	mHwnd = ::CreateWindowA( sInputClassName, "", 0, 0, 0, 0, 0, HWND_MESSAGE, NULL, GetModuleHandle( NULL ), NULL );
+	if( mHwnd ) {
+		SetWindowLongPtr( mHwnd, GWLP_USERDATA, reinterpret_cast< LONG_PTR >( this ) );
+
+		RAWINPUTDEVICE devices[2];
+		devices[0].usUsagePage	= 0x01;
+		devices[0].usUsage		= 0x06; // Keyboard.
+		devices[0].dwFlags		= RIDEV_INPUTSINK;
+		devices[0].hwndTarget	= mHwnd;
+		devices[1].usUsagePage	= 0x01;
+		devices[1].usUsage		= 0x02; // Mouse.
+		devices[1].dwFlags		= RIDEV_INPUTSINK;
+		devices[1].hwndTarget	= mHwnd;
+
+		if( !::RegisterRawInputDevices( devices, 2, sizeof( RAWINPUTDEVICE ) ) ) {
+			LOG_ERROR( "Unable to register raw input devices for the input thread." );
+			::DestroyWindow( mHwnd );
+			mHwnd = NULL;
+		}
+	}
+	else {
+		LOG_ERROR( "Unable to create the input thread window." );
+	}
+
+	// Publish an initial sample so readers start from the current cursor position.
+	if( mHwnd ) {
+		POINT pt;
+		if( ::GetCursorPos( &pt ) && ::ScreenToClient( mTarget, &pt ) ) {
+			mWriteState.X = pt.x;
+			mWriteState.Y = pt.y;
+		}
+		Publish( GetCounterTime() + mTimeOffset );
+	}
+
+	::SetEvent( mReady );
+	if( !mHwnd )
+		return;
+
+	::SetThreadPriority( ::GetCurrentThread(), THREAD_PRIORITY_HIGHEST );
+
+	MSG msg;
+	while( ::GetMessage( &msg, NULL, 0, 0 ) > 0 ) {
+		if( msg.message == WM_INPUT )
+			ProcessRawInput( reinterpret_cast< HRAWINPUT >( msg.lParam ) );
+		::DispatchMessage( &msg );
+	}
+
+	// Unregister so the devices do not keep targeting a destroyed window.
+	RAWINPUTDEVICE devices[2];
+	devices[0].usUsagePage	= 0x01;
+	devices[0].usUsage		= 0x06;
+	devices[0].dwFlags		= RIDEV_REMOVE;
+	devices[0].hwndTarget	= NULL;
+	devices[1].usUsagePage	= 0x01;
+	devices[1].usUsage		= 0x02;
+	devices[1].dwFlags		= RIDEV_REMOVE;
+	devices[1].hwndTarget	= NULL;
+	::RegisterRawInputDevices( devices, 2, sizeof( RAWINPUTDEVICE ) );
+
+	::UnregisterClassA( sInputClassName, GetModuleHandle( NULL ) );
+}
+
+LRESULT CALLBACK Win32InputThread::WindowProc( HWND handle, UINT msg, WPARAM wParam, LPARAM lParam )
+{
+	switch( msg ) {
+	case WM_CLOSE:
+		::DestroyWindow( handle );
+		return 0;
+	case WM_DESTROY:
+		::PostQuitMessage( 0 );
+		return 0;
+	}
+
+	return DefWindowProcA( handle, msg, wParam, lParam );
+}
+
+void Win32InputThread::ProcessRawInput( HRAWINPUT input )
+{
+	cbl::Float64 time = GetCounterTime() + mTimeOffset;
+
+	// Only sample while the game window has focus; the main thread handles focus changes.
+	if( ::GetForegroundWindow() != mTarget ) {
+		if( mWriteState.Keys.any() || mWriteState.Buttons.any() ) {
+			mWriteState.Keys.reset();
+			mWriteState.Buttons.reset();
+			Publish( time );
+		}
+		return;
+	}
+
+	UINT size = 0;
+	::GetRawInputData( input, RID_INPUT, NULL, &size, sizeof( RAWINPUTHEADER ) );
+	if( size == 0 )
+		return;
+	if( mRawBuffer.size() < size )
+		mRawBuffer.resize( size );
+	if( ::GetRawInputData( input, RID_INPUT, &mRawBuffer[0], &size, sizeof( RAWINPUTHEADER ) ) == UINT( -1 ) )
+		return;
+
+	const RAWINPUT* raw = reinterpret_cast< const RAWINPUT* >( &mRawBuffer[0] );
+	if( raw->header.dwType == RIM_TYPEKEYBOARD )
+		ProcessKeyboard( raw->data.keyboard, time );
+	else if( raw->header.dwType == RIM_TYPEMOUSE )
+		ProcessMouse( raw->data.mouse, time );
+
+	if( mDirty )
+		Publish( time );
+}
+
+void Win32InputThread::ProcessKeyboard( const RAWKEYBOARD & kb, cbl::Float64 time )
+{
+	// Rebuild the legacy key message flags so the usual key conversion can be reused.
+	LPARAM flags = LPARAM( kb.MakeCode ) << 16;
+	if( kb.Flags & RI_KEY_E0 )
+		flags |= 1 << 24;
+
+	Key::Code key = ConvertVirtualCode( kb.VKey, flags );
+	if( key == 0 )
+		return;
+
+	bool down = ( kb.Flags & RI_KEY_BREAK ) == 0;
+	if( mWriteState.Keys[ key ] == down )
+		return; // Auto-repeat.
+
+	mWriteState.Keys[ key ] = down;
+	Emit( InputEvent::Make( down ? InputEventType::KeyDown : InputEventType::KeyUp, time, key ) );
+}
+
+void Win32InputThread::ProcessMouse( const RAWMOUSE & mouse, cbl::Float64 time )
+{
+	if( Atomic::LoadAcquire( mRawMotion ) && !( mouse.usFlags & MOUSE_MOVE_ABSOLUTE ) && ( mouse.lLastX != 0 || mouse.lLastY != 0 ) )
+		Emit( InputEvent::Make( InputEventType::MouseRawMotion, time, 0, mouse.lLastX, mouse.lLastY ) );
+
+	POINT pt;
+	if( ::GetCursorPos( &pt ) && ::ScreenToClient( mTarget, &pt ) ) {
+		if( pt.x != mWriteState.X || pt.y != mWriteState.Y ) {
+			mWriteState.X = pt.x;
+			mWriteState.Y = pt.y;
+			Emit( InputEvent::Make( InputEventType::MouseMove, time, 0, pt.x, pt.y ) );
+		}
+	}
+
+	USHORT flags = mouse.usButtonFlags;
+	ProcessButton( flags, RI_MOUSE_LEFT_BUTTON_DOWN, RI_MOUSE_LEFT_BUTTON_UP, Mouse::Left, time );
+	ProcessButton( flags, RI_MOUSE_RIGHT_BUTTON_DOWN, RI_MOUSE_RIGHT_BUTTON_UP, Mouse::Right, time );
+	ProcessButton( flags, RI_MOUSE_MIDDLE_BUTTON_DOWN, RI_MOUSE_MIDDLE_BUTTON_UP, Mouse::Middle, time );
+	ProcessButton( flags, RI_MOUSE_BUTTON_4_DOWN, RI_MOUSE_BUTTON_4_UP, Mouse::XButton1, time );
+	ProcessButton( flags, RI_MOUSE_BUTTON_5_DOWN, RI_MOUSE_BUTTON_5_UP, Mouse::XButton2, time );
+
+	if( flags & RI_MOUSE_WHEEL )
+		Emit( InputEvent::Make( InputEventType::MouseWheel, time, 0, cbl::Int32( static_cast< SHORT >( mouse.usButtonData ) ) / WHEEL_DELTA ) );
+}
+
+void Win32InputThread::ProcessButton( USHORT flags, USHORT down, USHORT up, Mouse::Button button, cbl::Float64 time )
+{
+	if( flags & down ) {
+		mWriteState.Buttons[ button ] = true;
+		Emit( InputEvent::Make( InputEventType::MouseDown, time, button, mWriteState.X, mWriteState.Y ) );
+	}
+	if( flags & up ) {
+		mWriteState.Buttons[ button ] = false;
+		Emit( InputEvent::Make( InputEventType::MouseUp, time, button, mWriteState.X, mWriteState.Y ) );
+	}
+}
+
+void Win32InputThread::Emit( const InputEvent & ev )
+{
+	mDirty = true;
+	if( mEvents.Push( ev ) )
+		return;
+
+	if( Atomic::Increment( mDroppedEvents ) == 1 )
+		LOG( cbl::LogLevel::Warning << "Input thread queue is full, dropping input events. Increase GameWindow::sInputQueueSize." );
+}
+
+void Win32InputThread::Publish( cbl::Float64 time )
+{
+	mWriteState.Time = time;
+	++mWriteState.Sequence;
+	mState.GetWriteBuffer() = mWriteState;
+	mState.Publish();
+	mDirty = false;
+}
@@ -0,0 +1,119 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Win32InputThread.h
+ * @brief Windows raw input sampling thread.
+ */
+
+#ifndef __DBL_WIN32INPUTTHREAD_H_
+#define __DBL_WIN32INPUTTHREAD_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/InputEvent.h"
+#include "dbl/Input/InputState.h"
+#include "dbl/Threading/RingBuffer.h"
+#include "dbl/Threading/Thread.h"
+#include "dbl/Threading/TripleBuffer.h"
+
+// Chewable Headers //
+#include <cbl/Util/Noncopyable.h>
+
+// External Dependencies //
+#include <windows.h>
+
+namespace dbl
+{
+	//! @brief Samples keyboard and mouse input on its own thread.
+	//! Raw input is delivered to a message-only window owned by the thread, so input is
+	//! timestamped as soon as it arrives instead of when the game next pumps messages.
+	//! Events are handed to the main thread through a lock-free queue and the device
+	//! state is published through a wait-free buffer.
+	//! Raw input registration is process-wide, so only one window may run an input thread.
+	class Win32InputThread :
+		cbl::Noncopyable
+	{
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	target		Window that must have focus for input to be sampled.
+		//! @param	timeOffset	Offset from the performance counter to the window's input clock.
+		Win32InputThread( HWND target, cbl::Float64 timeOffset );
+		//! Destructor.
+		~Win32InputThread();
+		//! Start sampling.
+		bool Start( void );
+		//! Stop sampling and join the thread.
+		void Stop( void );
+		//! Pop a sampled event (main thread only).
+		inline bool PopEvent( InputEvent & ev ) { return mEvents.Pop( ev ); }
+		//! Read the latest published state (main thread only).
+		bool ReadState( InputState & state );
+		//! Start or stop emitting relative mouse motion events.
+		inline void SetRawMotion( bool state ) { Atomic::StoreRelease( mRawMotion, state ? 1 : 0 ); }
+		//! Get the number of events dropped because the main thread fell behind.
+		inline cbl::Uint32 GetDroppedEvents( void ) const { return Atomic::LoadAcquire( mDroppedEvents ); }
+
+	/***** Public Static Methods *****/
+	public:
+		//! Get the current performance counter time in seconds.
+		static cbl::Float64 GetCounterTime( void );
+
+	/***** Private Static Methods *****/
+	private:
+		//! Thread entry point.
+		static void Run( void * self );
+		//! Message-only window procedure.
+		static LRESULT CALLBACK WindowProc( HWND handle, UINT msg, WPARAM wParam, LPARAM lParam );
+
+	/***** Private Methods *****/
+	private:
+		//! Thread main loop.
+		void Run( void );
+		//! Handle a raw input packet.
+		void ProcessRawInput( HRAWINPUT input );
+		//! Handle raw keyboard input.
+		void ProcessKeyboard( const RAWKEYBOARD & kb, cbl::Float64 time );
+		//! Handle raw mouse input.
+		void ProcessMouse( const RAWMOUSE & mouse, cbl::Float64 time );
+		//! Handle a mouse button transition.
+		void ProcessButton( USHORT flags, USHORT down, USHORT up, Mouse::Button button, cbl::Float64 time );
+		//! Queue an event for the main thread and update the write state.
+		void Emit( const InputEvent & ev );
+		//! Publish the write state.
+		void Publish( cbl::Float64 time );
+
+	/***** Private Members *****/
+	private:
+		HWND							mTarget;		//!< Game window.
+		HWND							mHwnd;			//!< Message-only window receiving raw input.
+		cbl::Float64					mTimeOffset;	//!< Performance counter to input clock offset.
+		Thread							mThread;		//!< Sampling thread.
+		RingBuffer< InputEvent >		mEvents;		//!< Sampled events waiting for the main thread.
+		TripleBuffer< InputState >		mState;			//!< Published device state.
+		InputState						mWriteState;	//!< Device state being sampled.
+		std::vector< BYTE >				mRawBuffer;		//!< Raw input packet buffer.
+		HANDLE							mReady;			//!< Signalled once the thread has created its window.
+		bool							mDirty;			//!< State has changed since the last publish.
+		volatile cbl::Uint32			mRawMotion;		//!< Emit relative mouse motion events.
+		volatile cbl::Uint32			mDroppedEvents;	//!< Events dropped due to a full queue.
+	};
+}
+
+#endif // __DBL_WIN32INPUTTHREAD_H_
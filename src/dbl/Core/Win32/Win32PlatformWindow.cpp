@@ -26,6 +26,7 @@
 
 // Delectable Headers //
 #include "Win32PlatformWindow.h"
+#include "Win32InputThread.h"
 #include "dbl/Input/KeyCodes.h"
 #include "dbl/Core/GameWindow.h"
 
@@ -41,6 +42,7 @@ using namespace dbl;
 Key::Code ConvertVirtualCode( WPARAM virtualKey, LPARAM flags );
 
 cbl::Uint32					Win32PlatformWindow::sWindowCount	= 0;
+Win32PlatformWindow *		Win32PlatformWindow::sRawInputOwner	= NULL;
 const cbl::Char * const		sWindowClassNameA		= "DELECTABLE_WINDOW_CLASS";
 const cbl::Wchar * const	sWindowClassNameW		= L"DELECTABLE_WINDOW_CLASS";
 
@@ -55,6 +57,10 @@ Win32PlatformWindow::Win32PlatformWindow( GameWindow * const host, GameWindowSet
 , mIsCursorIn( false )
 , mClippedCursor( false )
 , mResizingMove( false )
+, mLastInputTime( 0.0 )
+, mInputThread( NULL )
+, mRelativeMouse( false )
+, mRawMouseRegistered( false )
 {
 	if( sWindowCount == 0 )
 		RegisterWindowClass();
@@ -100,6 +106,11 @@ GameWindowHandle Win32PlatformWindow::GetHandle( void )
 
 Win32PlatformWindow::~Win32PlatformWindow()
 {
+	// Release raw input so another window can take it.
+	mRelativeMouse = false;
+	SetInputThreadEnabled( false );
+	ApplyRelativeMouseMode();
+
 	if( mHwnd )
 		::DestroyWindow( mHwnd );
 
@@ -128,14 +139,14 @@ void Win32PlatformWindow::DoSetSizePosition( void )
 	}
 	mResizingMove = true;
 
-	mHost->OnWindowResized(
+	mHost->PostWindowEvent( WindowEvent::MakeResized(
 		mHost->GetSettings().Resolution.Width,
 		mHost->GetSettings().Resolution.Height,
 		mHost->GetSettings().Dimensions.Width,
 		mHost->GetSettings().Dimensions.Height,
 		mHost->GetSettings().Resolution.BitsPerPixel,
 		mHost->GetSettings().AspectRatio
-	);
+	) );
 	SetForegroundWindow( mHwnd );
 }
 
@@ -170,7 +181,7 @@ void Win32PlatformWindow::DoSetFullscreen( void )
 		// Apply fullscreen mode
 		if( ::ChangeDisplaySettings( &dm, CDS_FULLSCREEN ) != DISP_CHANGE_SUCCESSFUL )
 		{
-			mHost->OnWindowFullscreen( true, true );
+			mHost->PostWindowEvent( WindowEvent::Make( WindowEventType::Fullscreen, 1, 1 ) );
 			LOG( cbl::LogLevel::Error << "Failed to change display mode for fullscreen." );
 
 			return;
@@ -274,14 +285,149 @@ void Win32PlatformWindow::ProcessWindowEvents( void )
 	if( !mHwnd )
 		return;
 
+	// Input sampled on the input thread since the last frame goes before the messages.
+	if( mInputThread ) {
+		InputEvent ev;
+		while( mInputThread->PopEvent( ev ) )
+			mHost->PushInputEvent( ev );
+	}
+}
+
+void Win32PlatformWindow::PumpMessages( void )
+{
+	// WindowProc routes each message to its window, so one pass serves them all.
 	MSG msg;
-	while( PeekMessage( &msg, mHwnd, 0, 0, PM_REMOVE ) )
+	while( PeekMessage( &msg, NULL, 0, 0, PM_REMOVE ) )
 	{
 		TranslateMessage( &msg );
 		DispatchMessage( &msg );
 	}
 }
 
+bool Win32PlatformWindow::SetInputThreadEnabled( bool state )
+{
+	if( state == ( mInputThread != NULL ) )
+		return true;
+
+	if( !state ) {
+		CBL_DELETE( mInputThread );
+		mRawMouseRegistered = false; // The thread unregisters raw input on exit.
+		sRawInputOwner = NULL;
+		ApplyRelativeMouseMode();
+		return true;
+	}
+
+	if( sRawInputOwner && sRawInputOwner != this ) {
+		LOG( cbl::LogLevel::Warning << "Raw input is in use by another window, unable to start the input thread." );
+		return false;
+	}
+
+	mInputThread = new Win32InputThread( mHwnd, mHost->GetInputTime() - Win32InputThread::GetCounterTime() );
+	if( !mInputThread->Start() ) {
+		CBL_DELETE( mInputThread );
+		return false;
+	}
+
+	// The thread has taken over raw input registration for the process.
+	sRawInputOwner = this;
+	mRawMouseRegistered = false;
+	ApplyRelativeMouseMode();
+	return true;
+}
+
+bool Win32PlatformWindow::IsInputThreadEnabled( void ) const
+{
+	return mInputThread != NULL;
+}
+
+bool Win32PlatformWindow::ReadInputState( InputState & state )
+{
+	return mInputThread && mInputThread->ReadState( state );
+}
+
+bool Win32PlatformWindow::SetRelativeMouseMode( bool state )
+{
+	if( mRelativeMouse == state )
+		return true;
+
+	mRelativeMouse = state;
+	if( !ApplyRelativeMouseMode() ) {
+		mRelativeMouse = false;
+		return false;
+	}
+
+	return true;
+}
+
+bool Win32PlatformWindow::IsRelativeMouseMode( void ) const
+{
+	return mRelativeMouse;
+}
+
+bool Win32PlatformWindow::ApplyRelativeMouseMode( void )
+{
+	if( mInputThread ) {
+		mInputThread->SetRawMotion( mRelativeMouse );
+		return true;
+	}
+
+	if( mRelativeMouse == mRawMouseRegistered )
+		return true;
+
+	// Registering would take raw input away from the other window, and removing would stop it.
+	if( sRawInputOwner && sRawInputOwner != this ) {
+		if( mRelativeMouse )
+			LOG( cbl::LogLevel::Warning << "Raw input is in use by another window, unable to report relative mouse motion." );
+		return !mRelativeMouse;
+	}
+
+	RAWINPUTDEVICE device;
+	device.usUsagePage	= 0x01;
+	device.usUsage		= 0x02; // Mouse.
+	device.dwFlags		= mRelativeMouse ? 0 : RIDEV_REMOVE;
+	device.hwndTarget	= mRelativeMouse ? mHwnd : NULL;
+
+	if( !::RegisterRawInputDevices( &device, 1, sizeof( RAWINPUTDEVICE ) ) ) {
+		LOG( cbl::LogLevel::Warning << "Unable to register raw mouse input." );
+		return false;
+	}
+
+	mRawMouseRegistered = mRelativeMouse;
+	sRawInputOwner = mRelativeMouse ? this : NULL;
+	return true;
+}
+
+void Win32PlatformWindow::ProcessRawInput( HRAWINPUT input )
+{
+	UINT size = 0;
+	::GetRawInputData( input, RID_INPUT, NULL, &size, sizeof( RAWINPUTHEADER ) );
+	if( size == 0 )
+		return;
+	if( mRawBuffer.size() < size )
+		mRawBuffer.resize( size );
+	if( ::GetRawInputData( input, RID_INPUT, &mRawBuffer[0], &size, sizeof( RAWINPUTHEADER ) ) == UINT( -1 ) )
+		return;
+
+	const RAWINPUT* raw = reinterpret_cast< const RAWINPUT* >( &mRawBuffer[0] );
+	if( raw->header.dwType != RIM_TYPEMOUSE || ( raw->data.mouse.usFlags & MOUSE_MOVE_ABSOLUTE ) )
+		return;
+
+	if( raw->data.mouse.lLastX != 0 || raw->data.mouse.lLastY != 0 )
+		QueueInput( InputEventType::MouseRawMotion, 0, raw->data.mouse.lLastX, raw->data.mouse.lLastY );
+}
+
+bool Win32PlatformWindow::IsMinimised( void ) const
+{
+	return ::IsIconic( mHwnd ) != FALSE;
+}
+
+bool Win32PlatformWindow::WaitForEvents( cbl::Float64 timeout )
+{
+	// MWMO_INPUTAVAILABLE also wakes for messages that were seen but not yet removed.
+	const DWORD ms = timeout < 0.0 ? INFINITE : DWORD( timeout * 1000.0 );
+	return ::MsgWaitForMultipleObjectsEx( 0, NULL, ms, QS_ALLINPUT, MWMO_INPUTAVAILABLE ) == WAIT_OBJECT_0;
+}
+
 void Win32PlatformWindow::SetAcceptDragDrop( bool state )
 {
 	::DragAcceptFiles( mHwnd, state ? TRUE : FALSE );
@@ -295,7 +441,15 @@ void Win32PlatformWindow::ProcessEvent( UINT msg, WPARAM wParam, LPARAM lParam )
 	switch( msg ) {
 		// Window close event.
 		case WM_CLOSE: {
-			mHost->OnWindowClosed();
+			mHost->PostWindowEvent( WindowEvent::Make( WindowEventType::Closed ) );
+			} break;
+		// Display mode, monitor or work area change.
+		case WM_DISPLAYCHANGE: {
+			mHost->PostWindowEvent( WindowEvent::Make( WindowEventType::DisplayChanged ) );
+			} break;
+		case WM_SETTINGCHANGE: {
+			if( wParam == SPI_SETWORKAREA )
+				mHost->PostWindowEvent( WindowEvent::Make( WindowEventType::DisplayChanged ) );
 			} break;
 		// Set cursor event
 		case WM_SETCURSOR: {
@@ -305,11 +459,11 @@ void Win32PlatformWindow::ProcessEvent( UINT msg, WPARAM wParam, LPARAM lParam )
 			} break;
 		// Window gain focus event.
 		case WM_SETFOCUS: {
-			mHost->OnWindowGainedFocus();
+			QueueInput( InputEventType::GainedFocus );
 			} break;
 		// Window lost focus event.
 		case WM_KILLFOCUS: {
-			mHost->OnWindowLostFocus();
+			QueueInput( InputEventType::LostFocus );
 			} break;
 		case WM_MOVE:
 			if( mResizingMove ) {
@@ -319,27 +473,31 @@ void Win32PlatformWindow::ProcessEvent( UINT msg, WPARAM wParam, LPARAM lParam )
 					ClipCursor( true );
 				}
 			}
+			break;
 		// Text event.
 		case WM_CHAR: {
-			mHost->OnWindowKeyChar( cbl::Uint32( wParam ) );
+			QueueInput( InputEventType::KeyChar, cbl::Uint32( wParam ) );
 			} break;
 		// Key down event.
 		case WM_KEYDOWN:
 		case WM_SYSKEYDOWN: {
+			if( mInputThread ) break;
 			dbl::Key::Code key = ConvertVirtualCode( wParam, lParam );
 			if( key != 0 )
-				mHost->OnWindowKeyDown( key );
+				QueueInput( InputEventType::KeyDown, key );
 			} break;
 		// Key up event.
 		case WM_KEYUP:
 		case WM_SYSKEYUP: {
+			if( mInputThread ) break;
 			dbl::Key::Code key = ConvertVirtualCode( wParam, lParam );
 			if( key != 0 )
-				mHost->OnWindowKeyUp( key );
+				QueueInput( InputEventType::KeyUp, key );
 			} break;
 		// Mouse wheel event.
 		case WM_MOUSEWHEEL : {
-			mHost->OnWindowMouseWheel( static_cast< cbl::Int16 >( HIWORD( wParam ) ) / 120 );
+			if( mInputThread ) break;
+			QueueInput( InputEventType::MouseWheel, 0, static_cast< cbl::Int16 >( HIWORD( wParam ) ) / 120 );
 			} break;
 		// Mouse move event.
 		case WM_MOUSEMOVE : {
@@ -352,64 +510,78 @@ void Win32PlatformWindow::ProcessEvent( UINT msg, WPARAM wParam, LPARAM lParam )
 				TrackMouseEvent(&tme);
 
 				mIsCursorIn = true;
-				mHost->OnWindowMouseEnter();
+				QueueInput( InputEventType::MouseEnter );
 			}
-			mHost->OnWindowMouseMove( LOWORD(lParam), HIWORD(lParam) );
+			if( !mInputThread )
+				QueueInput( InputEventType::MouseMove, 0, LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// Left mouse button down event.
 		case WM_LBUTTONDOWN : {
-			mHost->OnWindowMouseDown( LOWORD(lParam), HIWORD(lParam), Mouse::Left );
+			if( mInputThread ) break;
+			QueueInput( InputEventType::MouseDown, Mouse::Left, LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// Left mouse button up event.
 		case WM_LBUTTONUP : {
-			mHost->OnWindowMouseUp( LOWORD(lParam), HIWORD(lParam), Mouse::Left );
+			if( mInputThread ) break;
+			QueueInput( InputEventType::MouseUp, Mouse::Left, LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// Left mouse button double click event.
 		case WM_LBUTTONDBLCLK : {
-			mHost->OnWindowMouseDblClick( LOWORD(lParam), HIWORD(lParam), Mouse::Left );
+			QueueInput( InputEventType::MouseDblClick, Mouse::Left, LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// Left mouse button down event.
 		case WM_RBUTTONDOWN : {
-			mHost->OnWindowMouseDown( LOWORD(lParam), HIWORD(lParam), Mouse::Right );
+			if( mInputThread ) break;
+			QueueInput( InputEventType::MouseDown, Mouse::Right, LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// Right mouse button up event.
 		case WM_RBUTTONUP : {
-			mHost->OnWindowMouseUp( LOWORD(lParam), HIWORD(lParam), Mouse::Right );
+			if( mInputThread ) break;
+			QueueInput( InputEventType::MouseUp, Mouse::Right, LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// Right mouse button double click event.
 		case WM_RBUTTONDBLCLK : {
-			mHost->OnWindowMouseDblClick( LOWORD(lParam), HIWORD(lParam), Mouse::Right );
+			QueueInput( InputEventType::MouseDblClick, Mouse::Right, LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// Middle mouse button down event.
 		case WM_MBUTTONDOWN : {
-			mHost->OnWindowMouseDown( LOWORD(lParam), HIWORD(lParam), Mouse::Middle );
+			if( mInputThread ) break;
+			QueueInput( InputEventType::MouseDown, Mouse::Middle, LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// Middle mouse button up event.
 		case WM_MBUTTONUP : {
-			mHost->OnWindowMouseUp( LOWORD(lParam), HIWORD(lParam), Mouse::Middle );
+			if( mInputThread ) break;
+			QueueInput( InputEventType::MouseUp, Mouse::Middle, LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// Right mouse button double click event.
 		case WM_MBUTTONDBLCLK : {
-			mHost->OnWindowMouseDblClick( LOWORD(lParam), HIWORD(lParam), Mouse::Middle );
+			QueueInput( InputEventType::MouseDblClick, Mouse::Middle, LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// X1 mouse button down event.
 		case WM_XBUTTONDOWN : {
-			mHost->OnWindowMouseDown( LOWORD(lParam), HIWORD(lParam),
-				HIWORD(wParam) == XBUTTON1 ? Mouse::XButton1 : Mouse::XButton2 );
+			if( mInputThread ) break;
+			QueueInput( InputEventType::MouseDown, HIWORD(wParam) == XBUTTON1 ? Mouse::XButton1 : Mouse::XButton2,
+				LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// X2 mouse button up event.
 		case WM_XBUTTONUP : {
-			mHost->OnWindowMouseUp( LOWORD(lParam), HIWORD(lParam),
-				HIWORD(wParam) == XBUTTON1 ? Mouse::XButton1 : Mouse::XButton2 );
+			if( mInputThread ) break;
+			QueueInput( InputEventType::MouseUp, HIWORD(wParam) == XBUTTON1 ? Mouse::XButton1 : Mouse::XButton2,
+				LOWORD(lParam), HIWORD(lParam) );
 			} break;
 		// Right mouse button double click event.
 		case WM_XBUTTONDBLCLK : {
-			mHost->OnWindowMouseDblClick( LOWORD(lParam), HIWORD(lParam),
-				HIWORD(wParam) == XBUTTON1 ? Mouse::XButton1 : Mouse::XButton2 );
+			QueueInput( InputEventType::MouseDblClick, HIWORD(wParam) == XBUTTON1 ? Mouse::XButton1 : Mouse::XButton2,
+				LOWORD(lParam), HIWORD(lParam) );
+			} break;
+		// Raw mouse motion (relative mouse mode).
+		case WM_INPUT: {
+			if( mRelativeMouse && !mInputThread )
+				ProcessRawInput( reinterpret_cast< HRAWINPUT >( lParam ) );
 			} break;
 		case WM_MOUSELEAVE: {
 			mIsCursorIn = false;
-			mHost->OnWindowMouseLeave();
+			QueueInput( InputEventType::MouseLeave );
 			} break;
 		case WM_DROPFILES: {
 			HDROP hDrop = (HDROP)wParam;
@@ -418,27 +590,40 @@ void Win32PlatformWindow::ProcessEvent( UINT msg, WPARAM wParam, LPARAM lParam )
 			::DragQueryPoint( hDrop, &dropPoint );
 			cbl::Uint32 fileCount = ::DragQueryFile( hDrop, 0xFFFFFFFF, NULL, 0 );
 
-			cbl::FileInfo::List files;
+			// Only collect the dropped paths here; folders are expanded on a background thread.
+			std::vector< cbl::String > paths;
+			std::vector< cbl::Char > path;
 			for( cbl::Uint32 i = 0; i < fileCount; ++i ) {
-				cbl::Char tmpFile[256];
-				if( ::DragQueryFile( hDrop, i, tmpFile, 256 ) ) {
-					// This is a folder?
-					if( cbl::FileSystem::FolderCheckExists( tmpFile ) ) {
-						cbl::FileInfo::List _newfiles = cbl::FileSystem::GetFileList( tmpFile, true );
-						for( size_t i = 0; i < _newfiles.size(); ++i )
-							files.push_back( _newfiles[i] );
-					}
-					else 
-						files.push_back( tmpFile );
-				}
+				const UINT length = ::DragQueryFileA( hDrop, i, NULL, 0 );
+				path.resize( length + 1 );
+				if( length > 0 && ::DragQueryFileA( hDrop, i, &path[0], length + 1 ) )
+					paths.push_back( cbl::String( &path[0], length ) );
 			}
 			::DragFinish( hDrop );
-			mHost->OnWindowDragDrop( dropPoint.x, dropPoint.y, files );
+			mHost->DropFiles( dropPoint.x, dropPoint.y, paths );
 
 			} break;
 	}
 }
 
+void Win32PlatformWindow::QueueInput( InputEventType::Type type, cbl::Uint32 code, cbl::Int32 x, cbl::Int32 y )
+{
+	// Back-date the event by how long the message waited in the queue so consumers
+	// get the time it actually happened rather than the time we pumped it.
+	cbl::Float64 now = mHost->GetInputTime();
+	DWORD age = ::GetTickCount() - DWORD( ::GetMessageTime() );
+	cbl::Float64 time = now - cbl::Float64( age ) / 1000.0;
+
+	// Sent messages report the time of the last posted message, so keep times monotonic.
+	if( time < mLastInputTime )
+		time = mLastInputTime;
+	if( time > now )
+		time = now;
+	mLastInputTime = time;
+
+	mHost->PushInputEvent( InputEvent::Make( type, time, code, x, y ) );
+}
+
 void Win32PlatformWindow::RegisterWindowClass( void )
 {
 #if CBL_TEXT == CBL_TEXT_UTF16
@@ -26,12 +26,17 @@
 
 // Delectable Headers //
 #include "../IPlatformWindow.h"
+#include "dbl/Input/InputEvent.h"
 
 // External Dependencies //
 #include <windows.h>
+#include <vector>
 
 namespace dbl
 {
+	// Forward Declarations //
+	class Win32InputThread;
+
 	//! @brief Windows 32-bit platform window.
 	//! This class is created in the GameWindow through a static factory method and should not be instantiated manually.
 	class Win32PlatformWindow :
@@ -76,10 +81,26 @@ namespace dbl
 		//! Lock the cursor into the platform window.
 		//! @param	clip	Clip state.
 		virtual void ClipCursor( bool clip );
-		//! Process window events.
+		//! Queue the input sampled on the input thread since the last frame.
 		virtual void ProcessWindowEvents( void );
 		//! Set whether the drag and drop works.
 		virtual void SetAcceptDragDrop( bool state );
+		//! Start or stop sampling raw input on a dedicated thread.
+		//! Fails while another window owns raw input (its input thread or relative mouse mode).
+		virtual bool SetInputThreadEnabled( bool state );
+		//! Check if input is being sampled on a dedicated thread.
+		virtual bool IsInputThreadEnabled( void ) const;
+		//! Read the latest state published by the input thread.
+		virtual bool ReadInputState( InputState & state );
+		//! Start or stop reporting relative mouse motion from raw input.
+		//! Fails while another window owns raw input (its input thread or relative mouse mode).
+		virtual bool SetRelativeMouseMode( bool state );
+		//! Check if relative mouse motion is being reported.
+		virtual bool IsRelativeMouseMode( void ) const;
+		//! Check if the window is minimised.
+		virtual bool IsMinimised( void ) const;
+		//! Block until window messages arrive or the timeout expires.
+		virtual bool WaitForEvents( cbl::Float64 timeout );
 		//! Process individual window event.
 		void ProcessEvent( UINT msg, WPARAM wParam, LPARAM lParam );
 
@@ -88,15 +109,24 @@ namespace dbl
 		//! Register window class (Win32 thing).
 		void RegisterWindowClass( void );
 		void SetIdealDimensions( RECT& rc );
+		//! Route raw mouse input to whichever thread reports relative motion.
+		bool ApplyRelativeMouseMode( void );
+		//! Handle raw input delivered to the window.
+		void ProcessRawInput( HRAWINPUT input );
+		//! Timestamp an input event and queue it on the host window.
+		void QueueInput( InputEventType::Type type, cbl::Uint32 code = 0, cbl::Int32 x = 0, cbl::Int32 y = 0 );
 
 	/***** Public Static Methods *****/
 	public:
 		//! Window procedure callback.
 		static LRESULT CALLBACK WindowProc( HWND handle, UINT msg, WPARAM wParam, LPARAM lParam );
+		//! Dispatch every message waiting on the thread's queue, for all windows at once.
+		static void PumpMessages( void );
 
 	/***** Private Static Members *****/
 	private:
 		static cbl::Uint32					sWindowCount;      //!< Number of windows that we own
+		static Win32PlatformWindow			* sRawInputOwner;	//!< Window whose raw input registration is active (registration is process-wide).
 
 	/***** Internal Types *****/
 	private:
@@ -111,6 +141,11 @@ namespace dbl
 		bool				mIsCursorIn;		//!< Is the mouse cursor in the window's area?
 		bool				mClippedCursor;
 		bool				mResizingMove;
+		cbl::Float64		mLastInputTime;		//!< Timestamp of the last queued input event.
+		Win32InputThread	* mInputThread;		//!< Raw input sampling thread (NULL if disabled).
+		bool				mRelativeMouse;		//!< Report relative mouse motion.
+		bool				mRawMouseRegistered;//!< Raw mouse input is registered to this window.
+		std::vector<BYTE>	mRawBuffer;			//!< Raw input packet buffer.
 		CursorTable			mCursorTable;
 	};
 }
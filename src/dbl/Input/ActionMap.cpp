@@ -0,0 +1,308 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file ActionMap.cpp
+ * @brief Action and axis mapping component.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Input/ActionMap.h"
+#include "dbl/Input/KeyboardManager.h"
+#include "dbl/Input/MouseManager.h"
+#include "dbl/Serialisation/YAMLDeserialiser.h"
+
+// Chewable Headers //
+#include <cbl/Debug/Logging.h>
+#include <cbl/Core/Game.h>
+
+// External Dependencies //
+#include <algorithm>
+#include <fstream>
+
+using namespace dbl;
+
+const cbl::Uint32 ActionMap::sInvalidId = 0xFFFFFFFF;
+
+ActionMap::ActionMap( cbl::Game & game )
+: cbl::GameComponent( game )
+, mKeyboard( NULL )
+, mMouse( NULL )
+{
+	Compile();
+}
+
+ActionMap::~ActionMap()
+{
+}
+
+cbl::Uint32 ActionMap::GetActionId( const cbl::String & name ) const
+{
+	NameMap::const_iterator it = mActionNames.find( name );
+	return it != mActionNames.end() ? it->second : sInvalidId;
+}
+
+cbl::Uint32 ActionMap::GetAxisId( const cbl::String & name ) const
+{
+	NameMap::const_iterator it = mAxisNames.find( name );
+	return it != mAxisNames.end() ? it->second : sInvalidId;
+}
+
+cbl::Float32 ActionMap::GetAxis( cbl::Uint32 id ) const
+{
+	if( id >= mAxisStates.size() )
+		return 0.0f;
+
+	const AxisState& state = mAxisStates[id];
+	return ( state.Positive > 0 ? 1.0f : 0.0f ) - ( state.Negative > 0 ? 1.0f : 0.0f );
+}
+
+void ActionMap::Initialise( void )
+{
+	mKeyboard = Game.Services.Get< KeyboardManager >();
+	mMouse = Game.Services.Get< MouseManager >();
+
+	LOG( "Initialising action map." );
+
+	if( mKeyboard ) {
+		mKeyboard->OnKeyClick	+= E::KeyClick::Method<CBL_E_METHOD(ActionMap,OnKeyClick)>(this);
+		mKeyboard->OnKeyUp		+= E::KeyUp::Method<CBL_E_METHOD(ActionMap,OnKeyUp)>(this);
+	}
+	if( mMouse ) {
+		mMouse->OnMouseClick	+= E::MouseClick::Method<CBL_E_METHOD(ActionMap,OnMouseClick)>(this);
+		mMouse->OnMouseDblClick	+= E::MouseDblClick::Method<CBL_E_METHOD(ActionMap,OnMouseClick)>(this);
+		mMouse->OnMouseUp		+= E::MouseUp::Method<CBL_E_METHOD(ActionMap,OnMouseUp)>(this);
+	}
+}
+
+void ActionMap::Shutdown( void )
+{
+	LOG( "Shutting down action map." );
+
+	if( mMouse ) {
+		mMouse->OnMouseUp		-= E::MouseUp::Method<CBL_E_METHOD(ActionMap,OnMouseUp)>(this);
+		mMouse->OnMouseDblClick	-= E::MouseDblClick::Method<CBL_E_METHOD(ActionMap,OnMouseClick)>(this);
+		mMouse->OnMouseClick	-= E::MouseClick::Method<CBL_E_METHOD(ActionMap,OnMouseClick)>(this);
+	}
+	if( mKeyboard ) {
+		mKeyboard->OnKeyUp		-= E::KeyUp::Method<CBL_E_METHOD(ActionMap,OnKeyUp)>(this);
+		mKeyboard->OnKeyClick	-= E::KeyClick::Method<CBL_E_METHOD(ActionMap,OnKeyClick)>(this);
+	}
+
+	mMouse = NULL;
+	mKeyboard = NULL;
+}
+
+void ActionMap::Update( const cbl::GameTime & )
+{
+	mPressed.swap( mNextPressed );
+	mReleased.swap( mNextReleased );
+	std::fill( mNextPressed.begin(), mNextPressed.end(), false );
+	std::fill( mNextReleased.begin(), mNextReleased.end(), false );
+}
+
+void ActionMap::SetBindings( const ActionBindings & bindings )
+{
+	mBindings = bindings;
+	Compile();
+}
+
+template<>
+bool ActionMap::LoadBindings<YAMLDeserialiser>( const cbl::Char* fileName )
+{
+	ActionBindings bindings;
+	try {
+		std::ifstream bindingsFile( fileName );
+		YAML::Parser parser( bindingsFile );
+
+		dbl::YAMLDeserialiser yaml;
+		yaml.SetStream( parser );
+		if( !yaml.Deserialise( bindings ) ) {
+			LOG( cbl::LogLevel::Warning << "Unable to load action bindings: " << fileName );
+			return false;
+		}
+	} catch( const YAML::Exception& ) {
+		LOG( cbl::LogLevel::Warning << "Unable to parse action bindings: " << fileName );
+		return false;
+	}
+
+	SetBindings( bindings );
+	return true;
+}
+
+void ActionMap::OnKeyClick( Key::Code keyCode, cbl::Uint16 )
+{
+	if( keyCode < Key::Count )
+		InputDown( cbl::Uint32( keyCode ) );
+}
+
+void ActionMap::OnKeyUp( Key::Code keyCode, cbl::Uint16 )
+{
+	if( keyCode < Key::Count )
+		InputUp( cbl::Uint32( keyCode ) );
+}
+
+void ActionMap::OnMouseClick( cbl::Int32, cbl::Int32, Mouse::Button button )
+{
+	if( button < Mouse::Count )
+		InputDown( Key::Count + cbl::Uint32( button ) );
+}
+
+void ActionMap::OnMouseUp( cbl::Int32, cbl::Int32, Mouse::Button button )
+{
+	if( button < Mouse::Count )
+		InputUp( Key::Count + cbl::Uint32( button ) );
+}
+
+void ActionMap::Compile( void )
+{
+	const cbl::Uint32 actionCount = GetActionCount();
+	const cbl::Uint32 axisCount = GetAxisCount();
+
+	mActionNames.clear();
+	for( cbl::Uint32 i = 0; i < actionCount; ++i )
+		if( !mActionNames.insert( std::make_pair( mBindings.Actions[i].Name, i ) ).second )
+			LOG( cbl::LogLevel::Warning << "Duplicate action binding: " << mBindings.Actions[i].Name );
+
+	mAxisNames.clear();
+	for( cbl::Uint32 i = 0; i < axisCount; ++i )
+		if( !mAxisNames.insert( std::make_pair( mBindings.Axes[i].Name, i ) ).second )
+			LOG( cbl::LogLevel::Warning << "Duplicate axis binding: " << mBindings.Axes[i].Name );
+
+	// Count the bindings per input, turn the counts into offsets, then fill in the IDs.
+	// An input bound twice to the same action is only counted once.
+	std::vector< std::vector< cbl::Uint32 > > actionInputs( actionCount );
+	for( cbl::Uint32 i = 0; i < actionCount; ++i ) {
+		const ActionBinding& binding = mBindings.Actions[i];
+		std::vector< cbl::Uint32 >& inputs = actionInputs[i];
+		for( size_t k = 0; k < binding.Keys.size(); ++k )
+			if( binding.Keys[k] < Key::Count )
+				inputs.push_back( cbl::Uint32( binding.Keys[k] ) );
+		for( size_t b = 0; b < binding.Buttons.size(); ++b )
+			if( binding.Buttons[b] < Mouse::Count )
+				inputs.push_back( Key::Count + cbl::Uint32( binding.Buttons[b] ) );
+		std::sort( inputs.begin(), inputs.end() );
+		inputs.erase( std::unique( inputs.begin(), inputs.end() ), inputs.end() );
+	}
+
+	mActionOffsets.assign( sInputCount + 1, 0 );
+	for( cbl::Uint32 i = 0; i < actionCount; ++i )
+		for( size_t j = 0; j < actionInputs[i].size(); ++j )
+			++mActionOffsets[ actionInputs[i][j] + 1 ];
+	for( cbl::Uint32 i = 0; i < sInputCount; ++i )
+		mActionOffsets[i+1] += mActionOffsets[i];
+
+	mActionIds.resize( mActionOffsets[sInputCount] );
+	OffsetList cursor( mActionOffsets.begin(), mActionOffsets.end() - 1 );
+	for( cbl::Uint32 i = 0; i < actionCount; ++i )
+		for( size_t j = 0; j < actionInputs[i].size(); ++j )
+			mActionIds[ cursor[ actionInputs[i][j] ]++ ] = i;
+
+	// Same for axes, keeping the direction with each entry.
+	mAxisOffsets.assign( sInputCount + 1, 0 );
+	for( cbl::Uint32 i = 0; i < axisCount; ++i ) {
+		const AxisBinding& binding = mBindings.Axes[i];
+		for( size_t k = 0; k < binding.Positive.size(); ++k )
+			if( binding.Positive[k] < Key::Count )
+				++mAxisOffsets[ binding.Positive[k] + 1 ];
+		for( size_t k = 0; k < binding.Negative.size(); ++k )
+			if( binding.Negative[k] < Key::Count )
+				++mAxisOffsets[ binding.Negative[k] + 1 ];
+	}
+	for( cbl::Uint32 i = 0; i < sInputCount; ++i )
+		mAxisOffsets[i+1] += mAxisOffsets[i];
+
+	mAxisEntries.resize( mAxisOffsets[sInputCount] );
+	cursor.assign( mAxisOffsets.begin(), mAxisOffsets.end() - 1 );
+	for( cbl::Uint32 i = 0; i < axisCount; ++i ) {
+		const AxisBinding& binding = mBindings.Axes[i];
+		for( size_t k = 0; k < binding.Positive.size(); ++k ) {
+			if( binding.Positive[k] < Key::Count ) {
+				AxisEntry entry = { i, true };
+				mAxisEntries[ cursor[ binding.Positive[k] ]++ ] = entry;
+			}
+		}
+		for( size_t k = 0; k < binding.Negative.size(); ++k ) {
+			if( binding.Negative[k] < Key::Count ) {
+				AxisEntry entry = { i, false };
+				mAxisEntries[ cursor[ binding.Negative[k] ]++ ] = entry;
+			}
+		}
+	}
+
+	// Reset action state and re-apply anything that is already held.
+	mHeldCounts.assign( actionCount, 0 );
+	AxisState empty = { 0, 0 };
+	mAxisStates.assign( axisCount, empty );
+	mHeld.assign( actionCount, false );
+	mPressed.assign( actionCount, false );
+	mReleased.assign( actionCount, false );
+	mNextPressed.assign( actionCount, false );
+	mNextReleased.assign( actionCount, false );
+
+	InputList held = mInputs;
+	mInputs.reset();
+	for( cbl::Uint32 i = 0; i < sInputCount; ++i )
+		if( held[i] )
+			InputDown( i );
+}
+
+void ActionMap::InputDown( cbl::Uint32 input )
+{
+	if( mInputs[input] )
+		return;
+	mInputs[input] = true;
+
+	for( cbl::Uint32 i = mAxisOffsets[input]; i < mAxisOffsets[input+1]; ++i ) {
+		AxisState& state = mAxisStates[ mAxisEntries[i].Axis ];
+		++( mAxisEntries[i].Positive ? state.Positive : state.Negative );
+	}
+
+	for( cbl::Uint32 i = mActionOffsets[input]; i < mActionOffsets[input+1]; ++i ) {
+		cbl::Uint32 id = mActionIds[i];
+		if( mHeldCounts[id]++ == 0 ) {
+			mHeld[id] = true;
+			mNextPressed[id] = true;
+			OnActionPressed( id );
+		}
+	}
+}
+
+void ActionMap::InputUp( cbl::Uint32 input )
+{
+	if( !mInputs[input] )
+		return;
+	mInputs[input] = false;
+
+	for( cbl::Uint32 i = mAxisOffsets[input]; i < mAxisOffsets[input+1]; ++i ) {
+		AxisState& state = mAxisStates[ mAxisEntries[i].Axis ];
+		--( mAxisEntries[i].Positive ? state.Positive : state.Negative );
+	}
+
+	for( cbl::Uint32 i = mActionOffsets[input]; i < mActionOffsets[input+1]; ++i ) {
+		cbl::Uint32 id = mActionIds[i];
+		if( --mHeldCounts[id] == 0 ) {
+			mHeld[id] = false;
+			mNextReleased[id] = true;
+			OnActionReleased( id );
+		}
+	}
+}
@@ -0,0 +1,298 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file ComboDetector.cpp
+ * @brief Key chord and sequence detection.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Input/ComboDetector.h"
+#include "dbl/Input/KeyboardManager.h"
+#include "dbl/Core/GameWindow.h"
+
+// Chewable Headers //
+#include <cbl/Debug/Logging.h>
+#include <cbl/Core/Game.h>
+
+// External Dependencies //
+#include <algorithm>
+
+using namespace dbl;
+
+cbl::Float64 ComboDetector::sDefaultWindow		= 0.3;
+const cbl::Uint32 ComboDetector::sInvalidId		= 0xFFFFFFFF;
+
+static const cbl::Uint32 sModifierCount	= 8;			// Shift, Alt and Ctrl flag combinations.
+static const cbl::Uint16 sNoSymbol		= 0xFFFF;		// Key isn't part of any combo.
+static const cbl::Uint32 sNoState		= 0xFFFFFFFF;	// Missing trie transition.
+
+bool _isModifierKey( Key::Code key )
+{
+	switch( key ) {
+		case Key::LCtrl: case Key::RCtrl:
+		case Key::LShift: case Key::RShift:
+		case Key::LAlt: case Key::RAlt:
+		case Key::LSystem: case Key::RSystem:
+			return true;
+		default:
+			return false;
+	}
+}
+
+ComboDetector::ComboDetector( cbl::Game & game )
+: cbl::GameComponent( game )
+, mSymbolCount( 0 )
+, mHistoryHead( 0 )
+, mState( 0 )
+, mDirty( true )
+, mTime( 0.0 )
+, mKeyboard( NULL )
+, mWindow( NULL )
+{
+}
+
+ComboDetector::~ComboDetector()
+{
+}
+
+cbl::Uint32 ComboDetector::GetStateCount( void )
+{
+	if( mDirty )
+		Compile();
+
+	return mSymbolCount > 0 ? cbl::Uint32( mTransitions.size() / mSymbolCount ) : 1;
+}
+
+void ComboDetector::Initialise( void )
+{
+	mKeyboard = Game.Services.Get< KeyboardManager >();
+	mWindow = Game.Services.Get< GameWindow >();
+
+	LOG( "Initialising combo detector." );
+
+	if( mKeyboard )
+		mKeyboard->OnKeyClick += E::KeyClick::Method<CBL_E_METHOD(ComboDetector,OnKeyClick)>(this);
+}
+
+void ComboDetector::Shutdown( void )
+{
+	LOG( "Shutting down combo detector." );
+
+	if( mKeyboard )
+		mKeyboard->OnKeyClick -= E::KeyClick::Method<CBL_E_METHOD(ComboDetector,OnKeyClick)>(this);
+
+	mKeyboard = NULL;
+	mWindow = NULL;
+}
+
+void ComboDetector::Update( const cbl::GameTime & time )
+{
+	mTime = time.Total.TotalSeconds();
+}
+
+cbl::Uint32 ComboDetector::AddChord( Key::Code key, cbl::Uint16 modifiers )
+{
+	ComboStep step( key, modifiers );
+	return AddSequence( &step, 1, 0.0 );
+}
+
+cbl::Uint32 ComboDetector::AddDoubleTap( Key::Code key, cbl::Float64 window )
+{
+	ComboStep steps[2] = { ComboStep( key ), ComboStep( key ) };
+	return AddSequence( steps, 2, window );
+}
+
+cbl::Uint32 ComboDetector::AddSequence( const ComboStep * steps, cbl::Uint32 count, cbl::Float64 window )
+{
+	if( !steps || count == 0 )
+		return sInvalidId;
+
+	for( cbl::Uint32 i = 0; i < count; ++i ) {
+		if( steps[i].Code >= Key::Count || steps[i].Modifiers >= sModifierCount ) {
+			LOG( cbl::LogLevel::Warning << "Invalid combo step: " << steps[i].Code );
+			return sInvalidId;
+		}
+	}
+
+	mCombos.push_back( Combo() );
+	mCombos.back().Steps.assign( steps, steps + count );
+	mCombos.back().Window = window;
+	mDirty = true;
+
+	return cbl::Uint32( mCombos.size() - 1 );
+}
+
+void ComboDetector::Clear( void )
+{
+	mCombos.clear();
+	mDirty = true;
+}
+
+void ComboDetector::Reset( void )
+{
+	mState = 0;
+}
+
+void ComboDetector::ProcessKey( Key::Code key, cbl::Uint16 modifiers, cbl::Float64 time )
+{
+	if( mDirty )
+		Compile();
+
+	cbl::Uint16 symbol = sNoSymbol;
+	if( key < Key::Count )
+		symbol = mSymbols[ key * sModifierCount + ( modifiers & ( sModifierCount - 1 ) ) ];
+
+	if( symbol == sNoSymbol ) {
+		// Holding a modifier on the way to a chord shouldn't break a sequence.
+		if( !_isModifierKey( key ) )
+			mState = 0;
+		return;
+	}
+
+	mState = mTransitions[ mState * mSymbolCount + symbol ];
+
+	if( !mHistory.empty() ) {
+		mHistory[ mHistoryHead ] = time;
+		mHistoryHead = ( mHistoryHead + 1 ) % cbl::Uint32( mHistory.size() );
+	}
+
+	bool consumed = false;
+	for( cbl::Uint32 i = mOutputOffsets[mState]; i < mOutputOffsets[mState+1]; ++i ) {
+		const Combo& combo = mCombos[ mOutputs[i] ];
+		if( CheckTiming( combo ) ) {
+			OnCombo( mOutputs[i] );
+			consumed = consumed || combo.Steps.size() > 1;
+		}
+	}
+
+	// A completed sequence doesn't count towards the next one (a triple tap is one double tap).
+	if( consumed )
+		mState = 0;
+}
+
+void ComboDetector::OnKeyClick( Key::Code keyCode, cbl::Uint16 modifiers )
+{
+	ProcessKey( keyCode, modifiers, mWindow ? mWindow->GetInputEventTime() : mTime );
+}
+
+void ComboDetector::Compile( void )
+{
+	mDirty = false;
+	mState = 0;
+
+	// Give every key and modifier combination used by a combo its own symbol.
+	mSymbols.assign( Key::Count * sModifierCount, sNoSymbol );
+	mSymbolCount = 0;
+	size_t longest = 0;
+	for( size_t c = 0; c < mCombos.size(); ++c ) {
+		const Combo& combo = mCombos[c];
+		for( size_t s = 0; s < combo.Steps.size(); ++s ) {
+			cbl::Uint16& symbol = mSymbols[ combo.Steps[s].Code * sModifierCount + combo.Steps[s].Modifiers ];
+			if( symbol == sNoSymbol )
+				symbol = cbl::Uint16( mSymbolCount++ );
+		}
+		longest = std::max( longest, combo.Steps.size() );
+	}
+
+	mHistory.assign( longest, 0.0 );
+	mHistoryHead = 0;
+
+	// Build the trie.
+	std::vector< std::vector< cbl::Uint32 > > outputs( 1 );
+	mTransitions.assign( mSymbolCount, sNoState );
+	for( size_t c = 0; c < mCombos.size(); ++c ) {
+		const Combo& combo = mCombos[c];
+		cbl::Uint32 state = 0;
+		for( size_t s = 0; s < combo.Steps.size(); ++s ) {
+			cbl::Uint32 symbol = mSymbols[ combo.Steps[s].Code * sModifierCount + combo.Steps[s].Modifiers ];
+			cbl::Uint32& next = mTransitions[ state * mSymbolCount + symbol ];
+			if( next == sNoState ) {
+				next = cbl::Uint32( outputs.size() );
+				outputs.push_back( std::vector< cbl::Uint32 >() );
+				mTransitions.resize( mTransitions.size() + mSymbolCount, sNoState );
+			}
+			// Re-read the transition; the table may have been resized.
+			state = mTransitions[ state * mSymbolCount + symbol ];
+		}
+		outputs[state].push_back( cbl::Uint32( c ) );
+	}
+
+	// Resolve failure links breadth first, turning the trie into a full transition table.
+	const size_t stateCount = outputs.size();
+	std::vector< cbl::Uint32 > fail( stateCount, 0 );
+	std::vector< cbl::Uint32 > queue;
+	queue.reserve( stateCount );
+	for( cbl::Uint32 s = 0; s < mSymbolCount; ++s ) {
+		cbl::Uint32& next = mTransitions[s];
+		if( next == sNoState ) {
+			next = 0;
+		}
+		else {
+			fail[next] = 0;
+			queue.push_back( next );
+		}
+	}
+
+	for( size_t head = 0; head < queue.size(); ++head ) {
+		cbl::Uint32 state = queue[head];
+		// Combos ending in a suffix of this state also complete here.
+		const std::vector< cbl::Uint32 >& inherited = outputs[ fail[state] ];
+		outputs[state].insert( outputs[state].end(), inherited.begin(), inherited.end() );
+
+		for( cbl::Uint32 s = 0; s < mSymbolCount; ++s ) {
+			cbl::Uint32& next = mTransitions[ state * mSymbolCount + s ];
+			if( next == sNoState ) {
+				next = mTransitions[ fail[state] * mSymbolCount + s ];
+			}
+			else {
+				fail[next] = mTransitions[ fail[state] * mSymbolCount + s ];
+				queue.push_back( next );
+			}
+		}
+	}
+
+	// Flatten the outputs.
+	mOutputOffsets.assign( stateCount + 1, 0 );
+	mOutputs.clear();
+	for( size_t i = 0; i < stateCount; ++i ) {
+		mOutputOffsets[i] = cbl::Uint32( mOutputs.size() );
+		mOutputs.insert( mOutputs.end(), outputs[i].begin(), outputs[i].end() );
+	}
+	mOutputOffsets[stateCount] = cbl::Uint32( mOutputs.size() );
+}
+
+bool ComboDetector::CheckTiming( const Combo & combo ) const
+{
+	const cbl::Uint32 size = cbl::Uint32( mHistory.size() );
+	const cbl::Uint32 steps = cbl::Uint32( combo.Steps.size() );
+
+	// Walk back from the latest press.
+	cbl::Uint32 index = ( mHistoryHead + size - 1 ) % size;
+	for( cbl::Uint32 i = 1; i < steps; ++i ) {
+		cbl::Uint32 previous = ( index + size - 1 ) % size;
+		if( mHistory[index] - mHistory[previous] > combo.Window )
+			return false;
+		index = previous;
+	}
+
+	return true;
+}
@@ -0,0 +1,281 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file GamepadManager.cpp
+ * @brief Gamepad manager component.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Input/GamepadManager.h"
+#include "IGamepadBackend.h"
+
+// Chewable Headers //
+#include <cbl/Debug/Logging.h>
+
+// External Dependencies //
+#include <algorithm>
+#include <cmath>
+
+using namespace dbl;
+
+bool			GamepadManager::sBackendEnabled		= false;
+cbl::Float32	GamepadManager::sStickDeadzone		= 0.24f;
+cbl::Float32	GamepadManager::sTriggerDeadzone	= 0.12f;
+cbl::Uint32		GamepadManager::sQueueSize			= 1024;
+
+static const GamepadState	sDisconnectedState;
+
+bool _isStickAxis( Gamepad::Axis axis )
+{
+	return axis != Gamepad::LeftTrigger && axis != Gamepad::RightTrigger;
+}
+
+GamepadManager::GamepadManager( cbl::Game & game )
+: cbl::GameComponent( game )
+, mBackend( NULL )
+{
+	for( cbl::Uint32 i = 0; i < Gamepad::MaxPads; ++i )
+		for( cbl::Uint32 j = 0; j < Gamepad::AxisCount; ++j )
+			mPads[i].Raw[j] = 0.0f;
+}
+
+GamepadManager::~GamepadManager()
+{
+	CBL_DELETE( mBackend );
+}
+
+bool GamepadManager::IsConnected( cbl::Uint32 pad ) const
+{
+	return pad < Gamepad::MaxPads && mPads[pad].State.Connected;
+}
+
+bool GamepadManager::IsButtonDown( cbl::Uint32 pad, Gamepad::Button button ) const
+{
+	return pad < Gamepad::MaxPads && mPads[pad].State.Buttons[button];
+}
+
+cbl::Float32 GamepadManager::GetAxis( cbl::Uint32 pad, Gamepad::Axis axis ) const
+{
+	return pad < Gamepad::MaxPads ? mPads[pad].State.Axes[axis] : 0.0f;
+}
+
+const GamepadState & GamepadManager::GetState( cbl::Uint32 pad ) const
+{
+	return pad < Gamepad::MaxPads ? mStates[pad] : sDisconnectedState;
+}
+
+cbl::Uint32 GamepadManager::GetDroppedEvents( void ) const
+{
+	return mBackend ? mBackend->GetDroppedEvents() : 0;
+}
+
+void GamepadManager::Initialise( void )
+{
+	LOG( "Initialising gamepad manager." );
+
+	if( sBackendEnabled )
+		StartBackend();
+}
+
+void GamepadManager::Shutdown( void )
+{
+	LOG( "Shutting down gamepad manager." );
+
+	if( mBackend ) {
+		mBackend->Stop();
+		CBL_DELETE( mBackend );
+	}
+}
+
+void GamepadManager::Update( const cbl::GameTime & )
+{
+	// Apply everything the backend read since the last frame, then anything injected.
+	GamepadEvent ev;
+	while( mBackend && mBackend->PopEvent( ev ) )
+		ApplyEvent( ev );
+
+	for( size_t i = 0; i < mInjected.size(); ++i )
+		ApplyEvent( mInjected[i] );
+	mInjected.clear();
+
+	size_t top = Filter.TopIndex();
+	FilterEvent* f = Filter.Top();
+
+	for( cbl::Uint32 pad = 0; pad < Gamepad::MaxPads; ++pad )
+	{
+		// Latch the frame's state.
+		GamepadState & state = mStates[pad];
+		const GamepadState & current = mPads[pad].State;
+		state.PreviousButtons = state.Buttons;
+		state.Buttons = current.Buttons;
+		state.Connected = current.Connected;
+		for( cbl::Uint32 axis = 0; axis < Gamepad::AxisCount; ++axis )
+			state.Axes[axis] = current.Axes[axis];
+
+		for( cbl::Uint32 count = 0; count < Gamepad::ButtonCount; ++count )
+		{
+			const cbl::Uint32 bit = pad * Gamepad::ButtonCount + count;
+			if( current.Buttons[ count ] )
+				OnButtonDown( pad, Gamepad::Button( count ) );
+			if( f && f->Buttons[ bit ] )
+				f->OnButtonDown( pad, Gamepad::Button( count ) );
+			for( size_t i = 0; i < top; ++i ) {
+				if( Filter[i].Buttons[ bit ] ) {
+					// We have an underlying state that needs to be set to false.
+					Filter[i].Buttons[ bit ] = false;
+					Filter[i].OnButtonUp( pad, Gamepad::Button( count ) );
+				}
+			}
+		}
+	}
+}
+
+void GamepadManager::InjectEvent( const GamepadEvent & ev )
+{
+	mInjected.push_back( ev );
+}
+
+bool GamepadManager::OpenDevice( const cbl::Char * path )
+{
+	if( !mBackend && !StartBackend() )
+		return false;
+
+	return mBackend->OpenDevice( path );
+}
+
+bool GamepadManager::StartBackend( void )
+{
+	mBackend = IGamepadBackend::Create( sQueueSize );
+	if( !mBackend ) {
+		LOG( cbl::LogLevel::Warning << "No gamepad backend is available on this platform." );
+		return false;
+	}
+
+	if( !mBackend->Start() ) {
+		LOG( cbl::LogLevel::Warning << "Unable to start the gamepad backend." );
+		CBL_DELETE( mBackend );
+		return false;
+	}
+
+	return true;
+}
+
+void GamepadManager::ApplyEvent( const GamepadEvent & ev )
+{
+	if( ev.Pad >= Gamepad::MaxPads )
+		return;
+
+	Pad & pad = mPads[ ev.Pad ];
+	switch( ev.Type )
+	{
+	case GamepadEventType::Connected:
+		if( !pad.State.Connected ) {
+			pad.State.Connected = true;
+			OnConnected( ev.Pad );
+		}
+		break;
+	case GamepadEventType::Disconnected:
+		if( pad.State.Connected ) {
+			// Release everything so nothing stays stuck down.
+			for( cbl::Uint32 i = 0; i < Gamepad::ButtonCount; ++i )
+				SetButton( ev.Pad, Gamepad::Button( i ), false );
+			for( cbl::Uint32 i = 0; i < Gamepad::AxisCount; ++i )
+				SetAxis( ev.Pad, Gamepad::Axis( i ), 0.0f );
+			pad.State.Connected = false;
+			OnDisconnected( ev.Pad );
+		}
+		break;
+	case GamepadEventType::Button:
+		if( ev.Code < Gamepad::ButtonCount )
+			SetButton( ev.Pad, Gamepad::Button( ev.Code ), ev.Value != 0.0f );
+		break;
+	case GamepadEventType::Axis:
+		if( ev.Code < Gamepad::AxisCount )
+			SetAxis( ev.Pad, Gamepad::Axis( ev.Code ), ev.Value );
+		break;
+	}
+}
+
+void GamepadManager::SetButton( cbl::Uint32 pad, Gamepad::Button button, bool down )
+{
+	GamepadState & state = mPads[pad].State;
+	const cbl::Uint32 bit = pad * Gamepad::ButtonCount + button;
+	FilterEvent* f = Filter.Top();
+
+	if( down ) {
+		if( !state.Buttons[ button ] ) {
+			state.Buttons[ button ] = true;
+			OnButtonClick( pad, button );
+		}
+		if( f && !f->Buttons[ bit ] ) {
+			f->Buttons[ bit ] = true;
+			f->OnButtonClick( pad, button );
+		}
+	}
+	else {
+		if( state.Buttons[ button ] ) {
+			state.Buttons[ button ] = false;
+			OnButtonUp( pad, button );
+		}
+		if( f && f->Buttons[ bit ] ) {
+			f->Buttons[ bit ] = false;
+			f->OnButtonUp( pad, button );
+		}
+	}
+}
+
+void GamepadManager::SetAxis( cbl::Uint32 pad, Gamepad::Axis axis, cbl::Float32 value )
+{
+	Pad & p = mPads[pad];
+	p.Raw[axis] = value;
+
+	cbl::Float32 filtered[2];
+	cbl::Uint32 first = axis, count = 1;
+
+	if( _isStickAxis( axis ) ) {
+		// Radial deadzone over both axes of the stick so diagonals aren't clipped.
+		first = axis & ~1u;
+		count = 2;
+		const cbl::Float32 x = p.Raw[ first ], y = p.Raw[ first + 1 ];
+		const cbl::Float32 length = std::sqrt( x * x + y * y );
+		cbl::Float32 scale = 0.0f;
+		if( length > sStickDeadzone )
+			scale = ( std::min( length, 1.0f ) - sStickDeadzone ) / ( ( 1.0f - sStickDeadzone ) * length );
+		filtered[0] = x * scale;
+		filtered[1] = y * scale;
+	}
+	else {
+		filtered[0] = value > sTriggerDeadzone ? ( std::min( value, 1.0f ) - sTriggerDeadzone ) / ( 1.0f - sTriggerDeadzone ) : 0.0f;
+	}
+
+	FilterEvent* f = Filter.Top();
+	for( cbl::Uint32 i = 0; i < count; ++i ) {
+		const Gamepad::Axis a = Gamepad::Axis( first + i );
+		if( p.State.Axes[a] == filtered[i] )
+			continue;
+
+		p.State.Axes[a] = filtered[i];
+		OnAxisMove( pad, a, filtered[i] );
+		if( f )
+			f->OnAxisMove( pad, a, filtered[i] );
+	}
+}
@@ -0,0 +1,52 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file IGamepadBackend.cpp
+ * @brief Abstract platform specific gamepad reader.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "IGamepadBackend.h"
+
+#if CBL_PLATFORM == CBL_PLATFORM_LINUX
+#include "Linux/EvdevGamepadBackend.h"
+typedef ::dbl::EvdevGamepadBackend GamepadBackendType;
+#endif
+
+using namespace dbl;
+
+#if CBL_PLATFORM == CBL_PLATFORM_LINUX
+IGamepadBackend * IGamepadBackend::Create( cbl::Uint32 queueSize )
+{
+	return new GamepadBackendType( queueSize );
+}
+#else
+IGamepadBackend * IGamepadBackend::Create( cbl::Uint32 )
+{
+	// No gamepad backend on this platform yet; events can still be injected.
+	return NULL;
+}
+#endif
+
+IGamepadBackend::~IGamepadBackend()
+{
+}
@@ -0,0 +1,68 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file IGamepadBackend.h
+ * @brief Abstract platform specific gamepad reader.
+ */
+
+#ifndef __DBL_GAMEPADBACKEND_H_
+#define __DBL_GAMEPADBACKEND_H_
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Util/Noncopyable.h>
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/GamepadManager.h"
+
+namespace dbl
+{
+	//! @brief Abstract platform gamepad reader.
+	//! 
+	//! Backends read devices on their own thread and hand raw (unfiltered) events to
+	//! the gamepad manager through PopEvent().
+	class IGamepadBackend :
+		cbl::Noncopyable
+	{
+	/***** Static Public Methods *****/
+	public:
+		//! Create the gamepad backend for the current platform.
+		//! @param	queueSize	Event queue size.
+		//! @return				NULL if the platform has no backend.
+		static IGamepadBackend * Create( cbl::Uint32 queueSize );
+
+	/***** Public Methods *****/
+	public:
+		//! Destructor.
+		virtual ~IGamepadBackend();
+		//! Start reading devices.
+		virtual bool Start( void ) = 0;
+		//! Stop reading devices and close them.
+		virtual void Stop( void ) = 0;
+		//! Pop a raw event (main thread only).
+		virtual bool PopEvent( GamepadEvent & ev ) = 0;
+		//! Open a device explicitly (main thread only).
+		virtual bool OpenDevice( const cbl::Char * path ) = 0;
+		//! Get the number of events dropped because the queue was full.
+		virtual cbl::Uint32 GetDroppedEvents( void ) const = 0;
+	};
+}
+
+#endif // __DBL_GAMEPADBACKEND_H_
@@ -0,0 +1,238 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file InputRecorder.cpp
+ * @brief Input event recording and replay.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Input/InputRecorder.h"
+#include "dbl/Core/GameWindow.h"
+
+// Chewable Headers //
+#include <cbl/Debug/Logging.h>
+
+// External Libraries //
+#include <cstring>
+
+using namespace dbl;
+
+const cbl::Uint32 InputRecorder::sVersion = 1;
+
+const char sInputMagic[4] = { 'D', 'B', 'L', 'I' };
+
+template< typename T >
+inline void _writeValue( std::ostream& os, const T& value )
+{
+	os.write( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+}
+
+template< typename T >
+inline bool _readValue( std::istream& is, T& value )
+{
+	return !is.read( reinterpret_cast< char* >( &value ), sizeof( T ) ).fail();
+}
+
+InputRecorder::InputRecorder()
+: mWindow( NULL )
+, mStream( NULL )
+, mStartFrame( 0 )
+, mStartTime( 0.0 )
+, mEventCount( 0 )
+{
+}
+
+InputRecorder::~InputRecorder()
+{
+	Stop();
+}
+
+bool InputRecorder::Start( GameWindow & window, const cbl::Char * file )
+{
+	Stop();
+
+	mFile.open( file, std::ios::out | std::ios::binary | std::ios::trunc );
+	if( !mFile.is_open() ) {
+		LOG_ERROR( "Unable to open input recording " << file << " for writing." );
+		return false;
+	}
+
+	return Start( window, mFile );
+}
+
+bool InputRecorder::Start( GameWindow & window, std::ostream & stream )
+{
+	if( mWindow )
+		return false;
+
+	mStream		= &stream;
+	mWindow		= &window;
+	mStartFrame	= window.GetFrameIndex() + 1;
+	mStartTime	= window.GetInputTime();
+	mEventCount	= 0;
+
+	mStream->write( sInputMagic, sizeof( sInputMagic ) );
+	_writeValue( *mStream, sVersion );
+
+	mWindow->OnWindowInputBatch += E::WindowInputBatch::Method<CBL_E_METHOD(InputRecorder,OnWindowInputBatch)>(this);
+	return true;
+}
+
+void InputRecorder::Stop( void )
+{
+	if( mWindow ) {
+		mWindow->OnWindowInputBatch -= E::WindowInputBatch::Method<CBL_E_METHOD(InputRecorder,OnWindowInputBatch)>(this);
+		mWindow = NULL;
+	}
+
+	if( mStream ) {
+		mStream->flush();
+		mStream = NULL;
+	}
+
+	if( mFile.is_open() )
+		mFile.close();
+}
+
+void InputRecorder::OnWindowInputBatch( const InputEventList & events )
+{
+	// The first update after Start() is recorded as frame 0 - the replay's first frame. A batch
+	// still being dispatched when Start() was called belongs to that frame too.
+	const cbl::Uint32 frame = mWindow->GetFrameIndex();
+	_writeValue( *mStream, cbl::Uint32( frame > mStartFrame ? frame - mStartFrame : 0 ) );
+	_writeValue( *mStream, cbl::Uint32( events.size() ) );
+
+	for( size_t i = 0; i < events.size(); ++i ) {
+		const InputEvent& ev = events[i];
+		_writeValue( *mStream, cbl::Float64( ev.Time - mStartTime ) );
+		_writeValue( *mStream, cbl::Uint8( ev.Type ) );
+		_writeValue( *mStream, ev.Code );
+		_writeValue( *mStream, ev.X );
+		_writeValue( *mStream, ev.Y );
+	}
+
+	mEventCount += cbl::Uint32( events.size() );
+}
+
+InputReplay::InputReplay()
+: mStream( NULL )
+, mFrame( 0 )
+, mNextFrame( 0 )
+, mNextCount( 0 )
+, mStartTime( 0.0 )
+, mStarted( false )
+, mFinished( true )
+{
+}
+
+InputReplay::~InputReplay()
+{
+	Close();
+}
+
+bool InputReplay::Open( const cbl::Char * file )
+{
+	Close();
+
+	mFile.open( file, std::ios::in | std::ios::binary );
+	if( !mFile.is_open() ) {
+		LOG_ERROR( "Unable to open input recording " << file << "." );
+		return false;
+	}
+
+	if( !Open( mFile ) ) {
+		mFile.close();
+		return false;
+	}
+
+	return true;
+}
+
+bool InputReplay::Open( std::istream & stream )
+{
+	char magic[4];
+	cbl::Uint32 version = 0;
+	if( stream.read( magic, sizeof( magic ) ).fail() || std::memcmp( magic, sInputMagic, sizeof( magic ) ) != 0 ) {
+		LOG_ERROR( "Not an input recording." );
+		return false;
+	}
+	if( !_readValue( stream, version ) || version != InputRecorder::sVersion ) {
+		LOG_ERROR( "Unsupported input recording version " << version << "." );
+		return false;
+	}
+
+	mStream		= &stream;
+	mFrame		= 0;
+	mStarted	= false;
+	mFinished	= false;
+	ReadFrameHeader();
+	return true;
+}
+
+void InputReplay::Close( void )
+{
+	mStream		= NULL;
+	mFinished	= true;
+
+	if( mFile.is_open() )
+		mFile.close();
+}
+
+void InputReplay::PollInput( GameWindow & window )
+{
+	if( mFinished )
+		return;
+
+	if( !mStarted ) {
+		mStarted	= true;
+		mStartTime	= window.GetInputTime();
+	}
+
+	while( !mFinished && mNextFrame <= mFrame ) {
+		for( cbl::Uint32 i = 0; i < mNextCount; ++i ) {
+			cbl::Float64 time;
+			cbl::Uint8 type;
+			InputEvent ev;
+			if( !_readValue( *mStream, time ) || !_readValue( *mStream, type ) || !_readValue( *mStream, ev.Code ) ||
+				!_readValue( *mStream, ev.X ) || !_readValue( *mStream, ev.Y ) ) {
+				LOG_ERROR( "Input recording is truncated at frame " << mFrame << "." );
+				mFinished = true;
+				break;
+			}
+
+			ev.Time = mStartTime + time;
+			ev.Type = type;
+			window.PushInputEvent( ev );
+		}
+
+		if( !mFinished )
+			ReadFrameHeader();
+	}
+
+	++mFrame;
+}
+
+void InputReplay::ReadFrameHeader( void )
+{
+	if( !_readValue( *mStream, mNextFrame ) || !_readValue( *mStream, mNextCount ) )
+		mFinished = true;
+}
@@ -37,7 +37,9 @@ using namespace dbl;
 
 KeyboardManager::KeyboardManager( cbl::Game & game )
 : cbl::GameComponent( game )
+, mFrameModifiers( 0 )
 , mWindow( NULL )
+, mBoundWindow( NULL )
 {
 }
 
@@ -50,17 +52,28 @@ bool KeyboardManager::IsKeyDown( Key::Code code ) const
 	return mKeys[code];
 }
 
+cbl::Uint16 KeyboardManager::GetModifiers( void ) const
+{
+	return mKeys.GetModifiers();
+}
+
+bool KeyboardManager::IsKeySampledDown( Key::Code code ) const
+{
+	return mWindow && mWindow->IsInputThreadEnabled() ? mSampledKeys[code] : mKeys[code];
+}
+
+void KeyboardManager::GetSnapshot( InputSnapshot & snapshot ) const
+{
+	snapshot.Keys			= mFrameKeys;
+	snapshot.PreviousKeys	= mPreviousKeys;
+	snapshot.Modifiers		= mFrameModifiers;
+}
+
 void KeyboardManager::Initialise( void )
 {
-	mWindow = Game.Services.Get< GameWindow >();
-	CBL_ASSERT_TRUE( mWindow );
-	
 	LOG( "Initialising keyboard manager." );
 
-	mWindow->OnWindowKeyDown	+= E::WindowKey::Method<CBL_E_METHOD( KeyboardManager, OnWindowKeyDown )>(this);
-	mWindow->OnWindowKeyUp		+= E::WindowKey::Method<CBL_E_METHOD( KeyboardManager, OnWindowKeyUp )>(this);
-	mWindow->OnWindowKeyChar	+= E::WindowKeyChar::Method<CBL_E_METHOD( KeyboardManager, OnWindowKeyChar )>(this);
-	mWindow->OnWindowLostFocus	+= E::Window::Method<CBL_E_METHOD( KeyboardManager, OnWindowLostFocus )>(this);
+	AttachWindow();
 }
 
 void KeyboardManager::Shutdown( void )
@@ -69,7 +82,37 @@ void KeyboardManager::Shutdown( void )
 		return;
 
 	LOG( "Shutting down keyboard manager." );
-	
+
+	DetachWindow();
+}
+
+void KeyboardManager::BindWindow( GameWindow * window )
+{
+	mBoundWindow = window;
+
+	// Not initialised yet; Initialise() picks the window up.
+	if( !mWindow )
+		return;
+
+	// The old window will never report key up for anything still held.
+	OnWindowLostFocus();
+	DetachWindow();
+	AttachWindow();
+}
+
+void KeyboardManager::AttachWindow( void )
+{
+	mWindow = mBoundWindow ? mBoundWindow : Game.Services.Get< GameWindow >();
+	CBL_ASSERT_TRUE( mWindow );
+
+	mWindow->OnWindowKeyDown	+= E::WindowKey::Method<CBL_E_METHOD( KeyboardManager, OnWindowKeyDown )>(this);
+	mWindow->OnWindowKeyUp		+= E::WindowKey::Method<CBL_E_METHOD( KeyboardManager, OnWindowKeyUp )>(this);
+	mWindow->OnWindowKeyChar	+= E::WindowKeyChar::Method<CBL_E_METHOD( KeyboardManager, OnWindowKeyChar )>(this);
+	mWindow->OnWindowLostFocus	+= E::Window::Method<CBL_E_METHOD( KeyboardManager, OnWindowLostFocus )>(this);
+}
+
+void KeyboardManager::DetachWindow( void )
+{
 	mWindow->OnWindowLostFocus	-= E::Window::Method<CBL_E_METHOD( KeyboardManager, OnWindowLostFocus )>(this);
 	mWindow->OnWindowKeyChar	-= E::WindowKeyChar::Method<CBL_E_METHOD( KeyboardManager, OnWindowKeyChar )>(this);
 	mWindow->OnWindowKeyUp		-= E::WindowKey::Method<CBL_E_METHOD( KeyboardManager, OnWindowKeyUp )>(this);
@@ -78,60 +121,70 @@ void KeyboardManager::Shutdown( void )
 	mWindow = NULL;
 }
 
-cbl::Uint16 _getKeyMod( const std::bitset<Key::Count>& keyList ) 
-{
-	return ( keyList[ Key::RShift ] || keyList[ Key::LShift ] ? Key::Modifier::Shift : 0 ) |
-		( keyList[ Key::RAlt ] || keyList[ Key::LAlt ] ? Key::Modifier::Alt : 0 ) |
-		( keyList[ Key::RCtrl ] || keyList[ Key::LCtrl ] ? Key::Modifier::Ctrl : 0 );
-}
-
 void KeyboardManager::Update( const cbl::GameTime & )
 {
-	FilterEvent* f = Filter.Top();
-
-	for( cbl::Uint32 count = 0; count < Key::Count; ++count )
-	{
-		if( mKeys[count] )
-			OnKeyDown( Key::Code( count ), _getKeyMod( mKeys ) );
-		if( f && f->Keys[ count ] )
-			f->OnKeyDown( Key::Code( count ), _getKeyMod( f->Keys ) );
-		for( size_t i = 0; i < Filter.size(); ++i ) {
-			if( &Filter[i] == f )
-				break;
-			if( Filter[i].Keys[count] ) {
-				// We have an underlying state that needs to be set to key up.
-				Filter[i].Keys[count] = false;
-				Filter[i].OnKeyUp( Key::Code( count ), _getKeyMod( Filter[i].Keys ) );
-			}
+	// Pick up the snapshot the window read from the input thread at frame start.
+	if( mWindow && mWindow->IsInputThreadEnabled() )
+		mSampledKeys = mWindow->GetInputState().Keys;
+
+	mPreviousKeys = mFrameKeys;
+	mFrameKeys = mKeys.GetBits();
+	mFrameModifiers = mKeys.GetModifiers();
+
+	for( cbl::Uint32 i = 0; i < mKeys.Size(); ++i )
+		OnKeyDown( mKeys.Get( i ), mKeys.GetModifiers() );
+
+	size_t top = Filter.TopIndex();
+	if( top < Filter.size() ) {
+		FilterEvent& f = Filter[top];
+		for( cbl::Uint32 i = 0; i < f.Keys.Size(); ++i )
+			f.OnKeyDown( f.Keys.Get( i ), f.Keys.GetModifiers() );
+	}
+
+	// Only layers that still hold keys need visiting. Anything underneath the
+	// active layer has an underlying state that needs to be set to key up.
+	for( size_t i = 0; i < mHeldLayers.size(); ) {
+		if( mHeldLayers[i] < top || mHeldLayers[i] >= Filter.size() ) {
+			size_t layer = mHeldLayers[i];
+			mHeldLayers[i] = mHeldLayers.back();
+			mHeldLayers.pop_back();
+			if( layer < Filter.size() )
+				ReleaseLayer( layer );
+		}
+		else {
+			++i;
 		}
 	}
 }
 
 void KeyboardManager::OnWindowKeyDown( Key::Code keyCode )
 {
-	if( !mKeys[ keyCode ] ) {
-		mKeys[ keyCode ] = true;
-		OnKeyClick( keyCode, _getKeyMod( mKeys ) );
-	}
-
-	FilterEvent* f = Filter.Top();
-	if( f && !f->Keys[ keyCode ] ) {
-		f->Keys[ keyCode ] = true;
-		f->OnKeyClick( keyCode, _getKeyMod( f->Keys ) );
+	if( mKeys.Insert( keyCode ) )
+		OnKeyClick( keyCode, mKeys.GetModifiers() );
+
+	size_t top = Filter.TopIndex();
+	if( top < Filter.size() ) {
+		FilterEvent& f = Filter[top];
+		if( f.Keys.Insert( keyCode ) ) {
+			HoldLayer( top );
+			f.OnKeyClick( keyCode, f.Keys.GetModifiers() );
+		}
 	}
 }
 
 void KeyboardManager::OnWindowKeyUp( Key::Code keyCode )
 {
-	if( mKeys[ keyCode ] ) {
-		mKeys[ keyCode ] = false;
-		OnKeyUp( keyCode, _getKeyMod( mKeys ) );
-	}
-
-	FilterEvent* f = Filter.Top();
-	if( f && f->Keys[ keyCode ] ) {
-		f->Keys[ keyCode ] = false;
-		f->OnKeyUp( keyCode, _getKeyMod( f->Keys ) );
+	if( mKeys.Remove( keyCode ) )
+		OnKeyUp( keyCode, mKeys.GetModifiers() );
+
+	size_t top = Filter.TopIndex();
+	if( top < Filter.size() ) {
+		FilterEvent& f = Filter[top];
+		if( f.Keys.Remove( keyCode ) ) {
+			if( f.Keys.Empty() )
+				DropLayer( top );
+			f.OnKeyUp( keyCode, f.Keys.GetModifiers() );
+		}
 	}
 }
 
@@ -145,18 +198,45 @@ void KeyboardManager::OnWindowKeyChar( cbl::Uint32 unicode )
 
 void KeyboardManager::OnWindowLostFocus( void )
 {
-	for( cbl::Uint32 count = 0; count < Key::Count; ++count )
-	{
-		if( mKeys[ count ] ) {
-			mKeys[ count ] = false;
-			OnKeyUp( Key::Code( count ), _getKeyMod( mKeys ) );
-		}
+	while( !mKeys.Empty() ) {
+		Key::Code code = mKeys.Get( mKeys.Size() - 1 );
+		mKeys.Remove( code );
+		OnKeyUp( code, mKeys.GetModifiers() );
+	}
+
+	LayerList layers;
+	layers.swap( mHeldLayers );
+	for( size_t i = 0; i < layers.size(); ++i )
+		if( layers[i] < Filter.size() )
+			ReleaseLayer( layers[i] );
+}
+
+void KeyboardManager::HoldLayer( size_t index )
+{
+	for( size_t i = 0; i < mHeldLayers.size(); ++i )
+		if( mHeldLayers[i] == index )
+			return;
 
-		for( size_t i = 0; i < Filter.size(); ++i ) {
-			if( Filter[i].Keys[ count ] ) {
-				Filter[i].Keys[ count ] = false;
-				Filter[i].OnKeyUp( Key::Code( count ), _getKeyMod( Filter[i].Keys ) );
-			}
+	mHeldLayers.push_back( index );
+}
+
+void KeyboardManager::DropLayer( size_t index )
+{
+	for( size_t i = 0; i < mHeldLayers.size(); ++i ) {
+		if( mHeldLayers[i] == index ) {
+			mHeldLayers[i] = mHeldLayers.back();
+			mHeldLayers.pop_back();
+			return;
 		}
 	}
 }
+
+void KeyboardManager::ReleaseLayer( size_t index )
+{
+	KeySet& keys = Filter[index].Keys;
+	while( !keys.Empty() ) {
+		Key::Code code = keys.Get( keys.Size() - 1 );
+		keys.Remove( code );
+		Filter[index].OnKeyUp( code, keys.GetModifiers() );
+	}
+}
@@ -0,0 +1,532 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file EvdevGamepadBackend.cpp
+ * @brief Linux evdev gamepad reader.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "EvdevGamepadBackend.h"
+
+// Chewable Headers //
+#include <cbl/Debug/Logging.h>
+
+// External Dependencies //
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+
+using namespace dbl;
+
+const cbl::Char * const	EvdevGamepadBackend::sDevicePath		= "/dev/input";
+const cbl::Uint32		EvdevGamepadBackend::sStreamPollTime	= 4;
+
+static const cbl::Uint32	sMaxEpollEvents		= 16;
+static const cbl::Uint32	sReadBatch			= 64;
+
+//! Axes the backend reads (including the d-pad hat).
+static const cbl::Uint32	sAxisCodes[]		= { ABS_X, ABS_Y, ABS_Z, ABS_RX, ABS_RY, ABS_RZ, ABS_GAS, ABS_BRAKE, ABS_HAT0X, ABS_HAT0Y };
+static const cbl::Uint32	sAxisCodeCount		= sizeof( sAxisCodes ) / sizeof( sAxisCodes[0] );
+
+bool _testBit( const cbl::Uint8 * bits, cbl::Uint32 bit )
+{
+	return ( ( bits[ bit / 8 ] >> ( bit % 8 ) ) & 1 ) != 0;
+}
+
+bool _isTriggerCode( cbl::Uint32 code )
+{
+	return code == ABS_Z || code == ABS_RZ || code == ABS_GAS || code == ABS_BRAKE;
+}
+
+Gamepad::Button _mapButton( cbl::Uint32 code )
+{
+	switch( code )
+	{
+	case BTN_SOUTH:			return Gamepad::A;
+	case BTN_EAST:			return Gamepad::B;
+	case BTN_NORTH:			return Gamepad::Y;
+	case BTN_WEST:			return Gamepad::X;
+	case BTN_TL:			return Gamepad::LeftShoulder;
+	case BTN_TR:			return Gamepad::RightShoulder;
+	case BTN_SELECT:		return Gamepad::Back;
+	case BTN_START:			return Gamepad::Start;
+	case BTN_MODE:			return Gamepad::Guide;
+	case BTN_THUMBL:		return Gamepad::LeftStick;
+	case BTN_THUMBR:		return Gamepad::RightStick;
+	case BTN_DPAD_UP:		return Gamepad::DPadUp;
+	case BTN_DPAD_DOWN:		return Gamepad::DPadDown;
+	case BTN_DPAD_LEFT:		return Gamepad::DPadLeft;
+	case BTN_DPAD_RIGHT:	return Gamepad::DPadRight;
+	}
+
+	// Generic joysticks number their buttons; map them in order.
+	if( code >= BTN_JOYSTICK && code < BTN_JOYSTICK + Gamepad::DPadUp )
+		return Gamepad::Button( code - BTN_JOYSTICK );
+
+	return Gamepad::ButtonCount;
+}
+
+Gamepad::Axis _mapAxis( cbl::Uint32 code )
+{
+	switch( code )
+	{
+	case ABS_X:		return Gamepad::LeftX;
+	case ABS_Y:		return Gamepad::LeftY;
+	case ABS_RX:	return Gamepad::RightX;
+	case ABS_RY:	return Gamepad::RightY;
+	case ABS_Z:
+	case ABS_BRAKE:	return Gamepad::LeftTrigger;
+	case ABS_RZ:
+	case ABS_GAS:	return Gamepad::RightTrigger;
+	}
+
+	return Gamepad::AxisCount;
+}
+
+EvdevGamepadBackend::EvdevGamepadBackend( cbl::Uint32 queueSize )
+: mEvents( queueSize )
+, mPending( Gamepad::MaxPads * 2 )
+, mEpoll( -1 )
+, mWake( -1 )
+, mNotify( -1 )
+, mStop( 0 )
+, mDropped( 0 )
+{
+	for( cbl::Uint32 i = 0; i < Gamepad::MaxPads; ++i )
+		mPads[i] = false;
+}
+
+EvdevGamepadBackend::~EvdevGamepadBackend()
+{
+	Stop();
+}
+
+bool EvdevGamepadBackend::Start( void )
+{
+	if( mThread.IsRunning() )
+		return true;
+
+	mEpoll = epoll_create1( EPOLL_CLOEXEC );
+	mWake = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+	if( mEpoll < 0 || mWake < 0 ) {
+		LOG_ERROR( "Unable to create the gamepad event queue: " << strerror( errno ) );
+		Stop();
+		return false;
+	}
+
+	epoll_event ev;
+	memset( &ev, 0, sizeof( ev ) );
+	ev.events = EPOLLIN;
+	ev.data.fd = mWake;
+	epoll_ctl( mEpoll, EPOLL_CTL_ADD, mWake, &ev );
+
+	// Hotplugging is optional; devices can still be opened explicitly without it.
+	mNotify = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+	if( mNotify >= 0 && inotify_add_watch( mNotify, sDevicePath, IN_CREATE | IN_ATTRIB ) >= 0 ) {
+		ev.data.fd = mNotify;
+		epoll_ctl( mEpoll, EPOLL_CTL_ADD, mNotify, &ev );
+	}
+	else {
+		LOG( cbl::LogLevel::Warning << "Unable to watch " << sDevicePath << " for gamepads." );
+	}
+
+	Atomic::StoreRelease( mStop, 0 );
+	if( !mThread.Start( &EvdevGamepadBackend::Run, this ) ) {
+		Stop();
+		return false;
+	}
+
+	return true;
+}
+
+void EvdevGamepadBackend::Stop( void )
+{
+	if( mThread.IsRunning() ) {
+		Atomic::StoreRelease( mStop, 1 );
+		Wake();
+		mThread.Join();
+	}
+
+	while( !mDevices.empty() )
+		RemoveDevice( mDevices.size() - 1 );
+
+	PendingDevice pending;
+	while( mPending.Pop( pending ) )
+		close( pending.Fd );
+
+	if( mNotify >= 0 ) close( mNotify );
+	if( mWake >= 0 ) close( mWake );
+	if( mEpoll >= 0 ) close( mEpoll );
+	mNotify = mWake = mEpoll = -1;
+}
+
+bool EvdevGamepadBackend::OpenDevice( const cbl::Char * path )
+{
+	int fd = open( path, O_RDONLY | O_NONBLOCK | O_CLOEXEC );
+	if( fd < 0 ) {
+		LOG( cbl::LogLevel::Warning << "Unable to open gamepad device " << path << ": " << strerror( errno ) );
+		return false;
+	}
+
+	PendingDevice pending;
+	pending.Fd		= fd;
+	pending.Path	= path;
+	if( !mPending.Push( pending ) ) {
+		close( fd );
+		return false;
+	}
+
+	// Hand the device to the reader thread.
+	return Wake();
+}
+
+bool EvdevGamepadBackend::Wake( void )
+{
+	const cbl::Uint64 one = 1;
+	return write( mWake, &one, sizeof( one ) ) == sizeof( one );
+}
+
+void EvdevGamepadBackend::Run( void * self )
+{
+	static_cast< EvdevGamepadBackend* >( self )->Run();
+}
+
+bool EvdevGamepadBackend::IsGamepad( int fd )
+{
+	cbl::Uint8 keys[ KEY_MAX / 8 + 1 ];
+	memset( keys, 0, sizeof( keys ) );
+	if( ioctl( fd, EVIOCGBIT( EV_KEY, sizeof( keys ) ), keys ) < 0 )
+		return false;
+
+	return _testBit( keys, BTN_GAMEPAD ) || _testBit( keys, BTN_JOYSTICK );
+}
+
+void EvdevGamepadBackend::Run( void )
+{
+	ScanDevices();
+
+	epoll_event events[ sMaxEpollEvents ];
+	while( !Atomic::LoadAcquire( mStop ) )
+	{
+		PendingDevice pending;
+		while( mPending.Pop( pending ) ) {
+			if( !AddDevice( pending.Fd, pending.Path ) )
+				close( pending.Fd );
+		}
+
+		// Block until a device has input unless there are streams to poll.
+		bool streams = false;
+		for( size_t i = 0; i < mDevices.size() && !streams; ++i )
+			streams = mDevices[i].Stream;
+
+		int count = epoll_wait( mEpoll, events, sMaxEpollEvents, streams ? int( sStreamPollTime ) : -1 );
+		for( int i = 0; i < count; ++i )
+		{
+			const int fd = events[i].data.fd;
+			if( fd == mWake ) {
+				cbl::Uint64 value;
+				while( read( mWake, &value, sizeof( value ) ) > 0 ) {}
+			}
+			else if( fd == mNotify ) {
+				ReadNotifications();
+			}
+			else {
+				for( size_t j = 0; j < mDevices.size(); ++j ) {
+					if( mDevices[j].Fd == fd ) {
+						if( !ReadDevice( mDevices[j] ) )
+							RemoveDevice( j );
+						break;
+					}
+				}
+			}
+		}
+
+		for( size_t i = mDevices.size(); i > 0; --i ) {
+			if( mDevices[i - 1].Stream && !ReadDevice( mDevices[i - 1] ) )
+				RemoveDevice( i - 1 );
+		}
+	}
+}
+
+void EvdevGamepadBackend::ScanDevices( void )
+{
+	DIR * dir = opendir( sDevicePath );
+	if( !dir )
+		return;
+
+	while( dirent * entry = readdir( dir ) ) {
+		if( strncmp( entry->d_name, "event", 5 ) == 0 )
+			TryOpen( cbl::String( sDevicePath ) + "/" + entry->d_name );
+	}
+
+	closedir( dir );
+}
+
+void EvdevGamepadBackend::ReadNotifications( void )
+{
+	cbl::Uint8 buffer[ 4096 ] __attribute__(( aligned( __alignof__( inotify_event ) ) ));
+	for( ;; )
+	{
+		ssize_t bytes = read( mNotify, buffer, sizeof( buffer ) );
+		if( bytes <= 0 )
+			break;
+
+		for( ssize_t offset = 0; offset < bytes; ) {
+			const inotify_event * ev = reinterpret_cast< const inotify_event * >( buffer + offset );
+			// New nodes are often created before udev grants access, so retry on attribute changes.
+			if( ev->len > 0 && strncmp( ev->name, "event", 5 ) == 0 )
+				TryOpen( cbl::String( sDevicePath ) + "/" + ev->name );
+			offset += sizeof( inotify_event ) + ev->len;
+		}
+	}
+}
+
+void EvdevGamepadBackend::TryOpen( const cbl::String & path )
+{
+	for( size_t i = 0; i < mDevices.size(); ++i ) {
+		if( mDevices[i].Path == path )
+			return;
+	}
+
+	int fd = open( path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC );
+	if( fd < 0 )
+		return;
+
+	if( !IsGamepad( fd ) || !AddDevice( fd, path ) )
+		close( fd );
+}
+
+bool EvdevGamepadBackend::AddDevice( int fd, const cbl::String & path )
+{
+	for( size_t i = 0; i < mDevices.size(); ++i ) {
+		if( mDevices[i].Path == path )
+			return false;
+	}
+
+	cbl::Uint32 pad = 0;
+	while( pad < Gamepad::MaxPads && mPads[pad] )
+		++pad;
+	if( pad == Gamepad::MaxPads ) {
+		LOG( cbl::LogLevel::Warning << "No free pad for gamepad " << path );
+		return false;
+	}
+
+	struct stat info;
+	if( fstat( fd, &info ) < 0 )
+		return false;
+
+	Device device;
+	memset( device.Ranges, 0, sizeof( device.Ranges ) );
+	memset( device.Buttons, 0, sizeof( device.Buttons ) );
+	device.Fd			= fd;
+	device.Path			= path;
+	device.Pad			= pad;
+	device.Stream		= !S_ISCHR( info.st_mode );
+	device.Dropped		= false;
+	device.PartialSize	= 0;
+
+	// Recorded streams carry no axis information, so assume common gamepad ranges.
+	for( cbl::Uint32 i = 0; i < sAxisCodeCount; ++i ) {
+		AxisRange & range = device.Ranges[ sAxisCodes[i] ];
+		range.Min = _isTriggerCode( sAxisCodes[i] ) ? 0 : -32768;
+		range.Max = _isTriggerCode( sAxisCodes[i] ) ? 255 : 32767;
+
+		input_absinfo abs;
+		if( !device.Stream && ioctl( fd, EVIOCGABS( sAxisCodes[i] ), &abs ) >= 0 && abs.maximum > abs.minimum ) {
+			range.Min = abs.minimum;
+			range.Max = abs.maximum;
+		}
+	}
+
+	if( !device.Stream ) {
+		epoll_event ev;
+		memset( &ev, 0, sizeof( ev ) );
+		ev.events = EPOLLIN;
+		ev.data.fd = fd;
+		if( epoll_ctl( mEpoll, EPOLL_CTL_ADD, fd, &ev ) < 0 )
+			return false;
+	}
+
+	LOG( "Gamepad " << pad << " connected: " << path );
+
+	mPads[pad] = true;
+	mDevices.push_back( device );
+	Emit( GamepadEvent::Make( GamepadEventType::Connected, pad ) );
+
+	// Pick up sticks and buttons that were already held when the device was opened.
+	if( !device.Stream )
+		Resync( mDevices.back() );
+
+	return true;
+}
+
+void EvdevGamepadBackend::RemoveDevice( size_t index )
+{
+	Device & device = mDevices[index];
+	if( !device.Stream )
+		epoll_ctl( mEpoll, EPOLL_CTL_DEL, device.Fd, NULL );
+	close( device.Fd );
+
+	LOG( "Gamepad " << device.Pad << " disconnected: " << device.Path );
+
+	mPads[ device.Pad ] = false;
+	Emit( GamepadEvent::Make( GamepadEventType::Disconnected, device.Pad ) );
+	mDevices.erase( mDevices.begin() + index );
+}
+
+bool EvdevGamepadBackend::ReadDevice( Device & device )
+{
+	cbl::Uint8 buffer[ sizeof( input_event ) * sReadBatch ];
+	for( ;; )
+	{
+		// Streams can end mid-record; carry the partial record over to the next read.
+		const size_t offset = device.PartialSize;
+		memcpy( buffer, device.Partial, offset );
+
+		ssize_t bytes = read( device.Fd, buffer + offset, sizeof( buffer ) - offset );
+		if( bytes < 0 ) {
+			if( errno == EINTR )
+				continue;
+			// ENODEV means the device was unplugged.
+			return errno == EAGAIN;
+		}
+		if( bytes == 0 ) {
+			// End of a stream; keep polling in case more records are appended.
+			return device.Stream;
+		}
+
+		const size_t total = offset + size_t( bytes );
+		const size_t count = total / sizeof( input_event );
+		for( size_t i = 0; i < count; ++i ) {
+			input_event ev;
+			memcpy( &ev, buffer + i * sizeof( input_event ), sizeof( ev ) );
+			ProcessEvent( device, ev );
+		}
+
+		device.PartialSize = total - count * sizeof( input_event );
+		memcpy( device.Partial, buffer + count * sizeof( input_event ), device.PartialSize );
+	}
+}
+
+void EvdevGamepadBackend::ProcessEvent( Device & device, const input_event & ev )
+{
+	const cbl::Float64 time = cbl::Float64( ev.time.tv_sec ) + cbl::Float64( ev.time.tv_usec ) * 1e-6;
+
+	if( ev.type == EV_SYN ) {
+		if( ev.code == SYN_DROPPED ) {
+			device.Dropped = true;
+		}
+		else if( ev.code == SYN_REPORT && device.Dropped ) {
+			device.Dropped = false;
+			Resync( device );
+		}
+		return;
+	}
+
+	// Everything up to the next report is incomplete after a drop.
+	if( device.Dropped )
+		return;
+
+	if( ev.type == EV_KEY ) {
+		Gamepad::Button button = _mapButton( ev.code );
+		if( button != Gamepad::ButtonCount )
+			EmitButton( device, button, ev.value != 0, time );
+	}
+	else if( ev.type == EV_ABS && ev.code < ABS_CNT ) {
+		EmitAxis( device, ev.code, ev.value, time );
+	}
+}
+
+void EvdevGamepadBackend::Resync( Device & device )
+{
+	if( device.Stream )
+		return;
+
+	cbl::Uint8 keys[ KEY_MAX / 8 + 1 ];
+	memset( keys, 0, sizeof( keys ) );
+	if( ioctl( device.Fd, EVIOCGKEY( sizeof( keys ) ), keys ) >= 0 ) {
+		for( cbl::Uint32 code = BTN_JOYSTICK; code <= BTN_DPAD_RIGHT; ++code ) {
+			Gamepad::Button button = _mapButton( code );
+			if( button != Gamepad::ButtonCount )
+				EmitButton( device, button, _testBit( keys, code ), 0.0 );
+		}
+	}
+
+	for( cbl::Uint32 i = 0; i < sAxisCodeCount; ++i ) {
+		input_absinfo abs;
+		if( ioctl( device.Fd, EVIOCGABS( sAxisCodes[i] ), &abs ) >= 0 )
+			EmitAxis( device, sAxisCodes[i], abs.value, 0.0 );
+	}
+}
+
+void EvdevGamepadBackend::EmitButton( Device & device, Gamepad::Button button, bool down, cbl::Float64 time )
+{
+	if( device.Buttons[ button ] == down )
+		return;
+
+	device.Buttons[ button ] = down;
+	Emit( GamepadEvent::Make( GamepadEventType::Button, device.Pad, button, down ? 1.0f : 0.0f, time ) );
+}
+
+void EvdevGamepadBackend::EmitAxis( Device & device, cbl::Uint32 code, cbl::Int32 value, cbl::Float64 time )
+{
+	// The d-pad hat is reported as buttons.
+	if( code == ABS_HAT0X ) {
+		EmitButton( device, Gamepad::DPadLeft, value < 0, time );
+		EmitButton( device, Gamepad::DPadRight, value > 0, time );
+		return;
+	}
+	if( code == ABS_HAT0Y ) {
+		EmitButton( device, Gamepad::DPadUp, value < 0, time );
+		EmitButton( device, Gamepad::DPadDown, value > 0, time );
+		return;
+	}
+
+	Gamepad::Axis axis = _mapAxis( code );
+	const AxisRange & range = device.Ranges[ code ];
+	if( axis == Gamepad::AxisCount || range.Max <= range.Min )
+		return;
+
+	cbl::Float32 normalised = cbl::Float32( value - range.Min ) / cbl::Float32( range.Max - range.Min );
+	if( axis != Gamepad::LeftTrigger && axis != Gamepad::RightTrigger ) {
+		normalised = normalised * 2.0f - 1.0f;
+		// evdev reports down as positive; flip so up is positive.
+		if( axis == Gamepad::LeftY || axis == Gamepad::RightY )
+			normalised = -normalised;
+	}
+	normalised = normalised < -1.0f ? -1.0f : ( normalised > 1.0f ? 1.0f : normalised );
+
+	Emit( GamepadEvent::Make( GamepadEventType::Axis, device.Pad, axis, normalised, time ) );
+}
+
+void EvdevGamepadBackend::Emit( const GamepadEvent & ev )
+{
+	if( !mEvents.Push( ev ) )
+		Atomic::StoreRelease( mDropped, mDropped + 1 );
+}
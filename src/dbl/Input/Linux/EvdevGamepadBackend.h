@@ -0,0 +1,155 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file EvdevGamepadBackend.h
+ * @brief Linux evdev gamepad reader.
+ */
+
+#ifndef __DBL_EVDEVGAMEPADBACKEND_H_
+#define __DBL_EVDEVGAMEPADBACKEND_H_
+
+// Delectable Headers //
+#include "dbl/Delectable.h"
+#include "dbl/Input/GamepadManager.h"
+#include "dbl/Threading/RingBuffer.h"
+#include "dbl/Threading/Thread.h"
+#include "../IGamepadBackend.h"
+
+// External Dependencies //
+#include <linux/input.h>
+#include <vector>
+
+namespace dbl
+{
+	//! @brief Reads gamepads through evdev on its own thread.
+	//! Device nodes are multiplexed with epoll alongside an eventfd (used to wake the
+	//! thread) and an inotify watch on /dev/input for hotplugging. Files and pipes of
+	//! recorded input_event records can't be added to epoll, so they are polled instead;
+	//! this allows the backend to be driven headless from a recorded stream.
+	class EvdevGamepadBackend :
+		public IGamepadBackend
+	{
+	/***** Public Static Members *****/
+	public:
+		static const cbl::Char * const	sDevicePath;		//!< Directory watched for gamepads.
+		static const cbl::Uint32		sStreamPollTime;	//!< Recorded stream polling interval (in milliseconds).
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	queueSize	Event queue size.
+		explicit EvdevGamepadBackend( cbl::Uint32 queueSize );
+		//! Destructor.
+		virtual ~EvdevGamepadBackend();
+		//! Start reading devices.
+		virtual bool Start( void );
+		//! Stop reading devices and close them.
+		virtual void Stop( void );
+		//! Pop a raw event (main thread only).
+		virtual bool PopEvent( GamepadEvent & ev ) { return mEvents.Pop( ev ); }
+		//! Open a device explicitly (main thread only).
+		virtual bool OpenDevice( const cbl::Char * path );
+		//! Get the number of events dropped because the queue was full.
+		virtual cbl::Uint32 GetDroppedEvents( void ) const { return Atomic::LoadAcquire( mDropped ); }
+
+	/***** Private Types *****/
+	private:
+		//! Axis range reported by the device.
+		struct AxisRange
+		{
+			cbl::Int32	Min;
+			cbl::Int32	Max;
+		};
+
+		//! Opened device.
+		struct Device
+		{
+			int				Fd;									//!< File descriptor.
+			cbl::String		Path;								//!< Device path.
+			cbl::Uint32		Pad;								//!< Assigned pad.
+			bool			Stream;								//!< Recorded stream (polled, not in epoll).
+			bool			Dropped;							//!< Events were dropped; skip to the next report.
+			AxisRange		Ranges[ ABS_CNT ];					//!< Absolute axis ranges.
+			bool			Buttons[ Gamepad::ButtonCount ];	//!< Current button states.
+			cbl::Uint8		Partial[ sizeof( input_event ) ];	//!< Incomplete record from the last read.
+			size_t			PartialSize;						//!< Bytes in the incomplete record.
+		};
+		typedef std::vector< Device >	DeviceList;
+
+		//! Device opened by the main thread, waiting to be added by the reader thread.
+		struct PendingDevice
+		{
+			int				Fd;
+			cbl::String		Path;
+		};
+
+	/***** Private Static Methods *****/
+	private:
+		//! Thread entry point.
+		static void Run( void * self );
+		//! Check if a device node reports gamepad or joystick buttons.
+		static bool IsGamepad( int fd );
+
+	/***** Private Methods *****/
+	private:
+		//! Wake the reader thread.
+		bool Wake( void );
+		//! Thread main loop.
+		void Run( void );
+		//! Scan the device directory for gamepads.
+		void ScanDevices( void );
+		//! Handle inotify notifications.
+		void ReadNotifications( void );
+		//! Open a device node by path (reader thread only).
+		void TryOpen( const cbl::String & path );
+		//! Add an opened device.
+		//! @return		False if no pad is free.
+		bool AddDevice( int fd, const cbl::String & path );
+		//! Close and remove a device.
+		void RemoveDevice( size_t index );
+		//! Read and translate a device's pending events.
+		//! @return		False if the device has gone.
+		bool ReadDevice( Device & device );
+		//! Translate a single input event.
+		void ProcessEvent( Device & device, const input_event & ev );
+		//! Re-read the device state after the kernel dropped events.
+		void Resync( Device & device );
+		//! Emit a button transition if the state changed.
+		void EmitButton( Device & device, Gamepad::Button button, bool down, cbl::Float64 time );
+		//! Emit a normalised axis value.
+		void EmitAxis( Device & device, cbl::Uint32 code, cbl::Int32 value, cbl::Float64 time );
+		//! Queue an event for the main thread.
+		void Emit( const GamepadEvent & ev );
+
+	/***** Private Members *****/
+	private:
+		Thread							mThread;		//!< Reader thread.
+		RingBuffer< GamepadEvent >		mEvents;		//!< Events waiting for the main thread.
+		RingBuffer< PendingDevice >		mPending;		//!< Devices opened by the main thread.
+		DeviceList						mDevices;		//!< Open devices (reader thread only).
+		bool							mPads[ Gamepad::MaxPads ];	//!< Pad slots in use (reader thread only).
+		int								mEpoll;			//!< Epoll instance.
+		int								mWake;			//!< Eventfd used to wake the reader thread.
+		int								mNotify;		//!< Inotify instance watching the device directory.
+		volatile cbl::Uint32			mStop;			//!< Reader thread stop request.
+		volatile cbl::Uint32			mDropped;		//!< Events dropped because the queue was full.
+	};
+}
+
+#endif // __DBL_EVDEVGAMEPADBACKEND_H_
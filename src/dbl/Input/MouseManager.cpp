@@ -38,10 +38,16 @@ using namespace dbl;
 MouseManager::MouseManager( cbl::Game & game )
 : cbl::GameComponent( game )
 , mWindow( NULL )
+, mBoundWindow( NULL )
 , mClipCursor( false )
 , mLockMouse( false )
 , mFocused( true )
 , mCentering( false )
+, mRawMotion( false )
+, mCoalesceMotion( false )
+, mKeepSamples( false )
+, mMotionPending( false )
+, mFrameWheel( 0 )
 {
 }
 
@@ -54,16 +60,63 @@ bool MouseManager::IsButtonDown( Mouse::Button button ) const
 	return mButtons[button];
 }
 
+const cbl::Vector2i & MouseManager::GetSampledPosition( void ) const
+{
+	return mWindow && mWindow->IsInputThreadEnabled() ? mSampledPosition : mPosition;
+}
+
+void MouseManager::GetSnapshot( InputSnapshot & snapshot ) const
+{
+	snapshot.Buttons			= mSnapshot.Buttons;
+	snapshot.PreviousButtons	= mSnapshot.PreviousButtons;
+	snapshot.X					= mSnapshot.X;
+	snapshot.Y					= mSnapshot.Y;
+	snapshot.DiffX				= mSnapshot.DiffX;
+	snapshot.DiffY				= mSnapshot.DiffY;
+	snapshot.Wheel				= mSnapshot.Wheel;
+}
+
 void MouseManager::Initialise( void )
 {
-	mWindow = Game.Services.Get< GameWindow >();
-	CBL_ASSERT_TRUE( mWindow );
-	
 	LOG( "Initialising mouse manager." );
-	
+
+	AttachWindow();
+}
+
+void MouseManager::Shutdown( void )
+{
+	if( !mWindow )
+		return;
+
+	LOG( "Shutting down mouse manager." );
+
+	DetachWindow();
+}
+
+void MouseManager::BindWindow( GameWindow * window )
+{
+	mBoundWindow = window;
+
+	// Not initialised yet; Initialise() picks the window up.
+	if( !mWindow )
+		return;
+
+	// Hand the cursor back to the old window and apply our cursor state to the new one.
+	OnWindowLostFocus();
+	DetachWindow();
+	AttachWindow();
+	OnWindowGainedFocus();
+}
+
+void MouseManager::AttachWindow( void )
+{
+	mWindow = mBoundWindow ? mBoundWindow : Game.Services.Get< GameWindow >();
+	CBL_ASSERT_TRUE( mWindow );
+
 	mWindow->OnWindowLostFocus		+= E::WindowLostFocus::Method<CBL_E_METHOD(MouseManager,OnWindowLostFocus)>(this);
 	mWindow->OnWindowGainedFocus	+= E::WindowGainedFocus::Method<CBL_E_METHOD(MouseManager,OnWindowGainedFocus)>(this);
 	mWindow->OnWindowMouseMove		+= E::WindowMouseMove::Method<CBL_E_METHOD(MouseManager,OnWindowMouseMove)>(this);
+	mWindow->OnWindowMouseRawMotion	+= E::WindowMouseRawMotion::Method<CBL_E_METHOD(MouseManager,OnWindowMouseRawMotion)>(this);
 	mWindow->OnWindowMouseDown		+= E::WindowMouseDown::Method<CBL_E_METHOD(MouseManager,OnWindowMouseDown)>(this);
 	mWindow->OnWindowMouseUp		+= E::WindowMouseUp::Method<CBL_E_METHOD(MouseManager,OnWindowMouseUp)>(this);
 	mWindow->OnWindowMouseDblClick	+= E::WindowMouseDblClick::Method<CBL_E_METHOD(MouseManager,OnWindowMouseDblClick)>(this);
@@ -71,18 +124,14 @@ void MouseManager::Initialise( void )
 	mWindow->OnWindowMouseLeave		+= E::WindowMouseLeave::Method<CBL_E_METHOD(MouseManager,OnWindowMouseLeave)>(this);
 }
 
-void MouseManager::Shutdown( void )
+void MouseManager::DetachWindow( void )
 {
-	if( !mWindow )
-		return;
-
-	LOG( "Shutting down mouse manager." );
-	
 	mWindow->OnWindowMouseLeave		-= E::WindowMouseLeave::Method<CBL_E_METHOD(MouseManager,OnWindowMouseLeave)>(this);
 	mWindow->OnWindowMouseWheel		-= E::WindowMouseWheel::Method<CBL_E_METHOD(MouseManager,OnWindowMouseWheel)>(this);
 	mWindow->OnWindowMouseDblClick	-= E::WindowMouseDblClick::Method<CBL_E_METHOD(MouseManager,OnWindowMouseDblClick)>(this);
 	mWindow->OnWindowMouseUp		-= E::WindowMouseUp::Method<CBL_E_METHOD(MouseManager,OnWindowMouseUp)>(this);
 	mWindow->OnWindowMouseDown		-= E::WindowMouseDown::Method<CBL_E_METHOD(MouseManager,OnWindowMouseDown)>(this);
+	mWindow->OnWindowMouseRawMotion	-= E::WindowMouseRawMotion::Method<CBL_E_METHOD(MouseManager,OnWindowMouseRawMotion)>(this);
 	mWindow->OnWindowMouseMove		-= E::WindowMouseMove::Method<CBL_E_METHOD(MouseManager,OnWindowMouseMove)>(this);
 	mWindow->OnWindowGainedFocus	-= E::WindowGainedFocus::Method<CBL_E_METHOD(MouseManager,OnWindowGainedFocus)>(this);
 	mWindow->OnWindowLostFocus		-= E::WindowLostFocus::Method<CBL_E_METHOD(MouseManager,OnWindowLostFocus)>(this);
@@ -92,6 +141,26 @@ void MouseManager::Shutdown( void )
 
 void MouseManager::Update( cbl::GameTime const & )
 {
+	// Pick up the snapshot the window read from the input thread at frame start.
+	if( mWindow && mWindow->IsInputThreadEnabled() ) {
+		mSampledPosition.X = mWindow->GetInputState().X;
+		mSampledPosition.Y = mWindow->GetInputState().Y;
+	}
+
+	FlushMotion();
+
+	// Latch the frame's state for snapshots.
+	mSnapshot.PreviousButtons = mSnapshot.Buttons;
+	mSnapshot.Buttons = mButtons;
+	mSnapshot.X = mPosition.X;
+	mSnapshot.Y = mPosition.Y;
+	mSnapshot.DiffX = mFrameMotion.X;
+	mSnapshot.DiffY = mFrameMotion.Y;
+	mSnapshot.Wheel = mFrameWheel;
+	mFrameMotion.X = mFrameMotion.Y = 0;
+	mFrameWheel = 0;
+
+	size_t top = Filter.TopIndex();
 	FilterEvent* f = Filter.Top();
 
 	for( cbl::Uint32 count = 0; count < Mouse::Count; ++count )
@@ -100,9 +169,7 @@ void MouseManager::Update( cbl::GameTime const & )
 			OnMouseDown( mPosition.X, mPosition.Y, Mouse::Button( count ) );
 		if( f && f->Buttons[ count ] )
 			f->OnMouseDown( mPosition.X, mPosition.Y, Mouse::Button( count ) );
-		for( size_t i = 0; i < Filter.size(); ++i ) {
-			if( &Filter[i] == f )
-				break;
+		for( size_t i = 0; i < top; ++i ) {
 			if( Filter[i].Buttons[count] ) {
 				// We have an underlying state that needs to be set to false.
 				Filter[i].Buttons[count] = false;
@@ -156,6 +223,11 @@ void MouseManager::LockMouse( bool showCursor )
 	mPosition.Y = mWindow->GetSettings().Dimensions.Height / 2;
 	mWindow->CenterCursorPosition();
 
+	// Prefer raw relative motion; fall back to re-centering the cursor after every move.
+	mRawMotion = mWindow->SetRelativeMouseMode( true );
+	if( mRawMotion && mFocused )
+		mWindow->ClipCursor( true );
+
 	if( showCursor )
 		ShowCursor();
 	else
@@ -169,13 +241,31 @@ void MouseManager::UnlockMouse( void )
 	mLockMouse = false;
 	ShowCursor();
 
+	if( mRawMotion ) {
+		mRawMotion = false;
+		mWindow->SetRelativeMouseMode( false );
+		mWindow->ClipCursor( mClipCursor );
+	}
+	mCentering = false;
+
 	mPosition = mStoredPosition;
 	mWindow->SetCursorPosition( mStoredPosition.X, mStoredPosition.Y );
 }
 
+void MouseManager::SetMotionCoalescing( bool state, bool keepSamples )
+{
+	if( mCoalesceMotion && !state )
+		FlushMotion();
+
+	mCoalesceMotion = state;
+	mKeepSamples = state && keepSamples;
+	mSamples.clear();
+	mFrameSamples.clear();
+}
+
 void MouseManager::OnWindowLostFocus( void )
 {
-	if( mClipCursor )
+	if( mClipCursor || mRawMotion )
 		mWindow->ClipCursor( false );
 
 	mFocused = false;
@@ -185,12 +275,12 @@ void MouseManager::OnWindowLostFocus( void )
 
 void MouseManager::OnWindowGainedFocus( void )
 {
-	if( mClipCursor )
+	if( mClipCursor || mRawMotion )
 		mWindow->ClipCursor( true );
 
 	mFocused = true;
 	
-	if( mLockMouse )
+	if( mLockMouse && !mRawMotion )
 		mWindow->CenterCursorPosition();
 	if( !mShowMouse )
 		mWindow->ShowCursor( false );
@@ -198,6 +288,10 @@ void MouseManager::OnWindowGainedFocus( void )
 
 void MouseManager::OnWindowMouseMove( cbl::Int32 x, cbl::Int32 y )
 {
+	// The locked cursor is reported through raw motion instead.
+	if( mRawMotion )
+		return;
+
 	if( mCentering ) {
 		mCentering = false;
 		mPosition.X = x;
@@ -208,20 +302,7 @@ void MouseManager::OnWindowMouseMove( cbl::Int32 x, cbl::Int32 y )
 	if( mPosition.X == x && mPosition.Y == y )
 		return;
 	
-	cbl::Int32 diffx = x - mPosition.X;
-	cbl::Int32 diffy = y - mPosition.Y;
-	OnMouseMove( x, y, diffx, diffy );
-
-	FilterEvent* f = Filter.Top();
-	if( f ) f->OnMouseMove( x, y, diffx, diffy );
-
-	for( cbl::Uint32 count = 0; count < Mouse::Count; ++count )
-	{
-		if( mButtons[ count ] )
-			OnMouseDrag( x, y, diffx, diffy, Mouse::Button( count ) );
-		if( f && f->Buttons[ count ] )
-			f->OnMouseDrag( x, y, diffx, diffy, Mouse::Button( count ) );
-	}
+	ProcessMotion( x, y, x - mPosition.X, y - mPosition.Y );
 
 	if( mLockMouse && mFocused ) {
 		mCentering = true;
@@ -233,6 +314,15 @@ void MouseManager::OnWindowMouseMove( cbl::Int32 x, cbl::Int32 y )
 	}
 }
 
+void MouseManager::OnWindowMouseRawMotion( cbl::Int32 diffx, cbl::Int32 diffy )
+{
+	if( !mRawMotion || !mFocused )
+		return;
+
+	// The locked cursor stays at the center; only the deltas change.
+	ProcessMotion( mPosition.X, mPosition.Y, diffx, diffy );
+}
+
 void MouseManager::OnWindowMouseDown( cbl::Int32 x, cbl::Int32 y, Mouse::Button button )
 {
 	if( !mButtons[ button ] ) {
@@ -277,6 +367,7 @@ void MouseManager::OnWindowMouseDblClick( cbl::Int32 x, cbl::Int32 y, Mouse::But
 
 void MouseManager::OnWindowMouseWheel( cbl::Int32 delta )
 {
+	mFrameWheel += delta;
 	OnMouseWheel( delta );
 
 	if( FilterEvent* f = Filter.Top() )
@@ -300,3 +391,62 @@ void MouseManager::OnWindowMouseLeave( void )
 		}
 	}
 }
+
+void MouseManager::ProcessMotion( cbl::Int32 x, cbl::Int32 y, cbl::Int32 diffx, cbl::Int32 diffy )
+{
+	if( !mCoalesceMotion ) {
+		DispatchMotion( x, y, diffx, diffy );
+		return;
+	}
+
+	mMotionPending = true;
+	mMotionPosition.X = x;
+	mMotionPosition.Y = y;
+	mMotionDelta.X += diffx;
+	mMotionDelta.Y += diffy;
+
+	if( mKeepSamples ) {
+		MotionSample sample = { x, y, diffx, diffy, mWindow ? mWindow->GetInputEventTime() : 0.0 };
+		mSamples.push_back( sample );
+	}
+}
+
+void MouseManager::DispatchMotion( cbl::Int32 x, cbl::Int32 y, cbl::Int32 diffx, cbl::Int32 diffy )
+{
+	mFrameMotion.X += diffx;
+	mFrameMotion.Y += diffy;
+
+	OnMouseMove( x, y, diffx, diffy );
+
+	FilterEvent* f = Filter.Top();
+	if( f ) f->OnMouseMove( x, y, diffx, diffy );
+
+	for( cbl::Uint32 count = 0; count < Mouse::Count; ++count )
+	{
+		if( mButtons[ count ] )
+			OnMouseDrag( x, y, diffx, diffy, Mouse::Button( count ) );
+		if( f && f->Buttons[ count ] )
+			f->OnMouseDrag( x, y, diffx, diffy, Mouse::Button( count ) );
+	}
+}
+
+void MouseManager::FlushMotion( void )
+{
+	if( !mCoalesceMotion )
+		return;
+
+	mFrameSamples.swap( mSamples );
+	mSamples.clear();
+
+	if( !mMotionPending )
+		return;
+
+	// Reset before dispatching in case a listener moves the cursor.
+	cbl::Vector2i position = mMotionPosition, delta = mMotionDelta;
+	mMotionPending = false;
+	mMotionDelta.X = mMotionDelta.Y = 0;
+
+	// Opposing moves can cancel out completely.
+	if( delta.X != 0 || delta.Y != 0 )
+		DispatchMotion( position.X, position.Y, delta.X, delta.Y );
+}
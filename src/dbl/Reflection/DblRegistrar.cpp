@@ -26,6 +26,7 @@
 
 // Delectable Headers //
 #include "dbl/Reflection/DblRegistrar.h"
+#include "dbl/Serialisation/YAMLStaticCodec.h"
 
 using namespace dbl;
 
@@ -55,6 +56,24 @@ void DblRegistrar::RegisterDblTypes( void )
 		.CBL_FIELD( Resolution, GameWindowSettings )
 		.CBL_FIELD_ATTR( AspectRatio, GameWindowSettings, cbl::FieldAttr::F_TRANSIENT );
 
+	typedb.Create<ActionBinding>()
+		.CBL_FIELD( Name, ActionBinding )
+		.CBL_FIELD( Keys, ActionBinding )
+		.CBL_FIELD( Buttons, ActionBinding );
+
+	typedb.Create<AxisBinding>()
+		.CBL_FIELD( Name, AxisBinding )
+		.CBL_FIELD( Positive, AxisBinding )
+		.CBL_FIELD( Negative, AxisBinding );
+
+	typedb.Create<ActionBindings>()
+		.CBL_FIELD( Actions, ActionBindings )
+		.CBL_FIELD( Axes, ActionBindings );
+
+	YAMLStaticCodecs::Register<GameWindowStyle>();
+	YAMLStaticCodecs::Register<GameWindowSize>();
+	YAMLStaticCodecs::Register<GameWindowSettings>();
+
 	typedb.Create<LevelObject>()
 		.Base<cbl::Object>();
 }
@@ -74,6 +93,32 @@ void RegisterKeyMouseEnums( cbl::TypeDB& typedb )
 		.CBL_ENUM( XButton1, Mouse )
 		.CBL_ENUM( XButton2, Mouse );
 
+	/***** Gamepad *****/
+	typedb.Create<Gamepad::Button>()
+		.CBL_ENUM( A, Gamepad )
+		.CBL_ENUM( B, Gamepad )
+		.CBL_ENUM( X, Gamepad )
+		.CBL_ENUM( Y, Gamepad )
+		.CBL_ENUM( LeftShoulder, Gamepad )
+		.CBL_ENUM( RightShoulder, Gamepad )
+		.CBL_ENUM( Back, Gamepad )
+		.CBL_ENUM( Start, Gamepad )
+		.CBL_ENUM( Guide, Gamepad )
+		.CBL_ENUM( LeftStick, Gamepad )
+		.CBL_ENUM( RightStick, Gamepad )
+		.CBL_ENUM( DPadUp, Gamepad )
+		.CBL_ENUM( DPadDown, Gamepad )
+		.CBL_ENUM( DPadLeft, Gamepad )
+		.CBL_ENUM( DPadRight, Gamepad );
+
+	typedb.Create<Gamepad::Axis>()
+		.CBL_ENUM( LeftX, Gamepad )
+		.CBL_ENUM( LeftY, Gamepad )
+		.CBL_ENUM( RightX, Gamepad )
+		.CBL_ENUM( RightY, Gamepad )
+		.CBL_ENUM( LeftTrigger, Gamepad )
+		.CBL_ENUM( RightTrigger, Gamepad );
+
 	/***** Keyboard *****/
 	typedb.Create<Key::Code>()
 		.CBL_ENUM( A, Key )
@@ -0,0 +1,148 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file BlockSerialisation.cpp
+ * @brief Contiguous block serialisation for containers of plain data.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Serialisation/BlockSerialisation.h"
+
+using namespace dbl;
+
+BlockFields::FieldList BlockFields::sFields;
+BlockFields::FieldCache BlockFields::sCache;
+
+static const cbl::Char sBase64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+BlockField::BlockField( const cbl::CName& owner, const cbl::Char* name, cbl::Uint32 elementSize, BlockFormat::Type format )
+: Owner( owner )
+, Name( name )
+, ElementSize( elementSize )
+, Format( format )
+{
+}
+
+const BlockField* BlockFields::Find( const cbl::Type* type, const cbl::Field* field )
+{
+	if( sFields.empty() || !type || !field )
+		return NULL;
+
+	FieldCache::const_iterator findit = sCache.find( field );
+	if( findit != sCache.end() )
+		return findit->second;
+
+	// Fields are unique to their declaring type, so the result can be cached by field.
+	const BlockField* block = NULL;
+	for( size_t i = 0; i < sFields.size(); ++i ) {
+		if( sFields[i]->Name == field->Name.Text && type->IsType( sFields[i]->Owner ) ) {
+			block = sFields[i];
+			break;
+		}
+	}
+
+	sCache.insert( std::make_pair( field, block ) );
+	return block;
+}
+
+void BlockFields::Clear( void )
+{
+	for( size_t i = 0; i < sFields.size(); ++i )
+		CBL_DELETE( sFields[i] );
+	sFields.clear();
+	sCache.clear();
+}
+
+void BlockFields::Add( BlockField* field )
+{
+	for( size_t i = 0; i < sFields.size(); ++i ) {
+		if( sFields[i]->Owner == field->Owner && sFields[i]->Name == field->Name ) {
+			CBL_DELETE( sFields[i] );
+			sFields[i] = field;
+			sCache.clear();
+			return;
+		}
+	}
+
+	sFields.push_back( field );
+	sCache.clear();
+}
+
+void BlockFields::EncodeBase64( const void* data, size_t size, cbl::String& out )
+{
+	const cbl::Uint8* in = static_cast<const cbl::Uint8*>( data );
+
+	out.clear();
+	out.reserve( ( ( size + 2 ) / 3 ) * 4 );
+
+	size_t i = 0;
+	for( ; i + 2 < size; i += 3 ) {
+		cbl::Uint32 v = ( cbl::Uint32( in[i] ) << 16 ) | ( cbl::Uint32( in[i+1] ) << 8 ) | in[i+2];
+		out += sBase64Chars[ ( v >> 18 ) & 0x3F ];
+		out += sBase64Chars[ ( v >> 12 ) & 0x3F ];
+		out += sBase64Chars[ ( v >> 6 ) & 0x3F ];
+		out += sBase64Chars[ v & 0x3F ];
+	}
+
+	if( i < size ) {
+		cbl::Uint32 v = cbl::Uint32( in[i] ) << 16;
+		if( i + 1 < size )
+			v |= cbl::Uint32( in[i+1] ) << 8;
+
+		out += sBase64Chars[ ( v >> 18 ) & 0x3F ];
+		out += sBase64Chars[ ( v >> 12 ) & 0x3F ];
+		out += ( i + 1 < size ) ? sBase64Chars[ ( v >> 6 ) & 0x3F ] : '=';
+		out += '=';
+	}
+}
+
+bool BlockFields::DecodeBase64( const cbl::Char* in, size_t length, std::vector<cbl::Uint8>& out )
+{
+	static cbl::Int8 sDecodeTable[256];
+	static bool sDecodeTableBuilt = false;
+	if( !sDecodeTableBuilt ) {
+		memset( sDecodeTable, -1, sizeof( sDecodeTable ) );
+		for( cbl::Int8 i = 0; i < 64; ++i )
+			sDecodeTable[ cbl::Uint8( sBase64Chars[i] ) ] = i;
+		sDecodeTableBuilt = true;
+	}
+
+	out.clear();
+	if( length % 4 != 0 )
+		return false;
+
+	out.reserve( ( length / 4 ) * 3 );
+	for( size_t i = 0; i < length; i += 4 ) {
+		cbl::Int32 a = sDecodeTable[ cbl::Uint8( in[i] ) ];
+		cbl::Int32 b = sDecodeTable[ cbl::Uint8( in[i+1] ) ];
+		cbl::Int32 c = in[i+2] == '=' ? 0 : sDecodeTable[ cbl::Uint8( in[i+2] ) ];
+		cbl::Int32 d = in[i+3] == '=' ? 0 : sDecodeTable[ cbl::Uint8( in[i+3] ) ];
+		if( a < 0 || b < 0 || c < 0 || d < 0 )
+			return false;
+
+		cbl::Uint32 v = ( cbl::Uint32( a ) << 18 ) | ( cbl::Uint32( b ) << 12 ) | ( cbl::Uint32( c ) << 6 ) | cbl::Uint32( d );
+		out.push_back( cbl::Uint8( v >> 16 ) );
+		if( in[i+2] != '=' ) out.push_back( cbl::Uint8( v >> 8 ) );
+		if( in[i+3] != '=' ) out.push_back( cbl::Uint8( v ) );
+	}
+	return true;
+}
@@ -0,0 +1,329 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file JSONDeserialiser.cpp
+ * @brief JSON deserialiser.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Serialisation/JSONDeserialiser.h"
+#include "dbl/Serialisation/BlockSerialisation.h"
+#include "dbl/Serialisation/PrefabCache.h"
+
+// External Libraries //
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+using namespace dbl;
+
+typedef cbl::Deserialiser::StreamPtr StreamPtr;
+
+template< typename T, typename PARSE >
+bool _readNumbers( const JSONDocument& doc, const JSONNode& node, void* data, const char* format )
+{
+	T* values = static_cast<T*>( data );
+	cbl::String scalar;
+	size_t i = 0;
+	for( const JSONNode* child = doc.GetFirstChild( node ); child; child = doc.GetNextSibling( *child ), ++i ) {
+		PARSE value = PARSE();
+		if( !JSONDocument::GetScalar( *child, scalar ) || sscanf( scalar.c_str(), format, &value ) != 1 )
+			return false;
+		values[i] = T( value );
+	}
+	return true;
+}
+
+template< typename T >
+bool _readReals( const JSONDocument& doc, const JSONNode& node, void* data )
+{
+	T* values = static_cast<T*>( data );
+	cbl::String scalar;
+	size_t i = 0;
+	for( const JSONNode* child = doc.GetFirstChild( node ); child; child = doc.GetNextSibling( *child ), ++i ) {
+		// NaN and infinity are written as null.
+		if( child->Type == JSONType::Null ) {
+			values[i] = std::numeric_limits<T>::quiet_NaN();
+			continue;
+		}
+		cbl::Float64 value = 0.0;
+		if( !JSONDocument::GetScalar( *child, scalar ) || sscanf( scalar.c_str(), "%lf", &value ) != 1 )
+			return false;
+		values[i] = T( value );
+	}
+	return true;
+}
+
+bool _readBlock( const JSONDocument& doc, const JSONNode& node, const BlockField& block, void* owner )
+{
+	if( node.Type == JSONType::String ) {
+		std::vector<cbl::Uint8> decoded;
+		if( !BlockFields::DecodeBase64( node.Text, node.Length, decoded ) ||
+			decoded.size() % block.ElementSize != 0 )
+			return false;
+
+		void* data = block.Resize( owner, decoded.size() / block.ElementSize );
+		if( !decoded.empty() )
+			memcpy( data, &decoded[0], decoded.size() );
+		return true;
+	}
+
+	if( node.Type != JSONType::Array || block.Format == BlockFormat::Raw )
+		return false;
+
+	void* data = block.Resize( owner, node.ChildCount );
+	switch( block.Format ) {
+		case BlockFormat::Int8:		return _readNumbers<cbl::Int8, cbl::Int32>( doc, node, data, "%d" );
+		case BlockFormat::Uint8:	return _readNumbers<cbl::Uint8, cbl::Uint32>( doc, node, data, "%u" );
+		case BlockFormat::Int16:	return _readNumbers<cbl::Int16, cbl::Int32>( doc, node, data, "%d" );
+		case BlockFormat::Uint16:	return _readNumbers<cbl::Uint16, cbl::Uint32>( doc, node, data, "%u" );
+		case BlockFormat::Int32:	return _readNumbers<cbl::Int32, cbl::Int32>( doc, node, data, "%d" );
+		case BlockFormat::Uint32:	return _readNumbers<cbl::Uint32, cbl::Uint32>( doc, node, data, "%u" );
+		case BlockFormat::Int64:	return _readNumbers<cbl::Int64, cbl::Int64>( doc, node, data, "%lld" );
+		case BlockFormat::Uint64:	return _readNumbers<cbl::Uint64, cbl::Uint64>( doc, node, data, "%llu" );
+		case BlockFormat::Float32:	return _readReals<cbl::Float32>( doc, node, data );
+		case BlockFormat::Float64:	return _readReals<cbl::Float64>( doc, node, data );
+		default: break;
+	}
+	return false;
+}
+
+JSONDeserialiser::JSONDeserialiser()
+: mHasDocument( false )
+{
+}
+
+bool JSONDeserialiser::IsStreamEnded( void ) const
+{
+	return !mHasDocument;
+}
+
+bool JSONDeserialiser::GetValueType( StreamPtr s, cbl::String& type ) const
+{
+	if( !s ) return false;
+
+	const JSONNode* tag = GetDocument().FindValue( *(const JSONNode*)s, "$type" );
+	return tag && JSONDocument::GetScalar( *tag, type );
+}
+
+StreamPtr JSONDeserialiser::Initialise( StreamPtr, const cbl::Type* type, void * )
+{
+	if( mHasDocument ) {
+		const JSONNode* root = GetDocument().GetRoot();
+		cbl::String typeStr;
+		if( GetValueType( (StreamPtr)root, typeStr ) ) {
+			const cbl::Type* targetType = CBL_ENT.Types.Get( cbl::CName( typeStr.c_str() ) );
+			if( targetType && targetType->IsType( type->Name ) )
+				return (StreamPtr)root;
+		}
+		mHasDocument = (*(JSONDocument*)mStream).GetNextDocument();
+	}
+	return NULL;
+}
+
+StreamPtr JSONDeserialiser::Shutdown( StreamPtr s, const cbl::Type*, void * )
+{
+	mContainers.clear();
+	mFieldContainers.clear();
+	mHasDocument = (*(JSONDocument*)mStream).GetNextDocument();
+	return s;
+}
+
+StreamPtr JSONDeserialiser::TraverseStream( StreamPtr s, const cbl::Char* path )
+{
+	if( !s ) return NULL;
+	return (StreamPtr)GetDocument().FindValue( *(const JSONNode*)s, path );
+}
+
+StreamPtr JSONDeserialiser::BeginContainerEntry( StreamPtr, const cbl::Type*, const cbl::Type* )
+{
+	if( mContainers.empty() )
+		return NULL;
+
+	return (StreamPtr)mContainers.back().Entry;
+}
+
+void JSONDeserialiser::EndContainerEntry( StreamPtr, const cbl::Type*, const cbl::Type* )
+{
+	if( mContainers.empty() )
+		return;
+
+	ContainerState& state = mContainers.back();
+	if( state.Entry )
+		state.Entry = GetDocument().GetNextSibling( *state.Entry );
+}
+
+StreamPtr JSONDeserialiser::GetContainerKeyStream( StreamPtr s ) const
+{
+	if( !s ) return NULL;
+	return (StreamPtr)GetDocument().FindValue( *(const JSONNode*)s, "Key" );
+}
+
+StreamPtr JSONDeserialiser::GetContainerValueStream( StreamPtr s, bool hasKey ) const
+{
+	if( !hasKey || !s ) return s;
+	return (StreamPtr)GetDocument().FindValue( *(const JSONNode*)s, "Value" );
+}
+
+StreamPtr JSONDeserialiser::BeginValue( StreamPtr s, const cbl::Type* type, void * obj, const cbl::FieldAttr* attr )
+{
+	const JSONNode* node = (const JSONNode*)s;
+	mCurrentValue = FieldOwner( type, obj );
+
+	if( !node )
+		return NULL;
+
+	// Unwrap typed values.
+	if( node->Type == JSONType::Object && GetDocument().FindValue( *node, "$type" ) ) {
+		node = GetDocument().FindValue( *node, "$value" );
+		if( !node )
+			return NULL;
+	}
+
+	if( type->FromString ) {
+		cbl::String value;
+		if( JSONDocument::GetScalar( *node, value ) ) {
+			type->FromString( value.c_str(), type, obj, attr );
+			return NULL; // We handled the value.
+		}
+	}
+	return (StreamPtr)node;
+}
+
+void JSONDeserialiser::EndValue( StreamPtr, const cbl::Type*, void *, const cbl::FieldAttr* )
+{
+}
+
+StreamPtr JSONDeserialiser::BeginFields( StreamPtr s )
+{
+	mFieldOwners.push_back( mCurrentValue );
+	return s;
+}
+
+void JSONDeserialiser::EndFields( StreamPtr )
+{
+	mFieldOwners.pop_back();
+}
+
+StreamPtr JSONDeserialiser::BeginField( StreamPtr s, const cbl::Field* field )
+{
+	// EndField() is called for every field, but only container fields push a state.
+	mFieldContainers.push_back( false );
+
+	const JSONNode* node = GetDocument().FindValue( *(const JSONNode*)s, field->Name.Text );
+	if( !node || !field->Container )
+		return (StreamPtr)node;
+
+	// Containers of plain data are read in one go instead of entry by entry.
+	if( !mFieldOwners.empty() ) {
+		const FieldOwner& owner = mFieldOwners.back();
+		if( const BlockField* block = BlockFields::Find( owner.first, field ) ) {
+			if( !_readBlock( GetDocument(), *node, *block, owner.second ) )
+				LOG_ERROR( "Field container (" << field->Name.Text << ") is not a valid data block." );
+			return NULL;
+		}
+	}
+
+	if( node->Type != JSONType::Array ) {
+		LOG_ERROR( "Field container (" << field->Name.Text << ") is not a JSON array." );
+		return NULL;
+	}
+
+	ContainerState state;
+	state.Entry = GetDocument().GetFirstChild( *node );
+	mContainers.push_back( state );
+	mFieldContainers.back() = true;
+
+	return (StreamPtr)node;
+}
+
+void JSONDeserialiser::EndField( StreamPtr, const cbl::Field* )
+{
+	if( mFieldContainers.empty() )
+		return;
+
+	if( mFieldContainers.back() )
+		mContainers.pop_back();
+	mFieldContainers.pop_back();
+}
+
+void JSONDeserialiser::OnStreamSet( void )
+{
+	mContainers.clear();
+	mFieldContainers.clear();
+	mHasDocument = (*(JSONDocument*)mStream).GetNextDocument();
+}
+
+template<>
+cbl::ObjectPtr cbl::ObjectManager::LoadObjectFromFile<JSONDeserialiser>( const cbl::Char* file, const cbl::Char* name, bool init )
+{
+	ObjectPtr newObj = NULL;
+
+	// Clone from the cached template if the file hasn't changed since it was parsed.
+	bool success = PrefabCache::Instantiate( file, newObj );
+	if( !success ) {
+		std::ifstream fs;
+		fs.open( file, std::ios_base::binary );
+
+		if( !fs.is_open() ) {
+			LOG_ERROR( "Unable to open object file for reading: " << file );
+			return NULL;
+		}
+
+		JSONDocument doc;
+		bool loaded = doc.Load( fs );
+		fs.close();
+
+		if( !loaded ) {
+			LOG_ERROR( "Unable to read JSON file: " << file );
+			return NULL;
+		}
+
+		JSONDeserialiser jd;
+		jd.SetStream( doc );
+
+		success = jd.DeserialisePtr( newObj );
+		if( success )
+			PrefabCache::Store( file, *newObj );
+	}
+
+	if( success ) {
+		if( name ) newObj->mName = name;
+		success = Add( newObj );
+		if( !success ) {
+			CBL_ENT.Delete( newObj );
+			newObj = NULL;
+		}
+	}
+
+	if( success ) {
+		LOG( "Object (" << newObj->GetName() << ") loaded from file: " << file );
+	} else {
+		LOG_ERROR( "Unable to deserialise from JSON file: " << file );
+	}
+
+	if( init && newObj )
+		InitObject( newObj );
+
+	return newObj;
+}
@@ -0,0 +1,412 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file JSONDocument.cpp
+ * @brief In-situ JSON reader.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Serialisation/JSONDocument.h"
+
+// External Libraries //
+#include <istream>
+#include <iterator>
+#include <cstring>
+
+using namespace dbl;
+
+cbl::Uint32 JSONDocument::MaxDepth = 512;
+
+cbl::Int32 _hexValue( cbl::Char c )
+{
+	if( c >= '0' && c <= '9' ) return c - '0';
+	if( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+	if( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+	return -1;
+}
+
+bool _isDigit( cbl::Char c )
+{
+	return c >= '0' && c <= '9';
+}
+
+JSONDocument::JSONDocument()
+: mCursor( NULL )
+, mEnd( NULL )
+, mFailed( false )
+{
+}
+
+bool JSONDocument::Load( std::istream& is )
+{
+	mBuffer.assign( std::istreambuf_iterator<cbl::Char>( is ), std::istreambuf_iterator<cbl::Char>() );
+	mNodes.clear();
+	mFailed = false;
+	mCursor = mBuffer.empty() ? NULL : &mBuffer[0];
+	mEnd	= mCursor + mBuffer.size();
+
+	// Skip the UTF-8 byte order mark.
+	if( mEnd - mCursor >= 3 && memcmp( mCursor, "\xEF\xBB\xBF", 3 ) == 0 )
+		mCursor += 3;
+
+	return !is.bad();
+}
+
+void JSONDocument::Load( const cbl::Char* text, size_t length )
+{
+	mBuffer.assign( text, text + length );
+	mNodes.clear();
+	mFailed = false;
+	mCursor = mBuffer.empty() ? NULL : &mBuffer[0];
+	mEnd	= mCursor + mBuffer.size();
+}
+
+bool JSONDocument::GetNextDocument( void )
+{
+	mNodes.clear();
+	if( mFailed )
+		return false;
+
+	SkipWhitespace();
+	if( mCursor == mEnd )
+		return false;
+
+	if( ParseValue( 0 ) == JSONNode::None ) {
+		mFailed = true;
+		mNodes.clear();
+		return false;
+	}
+	return true;
+}
+
+const JSONNode* JSONDocument::GetRoot( void ) const
+{
+	return mNodes.empty() ? NULL : &mNodes[0];
+}
+
+const JSONNode* JSONDocument::GetFirstChild( const JSONNode& node ) const
+{
+	return node.FirstChild == JSONNode::None ? NULL : &mNodes[node.FirstChild];
+}
+
+const JSONNode* JSONDocument::GetNextSibling( const JSONNode& node ) const
+{
+	return node.NextSibling == JSONNode::None ? NULL : &mNodes[node.NextSibling];
+}
+
+const JSONNode* JSONDocument::FindValue( const JSONNode& node, const cbl::Char* key ) const
+{
+	if( node.Type != JSONType::Object )
+		return NULL;
+
+	const size_t length = strlen( key );
+	for( cbl::Uint32 i = node.FirstChild; i != JSONNode::None; i = mNodes[i].NextSibling ) {
+		const JSONNode& child = mNodes[i];
+		if( child.KeyLength == length && memcmp( child.Key, key, length ) == 0 )
+			return &child;
+	}
+	return NULL;
+}
+
+bool JSONDocument::GetScalar( const JSONNode& node, cbl::String& value )
+{
+	if( !node.IsScalar() || node.Type == JSONType::Null )
+		return false;
+
+	value.assign( node.Text, node.Length );
+	return true;
+}
+
+cbl::Uint32 JSONDocument::ParseValue( cbl::Uint32 depth )
+{
+	SkipWhitespace();
+	if( mCursor == mEnd )
+		return Error( "Unexpected end of input." );
+
+	const cbl::Char c = *mCursor;
+	if( c == '{' || c == '[' ) {
+		if( depth >= MaxDepth )
+			return Error( "Maximum nesting depth exceeded." );
+
+		const bool isObject = c == '{';
+		const cbl::Char close = isObject ? '}' : ']';
+		const cbl::Uint32 index = AddNode( isObject ? JSONType::Object : JSONType::Array );
+		cbl::Uint32 prev = JSONNode::None;
+
+		++mCursor;
+		SkipWhitespace();
+		if( mCursor != mEnd && *mCursor == close ) {
+			++mCursor;
+			return index;
+		}
+
+		for( ;; ) {
+			const cbl::Char* key = NULL;
+			cbl::Uint32 keyLength = 0;
+			if( isObject ) {
+				SkipWhitespace();
+				if( mCursor == mEnd || *mCursor != '"' )
+					return Error( "Expected an object key." );
+				if( !ParseString( key, keyLength ) )
+					return JSONNode::None;
+				SkipWhitespace();
+				if( mCursor == mEnd || *mCursor != ':' )
+					return Error( "Expected ':' after an object key." );
+				++mCursor;
+			}
+
+			const cbl::Uint32 child = ParseValue( depth + 1 );
+			if( child == JSONNode::None )
+				return JSONNode::None;
+
+			mNodes[child].Key		= key;
+			mNodes[child].KeyLength	= keyLength;
+			if( prev == JSONNode::None )
+				mNodes[index].FirstChild = child;
+			else
+				mNodes[prev].NextSibling = child;
+			++mNodes[index].ChildCount;
+			prev = child;
+
+			SkipWhitespace();
+			if( mCursor == mEnd )
+				return Error( "Unexpected end of input." );
+			if( *mCursor == ',' ) {
+				++mCursor;
+				continue;
+			}
+			if( *mCursor == close ) {
+				++mCursor;
+				return index;
+			}
+			return Error( isObject ? "Expected ',' or '}'." : "Expected ',' or ']'." );
+		}
+	}
+
+	if( c == '"' ) {
+		const cbl::Uint32 index = AddNode( JSONType::String );
+		const cbl::Char* text = NULL;
+		cbl::Uint32 length = 0;
+		if( !ParseString( text, length ) )
+			return JSONNode::None;
+		mNodes[index].Text		= text;
+		mNodes[index].Length	= length;
+		return index;
+	}
+
+	const cbl::Char* start = mCursor;
+	JSONType::Type type = JSONType::Number;
+	bool valid = false;
+	switch( c ) {
+		case 't':	type = JSONType::Bool; valid = ParseLiteral( "true", 4 ); break;
+		case 'f':	type = JSONType::Bool; valid = ParseLiteral( "false", 5 ); break;
+		case 'n':	type = JSONType::Null; valid = ParseLiteral( "null", 4 ); break;
+		default:	valid = ParseNumber(); break;
+	}
+	if( !valid )
+		return Error( "Invalid value." );
+
+	const cbl::Uint32 index = AddNode( type );
+	mNodes[index].Text		= start;
+	mNodes[index].Length	= cbl::Uint32( mCursor - start );
+	return index;
+}
+
+bool JSONDocument::ParseString( const cbl::Char*& text, cbl::Uint32& length )
+{
+	// Unescaped text is written back over the source; it never outgrows the escapes.
+	++mCursor;
+	cbl::Char* out = mCursor;
+	text = out;
+
+	for( ;; ) {
+		if( mCursor == mEnd ) {
+			Error( "Unterminated string." );
+			return false;
+		}
+
+		cbl::Char c = *mCursor++;
+		if( c == '"' )
+			break;
+		if( (unsigned char)c < 0x20 ) {
+			Error( "Control character in string." );
+			return false;
+		}
+		if( c != '\\' ) {
+			*out++ = c;
+			continue;
+		}
+
+		if( mCursor == mEnd ) {
+			Error( "Unterminated string." );
+			return false;
+		}
+
+		c = *mCursor++;
+		switch( c ) {
+			case '"':	*out++ = '"'; break;
+			case '\\':	*out++ = '\\'; break;
+			case '/':	*out++ = '/'; break;
+			case 'b':	*out++ = '\b'; break;
+			case 'f':	*out++ = '\f'; break;
+			case 'n':	*out++ = '\n'; break;
+			case 'r':	*out++ = '\r'; break;
+			case 't':	*out++ = '\t'; break;
+			case 'u': {
+				cbl::Uint32 code = 0;
+				for( cbl::Uint32 pass = 0; pass < 2; ++pass ) {
+					if( mEnd - mCursor < 4 ) {
+						Error( "Invalid unicode escape." );
+						return false;
+					}
+					cbl::Uint32 unit = 0;
+					for( cbl::Uint32 i = 0; i < 4; ++i ) {
+						cbl::Int32 digit = _hexValue( *mCursor++ );
+						if( digit < 0 ) {
+							Error( "Invalid unicode escape." );
+							return false;
+						}
+						unit = ( unit << 4 ) | cbl::Uint32( digit );
+					}
+
+					if( pass == 1 ) {
+						if( unit < 0xDC00 || unit > 0xDFFF ) {
+							Error( "Invalid unicode surrogate pair." );
+							return false;
+						}
+						code = 0x10000 + ( ( code - 0xD800 ) << 10 ) + ( unit - 0xDC00 );
+						break;
+					}
+
+					code = unit;
+					if( code >= 0xDC00 && code <= 0xDFFF ) {
+						Error( "Invalid unicode surrogate pair." );
+						return false;
+					}
+					if( code < 0xD800 || code > 0xDBFF )
+						break;
+
+					// High surrogate; the low surrogate must follow.
+					if( mEnd - mCursor < 2 || mCursor[0] != '\\' || mCursor[1] != 'u' ) {
+						Error( "Invalid unicode surrogate pair." );
+						return false;
+					}
+					mCursor += 2;
+				}
+
+				if( code < 0x80 ) {
+					*out++ = cbl::Char( code );
+				} else if( code < 0x800 ) {
+					*out++ = cbl::Char( 0xC0 | ( code >> 6 ) );
+					*out++ = cbl::Char( 0x80 | ( code & 0x3F ) );
+				} else if( code < 0x10000 ) {
+					*out++ = cbl::Char( 0xE0 | ( code >> 12 ) );
+					*out++ = cbl::Char( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+					*out++ = cbl::Char( 0x80 | ( code & 0x3F ) );
+				} else {
+					*out++ = cbl::Char( 0xF0 | ( code >> 18 ) );
+					*out++ = cbl::Char( 0x80 | ( ( code >> 12 ) & 0x3F ) );
+					*out++ = cbl::Char( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+					*out++ = cbl::Char( 0x80 | ( code & 0x3F ) );
+				}
+				break;
+			}
+			default:
+				Error( "Invalid escape sequence." );
+				return false;
+		}
+	}
+
+	length = cbl::Uint32( out - text );
+	return true;
+}
+
+bool JSONDocument::ParseNumber( void )
+{
+	if( mCursor != mEnd && *mCursor == '-' )
+		++mCursor;
+
+	if( mCursor == mEnd || !_isDigit( *mCursor ) )
+		return false;
+
+	if( *mCursor == '0' ) {
+		++mCursor;
+	} else {
+		while( mCursor != mEnd && _isDigit( *mCursor ) ) ++mCursor;
+	}
+
+	if( mCursor != mEnd && *mCursor == '.' ) {
+		++mCursor;
+		if( mCursor == mEnd || !_isDigit( *mCursor ) )
+			return false;
+		while( mCursor != mEnd && _isDigit( *mCursor ) ) ++mCursor;
+	}
+
+	if( mCursor != mEnd && ( *mCursor == 'e' || *mCursor == 'E' ) ) {
+		++mCursor;
+		if( mCursor != mEnd && ( *mCursor == '+' || *mCursor == '-' ) )
+			++mCursor;
+		if( mCursor == mEnd || !_isDigit( *mCursor ) )
+			return false;
+		while( mCursor != mEnd && _isDigit( *mCursor ) ) ++mCursor;
+	}
+
+	return true;
+}
+
+bool JSONDocument::ParseLiteral( const cbl::Char* literal, size_t length )
+{
+	if( size_t( mEnd - mCursor ) < length || memcmp( mCursor, literal, length ) != 0 )
+		return false;
+
+	mCursor += length;
+	return true;
+}
+
+cbl::Uint32 JSONDocument::AddNode( JSONType::Type type )
+{
+	JSONNode node;
+	node.Type			= type;
+	node.Key			= NULL;
+	node.KeyLength		= 0;
+	node.Text			= NULL;
+	node.Length			= 0;
+	node.ChildCount		= 0;
+	node.FirstChild		= JSONNode::None;
+	node.NextSibling	= JSONNode::None;
+	mNodes.push_back( node );
+	return cbl::Uint32( mNodes.size() - 1 );
+}
+
+void JSONDocument::SkipWhitespace( void )
+{
+	while( mCursor != mEnd && ( *mCursor == ' ' || *mCursor == '\n' || *mCursor == '\r' || *mCursor == '\t' ) )
+		++mCursor;
+}
+
+cbl::Uint32 JSONDocument::Error( const cbl::Char* message )
+{
+	const size_t offset = mBuffer.empty() ? 0 : size_t( mCursor - &mBuffer[0] );
+	LOG_ERROR( "JSON parse error at offset " << offset << ": " << message );
+	mFailed = true;
+	return JSONNode::None;
+}
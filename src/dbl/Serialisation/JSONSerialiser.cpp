@@ -0,0 +1,320 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file JSONSerialiser.cpp
+ * @brief JSON serialiser.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Serialisation/JSONSerialiser.h"
+#include "dbl/Serialisation/BlockSerialisation.h"
+#include "dbl/Serialisation/PrefabCache.h"
+
+// External Libraries //
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+using namespace dbl;
+
+typedef cbl::Serialiser::StreamPtr StreamPtr;
+
+bool _isJSONNumber( const cbl::Char* text, size_t length )
+{
+	const cbl::Char* c = text;
+	const cbl::Char* end = text + length;
+
+	if( c != end && *c == '-' ) ++c;
+	if( c == end || *c < '0' || *c > '9' ) return false;
+	if( *c == '0' ) ++c;
+	else while( c != end && *c >= '0' && *c <= '9' ) ++c;
+
+	if( c != end && *c == '.' ) {
+		++c;
+		if( c == end || *c < '0' || *c > '9' ) return false;
+		while( c != end && *c >= '0' && *c <= '9' ) ++c;
+	}
+
+	if( c != end && ( *c == 'e' || *c == 'E' ) ) {
+		++c;
+		if( c != end && ( *c == '+' || *c == '-' ) ) ++c;
+		if( c == end || *c < '0' || *c > '9' ) return false;
+		while( c != end && *c >= '0' && *c <= '9' ) ++c;
+	}
+
+	return c == end;
+}
+
+void _writeScalar( JSONWriter& w, const cbl::String& value )
+{
+	// Numbers and booleans are written bare so other tools see typed values.
+	// The text is preserved either way, so this is lossless for strings too.
+	if( _isJSONNumber( value.c_str(), value.length() ) || value == "true" || value == "false" )
+		w.Raw( value.c_str(), value.length() );
+	else
+		w.String( value );
+}
+
+template< typename T, typename CAST >
+void _writeNumbers( JSONWriter& w, const void* data, size_t count, const char* format )
+{
+	char buffer[32];
+	const T* values = static_cast<const T*>( data );
+	for( size_t i = 0; i < count; ++i ) {
+		int length = sprintf( buffer, format, CAST( values[i] ) );
+		w.Raw( buffer, size_t( length ) );
+	}
+}
+
+template< typename T >
+void _writeReals( JSONWriter& w, const void* data, size_t count, const char* format )
+{
+	char buffer[32];
+	const T* values = static_cast<const T*>( data );
+	for( size_t i = 0; i < count; ++i ) {
+		const cbl::Float64 value = cbl::Float64( values[i] );
+		// JSON has no representation for NaN or infinity, so write them as null like JSONWriter::Real.
+		if( value != value || value - value != 0.0 ) {
+			w.Null();
+			continue;
+		}
+		int length = sprintf( buffer, format, value );
+		w.Raw( buffer, size_t( length ) );
+	}
+}
+
+void _writeBlock( JSONWriter& w, const BlockField& block, const void* owner )
+{
+	size_t count = block.GetCount( owner );
+	const void* data = block.GetData( owner );
+
+	if( block.Format == BlockFormat::Raw ) {
+		cbl::String encoded;
+		BlockFields::EncodeBase64( data, count * block.ElementSize, encoded );
+		w.String( encoded );
+		return;
+	}
+
+	w.BeginArray();
+	switch( block.Format ) {
+		case BlockFormat::Int8:		_writeNumbers<cbl::Int8, cbl::Int32>( w, data, count, "%d" ); break;
+		case BlockFormat::Uint8:	_writeNumbers<cbl::Uint8, cbl::Uint32>( w, data, count, "%u" ); break;
+		case BlockFormat::Int16:	_writeNumbers<cbl::Int16, cbl::Int32>( w, data, count, "%d" ); break;
+		case BlockFormat::Uint16:	_writeNumbers<cbl::Uint16, cbl::Uint32>( w, data, count, "%u" ); break;
+		case BlockFormat::Int32:	_writeNumbers<cbl::Int32, cbl::Int32>( w, data, count, "%d" ); break;
+		case BlockFormat::Uint32:	_writeNumbers<cbl::Uint32, cbl::Uint32>( w, data, count, "%u" ); break;
+		case BlockFormat::Int64:	_writeNumbers<cbl::Int64, cbl::Int64>( w, data, count, "%lld" ); break;
+		case BlockFormat::Uint64:	_writeNumbers<cbl::Uint64, cbl::Uint64>( w, data, count, "%llu" ); break;
+		case BlockFormat::Float32:	_writeReals<cbl::Float32>( w, data, count, "%.9g" ); break;
+		case BlockFormat::Float64:	_writeReals<cbl::Float64>( w, data, count, "%.17g" ); break;
+		default: break;
+	}
+	w.EndArray();
+}
+
+JSONSerialiser::JSONSerialiser()
+: mTraverseCount( 0 )
+, mBlockField( NULL )
+{
+}
+
+void JSONSerialiser::OnOutput( StreamPtr s, const cbl::Char* filename )
+{
+	std::ofstream file;
+	file.open( filename, std::ios_base::binary );
+
+	if( !file.is_open() ) {
+		LOG_ERROR( "Unable to write to file: " << filename );
+		return;
+	}
+
+	const cbl::String& json = (*(JSONWriter*)s).GetString();
+	file.write( json.c_str(), json.size() );
+
+	file.close();
+	return;
+}
+
+StreamPtr JSONSerialiser::Initialise( StreamPtr s, const cbl::Type*, const void* )
+{
+	return s;
+}
+
+StreamPtr JSONSerialiser::Shutdown( StreamPtr s, const cbl::Type*, const void* )
+{
+	for( cbl::Uint32 i = 0; i < mTraverseCount; ++i )
+		(*(JSONWriter*)s).EndObject();
+
+	mTraverseCount = 0;
+	return s;
+}
+
+StreamPtr JSONSerialiser::TraverseStream( StreamPtr s, const cbl::Char* path )
+{
+	if( !s ) {
+		LOG_ERROR( "Unable to traverse stream. No stream set." );
+		return NULL;
+	}
+
+	(*(JSONWriter*)s)
+		.BeginObject()
+		.Key( path );
+
+	++mTraverseCount;
+	return s;
+}
+
+StreamPtr JSONSerialiser::BeginContainerEntry( StreamPtr s, const cbl::Type* keyType, const cbl::Type* )
+{
+	if( keyType )
+		(*(JSONWriter*)s).BeginObject();
+
+	return s;
+}
+
+void JSONSerialiser::EndContainerEntry( StreamPtr s, const cbl::Type* keyType, const cbl::Type* )
+{
+	if( keyType )
+		(*(JSONWriter*)s).EndObject();
+}
+
+StreamPtr JSONSerialiser::BeginContainerKey( StreamPtr s, const cbl::Type* )
+{
+	(*(JSONWriter*)s).Key( "Key" );
+	return s;
+}
+
+void JSONSerialiser::EndContainerKey( StreamPtr, const cbl::Type* )
+{
+}
+
+StreamPtr JSONSerialiser::BeginContainerValue( StreamPtr s, const cbl::Type* keyType, const cbl::Type* )
+{
+	if( keyType )
+		(*(JSONWriter*)s).Key( "Value" );
+
+	return s;
+}
+
+void JSONSerialiser::EndContainerValue( StreamPtr, const cbl::Type*, const cbl::Type* )
+{
+}
+
+StreamPtr JSONSerialiser::BeginValue( StreamPtr s, const cbl::Type* type, const void* obj, const cbl::FieldAttr* attr, cbl::Entity::OPTIONS, bool outputType )
+{
+	JSONWriter& w = (*(JSONWriter*)s);
+	mCurrentValue = FieldOwner( type, obj );
+
+	if( outputType ) {
+		w.BeginObject()
+			.Key( "$type" ).String( type->Name.Text )
+			.Key( "$value" );
+	}
+
+	if( type->ToString ) {
+		cbl::String tempValue;
+		type->ToString( tempValue, type, obj, attr );
+		_writeScalar( w, tempValue );
+		return NULL;
+	}
+
+	return s;
+}
+
+void JSONSerialiser::EndValue( StreamPtr s, const cbl::Type* type, const void*, const cbl::FieldAttr*, cbl::Entity::OPTIONS opt, bool outputType )
+{
+	JSONWriter& w = (*(JSONWriter*)s);
+
+	if( ( !type->HasFields() || opt == cbl::Entity::O_IGNORE_FIELDS ) && type->ToString == NULL )
+		w.Null();
+
+	if( outputType )
+		w.EndObject();
+}
+
+StreamPtr JSONSerialiser::BeginFields( StreamPtr s )
+{
+	mFieldOwners.push_back( mCurrentValue );
+	(*(JSONWriter*)s).BeginObject();
+	return s;
+}
+
+void JSONSerialiser::EndFields( StreamPtr s )
+{
+	mFieldOwners.pop_back();
+	(*(JSONWriter*)s).EndObject();
+}
+
+StreamPtr JSONSerialiser::BeginField( StreamPtr s, const cbl::Field* field )
+{
+	JSONWriter& w = (*(JSONWriter*)s);
+	w.Key( field->Name.Text );
+
+	// Containers of plain data are written in one go instead of entry by entry.
+	if( field->Container && !mFieldOwners.empty() ) {
+		const FieldOwner& owner = mFieldOwners.back();
+		if( const BlockField* block = BlockFields::Find( owner.first, field ) ) {
+			_writeBlock( w, *block, owner.second );
+			mBlockField = field;
+			return NULL;
+		}
+	}
+
+	if( field->Container )
+		w.BeginArray();
+
+	return s;
+}
+
+void JSONSerialiser::EndField( StreamPtr s, const cbl::Field* field )
+{
+	if( field == mBlockField ) {
+		mBlockField = NULL;
+		return;
+	}
+
+	if( field->Container )
+		(*(JSONWriter*)s).EndArray();
+}
+
+void JSONSerialiser::OnStreamSet( void )
+{
+}
+
+template<>
+void cbl::ObjectManager::SaveObjectToFile<dbl::JSONSerialiser>( const cbl::Char* file, cbl::ObjectPtr obj ) const
+{
+	if( !obj ) {
+		LOG_ERROR( "No object to write to JSON file: " << file );
+		return;
+	}
+
+	JSONWriter w;
+	JSONSerialiser js;
+	js
+		.SetStream( w )
+		.Serialise( *obj );
+	js.Output( file );
+	PrefabCache::Invalidate( file );
+
+	LOG( "Object (" << obj->GetName() << ") saved to file: " << file );
+}
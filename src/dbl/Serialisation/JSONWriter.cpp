@@ -0,0 +1,204 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file JSONWriter.cpp
+ * @brief Streaming JSON writer.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Serialisation/JSONWriter.h"
+
+// External Libraries //
+#include <cstdio>
+#include <cstring>
+
+using namespace dbl;
+
+JSONWriter::JSONWriter()
+: mAfterKey( false )
+{
+}
+
+JSONWriter& JSONWriter::BeginObject( void )
+{
+	BeginValue();
+	mBuffer += '{';
+	mScopes.push_back( false );
+	return *this;
+}
+
+JSONWriter& JSONWriter::EndObject( void )
+{
+	CBL_ASSERT_TRUE( !mScopes.empty() );
+	mScopes.pop_back();
+	mBuffer += '}';
+	EndValue();
+	return *this;
+}
+
+JSONWriter& JSONWriter::BeginArray( void )
+{
+	BeginValue();
+	mBuffer += '[';
+	mScopes.push_back( false );
+	return *this;
+}
+
+JSONWriter& JSONWriter::EndArray( void )
+{
+	CBL_ASSERT_TRUE( !mScopes.empty() );
+	mScopes.pop_back();
+	mBuffer += ']';
+	EndValue();
+	return *this;
+}
+
+JSONWriter& JSONWriter::Key( const cbl::Char* key )
+{
+	BeginValue();
+	WriteString( key, strlen( key ) );
+	mBuffer += ':';
+	mAfterKey = true;
+	return *this;
+}
+
+JSONWriter& JSONWriter::String( const cbl::Char* str, size_t length )
+{
+	BeginValue();
+	WriteString( str, length );
+	EndValue();
+	return *this;
+}
+
+JSONWriter& JSONWriter::String( const cbl::Char* str )
+{
+	return String( str, strlen( str ) );
+}
+
+JSONWriter& JSONWriter::Int( cbl::Int64 value )
+{
+	char buffer[32];
+	int length = sprintf( buffer, "%lld", (long long)value );
+	return Raw( buffer, size_t( length ) );
+}
+
+JSONWriter& JSONWriter::Uint( cbl::Uint64 value )
+{
+	char buffer[32];
+	int length = sprintf( buffer, "%llu", (unsigned long long)value );
+	return Raw( buffer, size_t( length ) );
+}
+
+JSONWriter& JSONWriter::Real( cbl::Float64 value )
+{
+	// JSON has no representation for NaN or infinity.
+	if( value != value || value - value != 0.0 )
+		return Null();
+
+	char buffer[32];
+	int length = sprintf( buffer, "%.17g", value );
+	return Raw( buffer, size_t( length ) );
+}
+
+JSONWriter& JSONWriter::Bool( bool value )
+{
+	return value ? Raw( "true", 4 ) : Raw( "false", 5 );
+}
+
+JSONWriter& JSONWriter::Null( void )
+{
+	return Raw( "null", 4 );
+}
+
+JSONWriter& JSONWriter::Raw( const cbl::Char* json, size_t length )
+{
+	BeginValue();
+	mBuffer.append( json, length );
+	EndValue();
+	return *this;
+}
+
+void JSONWriter::Clear( void )
+{
+	mBuffer.clear();
+	mScopes.clear();
+	mAfterKey = false;
+}
+
+void JSONWriter::BeginValue( void )
+{
+	if( mAfterKey ) {
+		mAfterKey = false;
+		return;
+	}
+
+	if( !mScopes.empty() ) {
+		if( mScopes.back() )
+			mBuffer += ',';
+		mScopes.back() = true;
+	}
+}
+
+void JSONWriter::EndValue( void )
+{
+	if( mScopes.empty() )
+		mBuffer += '\n';
+}
+
+void JSONWriter::WriteString( const cbl::Char* str, size_t length )
+{
+	static const cbl::Char sHex[] = "0123456789abcdef";
+
+	mBuffer.reserve( mBuffer.size() + length + 2 );
+	mBuffer += '"';
+
+	// Copy runs of characters that need no escaping in one go.
+	const cbl::Char* run = str;
+	const cbl::Char* end = str + length;
+	for( const cbl::Char* c = str; c != end; ++c ) {
+		unsigned char ch = (unsigned char)*c;
+		if( ch >= 0x20 && ch != '"' && ch != '\\' )
+			continue;
+
+		mBuffer.append( run, c - run );
+		run = c + 1;
+
+		mBuffer += '\\';
+		switch( ch ) {
+			case '"':	mBuffer += '"'; break;
+			case '\\':	mBuffer += '\\'; break;
+			case '\n':	mBuffer += 'n'; break;
+			case '\r':	mBuffer += 'r'; break;
+			case '\t':	mBuffer += 't'; break;
+			case '\b':	mBuffer += 'b'; break;
+			case '\f':	mBuffer += 'f'; break;
+			default:
+				mBuffer += "u00";
+				mBuffer += sHex[ch >> 4];
+				mBuffer += sHex[ch & 0xF];
+				break;
+		}
+	}
+	mBuffer.append( run, end - run );
+
+	mBuffer += '"';
+}
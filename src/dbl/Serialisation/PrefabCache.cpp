@@ -0,0 +1,142 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file PrefabCache.cpp
+ * @brief Object template cache for file loaded objects.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Serialisation/PrefabCache.h"
+
+// Chewable Headers //
+#include "cbl/Serialisation/BinaryDeserialiser.h"
+#include "cbl/Serialisation/BinarySerialiser.h"
+
+// External Libraries //
+#include <fstream>
+#include <sstream>
+
+using namespace dbl;
+
+PrefabCache::EntryMap PrefabCache::sEntries;
+bool PrefabCache::sEnabled = true;
+
+//! Hash a file's contents (64-bit FNV-1a).
+bool _hashFile( const cbl::Char* file, cbl::Uint64& hash, cbl::Uint64& size )
+{
+	std::ifstream is( file, std::ios_base::in | std::ios_base::binary );
+	if( !is.is_open() )
+		return false;
+
+	hash = 14695981039346656037ULL;
+	size = 0;
+	char chunk[4096];
+	while( is.read( chunk, sizeof( chunk ) ) || is.gcount() > 0 ) {
+		const std::streamsize read = is.gcount();
+		for( std::streamsize i = 0; i < read; ++i ) {
+			hash ^= cbl::Uint8( chunk[i] );
+			hash *= 1099511628211ULL;
+		}
+		size += cbl::Uint64( read );
+	}
+	return true;
+}
+
+void PrefabCache::SetEnabled( bool enabled )
+{
+	sEnabled = enabled;
+	if( !sEnabled )
+		Clear();
+}
+
+bool PrefabCache::Instantiate( const cbl::Char* file, cbl::ObjectPtr& obj )
+{
+	const Entry* entry = Find( file );
+	if( !entry )
+		return false;
+
+	std::istringstream is( entry->Image, std::ios_base::binary );
+	cbl::BinaryDeserialiser bd;
+	bd.SetStream( is );
+
+	obj = NULL;
+	if( !bd.DeserialisePtr( obj ) ) {
+		LOG_ERROR( "Unable to clone object from cached file: " << file );
+		Invalidate( file );
+		return false;
+	}
+	return true;
+}
+
+void PrefabCache::Store( const cbl::Char* file, const cbl::Object& obj )
+{
+	if( !sEnabled )
+		return;
+
+	Entry entry;
+	if( !_hashFile( file, entry.Hash, entry.Size ) )
+		return;
+
+	std::ostringstream os( std::ios_base::binary );
+	cbl::BinarySerialiser bs;
+	bs.SetStream( os );
+	bs.Serialise( obj );
+
+	entry.Image = os.str();
+	sEntries[file] = entry;
+}
+
+bool PrefabCache::IsCached( const cbl::Char* file )
+{
+	return Find( file ) != NULL;
+}
+
+void PrefabCache::Invalidate( const cbl::Char* file )
+{
+	sEntries.erase( file );
+}
+
+void PrefabCache::Clear( void )
+{
+	sEntries.clear();
+}
+
+const PrefabCache::Entry* PrefabCache::Find( const cbl::Char* file )
+{
+	if( !sEnabled || sEntries.empty() )
+		return NULL;
+
+	EntryMap::iterator found = sEntries.find( file );
+	if( found == sEntries.end() )
+		return NULL;
+
+	// Timestamps are too coarse to catch an edit made straight after the last one, so compare contents.
+	cbl::Uint64 hash = 0, size = 0;
+	if( !_hashFile( file, hash, size ) ||
+		hash != found->second.Hash ||
+		size != found->second.Size ) {
+		sEntries.erase( found );
+		return NULL;
+	}
+
+	return &found->second;
+}
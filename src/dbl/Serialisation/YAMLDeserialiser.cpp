@@ -26,17 +26,80 @@
 
 // Delectable Headers//
 #include "dbl/Serialisation/YAMLDeserialiser.h"
+#include "dbl/Serialisation/BlockSerialisation.h"
+#include "dbl/Serialisation/PrefabCache.h"
+#include "dbl/Serialisation/YAMLStaticCodec.h"
 
 // External Libraries //
 #include "yaml-cpp/yaml.h"
+#include <cstdio>
+#include <cstring>
 
 using namespace dbl;
 
 typedef cbl::Deserialiser::StreamPtr StreamPtr;
 
+template< typename T, typename PARSE >
+bool _readNumbers( const YAML::Node& node, void* data, const char* format )
+{
+	T* values = static_cast<T*>( data );
+	cbl::String scalar;
+	size_t i = 0;
+	for( YAML::Iterator it = node.begin(); it != node.end(); ++it, ++i ) {
+		PARSE value = PARSE();
+		if( !(*it).GetScalar( scalar ) || sscanf( scalar.c_str(), format, &value ) != 1 )
+			return false;
+		values[i] = T( value );
+	}
+	return true;
+}
+
+bool _readBlock( const YAML::Node& node, const BlockField& block, void* owner )
+{
+	if( node.Type() == YAML::NodeType::Scalar ) {
+		cbl::String encoded;
+		std::vector<cbl::Uint8> decoded;
+		if( !node.GetScalar( encoded ) ||
+			!BlockFields::DecodeBase64( encoded.c_str(), encoded.length(), decoded ) ||
+			decoded.size() % block.ElementSize != 0 )
+			return false;
+
+		void* data = block.Resize( owner, decoded.size() / block.ElementSize );
+		if( !decoded.empty() )
+			memcpy( data, &decoded[0], decoded.size() );
+		return true;
+	}
+
+	if( node.Type() != YAML::NodeType::Sequence || block.Format == BlockFormat::Raw )
+		return false;
+
+	void* data = block.Resize( owner, node.size() );
+	switch( block.Format ) {
+		case BlockFormat::Int8:		return _readNumbers<cbl::Int8, cbl::Int32>( node, data, "%d" );
+		case BlockFormat::Uint8:	return _readNumbers<cbl::Uint8, cbl::Uint32>( node, data, "%u" );
+		case BlockFormat::Int16:	return _readNumbers<cbl::Int16, cbl::Int32>( node, data, "%d" );
+		case BlockFormat::Uint16:	return _readNumbers<cbl::Uint16, cbl::Uint32>( node, data, "%u" );
+		case BlockFormat::Int32:	return _readNumbers<cbl::Int32, cbl::Int32>( node, data, "%d" );
+		case BlockFormat::Uint32:	return _readNumbers<cbl::Uint32, cbl::Uint32>( node, data, "%u" );
+		case BlockFormat::Int64:	return _readNumbers<cbl::Int64, cbl::Int64>( node, data, "%lld" );
+		case BlockFormat::Uint64:	return _readNumbers<cbl::Uint64, cbl::Uint64>( node, data, "%llu" );
+		case BlockFormat::Float32:	return _readNumbers<cbl::Float32, cbl::Float64>( node, data, "%lf" );
+		case BlockFormat::Float64:	return _readNumbers<cbl::Float64, cbl::Float64>( node, data, "%lf" );
+		default: break;
+	}
+	return false;
+}
+
 YAMLDeserialiser::YAMLDeserialiser()
 : mHasDocument( false )
+, mStaticCodecs( true )
+{
+}
+
+YAMLDeserialiser& YAMLDeserialiser::SetStaticCodecsEnabled( bool enabled )
 {
+	mStaticCodecs = enabled;
+	return *this;
 }
 
 bool YAMLDeserialiser::IsStreamEnded( void ) const
@@ -119,6 +182,15 @@ StreamPtr YAMLDeserialiser::GetContainerValueStream( StreamPtr s, bool hasKey )
 
 StreamPtr YAMLDeserialiser::BeginValue( StreamPtr s, const cbl::Type* type, void * obj, const cbl::FieldAttr* attr )
 {
+	mCurrentValue = FieldOwner( type, obj );
+
+	if( mStaticCodecs ) {
+		if( const YAMLStaticCodec* codec = YAMLStaticCodecs::Find( type ) ) {
+			codec->Read( *((YAML::Node*)s), obj );
+			return NULL; // Generated routine handled the value.
+		}
+	}
+
 	if( type->FromString ) {
 		cbl::String value;
 		if( ((YAML::Node*)s)->GetScalar( value ) ) {
@@ -135,17 +207,30 @@ void YAMLDeserialiser::EndValue( StreamPtr, const cbl::Type*, void *, const cbl:
 
 StreamPtr YAMLDeserialiser::BeginFields( StreamPtr s )
 {
+	mFieldOwners.push_back( mCurrentValue );
 	return s;
 }
 
 void YAMLDeserialiser::EndFields( StreamPtr )
 {
+	mFieldOwners.pop_back();
 }
 
 StreamPtr YAMLDeserialiser::BeginField( StreamPtr s, const cbl::Field* field )
 {
 	try {
 		YAML::Node* node = const_cast<YAML::Node*>(((YAML::Node*)s)->FindValue( field->Name.Text ));
+
+		// Containers of plain data are read in one go instead of entry by entry.
+		if( node && field->Container && !mFieldOwners.empty() ) {
+			const FieldOwner& owner = mFieldOwners.back();
+			if( const BlockField* block = BlockFields::Find( owner.first, field ) ) {
+				if( !_readBlock( *node, *block, owner.second ) )
+					LOG_ERROR( "Field container (" << field->Name.Text << ") is not a valid data block." );
+				return NULL;
+			}
+		}
+
 		if( node && field->Container ) {
 			if( node->Type() == YAML::NodeType::Sequence ) {
 				mBeginIt	= node->begin();
@@ -177,28 +262,38 @@ void YAMLDeserialiser::OnStreamSet( void )
 template<>
 cbl::ObjectPtr cbl::ObjectManager::LoadObjectFromFile<YAMLDeserialiser>( const cbl::Char* file, const cbl::Char* name, bool init )
 {
-	std::ifstream fs;
-	fs.open( file, std::ios_base::binary );
+	ObjectPtr newObj = NULL;
 
-	if( !fs.is_open() ) {
-		LOG_ERROR( "Unable to open object file for reading: " << file );
-		return NULL;
-	}
+	// Clone from the cached template if the file hasn't changed since it was parsed.
+	bool success = PrefabCache::Instantiate( file, newObj );
+	if( !success ) {
+		std::ifstream fs;
+		fs.open( file, std::ios_base::binary );
 
-	YAML::Parser parser;
+		if( !fs.is_open() ) {
+			LOG_ERROR( "Unable to open object file for reading: " << file );
+			return NULL;
+		}
+
+		YAML::Parser parser;
+
+		try { parser.Load( fs ); }
+		catch( const YAML::Exception& e ) {
+			LOG_ERROR( e.what() );
+			fs.close();
+			return NULL;
+		}
+
+		YAMLDeserialiser yd;
+		yd.SetStream( parser );
+
+		success = yd.DeserialisePtr( newObj );
+		if( success )
+			PrefabCache::Store( file, *newObj );
 
-	try { parser.Load( fs ); }
-	catch( const YAML::Exception& e ) {
-		LOG_ERROR( e.what() );
 		fs.close();
-		return NULL;
 	}
 
-	YAMLDeserialiser yd;
-	yd.SetStream( parser );
-
-	ObjectPtr newObj = NULL;
-	bool success = yd.DeserialisePtr( newObj );
 	if( success ) {
 		if( name ) newObj->mName = name;
 		success = Add( newObj );
@@ -214,10 +309,8 @@ cbl::ObjectPtr cbl::ObjectManager::LoadObjectFromFile<YAMLDeserialiser>( const c
 		LOG_ERROR( "Unable to deserialise from binary file: " << file );
 	}
 
-	fs.close();
-
 	if( init )
 		InitObject( newObj );
 
 	return newObj;
-}
\ No newline at end of file
+}
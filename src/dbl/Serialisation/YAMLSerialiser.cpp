@@ -26,21 +26,73 @@
 
 // Delectable Headers //
 #include "dbl/Serialisation/YAMLSerialiser.h"
+#include "dbl/Serialisation/BlockSerialisation.h"
+#include "dbl/Serialisation/PrefabCache.h"
+#include "dbl/Serialisation/YAMLStaticCodec.h"
 
 // External Libraries //
 #include <yaml-cpp/yaml.h>
 #include <fstream>
+#include <cstdio>
 
 using namespace dbl;
 
 typedef cbl::Serialiser::StreamPtr StreamPtr;
 
+template< typename T, typename CAST >
+void _writeNumbers( YAML::Emitter& e, const void* data, size_t count, const char* format )
+{
+	char buffer[32];
+	const T* values = static_cast<const T*>( data );
+	for( size_t i = 0; i < count; ++i ) {
+		sprintf( buffer, format, CAST( values[i] ) );
+		e << buffer;
+	}
+}
+
+void _writeBlock( YAML::Emitter& e, const BlockField& block, const void* owner )
+{
+	size_t count = block.GetCount( owner );
+	const void* data = block.GetData( owner );
+
+	if( block.Format == BlockFormat::Raw ) {
+		cbl::String encoded;
+		BlockFields::EncodeBase64( data, count * block.ElementSize, encoded );
+		e << encoded;
+		return;
+	}
+
+	e << YAML::Flow << YAML::BeginSeq;
+	switch( block.Format ) {
+		case BlockFormat::Int8:		_writeNumbers<cbl::Int8, cbl::Int32>( e, data, count, "%d" ); break;
+		case BlockFormat::Uint8:	_writeNumbers<cbl::Uint8, cbl::Uint32>( e, data, count, "%u" ); break;
+		case BlockFormat::Int16:	_writeNumbers<cbl::Int16, cbl::Int32>( e, data, count, "%d" ); break;
+		case BlockFormat::Uint16:	_writeNumbers<cbl::Uint16, cbl::Uint32>( e, data, count, "%u" ); break;
+		case BlockFormat::Int32:	_writeNumbers<cbl::Int32, cbl::Int32>( e, data, count, "%d" ); break;
+		case BlockFormat::Uint32:	_writeNumbers<cbl::Uint32, cbl::Uint32>( e, data, count, "%u" ); break;
+		case BlockFormat::Int64:	_writeNumbers<cbl::Int64, cbl::Int64>( e, data, count, "%lld" ); break;
+		case BlockFormat::Uint64:	_writeNumbers<cbl::Uint64, cbl::Uint64>( e, data, count, "%llu" ); break;
+		case BlockFormat::Float32:	_writeNumbers<cbl::Float32, cbl::Float64>( e, data, count, "%.9g" ); break;
+		case BlockFormat::Float64:	_writeNumbers<cbl::Float64, cbl::Float64>( e, data, count, "%.17g" ); break;
+		default: break;
+	}
+	e << YAML::EndSeq;
+}
+
 YAMLSerialiser::YAMLSerialiser()
 : mInlineContainer( false )
+, mStaticCodecs( true )
 , mTraverseCount( 0 )
+, mBlockField( NULL )
 {
 }
 
+YAMLSerialiser& YAMLSerialiser::SetStaticCodecsEnabled( bool enabled )
+{
+	mStaticCodecs = enabled;
+	return *this;
+}
+
 void YAMLSerialiser::OnOutput( StreamPtr s, const cbl::Char* filename )
 {
 	std::ofstream file;
@@ -146,9 +198,18 @@ void YAMLSerialiser::EndContainerValue( StreamPtr, const cbl::Type*, const cbl::
 
 StreamPtr YAMLSerialiser::BeginValue( StreamPtr s, const cbl::Type* type, const void* obj, const cbl::FieldAttr* attr, cbl::Entity::OPTIONS, bool outputType )
 {
+	mCurrentValue = FieldOwner( type, obj );
+
 	if( outputType )
 		(*(YAML::Emitter*)s) << YAML::LocalTag( type->Name.Text );
 
+	if( mStaticCodecs ) {
+		if( const YAMLStaticCodec* codec = YAMLStaticCodecs::Find( type ) ) {
+			codec->Write( (*(YAML::Emitter*)s), obj );
+			return NULL;
+		}
+	}
+
 	if( type->ToString ) {
 		cbl::String tempValue;
 		type->ToString( tempValue, type, obj, attr );
@@ -168,6 +229,8 @@ void YAMLSerialiser::EndValue( StreamPtr s, const cbl::Type* type, const void*,
 
 StreamPtr YAMLSerialiser::BeginFields( StreamPtr s )
 {
+	mFieldOwners.push_back( mCurrentValue );
+
 	(*(YAML::Emitter*)s)
 		<< YAML::BeginMap;
 
@@ -176,6 +239,8 @@ StreamPtr YAMLSerialiser::BeginFields( StreamPtr s )
 
 void YAMLSerialiser::EndFields( StreamPtr s )
 {
+	mFieldOwners.pop_back();
+
 	(*(YAML::Emitter*)s)
 		<< YAML::EndMap;
 }
@@ -186,6 +251,16 @@ StreamPtr YAMLSerialiser::BeginField( StreamPtr s, const cbl::Field* field )
 		<< YAML::Key << field->Name.Text
 		<< YAML::Value;
 
+	// Containers of plain data are written in one go instead of entry by entry.
+	if( field->Container && !mFieldOwners.empty() ) {
+		const FieldOwner& owner = mFieldOwners.back();
+		if( const BlockField* block = BlockFields::Find( owner.first, field ) ) {
+			_writeBlock( (*(YAML::Emitter*)s), *block, owner.second );
+			mBlockField = field;
+			return NULL;
+		}
+	}
+
 	if( field->Container ) {
 		(*(YAML::Emitter*)s)
 			<< YAML::BeginSeq;
@@ -198,6 +273,11 @@ StreamPtr YAMLSerialiser::BeginField( StreamPtr s, const cbl::Field* field )
 
 void YAMLSerialiser::EndField( StreamPtr s, const cbl::Field* field )
 {
+	if( field == mBlockField ) {
+		mBlockField = NULL;
+		return;
+	}
+
 	if( field->Container ) {
 		(*(YAML::Emitter*)s)
 			<< YAML::EndSeq;
@@ -231,6 +311,7 @@ void cbl::ObjectManager::SaveObjectToFile<dbl::YAMLSerialiser>( const cbl::Char*
 		.SetStream( e )
 		.Serialise( *obj );
 	ys.Output( file );
+	PrefabCache::Invalidate( file );
 
 	LOG( "Object (" << obj->GetName() << ") saved to file: " << file );
 }
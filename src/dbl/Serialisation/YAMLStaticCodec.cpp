@@ -0,0 +1,73 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file YAMLStaticCodec.cpp
+ * @brief Compile-time generated YAML serialisation routines.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Serialisation/YAMLStaticCodec.h"
+
+using namespace dbl;
+
+const YAMLStaticCodec* YAMLStaticCodecs::Find( const cbl::Type* type )
+{
+	const CodecMap& codecs = GetCodecs();
+	if( codecs.empty() || !type )
+		return NULL;
+
+	CodecMap::const_iterator found = codecs.find( type );
+	if( found == codecs.end() )
+		return NULL;
+
+	// The type database may have been rebuilt since registration.
+	if( !( found->second.Name == type->Name ) )
+		return NULL;
+
+	return &found->second;
+}
+
+void YAMLStaticCodecs::Clear( void )
+{
+	GetCodecs().clear();
+}
+
+void YAMLStaticCodecs::Add( const cbl::CName& name, YAMLStaticCodec::WriteFunc write, YAMLStaticCodec::ReadFunc read )
+{
+	const cbl::Type* type = CBL_ENT.Types.Get( name );
+	if( !type ) {
+		LOG_ERROR( "Unable to register static codec. Type (" << name.Text << ") is not registered." );
+		return;
+	}
+
+	YAMLStaticCodec codec;
+	codec.Name	= name;
+	codec.Write	= write;
+	codec.Read	= read;
+	GetCodecs()[type] = codec;
+}
+
+YAMLStaticCodecs::CodecMap& YAMLStaticCodecs::GetCodecs( void )
+{
+	static CodecMap codecs;
+	return codecs;
+}
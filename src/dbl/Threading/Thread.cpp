@@ -0,0 +1,135 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Thread.cpp
+ * @brief Native thread wrapper.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Threading/Thread.h"
+
+// Chewable Headers //
+#include <cbl/Debug/Assert.h>
+#include <cbl/Debug/Logging.h>
+
+// External Libraries //
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+using namespace dbl;
+
+void Thread::Sleep( cbl::Uint32 milliseconds )
+{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	::Sleep( DWORD( milliseconds ) );
+#else
+	timespec ts;
+	ts.tv_sec	= milliseconds / 1000;
+	ts.tv_nsec	= long( milliseconds % 1000 ) * 1000000L;
+	nanosleep( &ts, NULL );
+#endif
+}
+
+cbl::Uint64 Thread::GetCurrentId( void )
+{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	return cbl::Uint64( ::GetCurrentThreadId() );
+#else
+	return cbl::Uint64( pthread_self() );
+#endif
+}
+
+Thread::Thread()
+: mHandle( NULL )
+, mFunction( NULL )
+, mArg( NULL )
+{
+}
+
+Thread::~Thread()
+{
+	CBL_ASSERT( mHandle == NULL, "Thread was destroyed while still running!" );
+}
+
+bool Thread::Start( Function function, void * arg )
+{
+	if( mHandle )
+		return false;
+
+	mFunction	= function;
+	mArg		= arg;
+
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	mHandle = reinterpret_cast< void * >( _beginthreadex( NULL, 0, &Thread::Entry, this, 0, NULL ) );
+#else
+	pthread_t* thread = new pthread_t;
+	if( pthread_create( thread, NULL, &Thread::Entry, this ) == 0 )
+		mHandle = thread;
+	else
+		delete thread;
+#endif
+
+	if( !mHandle ) {
+		LOG_ERROR( "Unable to create thread." );
+		return false;
+	}
+
+	return true;
+}
+
+void Thread::Join( void )
+{
+	if( !mHandle )
+		return;
+
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	::WaitForSingleObject( mHandle, INFINITE );
+	::CloseHandle( mHandle );
+#else
+	pthread_t* thread = static_cast< pthread_t* >( mHandle );
+	pthread_join( *thread, NULL );
+	delete thread;
+#endif
+
+	mHandle = NULL;
+}
+
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+unsigned int __stdcall Thread::Entry( void * self )
+{
+	Thread* thread = static_cast< Thread* >( self );
+	thread->mFunction( thread->mArg );
+	return 0;
+}
+#else
+void * Thread::Entry( void * self )
+{
+	Thread* thread = static_cast< Thread* >( self );
+	thread->mFunction( thread->mArg );
+	return NULL;
+}
+#endif
@@ -0,0 +1,89 @@
+/* This source file is part of the Delectable Engine.
+ * For the latest info, please visit http://delectable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file WaitableTimer.cpp
+ * @brief High resolution sleep timer.
+ */
+
+// Precompiled Headers //
+#include "dbl/StdAfx.h"
+
+// Delectable Headers //
+#include "dbl/Threading/WaitableTimer.h"
+
+// External Libraries //
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+#include <windows.h>
+// Windows 10 1803 and later. Older SDKs don't define it.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#else
+#include <time.h>
+#include <errno.h>
+#endif
+
+using namespace dbl;
+
+WaitableTimer::WaitableTimer()
+: mHandle( NULL )
+, mHighResolution( false )
+{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	mHandle = ::CreateWaitableTimerExW( NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS );
+	mHighResolution = mHandle != NULL;
+	if( !mHandle )
+		mHandle = ::CreateWaitableTimerW( NULL, TRUE, NULL );
+#else
+	// nanosleep is backed by high resolution timers.
+	mHighResolution = true;
+#endif
+}
+
+WaitableTimer::~WaitableTimer()
+{
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	if( mHandle )
+		::CloseHandle( mHandle );
+#endif
+}
+
+void WaitableTimer::Wait( cbl::Float64 seconds )
+{
+	if( seconds <= 0.0 )
+		return;
+
+#if CBL_PLATFORM == CBL_PLATFORM_WIN32
+	if( !mHandle ) {
+		::Sleep( DWORD( seconds * 1000.0 ) );
+		return;
+	}
+
+	// Negative due times are relative, in 100ns units.
+	LARGE_INTEGER due;
+	due.QuadPart = -LONGLONG( seconds * 10000000.0 );
+	if( ::SetWaitableTimer( mHandle, &due, 0, NULL, NULL, FALSE ) )
+		::WaitForSingleObject( mHandle, INFINITE );
+#else
+	timespec ts;
+	ts.tv_sec	= time_t( seconds );
+	ts.tv_nsec	= long( ( seconds - cbl::Float64( ts.tv_sec ) ) * 1000000000.0 );
+	while( nanosleep( &ts, &ts ) == -1 && errno == EINTR ) {}
+#endif
+}